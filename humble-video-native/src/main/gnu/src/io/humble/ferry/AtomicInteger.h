@@ -20,7 +20,7 @@
 #ifndef ATOMICINTEGER_H_
 #define ATOMICINTEGER_H_
 
-#include <io/humble/ferry/JNIHelper.h>
+#include <io/humble/ferry/Ferry.h>
 
 namespace io { namespace humble { namespace ferry {
 /**
@@ -31,73 +31,118 @@ namespace io { namespace humble { namespace ferry {
  * since you'd just be calling from native code back into Java).  It's
  * here so that native code inside a JVM can have access to portable
  * thread-safe objects.
- * </p>  
+ * </p>
  * <p>
- * And that said, this method is really only Atomic if running inside a
- * Java JVM (or other virtual machine that can provide the functionality).
- * If running in a standalone C++ program there
- * is no current guarantee of Atomicity.
- * </p><p>
- * The object just forwards to the Java object:
- * java.util.concurrent.atomic.AtomicInteger
+ * All operations use the hardware atomic instructions of the platform
+ * we're compiled on, whether or not we're running inside a Java JVM,
+ * and never call into Java.  By default every operation is sequentially
+ * consistent (the same guarantee java.util.concurrent.atomic.AtomicInteger
+ * gives), but callers on hot paths can ask for a weaker {@link MemoryOrder}.
  * </p>
  */
 class VS_API_FERRY AtomicInteger
   {
     public:
+      /**
+       * The memory ordering to apply to an operation.  These map
+       * one-for-one onto the C++11 memory model orders.
+       * <p>
+       * Orders that make no sense for an operation (e.g. MEMORY_ORDER_RELEASE
+       * on a #get()) are weakened to the nearest order that does.
+       * </p>
+       */
+      typedef enum MemoryOrder {
+        /** Atomic, but no ordering of other memory operations. */
+        MEMORY_ORDER_RELAXED=__ATOMIC_RELAXED,
+        /** Later reads and writes may not move before this operation. */
+        MEMORY_ORDER_ACQUIRE=__ATOMIC_ACQUIRE,
+        /** Earlier reads and writes may not move after this operation. */
+        MEMORY_ORDER_RELEASE=__ATOMIC_RELEASE,
+        /** Both MEMORY_ORDER_ACQUIRE and MEMORY_ORDER_RELEASE. */
+        MEMORY_ORDER_ACQ_REL=__ATOMIC_ACQ_REL,
+        /** A single total order across all sequentially consistent operations. */
+        MEMORY_ORDER_SEQ_CST=__ATOMIC_SEQ_CST
+      } MemoryOrder;
+
       AtomicInteger();
       AtomicInteger(int32_t);
       ~AtomicInteger();
 
-      int32_t get();
-      void set(int32_t);
+      int32_t get(MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_load_n(&mValue, loadOrder(order));
+      }
+      void set(int32_t newval, MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        __atomic_store_n(&mValue, newval, storeOrder(order));
+      }
 
-      int32_t getAndSet(int32_t);
-      int32_t getAndIncrement();
-      int32_t getAndDecrement();
-      int32_t getAndAdd(int32_t);
-      int32_t incrementAndGet();
-      int32_t decrementAndGet();
-      int32_t addAndGet(int32_t);
+      int32_t getAndSet(int32_t newval, MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_exchange_n(&mValue, newval, order);
+      }
+      int32_t getAndIncrement(MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_fetch_add(&mValue, 1, order);
+      }
+      int32_t getAndDecrement(MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_fetch_sub(&mValue, 1, order);
+      }
+      int32_t getAndAdd(int32_t delta, MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_fetch_add(&mValue, delta, order);
+      }
+      int32_t incrementAndGet(MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_add_fetch(&mValue, 1, order);
+      }
+      int32_t decrementAndGet(MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_sub_fetch(&mValue, 1, order);
+      }
+      int32_t addAndGet(int32_t delta, MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_add_fetch(&mValue, delta, order);
+      }
 
       /**
        * Compare the current value to expected, and if
        * they are equal, set the current value to update.
        * @param expected the value expected
        * @param update the value to update to
+       * @param order the memory order to use if the update happens; if
+       *   it does not, the read of the current value is done with the
+       *   load equivalent of this order.
        * @return true if equal
        */
-      bool compareAndSet(int32_t expected, int32_t update);
+      bool compareAndSet(int32_t expected, int32_t update,
+          MemoryOrder order=MEMORY_ORDER_SEQ_CST) {
+        return __atomic_compare_exchange_n(&mValue, &expected, update, false,
+            order, loadOrder(order));
+      }
 
       /**
        * @return true if we're actually able to guarantee
-       * atomicity; false if we can't.
+       * atomicity; false if we can't.  Now that we use native atomics
+       * this is always true.
        */
       bool isAtomic();
 
-      friend class JNIHelper;
-
     private:
-      static bool init();
-
-      int32_t mNonAtomicValue;
-      jobject mAtomicValue;
-      static void initializeClass(JavaVM*, void*);
-      void initializeObject();
-      static jclass mClass;
-      static jmethodID mConstructorMethod;
-      static jmethodID mGetMethod;
-      static jmethodID mSetMethod;
-      static jmethodID mGetAndSetMethod;
-      static jmethodID mGetAndIncrementMethod;
-      static jmethodID mGetAndDecrementMethod;
-      static jmethodID mGetAndAddMethod;
-      static jmethodID mIncrementAndGetMethod;
-      static jmethodID mDecrementAndGetMethod;
-      static jmethodID mAddAndGetMethod;
-      static jmethodID mCompareAndSetMethod;
+      static int loadOrder(MemoryOrder order) {
+        switch(order) {
+          case MEMORY_ORDER_RELEASE:
+            return __ATOMIC_RELAXED;
+          case MEMORY_ORDER_ACQ_REL:
+            return __ATOMIC_ACQUIRE;
+          default:
+            return order;
+        }
+      }
+      static int storeOrder(MemoryOrder order) {
+        switch(order) {
+          case MEMORY_ORDER_ACQUIRE:
+            return __ATOMIC_RELAXED;
+          case MEMORY_ORDER_ACQ_REL:
+            return __ATOMIC_RELEASE;
+          default:
+            return order;
+        }
+      }
 
-      static bool mInitialized;
+      int32_t mValue;
   };
 }}}
 #endif // ! ATOMICINTEGER_H_
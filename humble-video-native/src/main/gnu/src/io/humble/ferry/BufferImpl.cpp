@@ -23,6 +23,7 @@
 #include <io/humble/ferry/HumbleException.h>
 #include <io/humble/ferry/JNIMemoryManager.h>
 #include <io/humble/ferry/RefPointer.h>
+#include <io/humble/ferry/RefCountedRegistry.h>
 #include <io/humble/ferry/BufferImpl.h>
 
 VS_LOG_SETUP(VS_CPP_PACKAGE.Buffer);
@@ -49,10 +50,14 @@ namespace io { namespace humble { namespace ferry
     mClosure = 0;
     mInternallyAllocated = false;
     mType = BUFFER_UINT8; // bytes
+    mByteStats = 0;
   }
 
   BufferImpl :: ~BufferImpl()
   {
+    RefCountedRegistry::onBytesReleased(
+        static_cast<RefCountedRegistry::TypeStats*>(mByteStats),
+        mBufferSize);
     if (mBuffer)
     {
       VS_ASSERT(mBufferSize, "had buffer but no size");
@@ -107,6 +112,7 @@ namespace io { namespace humble { namespace ferry
       retval->mBuffer = buffer;
       retval->mBufferSize = bufferSize;
       retval->mInternallyAllocated = true;
+      retval->countBytes(requestor);
     } catch (std::exception & e) {
       JNIMemoryManager::free(buffer);
       throw;
@@ -115,7 +121,7 @@ namespace io { namespace humble { namespace ferry
   }
 
   BufferImpl*
-  BufferImpl :: make(io::humble::ferry::RefCounted* /*unused*/, void *bufToWrap, int32_t bufferSize,
+  BufferImpl :: make(io::humble::ferry::RefCounted* requestor, void *bufToWrap, int32_t bufferSize,
       FreeFunc freeFunc, void *closure)
   {
     RefPointer<BufferImpl> retval;
@@ -136,10 +142,19 @@ namespace io { namespace humble { namespace ferry
       retval->mBufferSize = bufferSize;
       retval->mBuffer = bufToWrap;
       retval->mInternallyAllocated = false;
+      retval->countBytes(requestor);
     }
     return retval.get();
   }
   
+  void
+  BufferImpl :: countBytes(RefCounted* requestor)
+  {
+    if (RefCountedRegistry::isEnabled())
+      mByteStats = RefCountedRegistry::onBytesAcquired(
+          requestor ? requestor : this, mBufferSize);
+  }
+
   Buffer::Type
   BufferImpl :: getType()
   {
@@ -60,11 +60,14 @@ namespace io { namespace humble { namespace ferry
     BufferImpl();
     virtual ~BufferImpl();
   private:
+    void countBytes(io::humble::ferry::RefCounted* requestor);
     void* mBuffer;
     FreeFunc mFreeFunc;
     void* mClosure;
     int32_t mBufferSize;
     bool mInternallyAllocated;
+    // RefCountedRegistry counters our bytes are counted against
+    void* mByteStats;
     Type mType;
     static uint8_t mTypeSize[];
   };
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "CancellationToken.h"
+#include "JNIHelper.h"
+
+namespace io { namespace humble { namespace ferry {
+
+static pthread_once_t sKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t sKey;
+
+static void
+makeCurrentKey()
+{
+  pthread_key_create(&sKey, 0);
+}
+
+/**
+ * Deadlines only need to be roughly right, so we use the cheapest
+ * monotonic clock we can find; armed tokens read it on every check.
+ */
+static int64_t
+nowMicros()
+{
+  struct timespec ts;
+#if defined(CLOCK_MONOTONIC_COARSE)
+  if (!clock_gettime(CLOCK_MONOTONIC_COARSE, &ts))
+    return ((int64_t)ts.tv_sec)*1000000LL + ts.tv_nsec/1000;
+#endif
+#if defined(CLOCK_MONOTONIC)
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return ((int64_t)ts.tv_sec)*1000000LL + ts.tv_nsec/1000;
+#endif
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return ((int64_t)tv.tv_sec)*1000000LL + tv.tv_usec;
+}
+
+CancellationToken :: CancellationToken()
+{
+  mState = STATE_ACTIVE;
+  mDeadline = 0;
+}
+
+CancellationToken :: ~CancellationToken()
+{
+}
+
+CancellationToken*
+CancellationToken :: make()
+{
+  CancellationToken* retval = new CancellationToken();
+  retval->acquire();
+  return retval;
+}
+
+void
+CancellationToken :: cancel()
+{
+  int32_t state = __atomic_load_n(&mState, __ATOMIC_ACQUIRE);
+  while (state == STATE_ACTIVE || state == STATE_ARMED)
+  {
+    if (__atomic_compare_exchange_n(&mState, &state, STATE_CANCELLED,
+        false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+      break;
+  }
+}
+
+bool
+CancellationToken :: isTimedOut()
+{
+  // give an armed token the chance to notice its deadline passed
+  isCancelled();
+  return __atomic_load_n(&mState, __ATOMIC_ACQUIRE) == STATE_TIMED_OUT;
+}
+
+void
+CancellationToken :: setTimeout(int64_t microseconds)
+{
+  __atomic_store_n(&mDeadline, nowMicros() + microseconds, __ATOMIC_RELEASE);
+  int32_t expected = STATE_ACTIVE;
+  __atomic_compare_exchange_n(&mState, &expected, STATE_ARMED,
+      false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+void
+CancellationToken :: clearTimeout()
+{
+  int32_t expected = STATE_ARMED;
+  __atomic_compare_exchange_n(&mState, &expected, STATE_ACTIVE,
+      false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+void
+CancellationToken :: reset()
+{
+  __atomic_store_n(&mState, STATE_ACTIVE, __ATOMIC_RELEASE);
+}
+
+bool
+CancellationToken :: checkDeadline()
+{
+  if (nowMicros() < __atomic_load_n(&mDeadline, __ATOMIC_ACQUIRE))
+    return false;
+  int32_t expected = STATE_ARMED;
+  __atomic_compare_exchange_n(&mState, &expected, STATE_TIMED_OUT,
+      false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+  // if we lost a race, expected now holds whatever the state became
+  return expected != STATE_ACTIVE;
+}
+
+CancellationToken*
+CancellationToken :: getCurrent()
+{
+  pthread_once(&sKeyOnce, makeCurrentKey);
+  return (CancellationToken*)pthread_getspecific(sKey);
+}
+
+bool
+CancellationToken :: sIsCancelled(CancellationToken* token)
+{
+  if (!token)
+    token = getCurrent();
+  if (token)
+    return token->isCancelled();
+
+  // no token; fall back to asking Java
+  JNIHelper* helper = JNIHelper::getHelper();
+  return helper && helper->isInterrupted();
+}
+
+CancellationToken :: Scope :: Scope(CancellationToken* token)
+{
+  mPrevious = 0;
+  mBound = token != 0;
+  if (mBound)
+  {
+    mPrevious = getCurrent();
+    pthread_setspecific(sKey, token);
+  }
+}
+
+CancellationToken :: Scope :: ~Scope()
+{
+  if (mBound)
+    pthread_setspecific(sKey, mPrevious);
+}
+
+}}}
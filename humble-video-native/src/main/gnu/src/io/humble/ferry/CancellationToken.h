@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef CANCELLATIONTOKEN_H_
+#define CANCELLATIONTOKEN_H_
+
+#include <io/humble/ferry/RefCounted.h>
+#include <io/humble/ferry/HumbleException.h>
+
+namespace io { namespace humble { namespace ferry {
+
+/**
+ * A flag that tells a blocking operation to give up, optionally once a
+ * deadline has passed.
+ * <p>
+ * Attach a token to a Demuxer, Muxer or custom IO handler and any thread
+ * can then #cancel() the work it is doing.  Checking a token that
+ * has no deadline is a single atomic load, so the I/O loops inside FFmpeg
+ * can check it as often as they like.
+ * </p><p>
+ * Once cancelled a token stays cancelled until #reset() is called.
+ * </p>
+ */
+class VS_API_FERRY CancellationToken : public RefCounted
+{
+public:
+  /**
+   * Make a new token that is not cancelled and has no deadline.
+   */
+  static CancellationToken* make();
+
+  /**
+   * Cancel any operation checking this token.  Safe to call from any
+   * thread, including while the operation is blocked.
+   */
+  void cancel();
+
+  /**
+   * Has this token been cancelled, or has its deadline passed?
+   */
+  bool isCancelled() {
+    int32_t state = __atomic_load_n(&mState, __ATOMIC_ACQUIRE);
+    if (state == STATE_ACTIVE)
+      return false;
+    if (state == STATE_ARMED)
+      return checkDeadline();
+    return true;
+  }
+
+  /**
+   * Did this token cancel because its deadline passed (rather than because
+   * someone called #cancel())?
+   */
+  bool isTimedOut();
+
+  /**
+   * Cancel this token automatically once the given amount of time has
+   * passed.  Replaces any earlier deadline.  Has no effect if the token is
+   * already cancelled.
+   *
+   * @param microseconds How long from now the deadline is.  0 or less
+   *   means the deadline has already passed.
+   */
+  void setTimeout(int64_t microseconds);
+
+  /**
+   * Remove any deadline set with #setTimeout(long).  Has no effect if the
+   * token is already cancelled.
+   */
+  void clearTimeout();
+
+  /**
+   * Clear both the cancelled flag and any deadline so the token can be
+   * used again.  Only call this when no operation is checking the token.
+   */
+  void reset();
+
+#ifndef SWIG
+  /**
+   * Binds a token to the calling thread for as long as the scope
+   * lives, so that code with no handle to the token (for example
+   * FfmpegException::check or VS_CHECK_INTERRUPT) still checks it.
+   * Scopes nest; a null token leaves the current binding alone.
+   */
+  class VS_API_FERRY Scope
+  {
+  public:
+    Scope(CancellationToken* token);
+    ~Scope();
+  private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+    CancellationToken* mPrevious;
+    bool mBound;
+  };
+
+  /**
+   * @return The token bound to this thread by a Scope, or null.  The
+   *   caller does not get a reference.
+   */
+  static CancellationToken* getCurrent();
+
+  /**
+   * Should the calling thread stop what it is doing?
+   * <p>
+   * Checks, in order: the given token; the token bound to this thread; and
+   * only if neither exists, whether the Java thread has been interrupted.
+   * The last check is a JNI call, so anything that checks often should
+   * have a token.
+   * </p>
+   *
+   * @param token The token to check, or null.
+   */
+  static bool sIsCancelled(CancellationToken* token);
+#endif // ! SWIG
+
+protected:
+  CancellationToken();
+  virtual ~CancellationToken();
+
+private:
+  typedef enum State {
+    STATE_ACTIVE=0,
+    STATE_ARMED=1,
+    STATE_CANCELLED=2,
+    STATE_TIMED_OUT=3,
+  } State;
+
+  bool checkDeadline();
+
+  volatile int32_t mState;
+  volatile int64_t mDeadline;
+};
+
+/**
+ * If __COND__ is true, throw HumbleInterruptedException if __TOKEN__ (or
+ * failing that, the token bound to this thread, or failing that the Java
+ * thread) has been cancelled.
+ */
+#define VS_CHECK_CANCELLED(__TOKEN__, __COND__) do { \
+    if ((__COND__) && \
+        ::io::humble::ferry::CancellationToken::sIsCancelled(__TOKEN__)) \
+      throw ::io::humble::ferry::HumbleInterruptedException(); \
+} while(0)
+
+}}}
+
+#endif /*CANCELLATIONTOKEN_H_*/
@@ -235,6 +235,7 @@ JNI_OnLoad(JavaVM *, void *)
 #include <io/humble/ferry/AtomicInteger.h>
 #include <io/humble/ferry/Logger.h>
 #include <io/humble/ferry/Mutex.h>
+#include <io/humble/ferry/CancellationToken.h>
 #include <io/humble/ferry/Buffer.h>
 #include <io/humble/ferry/RefCountedTester.h>
 
@@ -450,6 +451,66 @@ SWIGINTERN io::humble::ferry::Buffer *io_humble_ferry_Buffer_make__SWIG_3(io::hu
 extern "C" {
 #endif
 
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1MEMORY_1ORDER_1RELAXED_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::AtomicInteger::MemoryOrder)io::humble::ferry::AtomicInteger::MEMORY_ORDER_RELAXED;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1MEMORY_1ORDER_1ACQUIRE_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::AtomicInteger::MemoryOrder)io::humble::ferry::AtomicInteger::MEMORY_ORDER_ACQUIRE;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1MEMORY_1ORDER_1RELEASE_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::AtomicInteger::MemoryOrder)io::humble::ferry::AtomicInteger::MEMORY_ORDER_RELEASE;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1MEMORY_1ORDER_1ACQ_1REL_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::AtomicInteger::MemoryOrder)io::humble::ferry::AtomicInteger::MEMORY_ORDER_ACQ_REL;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1MEMORY_1ORDER_1SEQ_1CST_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::AtomicInteger::MemoryOrder)io::humble::ferry::AtomicInteger::MEMORY_ORDER_SEQ_CST;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
 SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_new_1AtomicInteger_1_1SWIG_10(JNIEnv *jenv, jclass jcls) {
   jlong jresult = 0 ;
   io::humble::ferry::AtomicInteger *result = 0 ;
@@ -556,15 +617,17 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_delete_1AtomicInteger(JNIE
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1get(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1get_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg2 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -577,7 +640,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1get(JNIEnv
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->get();
+      result = (int32_t)(arg1)->get(arg2);
     }
     catch(std::exception & e)
     {
@@ -599,20 +662,20 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1get(JNIEnv
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1set(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1get_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
-  int32_t arg2 ;
+  int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
-  arg2 = (int32_t)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return ;
+    return 0;
   }
   
   {
@@ -620,42 +683,44 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1set(JNIEnv
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      (arg1)->set(arg2);
+      result = (int32_t)(arg1)->get();
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return ;
+      return 0;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return ;
+      return 0;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
+  jresult = (jint)result; 
+  return jresult;
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndSet(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
-  jint jresult = 0 ;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1set_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
   int32_t arg2 ;
-  int32_t result;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg3 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
   arg2 = (int32_t)jarg2; 
+  arg3 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg3; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return 0;
+    return ;
   }
   
   {
@@ -663,42 +728,40 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndSet(J
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->getAndSet(arg2);
+      (arg1)->set(arg2,arg3);
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return 0;
+      return ;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return 0;
+      return ;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jint)result; 
-  return jresult;
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndIncrement(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
-  jint jresult = 0 ;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1set_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
-  int32_t result;
+  int32_t arg2 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return 0;
+    return ;
   }
   
   {
@@ -706,37 +769,39 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndIncre
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->getAndIncrement();
+      (arg1)->set(arg2);
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return 0;
+      return ;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return 0;
+      return ;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jint)result; 
-  return jresult;
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndDecrement(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndSet_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
   jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t arg2 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg3 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
+  arg3 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg3; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -749,7 +814,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndDecre
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->getAndDecrement();
+      result = (int32_t)(arg1)->getAndSet(arg2,arg3);
     }
     catch(std::exception & e)
     {
@@ -771,7 +836,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndDecre
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndAdd(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndSet_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
   int32_t arg2 ;
@@ -794,7 +859,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndAdd(J
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->getAndAdd(arg2);
+      result = (int32_t)(arg1)->getAndSet(arg2);
     }
     catch(std::exception & e)
     {
@@ -816,15 +881,17 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndAdd(J
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1incrementAndGet(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndIncrement_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg2 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -837,7 +904,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1incrementAn
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->incrementAndGet();
+      result = (int32_t)(arg1)->getAndIncrement(arg2);
     }
     catch(std::exception & e)
     {
@@ -859,7 +926,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1incrementAn
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1decrementAndGet(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndIncrement_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
   jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
   int32_t result;
@@ -880,7 +947,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1decrementAn
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->decrementAndGet();
+      result = (int32_t)(arg1)->getAndIncrement();
     }
     catch(std::exception & e)
     {
@@ -902,17 +969,17 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1decrementAn
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1addAndGet(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndDecrement_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
-  int32_t arg2 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg2 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
-  arg2 = (int32_t)jarg2; 
+  arg2 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -925,7 +992,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1addAndGet(J
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->addAndGet(arg2);
+      result = (int32_t)(arg1)->getAndDecrement(arg2);
     }
     catch(std::exception & e)
     {
@@ -947,19 +1014,15 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1addAndGet(J
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1compareAndSet(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
-  jboolean jresult = 0 ;
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndDecrement_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
-  int32_t arg2 ;
-  int32_t arg3 ;
-  bool result;
+  int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
-  arg2 = (int32_t)jarg2; 
-  arg3 = (int32_t)jarg3; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -972,7 +1035,7 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1compare
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->compareAndSet(arg2,arg3);
+      result = (int32_t)(arg1)->getAndDecrement();
     }
     catch(std::exception & e)
     {
@@ -989,20 +1052,24 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1compare
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
+  jresult = (jint)result; 
   return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1isAtomic(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
-  jboolean jresult = 0 ;
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndAdd_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
+  jint jresult = 0 ;
   io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
-  bool result;
+  int32_t arg2 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg3 ;
+  int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
+  arg3 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg3; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1015,7 +1082,7 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1isAtomi
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->isAtomic();
+      result = (int32_t)(arg1)->getAndAdd(arg2,arg3);
     }
     catch(std::exception & e)
     {
@@ -1032,20 +1099,22 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1isAtomi
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
+  jresult = (jint)result; 
   return jresult;
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1acquire(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1getAndAdd_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
-  io::humble::ferry::RefCounted *arg1 = (io::humble::ferry::RefCounted *) 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t arg2 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::RefCounted **)&jarg1; 
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1058,7 +1127,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1acquire(JNIEnv
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->acquire();
+      result = (int32_t)(arg1)->getAndAdd(arg2);
     }
     catch(std::exception & e)
     {
@@ -1080,15 +1149,17 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1acquire(JNIEnv
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1release(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1incrementAndGet_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
-  io::humble::ferry::RefCounted *arg1 = (io::humble::ferry::RefCounted *) 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg2 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::RefCounted **)&jarg1; 
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1101,7 +1172,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1release(JNIEnv
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->release();
+      result = (int32_t)(arg1)->incrementAndGet(arg2);
     }
     catch(std::exception & e)
     {
@@ -1123,15 +1194,15 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1release(JNIEnv
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1getCurrentNativeRefCount(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1incrementAndGet_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
   jint jresult = 0 ;
-  io::humble::ferry::RefCounted *arg1 = (io::humble::ferry::RefCounted *) 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
   int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::RefCounted **)&jarg1; 
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1144,7 +1215,7 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1getCurrentNati
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (int32_t)(arg1)->getCurrentRefCount();
+      result = (int32_t)(arg1)->incrementAndGet();
     }
     catch(std::exception & e)
     {
@@ -1166,84 +1237,30 @@ SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1getCurrentNati
 }
 
 
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1ERROR_1get(JNIEnv *jenv, jclass jcls) {
-  jint jresult = 0 ;
-  io::humble::ferry::Logger::Level result;
-  
-  (void)jenv;
-  (void)jcls;
-  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_ERROR;
-  jresult = (jint)result; 
-  return jresult;
-}
-
-
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1WARN_1get(JNIEnv *jenv, jclass jcls) {
-  jint jresult = 0 ;
-  io::humble::ferry::Logger::Level result;
-  
-  (void)jenv;
-  (void)jcls;
-  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_WARN;
-  jresult = (jint)result; 
-  return jresult;
-}
-
-
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1INFO_1get(JNIEnv *jenv, jclass jcls) {
-  jint jresult = 0 ;
-  io::humble::ferry::Logger::Level result;
-  
-  (void)jenv;
-  (void)jcls;
-  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_INFO;
-  jresult = (jint)result; 
-  return jresult;
-}
-
-
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1DEBUG_1get(JNIEnv *jenv, jclass jcls) {
-  jint jresult = 0 ;
-  io::humble::ferry::Logger::Level result;
-  
-  (void)jenv;
-  (void)jcls;
-  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_DEBUG;
-  jresult = (jint)result; 
-  return jresult;
-}
-
-
-SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1TRACE_1get(JNIEnv *jenv, jclass jcls) {
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1decrementAndGet_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
   jint jresult = 0 ;
-  io::humble::ferry::Logger::Level result;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg2 ;
+  int32_t result;
   
   (void)jenv;
   (void)jcls;
-  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_TRACE;
-  jresult = (jint)result; 
-  return jresult;
-}
-
-
-SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getLogger(JNIEnv *jenv, jclass jcls, jstring jarg1) {
-  jlong jresult = 0 ;
-  char *arg1 = (char *) 0 ;
-  io::humble::ferry::Logger *result = 0 ;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg2; 
   
-  (void)jenv;
-  (void)jcls;
-  arg1 = 0;
-  if (jarg1) {
-    arg1 = (char *)jenv->GetStringUTFChars(jarg1, 0);
-    if (!arg1) return 0;
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
   }
+  
   {
     // JNIHelper.swg: Start generated code
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (io::humble::ferry::Logger *)io::humble::ferry::Logger::getLogger((char const *)arg1);
+      result = (int32_t)(arg1)->decrementAndGet(arg2);
     }
     catch(std::exception & e)
     {
@@ -1260,30 +1277,33 @@ SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getLogger(JNIEnv
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  *(io::humble::ferry::Logger **)&jresult = result; 
-  if (arg1) jenv->ReleaseStringUTFChars(jarg1, (const char *)arg1);
+  jresult = (jint)result; 
   return jresult;
 }
 
 
-SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getStaticLogger(JNIEnv *jenv, jclass jcls, jstring jarg1) {
-  jlong jresult = 0 ;
-  char *arg1 = (char *) 0 ;
-  io::humble::ferry::Logger *result = 0 ;
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1decrementAndGet_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t result;
   
   (void)jenv;
   (void)jcls;
-  arg1 = 0;
-  if (jarg1) {
-    arg1 = (char *)jenv->GetStringUTFChars(jarg1, 0);
-    if (!arg1) return 0;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
   }
+  
   {
     // JNIHelper.swg: Start generated code
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (io::humble::ferry::Logger *)io::humble::ferry::Logger::getStaticLogger((char const *)arg1);
+      result = (int32_t)(arg1)->decrementAndGet();
     }
     catch(std::exception & e)
     {
@@ -1300,38 +1320,69 @@ SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getStaticLogger(J
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  *(io::humble::ferry::Logger **)&jresult = result; 
-  if (arg1) jenv->ReleaseStringUTFChars(jarg1, (const char *)arg1);
+  jresult = (jint)result; 
   return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1log(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jint jarg4, jstring jarg5) {
-  jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *arg2 = (char *) 0 ;
-  int arg3 ;
-  io::humble::ferry::Logger::Level arg4 ;
-  char *arg5 = (char *) 0 ;
-  void *arg6 = 0 ;
-  bool result;
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1addAndGet_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t arg2 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg3 ;
+  int32_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = 0;
-  if (jarg2) {
-    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
-    if (!arg2) return 0;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
+  arg3 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg3; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
   }
-  arg3 = (int)jarg3; 
-  arg4 = (io::humble::ferry::Logger::Level)jarg4; 
-  arg5 = 0;
-  if (jarg5) {
-    arg5 = (char *)jenv->GetStringUTFChars(jarg5, 0);
-    if (!arg5) return 0;
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int32_t)(arg1)->addAndGet(arg2,arg3);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
   }
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1addAndGet_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+  jint jresult = 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t arg2 ;
+  int32_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1344,7 +1395,7 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1log(JNIEnv *je
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->log((char const *)arg2,arg3,arg4,(char const *)arg5,arg6);
+      result = (int32_t)(arg1)->addAndGet(arg2);
     }
     catch(std::exception & e)
     {
@@ -1361,37 +1412,73 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1log(JNIEnv *je
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
-  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
-  if (arg5) jenv->ReleaseStringUTFChars(jarg5, (const char *)arg5);
+  jresult = (jint)result; 
   return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1error(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1compareAndSet_1_1SWIG_10(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3, jint jarg4) {
   jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *arg2 = (char *) 0 ;
-  int arg3 ;
-  char *arg4 = (char *) 0 ;
-  void *arg5 = 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t arg2 ;
+  int32_t arg3 ;
+  io::humble::ferry::AtomicInteger::MemoryOrder arg4 ;
   bool result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = 0;
-  if (jarg2) {
-    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
-    if (!arg2) return 0;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
+  arg3 = (int32_t)jarg3; 
+  arg4 = (io::humble::ferry::AtomicInteger::MemoryOrder)jarg4; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
   }
-  arg3 = (int)jarg3; 
-  arg4 = 0;
-  if (jarg4) {
-    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
-    if (!arg4) return 0;
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->compareAndSet(arg2,arg3,arg4);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
   }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1compareAndSet_1_1SWIG_11(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
+  int32_t arg2 ;
+  int32_t arg3 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  arg2 = (int32_t)jarg2; 
+  arg3 = (int32_t)jarg3; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1404,7 +1491,7 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1error(JNIEnv *
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->error((char const *)arg2,arg3,(char const *)arg4,arg5);
+      result = (bool)(arg1)->compareAndSet(arg2,arg3);
     }
     catch(std::exception & e)
     {
@@ -1422,41 +1509,1204 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1error(JNIEnv *
     // JNIHelper.swg: End generated code
   }
   jresult = (jboolean)result; 
-  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
-  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
   return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1warn(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_AtomicInteger_1isAtomic(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
   jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *arg2 = (char *) 0 ;
-  int arg3 ;
-  char *arg4 = (char *) 0 ;
-  void *arg5 = 0 ;
+  io::humble::ferry::AtomicInteger *arg1 = (io::humble::ferry::AtomicInteger *) 0 ;
   bool result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = 0;
-  if (jarg2) {
-    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
-    if (!arg2) return 0;
+  arg1 = *(io::humble::ferry::AtomicInteger **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
   }
-  arg3 = (int)jarg3; 
-  arg4 = 0;
-  if (jarg4) {
-    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
-    if (!arg4) return 0;
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->isAtomic();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1acquire(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jint jresult = 0 ;
+  io::humble::ferry::RefCounted *arg1 = (io::humble::ferry::RefCounted *) 0 ;
+  int32_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::RefCounted **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int32_t)(arg1)->acquire();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1release(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jint jresult = 0 ;
+  io::humble::ferry::RefCounted *arg1 = (io::humble::ferry::RefCounted *) 0 ;
+  int32_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::RefCounted **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
   }
   
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int32_t)(arg1)->release();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_RefCounted_1getCurrentNativeRefCount(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jint jresult = 0 ;
+  io::humble::ferry::RefCounted *arg1 = (io::humble::ferry::RefCounted *) 0 ;
+  int32_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::RefCounted **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int32_t)(arg1)->getCurrentRefCount();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1ERROR_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::Logger::Level result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_ERROR;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1WARN_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::Logger::Level result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_WARN;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1INFO_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::Logger::Level result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_INFO;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1DEBUG_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::Logger::Level result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_DEBUG;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1LEVEL_1TRACE_1get(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  io::humble::ferry::Logger::Level result;
+  
+  (void)jenv;
+  (void)jcls;
+  result = (io::humble::ferry::Logger::Level)io::humble::ferry::Logger::LEVEL_TRACE;
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getLogger(JNIEnv *jenv, jclass jcls, jstring jarg1) {
+  jlong jresult = 0 ;
+  char *arg1 = (char *) 0 ;
+  io::humble::ferry::Logger *result = 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = 0;
+  if (jarg1) {
+    arg1 = (char *)jenv->GetStringUTFChars(jarg1, 0);
+    if (!arg1) return 0;
+  }
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (io::humble::ferry::Logger *)io::humble::ferry::Logger::getLogger((char const *)arg1);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  *(io::humble::ferry::Logger **)&jresult = result; 
+  if (arg1) jenv->ReleaseStringUTFChars(jarg1, (const char *)arg1);
+  return jresult;
+}
+
+
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getStaticLogger(JNIEnv *jenv, jclass jcls, jstring jarg1) {
+  jlong jresult = 0 ;
+  char *arg1 = (char *) 0 ;
+  io::humble::ferry::Logger *result = 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = 0;
+  if (jarg1) {
+    arg1 = (char *)jenv->GetStringUTFChars(jarg1, 0);
+    if (!arg1) return 0;
+  }
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (io::humble::ferry::Logger *)io::humble::ferry::Logger::getStaticLogger((char const *)arg1);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  *(io::humble::ferry::Logger **)&jresult = result; 
+  if (arg1) jenv->ReleaseStringUTFChars(jarg1, (const char *)arg1);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1log(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jint jarg4, jstring jarg5) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *arg2 = (char *) 0 ;
+  int arg3 ;
+  io::humble::ferry::Logger::Level arg4 ;
+  char *arg5 = (char *) 0 ;
+  void *arg6 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  arg3 = (int)jarg3; 
+  arg4 = (io::humble::ferry::Logger::Level)jarg4; 
+  arg5 = 0;
+  if (jarg5) {
+    arg5 = (char *)jenv->GetStringUTFChars(jarg5, 0);
+    if (!arg5) return 0;
+  }
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->log((char const *)arg2,arg3,arg4,(char const *)arg5,arg6);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  if (arg5) jenv->ReleaseStringUTFChars(jarg5, (const char *)arg5);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1error(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *arg2 = (char *) 0 ;
+  int arg3 ;
+  char *arg4 = (char *) 0 ;
+  void *arg5 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  arg3 = (int)jarg3; 
+  arg4 = 0;
+  if (jarg4) {
+    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
+    if (!arg4) return 0;
+  }
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->error((char const *)arg2,arg3,(char const *)arg4,arg5);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1warn(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *arg2 = (char *) 0 ;
+  int arg3 ;
+  char *arg4 = (char *) 0 ;
+  void *arg5 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  arg3 = (int)jarg3; 
+  arg4 = 0;
+  if (jarg4) {
+    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
+    if (!arg4) return 0;
+  }
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->warn((char const *)arg2,arg3,(char const *)arg4,arg5);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1info(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *arg2 = (char *) 0 ;
+  int arg3 ;
+  char *arg4 = (char *) 0 ;
+  void *arg5 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  arg3 = (int)jarg3; 
+  arg4 = 0;
+  if (jarg4) {
+    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
+    if (!arg4) return 0;
+  }
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->info((char const *)arg2,arg3,(char const *)arg4,arg5);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1debug(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *arg2 = (char *) 0 ;
+  int arg3 ;
+  char *arg4 = (char *) 0 ;
+  void *arg5 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  arg3 = (int)jarg3; 
+  arg4 = 0;
+  if (jarg4) {
+    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
+    if (!arg4) return 0;
+  }
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->debug((char const *)arg2,arg3,(char const *)arg4,arg5);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1trace(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *arg2 = (char *) 0 ;
+  int arg3 ;
+  char *arg4 = (char *) 0 ;
+  void *arg5 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  arg3 = (int)jarg3; 
+  arg4 = 0;
+  if (jarg4) {
+    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
+    if (!arg4) return 0;
+  }
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->trace((char const *)arg2,arg3,(char const *)arg4,arg5);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isPrintStackTrace(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->isPrintStackTrace();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setPrintStackTrace(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return ;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      (arg1)->setPrintStackTrace(arg2);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return ;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return ;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isLogging(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  io::humble::ferry::Logger::Level arg2 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = (io::humble::ferry::Logger::Level)jarg2; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)(arg1)->isLogging(arg2);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setIsLogging(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jboolean jarg3) {
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  io::humble::ferry::Logger::Level arg2 ;
+  bool arg3 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg2 = (io::humble::ferry::Logger::Level)jarg2; 
+  arg3 = jarg3 ? true : false; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return ;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      (arg1)->setIsLogging(arg2,arg3);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return ;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return ;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isGlobalLogging(JNIEnv *jenv, jclass jcls, jint jarg1) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::Logger::Level arg1 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = (io::humble::ferry::Logger::Level)jarg1; 
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)io::humble::ferry::Logger::isGlobalLogging(arg1);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setGlobalIsLogging(JNIEnv *jenv, jclass jcls, jint jarg1, jboolean jarg2) {
+  io::humble::ferry::Logger::Level arg1 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = (io::humble::ferry::Logger::Level)jarg1; 
+  arg2 = jarg2 ? true : false; 
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      io::humble::ferry::Logger::setGlobalIsLogging(arg1,arg2);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return ;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return ;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+}
+
+
+SWIGEXPORT jstring JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getName(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jstring jresult = 0 ;
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  char *result = 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return 0;
+  }
+  
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (char *)(arg1)->getName();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  if (result) jresult = jenv->NewStringUTF((const char *)result);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setAsynchronous(JNIEnv *jenv, jclass jcls, jboolean jarg1) {
+  jboolean jresult = 0 ;
+  bool arg1 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = jarg1 ? true : false; 
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)io::humble::ferry::Logger::setAsynchronous(arg1);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isAsynchronous(JNIEnv *jenv, jclass jcls) {
+  jboolean jresult = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (bool)io::humble::ferry::Logger::isAsynchronous();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1flush(JNIEnv *jenv, jclass jcls) {
+  (void)jenv;
+  (void)jcls;
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      io::humble::ferry::Logger::flush();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return ;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return ;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+}
+
+
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getDroppedMessages(JNIEnv *jenv, jclass jcls) {
+  jlong jresult = 0 ;
+  int64_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int64_t)io::humble::ferry::Logger::getDroppedMessages();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jlong)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setRateLimit(JNIEnv *jenv, jclass jcls, jint jarg1) {
+  int32_t arg1 ;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = (int32_t)jarg1; 
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      io::humble::ferry::Logger::setRateLimit(arg1);
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return ;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return ;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+}
+
+
+SWIGEXPORT jint JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getRateLimit(JNIEnv *jenv, jclass jcls) {
+  jint jresult = 0 ;
+  int32_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int32_t)io::humble::ferry::Logger::getRateLimit();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getRateLimitedMessages(JNIEnv *jenv, jclass jcls) {
+  jlong jresult = 0 ;
+  int64_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  {
+    // JNIHelper.swg: Start generated code
+    // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+    try
+    {
+      result = (int64_t)io::humble::ferry::Logger::getRateLimitedMessages();
+    }
+    catch(std::exception & e)
+    {
+      io::humble::ferry::JNIHelper::catchException(jenv, e);
+      return 0;
+    }
+    catch(...)
+    {
+      std::runtime_error e("Unhandled and unknown native exception");
+      io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
+      return 0;
+    }
+    
+    // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+    // JNIHelper.swg: End generated code
+  }
+  jresult = (jlong)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_delete_1Logger(JNIEnv *jenv, jclass jcls, jlong jarg1) {
+  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return 0;
+    return ;
   }
   
   {
@@ -1464,67 +2714,38 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1warn(JNIEnv *j
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->warn((char const *)arg2,arg3,(char const *)arg4,arg5);
+      delete arg1;
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return 0;
+      return ;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return 0;
+      return ;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
-  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
-  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
-  return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1info(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
-  jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *arg2 = (char *) 0 ;
-  int arg3 ;
-  char *arg4 = (char *) 0 ;
-  void *arg5 = 0 ;
-  bool result;
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1make(JNIEnv *jenv, jclass jcls) {
+  jlong jresult = 0 ;
+  io::humble::ferry::Mutex *result = 0 ;
   
   (void)jenv;
   (void)jcls;
-  (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = 0;
-  if (jarg2) {
-    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
-    if (!arg2) return 0;
-  }
-  arg3 = (int)jarg3; 
-  arg4 = 0;
-  if (jarg4) {
-    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
-    if (!arg4) return 0;
-  }
-  
-  if (!arg1) {
-    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
-      "invalid native object; delete() likely already called");
-    return 0;
-  }
-  
   {
     // JNIHelper.swg: Start generated code
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->info((char const *)arg2,arg3,(char const *)arg4,arg5);
+      result = (io::humble::ferry::Mutex *)io::humble::ferry::Mutex::make();
     }
     catch(std::exception & e)
     {
@@ -1541,42 +2762,23 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1info(JNIEnv *j
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
-  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
-  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
+  *(io::humble::ferry::Mutex **)&jresult = result; 
   return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1debug(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
-  jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *arg2 = (char *) 0 ;
-  int arg3 ;
-  char *arg4 = (char *) 0 ;
-  void *arg5 = 0 ;
-  bool result;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1lock(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = 0;
-  if (jarg2) {
-    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
-    if (!arg2) return 0;
-  }
-  arg3 = (int)jarg3; 
-  arg4 = 0;
-  if (jarg4) {
-    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
-    if (!arg4) return 0;
-  }
+  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return 0;
+    return ;
   }
   
   {
@@ -1584,59 +2786,38 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1debug(JNIEnv *
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->debug((char const *)arg2,arg3,(char const *)arg4,arg5);
+      (arg1)->lock();
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return 0;
+      return ;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return 0;
+      return ;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
-  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
-  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
-  return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1trace(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2, jint jarg3, jstring jarg4) {
-  jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *arg2 = (char *) 0 ;
-  int arg3 ;
-  char *arg4 = (char *) 0 ;
-  void *arg5 = 0 ;
-  bool result;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1unlock(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = 0;
-  if (jarg2) {
-    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
-    if (!arg2) return 0;
-  }
-  arg3 = (int)jarg3; 
-  arg4 = 0;
-  if (jarg4) {
-    arg4 = (char *)jenv->GetStringUTFChars(jarg4, 0);
-    if (!arg4) return 0;
-  }
+  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return 0;
+    return ;
   }
   
   {
@@ -1644,39 +2825,35 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1trace(JNIEnv *
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->trace((char const *)arg2,arg3,(char const *)arg4,arg5);
+      (arg1)->unlock();
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return 0;
+      return ;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return 0;
+      return ;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
-  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
-  if (arg4) jenv->ReleaseStringUTFChars(jarg4, (const char *)arg4);
-  return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isPrintStackTrace(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1isNative(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
   jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
   bool result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1689,7 +2866,7 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isPrintStackTr
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->isPrintStackTrace();
+      result = (bool)(arg1)->isNative();
     }
     catch(std::exception & e)
     {
@@ -1711,20 +2888,20 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isPrintStackTr
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setPrintStackTrace(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  bool arg2 ;
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1getAcquisitions(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jlong jresult = 0 ;
+  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
+  int64_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = jarg2 ? true : false; 
+  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return ;
+    return 0;
   }
   
   {
@@ -1732,37 +2909,37 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setPrintStackTrace
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      (arg1)->setPrintStackTrace(arg2);
+      result = (int64_t)(arg1)->getAcquisitions();
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return ;
+      return 0;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return ;
+      return 0;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
+  jresult = (jlong)result; 
+  return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isLogging(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
-  jboolean jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  io::humble::ferry::Logger::Level arg2 ;
-  bool result;
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1getContendedAcquisitions(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jlong jresult = 0 ;
+  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
+  int64_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = (io::humble::ferry::Logger::Level)jarg2; 
+  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1775,7 +2952,7 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isLogging(JNIE
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)(arg1)->isLogging(arg2);
+      result = (int64_t)(arg1)->getContendedAcquisitions();
     }
     catch(std::exception & e)
     {
@@ -1792,27 +2969,25 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isLogging(JNIE
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
+  jresult = (jlong)result; 
   return jresult;
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setIsLogging(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jboolean jarg3) {
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  io::humble::ferry::Logger::Level arg2 ;
-  bool arg3 ;
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1getWaitTime(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jlong jresult = 0 ;
+  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
+  int64_t result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
-  arg2 = (io::humble::ferry::Logger::Level)jarg2; 
-  arg3 = jarg3 ? true : false; 
+  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return ;
+    return 0;
   }
   
   {
@@ -1820,40 +2995,40 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setIsLogging(JNIEn
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      (arg1)->setIsLogging(arg2,arg3);
+      result = (int64_t)(arg1)->getWaitTime();
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return ;
+      return 0;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return ;
+      return 0;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
+  jresult = (jlong)result; 
+  return jresult;
 }
 
 
-SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isGlobalLogging(JNIEnv *jenv, jclass jcls, jint jarg1) {
-  jboolean jresult = 0 ;
-  io::humble::ferry::Logger::Level arg1 ;
-  bool result;
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1make(JNIEnv *jenv, jclass jcls) {
+  jlong jresult = 0 ;
+  io::humble::ferry::CancellationToken *result = 0 ;
   
   (void)jenv;
   (void)jcls;
-  arg1 = (io::humble::ferry::Logger::Level)jarg1; 
   {
     // JNIHelper.swg: Start generated code
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (bool)io::humble::ferry::Logger::isGlobalLogging(arg1);
+      result = (io::humble::ferry::CancellationToken *)io::humble::ferry::CancellationToken::make();
     }
     catch(std::exception & e)
     {
@@ -1870,25 +3045,31 @@ SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_Logger_1isGlobalLoggin
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  jresult = (jboolean)result; 
+  *(io::humble::ferry::CancellationToken **)&jresult = result; 
   return jresult;
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setGlobalIsLogging(JNIEnv *jenv, jclass jcls, jint jarg1, jboolean jarg2) {
-  io::humble::ferry::Logger::Level arg1 ;
-  bool arg2 ;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1cancel(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  io::humble::ferry::CancellationToken *arg1 = (io::humble::ferry::CancellationToken *) 0 ;
   
   (void)jenv;
   (void)jcls;
-  arg1 = (io::humble::ferry::Logger::Level)jarg1; 
-  arg2 = jarg2 ? true : false; 
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::CancellationToken **)&jarg1; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return ;
+  }
+  
   {
     // JNIHelper.swg: Start generated code
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      io::humble::ferry::Logger::setGlobalIsLogging(arg1,arg2);
+      (arg1)->cancel();
     }
     catch(std::exception & e)
     {
@@ -1908,15 +3089,15 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Logger_1setGlobalIsLogging
 }
 
 
-SWIGEXPORT jstring JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getName(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
-  jstring jresult = 0 ;
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
-  char *result = 0 ;
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1isCancelled(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::CancellationToken *arg1 = (io::humble::ferry::CancellationToken *) 0 ;
+  bool result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  arg1 = *(io::humble::ferry::CancellationToken **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -1929,7 +3110,7 @@ SWIGEXPORT jstring JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getName(JNIEnv
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (char *)(arg1)->getName();
+      result = (bool)(arg1)->isCancelled();
     }
     catch(std::exception & e)
     {
@@ -1946,22 +3127,25 @@ SWIGEXPORT jstring JNICALL Java_io_humble_ferry_FerryJNI_Logger_1getName(JNIEnv
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  if (result) jresult = jenv->NewStringUTF((const char *)result);
+  jresult = (jboolean)result; 
   return jresult;
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_delete_1Logger(JNIEnv *jenv, jclass jcls, jlong jarg1) {
-  io::humble::ferry::Logger *arg1 = (io::humble::ferry::Logger *) 0 ;
+SWIGEXPORT jboolean JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1isTimedOut(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jboolean jresult = 0 ;
+  io::humble::ferry::CancellationToken *arg1 = (io::humble::ferry::CancellationToken *) 0 ;
+  bool result;
   
   (void)jenv;
   (void)jcls;
-  arg1 = *(io::humble::ferry::Logger **)&jarg1; 
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::CancellationToken **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
       "invalid native object; delete() likely already called");
-    return ;
+    return 0;
   }
   
   {
@@ -1969,66 +3153,76 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_delete_1Logger(JNIEnv *jen
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      delete arg1;
+      result = (bool)(arg1)->isTimedOut();
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return ;
+      return 0;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return ;
+      return 0;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
+  jresult = (jboolean)result; 
+  return jresult;
 }
 
 
-SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1make(JNIEnv *jenv, jclass jcls) {
-  jlong jresult = 0 ;
-  io::humble::ferry::Mutex *result = 0 ;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1setTimeout(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jlong jarg2) {
+  io::humble::ferry::CancellationToken *arg1 = (io::humble::ferry::CancellationToken *) 0 ;
+  int64_t arg2 ;
   
   (void)jenv;
   (void)jcls;
+  (void)jarg1_;
+  arg1 = *(io::humble::ferry::CancellationToken **)&jarg1; 
+  arg2 = (int64_t)jarg2; 
+  
+  if (!arg1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
+      "invalid native object; delete() likely already called");
+    return ;
+  }
+  
   {
     // JNIHelper.swg: Start generated code
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      result = (io::humble::ferry::Mutex *)io::humble::ferry::Mutex::make();
+      (arg1)->setTimeout(arg2);
     }
     catch(std::exception & e)
     {
       io::humble::ferry::JNIHelper::catchException(jenv, e);
-      return 0;
+      return ;
     }
     catch(...)
     {
       std::runtime_error e("Unhandled and unknown native exception");
       io::humble::ferry::JNIHelper::throwJavaException(jenv, "java/lang/RuntimeException", e);
-      return 0;
+      return ;
     }
     
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<
     // JNIHelper.swg: End generated code
   }
-  *(io::humble::ferry::Mutex **)&jresult = result; 
-  return jresult;
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1lock(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
-  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1clearTimeout(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  io::humble::ferry::CancellationToken *arg1 = (io::humble::ferry::CancellationToken *) 0 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
+  arg1 = *(io::humble::ferry::CancellationToken **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -2041,7 +3235,7 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1lock(JNIEnv *jenv,
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      (arg1)->lock();
+      (arg1)->clearTimeout();
     }
     catch(std::exception & e)
     {
@@ -2061,13 +3255,13 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1lock(JNIEnv *jenv,
 }
 
 
-SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1unlock(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
-  io::humble::ferry::Mutex *arg1 = (io::humble::ferry::Mutex *) 0 ;
+SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1reset(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  io::humble::ferry::CancellationToken *arg1 = (io::humble::ferry::CancellationToken *) 0 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
-  arg1 = *(io::humble::ferry::Mutex **)&jarg1; 
+  arg1 = *(io::humble::ferry::CancellationToken **)&jarg1; 
   
   if (!arg1) {
     SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException,
@@ -2080,7 +3274,7 @@ SWIGEXPORT void JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1unlock(JNIEnv *jenv
     // >>>>>>>>>>>>>>>>>>>>>>>>>>>
     try
     {
-      (arg1)->unlock();
+      (arg1)->reset();
     }
     catch(std::exception & e)
     {
@@ -2640,6 +3834,14 @@ SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Mutex_1SWIGUpcast(JNIEnv
     return baseptr;
 }
 
+SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_CancellationToken_1SWIGUpcast(JNIEnv *jenv, jclass jcls, jlong jarg1) {
+    jlong baseptr = 0;
+    (void)jenv;
+    (void)jcls;
+    *(io::humble::ferry::RefCounted **)&baseptr = *(io::humble::ferry::CancellationToken **)&jarg1;
+    return baseptr;
+}
+
 SWIGEXPORT jlong JNICALL Java_io_humble_ferry_FerryJNI_Buffer_1SWIGUpcast(JNIEnv *jenv, jclass jcls, jlong jarg1) {
     jlong baseptr = 0;
     (void)jenv;
@@ -24,6 +24,7 @@
 
 #include <io/humble/ferry/Ferry.h>
 #include <io/humble/ferry/HumbleException.h>
+#include <io/humble/ferry/CancellationToken.h>
 
 namespace io { namespace humble { namespace ferry {
 /**
@@ -197,16 +198,11 @@ class JNIHelper
 
 /**
  * If __COND__ is true, then this macro
- * checks if the thread is interrupted, and
- * if so sets 'retval' to 'EINTR'.
+ * checks if the current operation has been cancelled (see
+ * CancellationToken#sIsCancelled(CancellationToken*)), and
+ * if so throws HumbleInterruptedException.
  */
-#define VS_CHECK_INTERRUPT(__COND__) do { \
-    if (__COND__) { \
-      JNIHelper* helper = JNIHelper::getHelper(); \
-      if (helper && helper->isInterrupted()) \
-        throw HumbleInterruptedException(); \
-        } \
-} while(0)
+#define VS_CHECK_INTERRUPT(__COND__) VS_CHECK_CANCELLED(0, __COND__)
 
 
 }}}
@@ -43,16 +43,20 @@
 
 #include "Ferry.h"
 #include "RefCounted.h"
+#include "MemoryPool.h"
 
 static void *
 VSJNI_malloc(jobject obj, size_t requested_size);
 static void
 VSJNI_free(void * mem);
 static void *
-VSJNI_alignMemory(void *);
+VSJNI_alignMemory(void *, size_t alignment);
 static void *
 VSJNI_unalignMemory(void*);
-static size_t VSJNI_ALIGNMENT_BOUNDARY = 16; // Must be power of two
+// Must be a power of two; read once per allocation, as it can change
+// while other threads are allocating.
+static size_t sVSJNI_Alignment =
+    io::humble::ferry::JNIMemoryManager::DEFAULT_ALIGNMENT;
 
 /**
  * Must match numbers in JNIMemoryManager.java
@@ -95,6 +99,22 @@ JNIMemoryManager::free(void* mem)
   VSJNI_free(mem);
 }
 
+bool
+JNIMemoryManager::setAlignment(size_t alignment)
+{
+  if (!alignment || alignment > MAX_ALIGNMENT ||
+      (alignment & (alignment - 1)))
+    return false;
+  __atomic_store_n(&sVSJNI_Alignment, alignment, __ATOMIC_RELAXED);
+  return true;
+}
+
+size_t
+JNIMemoryManager::getAlignment()
+{
+  return __atomic_load_n(&sVSJNI_Alignment, __ATOMIC_RELAXED);
+}
+
 }
 }
 }
@@ -215,11 +235,21 @@ struct VSJNI_AllocationHeader
    * Yes it's a shame, but another four bytes go to the model.
    */
   enum VSJNIMemoryModel mModel;
+  /**
+   * If non zero, this block came from the MemoryPool and this is
+   * the capacity the pool gave it.
+   */
+  size_t mPoolCapacity;
+  /**
+   * If true, the block is backed by huge pages and mPoolCapacity is
+   * the capacity the pool mapped.
+   */
+  bool mHugePages;
 };
 
 static void *
 VS_JNI_malloc_native(JNIEnv *env, jobject obj, size_t requested_size,
-    bool notifyJavaHeap)
+    size_t alignment, bool notifyJavaHeap)
 {
   void *retval = 0;
   void *buffer = 0;
@@ -231,13 +261,13 @@ VS_JNI_malloc_native(JNIEnv *env, jobject obj, size_t requested_size,
       // We allocate a byte array for the actual memory
       bytearray = static_cast<jbyteArray> (env->CallObjectMethod(obj,
           sJNIMemoryAllocatorMallocMethod, requested_size
-              + sizeof(VSJNI_AllocationHeader) + VSJNI_ALIGNMENT_BOUNDARY));
+              + sizeof(VSJNI_AllocationHeader) + alignment));
     }
     else
     {
       // We allocate a byte array for the actual memory
       bytearray = env->NewByteArray(requested_size
-          + sizeof(VSJNI_AllocationHeader) + VSJNI_ALIGNMENT_BOUNDARY);
+          + sizeof(VSJNI_AllocationHeader) + alignment);
     }
     if (!bytearray)
       throw std::bad_alloc();
@@ -259,8 +289,20 @@ VS_JNI_malloc_native(JNIEnv *env, jobject obj, size_t requested_size,
   }
 
   // We're not in a JVM, so use malloc/free instead
-  buffer = requested_size > 0 ? malloc((size_t) requested_size + sizeof(VSJNI_AllocationHeader)
-      + VSJNI_ALIGNMENT_BOUNDARY) : 0;
+  size_t size = (size_t) requested_size + sizeof(VSJNI_AllocationHeader)
+      + alignment;
+  size_t poolCapacity = 0;
+  bool hugePages = false;
+  if (requested_size <= 0)
+    buffer = 0;
+  else if (io::humble::ferry::MemoryPool::useHugePages(size) &&
+      (buffer = io::humble::ferry::MemoryPool::allocateHugePages(size,
+          &poolCapacity)) != 0)
+    hugePages = true;
+  else if (io::humble::ferry::MemoryPool::isEnabled())
+    buffer = io::humble::ferry::MemoryPool::allocate(size, &poolCapacity);
+  else
+    buffer = malloc(size);
   VSJNI_AllocationHeader *header = (VSJNI_AllocationHeader*) buffer;
   if (!header)
     throw std::bad_alloc();
@@ -268,6 +310,8 @@ VS_JNI_malloc_native(JNIEnv *env, jobject obj, size_t requested_size,
   // if this was JVMed or Malloced.
   memset(header, 0, sizeof(VSJNI_AllocationHeader));
   header->mModel = NATIVE_BUFFERS;
+  header->mPoolCapacity = poolCapacity;
+  header->mHugePages = hugePages;
 
   retval = (void*) ((char*) header + sizeof(VSJNI_AllocationHeader));
   return retval;
@@ -275,14 +319,14 @@ VS_JNI_malloc_native(JNIEnv *env, jobject obj, size_t requested_size,
 
 static void *
 VS_JNI_malloc_javaDirectBufferBacked(JNIEnv *env, jobject obj,
-    size_t requested_size,
+    size_t requested_size, size_t alignment,
     bool notifyJavaHeap)
 {
   void *retval = 0;
   void *buffer = 0;
   // We allocate a byte array for the actual memory
   jlong size = requested_size + sizeof(VSJNI_AllocationHeader)
-      + VSJNI_ALIGNMENT_BOUNDARY;
+      + alignment;
 
   if (env->ExceptionCheck()) {
     throw std::bad_alloc();
@@ -296,13 +340,13 @@ VS_JNI_malloc_javaDirectBufferBacked(JNIEnv *env, jobject obj,
       // We allocate a byte array for the actual memory
       bytearray = static_cast<jbyteArray> (env->CallObjectMethod(obj,
           sJNIMemoryAllocatorMallocMethod, requested_size
-              + sizeof(VSJNI_AllocationHeader) + VSJNI_ALIGNMENT_BOUNDARY));
+              + sizeof(VSJNI_AllocationHeader) + alignment));
     }
     else
     {
       // We allocate a byte array for the actual memory
       bytearray = env->NewByteArray(requested_size
-          + sizeof(VSJNI_AllocationHeader) + VSJNI_ALIGNMENT_BOUNDARY);
+          + sizeof(VSJNI_AllocationHeader) + alignment);
     }
     if (!bytearray)
       throw std::bad_alloc();
@@ -379,7 +423,8 @@ VS_JNI_malloc_javaDirectBufferBacked(JNIEnv *env, jobject obj,
 }
 
 static void *
-VS_JNI_malloc_javaByteBacked(JNIEnv* env, jobject obj, size_t requested_size)
+VS_JNI_malloc_javaByteBacked(JNIEnv* env, jobject obj, size_t requested_size,
+    size_t alignment)
 {
   void* retval = 0;
   void* buffer = 0;
@@ -393,13 +438,13 @@ VS_JNI_malloc_javaByteBacked(JNIEnv* env, jobject obj, size_t requested_size)
     // We allocate a byte array for the actual memory
     bytearray = static_cast<jbyteArray> (env->CallObjectMethod(obj,
         sJNIMemoryAllocatorMallocMethod, requested_size
-            + sizeof(VSJNI_AllocationHeader) + VSJNI_ALIGNMENT_BOUNDARY));
+            + sizeof(VSJNI_AllocationHeader) + alignment));
   }
   else
   {
     // We allocate a byte array for the actual memory
     bytearray = env->NewByteArray(requested_size
-        + sizeof(VSJNI_AllocationHeader) + VSJNI_ALIGNMENT_BOUNDARY);
+        + sizeof(VSJNI_AllocationHeader) + alignment);
   }
 
   // if JVM didn't like that, return bad_alloc(); when we 
@@ -459,8 +504,9 @@ VSJNI_malloc(jobject obj, size_t requested_size)
     void* retval = 0;
     JNIEnv* env = 0;
 
-    if ((size_t) requested_size > INT_MAX - VSJNI_ALIGNMENT_BOUNDARY)
-      // we need 16 byte clearance; and only support up to 4GBs.  Sorry folks, if
+    size_t alignment = io::humble::ferry::JNIMemoryManager::getAlignment();
+    if ((size_t) requested_size > INT_MAX - alignment)
+      // we need alignment clearance; and only support up to 4GBs.  Sorry folks, if
       // you need more than 4GB of contiguous memory, it's not us.
       return 0;
 
@@ -472,21 +518,24 @@ VSJNI_malloc(jobject obj, size_t requested_size)
     switch (model)
     {
       case JAVA_STANDARD_HEAP:
-        retval = VS_JNI_malloc_javaByteBacked(env, obj, requested_size);
+        retval = VS_JNI_malloc_javaByteBacked(env, obj, requested_size,
+            alignment);
         break;
       case JAVA_DIRECT_BUFFERS:
         retval = VS_JNI_malloc_javaDirectBufferBacked(env, obj, requested_size,
-            false);
+            alignment, false);
         break;
       case JAVA_DIRECT_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION:
         retval = VS_JNI_malloc_javaDirectBufferBacked(env, obj, requested_size,
-            true);
+            alignment, true);
         break;
       case NATIVE_BUFFERS:
-        retval = VS_JNI_malloc_native(env, obj, requested_size, false);
+        retval = VS_JNI_malloc_native(env, obj, requested_size, alignment,
+            false);
         break;
       case NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION:
-        retval = VS_JNI_malloc_native(env, obj, requested_size, true);
+        retval = VS_JNI_malloc_native(env, obj, requested_size, alignment,
+            true);
         break;
       default:
         throw std::bad_alloc();
@@ -499,11 +548,11 @@ VSJNI_malloc(jobject obj, size_t requested_size)
         (size_t)requested_size,
         model);
 #endif
-    // Now, align on VSJNI_ALIGNMENT_BOUNDARY byte boundary;
+    // Now, align on an alignment byte boundary;
     // on Posix system we could have used memalign for the malloc,
     // but that doesn't work
     // for Java allocations, so we do this hack for everyone.
-    return VSJNI_alignMemory(retval);
+    return VSJNI_alignMemory(retval, alignment);
   }
   catch (std::bad_alloc & e)
   {
@@ -516,7 +565,7 @@ VSJNI_malloc(jobject obj, size_t requested_size)
 }
 
 /**
- * Aligns memory on a VSJNI_ALIGNMENT_BOUNDARY address.
+ * Aligns memory on an alignment boundary.
  *
  * @param aInput The address to align; caller is responsible for
  *  ensuring non-null and
@@ -613,7 +662,13 @@ VSJNI_free(void * mem)
         /** fall though */
       case NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION:
       {
-        free(buffer);
+        if (header->mHugePages)
+          io::humble::ferry::MemoryPool::releaseHugePages(buffer,
+              header->mPoolCapacity);
+        else if (header->mPoolCapacity)
+          io::humble::ferry::MemoryPool::release(buffer, header->mPoolCapacity);
+        else
+          free(buffer);
       }
         break;
       default:
@@ -636,19 +691,20 @@ VSJNI_free(void * mem)
 static void *VSJNI_malloc(jobject, size_t requested_size)
 {
   void* retval = 0;
+  size_t alignment = io::humble::ferry::JNIMemoryManager::getAlignment();
 
   if (
-      (sizeof(size_t) == 4 && (size_t)requested_size > INT_MAX - VSJNI_ALIGNMENT_BOUNDARY) ||
-      ((int64_t)requested_size > LLONG_MAX - VSJNI_ALIGNMENT_BOUNDARY))
-  // we need 16 byte clearance; ok, for 64-bit machines if you're
+      (sizeof(size_t) == 4 && (size_t)requested_size > INT_MAX - alignment) ||
+      ((int64_t)requested_size > LLONG_MAX - (int64_t)alignment))
+  // we need alignment clearance; ok, for 64-bit machines if you're
   // asking for 9-Tera-Whatevers of memory, you'll fail anyway,
   // but we try to be complete.
   return 0;
-  retval = malloc(requested_size + VSJNI_ALIGNMENT_BOUNDARY);
+  retval = malloc(requested_size + alignment);
   if (!retval)
   return 0;
 
-  return VSJNI_alignMemory(retval);
+  return VSJNI_alignMemory(retval, alignment);
 }
 static void
 VSJNI_free(void * mem)
@@ -662,13 +718,15 @@ VSJNI_free(void * mem)
 }
 #endif // USE_JVM_FOR_MEM_MANAGEMENT
 static void*
-VSJNI_alignMemory(void* aInput)
+VSJNI_alignMemory(void* aInput, size_t alignment)
 {
   void* retval = aInput;
   retval = aInput;
-  size_t alignDiff = ((-(size_t) retval - 1) & (VSJNI_ALIGNMENT_BOUNDARY - 1)) + 1;
+  size_t alignDiff = ((-(size_t) retval - 1) & (alignment - 1)) + 1;
   retval = (char*) retval + alignDiff;
-  ((char*) retval)[-1] = (char) alignDiff;
+  // alignDiff is 1 to alignment, so store one less to fit
+  // a 256 byte alignment in a byte.
+  ((unsigned char*) retval)[-1] = (unsigned char) (alignDiff - 1);
 #ifdef VSJNI_MEMMANAGER_DEBUG
   printf ("align: orig(%p:%lld) new(%p:%lld) align(%d)\n",
       aInput, (int64_t)aInput,
@@ -688,7 +746,7 @@ VSJNI_alignMemory(void* aInput)
 static void*
 VSJNI_unalignMemory(void *aInput)
 {
-  size_t alignDiff = ((char*) aInput)[-1];
+  size_t alignDiff = (size_t)((unsigned char*) aInput)[-1] + 1;
   void * retval = (void*) (((char*) aInput) - alignDiff);
 #ifdef VSJNI_MEMMANAGER_DEBUG
   printf ("unalign: orig(%p:%lld) new(%p:%lld) align(%d)\n",
@@ -760,4 +818,91 @@ Java_io_humble_ferry_FerryJNI_setMemoryModel(JNIEnv *, jclass, jint value)
 #endif
 }
 
+VS_API_EXPORT jboolean JNICALL
+Java_io_humble_ferry_FerryJNI_isNativeBufferPooling(JNIEnv *, jclass)
+{
+  return io::humble::ferry::MemoryPool::isEnabled();
+}
+
+VS_API_EXPORT void JNICALL
+Java_io_humble_ferry_FerryJNI_setNativeBufferPooling(JNIEnv *, jclass, jboolean value)
+{
+  io::humble::ferry::MemoryPool::setEnabled(value);
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferPoolHighWaterMark(JNIEnv *, jclass)
+{
+  return io::humble::ferry::MemoryPool::getHighWaterMark();
+}
+
+VS_API_EXPORT void JNICALL
+Java_io_humble_ferry_FerryJNI_setNativeBufferPoolHighWaterMark(JNIEnv *, jclass, jlong value)
+{
+  io::humble::ferry::MemoryPool::setHighWaterMark(value);
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferPoolHits(JNIEnv *, jclass)
+{
+  return io::humble::ferry::MemoryPool::getHits();
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferPoolMisses(JNIEnv *, jclass)
+{
+  return io::humble::ferry::MemoryPool::getMisses();
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferPoolBytesRetained(JNIEnv *, jclass)
+{
+  return io::humble::ferry::MemoryPool::getBytesRetained();
+}
+
+VS_API_EXPORT void JNICALL
+Java_io_humble_ferry_FerryJNI_trimNativeBufferPool(JNIEnv *, jclass)
+{
+  io::humble::ferry::MemoryPool::trim();
+}
+
+VS_API_EXPORT jint JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferAlignment(JNIEnv *, jclass)
+{
+  return (jint) io::humble::ferry::JNIMemoryManager::getAlignment();
+}
+
+VS_API_EXPORT jboolean JNICALL
+Java_io_humble_ferry_FerryJNI_setNativeBufferAlignment(JNIEnv *, jclass, jint value)
+{
+  return value > 0 &&
+      io::humble::ferry::JNIMemoryManager::setAlignment((size_t) value);
+}
+
+VS_API_EXPORT jint JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferHugePageMode(JNIEnv *, jclass)
+{
+  return io::humble::ferry::MemoryPool::getHugePageMode();
+}
+
+VS_API_EXPORT jboolean JNICALL
+Java_io_humble_ferry_FerryJNI_setNativeBufferHugePageMode(JNIEnv *, jclass, jint value)
+{
+  return io::humble::ferry::MemoryPool::setHugePageMode(
+      (io::humble::ferry::MemoryPool::HugePageMode) value);
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_io_humble_ferry_FerryJNI_getNativeBufferHugePageThreshold(JNIEnv *, jclass)
+{
+  return (jlong) io::humble::ferry::MemoryPool::getHugePageThreshold();
+}
+
+VS_API_EXPORT void JNICALL
+Java_io_humble_ferry_FerryJNI_setNativeBufferHugePageThreshold(JNIEnv *, jclass, jlong value)
+{
+  io::humble::ferry::MemoryPool::setHugePageThreshold(
+      value < 0 ? 0 : (size_t) value);
+}
+
 }
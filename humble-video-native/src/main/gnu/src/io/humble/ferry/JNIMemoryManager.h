@@ -43,17 +43,48 @@ namespace io { namespace humble { namespace ferry {
 class VS_API_FERRY JNIMemoryManager
 {
 public:
+  /**
+   * The alignment used for blocks unless #setAlignment(size_t) is
+   * called.  64 bytes is a cache line, and is enough for AVX-512 loads
+   * and stores.  Define VS_JNI_DEFAULT_ALIGNMENT when building to
+   * change it.
+   */
+#ifndef VS_JNI_DEFAULT_ALIGNMENT
+#define VS_JNI_DEFAULT_ALIGNMENT 64
+#endif
+  static const size_t DEFAULT_ALIGNMENT=VS_JNI_DEFAULT_ALIGNMENT;
+  /** The largest alignment #setAlignment(size_t) accepts. */
+  static const size_t MAX_ALIGNMENT=256;
+
+  /**
+   * Set the boundary that blocks returned from #malloc(size_t) are
+   * aligned on.  Blocks already allocated are unaffected.
+   *
+   * @param alignment The alignment, in bytes. Must be a power of two
+   *   no larger than #MAX_ALIGNMENT.
+   *
+   * @return true if set; false if alignment was not valid.
+   */
+  static bool setAlignment(size_t alignment);
+
+  /**
+   * @return the boundary that blocks returned from #malloc(size_t) are
+   *   aligned on.
+   */
+  static size_t getAlignment();
+
   /**
    * Create a malloced block of AT LEAST site_t bounds long.
    *
-   * This block will be aligned on a 128-bit boundary, suitable
-   * for passing to libraries that do SSE-based operations on it.
+   * This block will be aligned on a #getAlignment() boundary, suitable
+   * for passing to libraries that do SIMD operations on it.
    *
    * @param requested_size Requested minimum size of memory, in bytes
    *
    * @throws std::std_alloc If memory cannot be allocated
    *
-   * @return a block of memory of at least requested size aligned on a 128-bit boundary.
+   * @return a block of memory of at least requested size aligned on a
+   *   #getAlignment() boundary.
    */
   static void* malloc(size_t requested_size);
 
@@ -82,8 +113,8 @@ public:
    * Direct Buffers for memory, the allocator object is only used to
    * help print debugging messages.
    *
-   * This block will be aligned on a 128-bit boundary, suitable
-   * for passing to libraries that do SSE-based operations on it.
+   * This block will be aligned on a #getAlignment() boundary, suitable
+   * for passing to libraries that do SIMD operations on it.
    *
    * Lastly if you understood or followed any of the above comments
    * you're not drunk enough to work on this code.
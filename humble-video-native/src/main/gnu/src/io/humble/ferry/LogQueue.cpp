@@ -0,0 +1,229 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <sys/time.h>
+#include <cerrno>
+
+#include "LogQueue.h"
+#include "JNIHelper.h"
+
+namespace io { namespace humble { namespace ferry {
+
+LogQueue*
+LogQueue :: getQueue()
+{
+  // never destroyed; loggers can still be logging while the library
+  // unloads.
+  static LogQueue* sQueue = new LogQueue();
+  return sQueue;
+}
+
+LogQueue :: LogQueue()
+{
+  for(int32_t i = 0; i < CAPACITY; i++)
+    mRecords[i].mSequence = i;
+  mTail = 0;
+  mHead = 0;
+  mDropped = 0;
+  mRunning = 0;
+  mSleeping = 0;
+  mStopRequested = false;
+  pthread_mutex_init(&mDrainLock, 0);
+  pthread_mutex_init(&mLock, 0);
+  pthread_cond_init(&mWakeup, 0);
+}
+
+LogQueue :: ~LogQueue()
+{
+  pthread_cond_destroy(&mWakeup);
+  pthread_mutex_destroy(&mLock);
+  pthread_mutex_destroy(&mDrainLock);
+}
+
+LogQueue::Record*
+LogQueue :: reserve()
+{
+  int64_t pos = __atomic_load_n(&mTail, __ATOMIC_RELAXED);
+  for(;;)
+  {
+    Record* record = &mRecords[pos & (CAPACITY-1)];
+    int64_t seq = __atomic_load_n(&record->mSequence, __ATOMIC_ACQUIRE);
+    int64_t diff = seq - pos;
+    if (diff == 0)
+    {
+      if (__atomic_compare_exchange_n(&mTail, &pos, pos+1, true,
+          __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      {
+        record->mPosition = pos;
+        return record;
+      }
+      // pos now holds the current tail; try again.
+    }
+    else if (diff < 0)
+    {
+      // the consumer hasn't freed this slot yet; we're full.
+      __atomic_add_fetch(&mDropped, 1, __ATOMIC_RELAXED);
+      return 0;
+    }
+    else
+      pos = __atomic_load_n(&mTail, __ATOMIC_RELAXED);
+  }
+}
+
+void
+LogQueue :: commit(Record* record)
+{
+  __atomic_store_n(&record->mSequence, record->mPosition+1, __ATOMIC_RELEASE);
+  // pairs with the fence in run(); either we see it sleeping, or
+  // it sees our record before it sleeps.
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&mSleeping, __ATOMIC_RELAXED))
+  {
+    pthread_mutex_lock(&mLock);
+    pthread_cond_signal(&mWakeup);
+    pthread_mutex_unlock(&mLock);
+  }
+}
+
+int32_t
+LogQueue :: drain()
+{
+  // caller holds mDrainLock
+  int32_t retval = 0;
+  for(;;)
+  {
+    int64_t pos = mHead;
+    Record* record = &mRecords[pos & (CAPACITY-1)];
+    int64_t seq = __atomic_load_n(&record->mSequence, __ATOMIC_ACQUIRE);
+    if (seq != pos+1)
+      // empty, or the next record is claimed but not yet published.
+      break;
+    if (record->mLogger)
+      record->mLogger->doLog(record->mLevel, record->mMessage);
+    __atomic_store_n(&record->mSequence, pos+CAPACITY, __ATOMIC_RELEASE);
+    __atomic_store_n(&mHead, pos+1, __ATOMIC_RELAXED);
+    ++retval;
+  }
+  return retval;
+}
+
+void*
+LogQueue :: run(void* closure)
+{
+  LogQueue* self = (LogQueue*)closure;
+  JavaVM* vm = JNIHelper::sGetVM();
+  JNIEnv* env = 0;
+  // attach as a daemon so we never hold up the JVM exiting.
+  if (vm)
+    vm->AttachCurrentThreadAsDaemon((void**)(void*)&env, 0);
+
+  for(;;)
+  {
+    pthread_mutex_lock(&self->mDrainLock);
+    self->drain();
+    pthread_mutex_unlock(&self->mDrainLock);
+
+    pthread_mutex_lock(&self->mLock);
+    if (self->mStopRequested)
+    {
+      pthread_mutex_unlock(&self->mLock);
+      break;
+    }
+    __atomic_store_n(&self->mSleeping, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t head = __atomic_load_n(&self->mHead, __ATOMIC_RELAXED);
+    Record* next = &self->mRecords[head & (CAPACITY-1)];
+    if (__atomic_load_n(&next->mSequence, __ATOMIC_ACQUIRE) != head+1)
+    {
+      // nothing published; wait, but not forever in case a producer
+      // is stalled between claiming and publishing a record.
+      struct timeval now;
+      struct timespec deadline;
+      gettimeofday(&now, 0);
+      deadline.tv_sec = now.tv_sec;
+      deadline.tv_nsec = (now.tv_usec + 100*1000)*1000;
+      if (deadline.tv_nsec >= 1000*1000*1000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000*1000*1000;
+      }
+      pthread_cond_timedwait(&self->mWakeup, &self->mLock, &deadline);
+    }
+    __atomic_store_n(&self->mSleeping, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&self->mLock);
+  }
+
+  if (vm && env)
+    vm->DetachCurrentThread();
+  return 0;
+}
+
+bool
+LogQueue :: start()
+{
+  pthread_mutex_lock(&mLock);
+  if (!mRunning)
+  {
+    mStopRequested = false;
+    if (!pthread_create(&mThread, 0, run, this))
+      __atomic_store_n(&mRunning, 1, __ATOMIC_RELEASE);
+  }
+  bool retval = mRunning;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+void
+LogQueue :: stop()
+{
+  pthread_mutex_lock(&mLock);
+  bool running = mRunning;
+  if (running)
+  {
+    mStopRequested = true;
+    __atomic_store_n(&mRunning, 0, __ATOMIC_RELEASE);
+    pthread_cond_signal(&mWakeup);
+  }
+  pthread_mutex_unlock(&mLock);
+  if (running)
+    pthread_join(mThread, 0);
+  // anything that raced in while we stopped.
+  flush();
+}
+
+bool
+LogQueue :: isRunning()
+{
+  return __atomic_load_n(&mRunning, __ATOMIC_ACQUIRE);
+}
+
+void
+LogQueue :: flush()
+{
+  pthread_mutex_lock(&mDrainLock);
+  drain();
+  pthread_mutex_unlock(&mDrainLock);
+}
+
+int64_t
+LogQueue :: getDropped()
+{
+  return __atomic_load_n(&mDropped, __ATOMIC_RELAXED);
+}
+
+}}}
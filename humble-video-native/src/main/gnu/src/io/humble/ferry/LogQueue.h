@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef LOGQUEUE_H_
+#define LOGQUEUE_H_
+
+#include <pthread.h>
+
+#include <io/humble/ferry/Ferry.h>
+#include <io/humble/ferry/Logger.h>
+
+namespace io { namespace humble { namespace ferry {
+
+/**
+ * Internal Only.  The queue behind Logger::setAsynchronous(bool).
+ * <p>
+ * A bounded, lock-free, multi-producer ring of log records.  Threads
+ * that log claim a slot, format their message straight into it and
+ * publish it; they never block, and if the ring is full the message is
+ * dropped and counted.  A dedicated thread drains the ring and hands
+ * each record to its Logger, which is where any Java or stderr I/O
+ * happens.
+ * </p>
+ * <p>
+ * Records are only ever consumed by whoever holds the drain lock
+ * (normally the drain thread, but also #flush() and #stop()), so
+ * the consumer side is always single threaded.
+ * </p>
+ */
+class VS_API_FERRY LogQueue
+{
+public:
+  /** The number of records the ring holds; a power of two. */
+  static const int32_t CAPACITY=1024;
+  /** The longest message, in bytes, a queued record can hold. */
+  static const int32_t MAX_MESSAGE_LENGTH=1024;
+
+  /**
+   * A slot in the ring.
+   */
+  typedef struct Record
+  {
+    Logger* mLogger;
+    Logger::Level mLevel;
+    char mMessage[MAX_MESSAGE_LENGTH];
+    // private to LogQueue
+    int64_t mPosition;
+    int64_t mSequence;
+  } Record;
+
+  /** @return the queue all Loggers share. */
+  static LogQueue* getQueue();
+
+  /**
+   * Claim a free record.  Never blocks.
+   *
+   * @return the record to fill in and pass to #commit(Record*), or null
+   *   if the ring is full (the message is counted as dropped).
+   */
+  Record* reserve();
+  /**
+   * Publish a record from #reserve().
+   */
+  void commit(Record* record);
+
+  /**
+   * Start the drain thread, if not already running.
+   *
+   * @return true if the thread is running.
+   */
+  bool start();
+  /**
+   * Stop the drain thread, and log everything still queued on the
+   * calling thread.
+   */
+  void stop();
+  /** @return true if the drain thread is running. */
+  bool isRunning();
+
+  /**
+   * Log everything queued so far, on the calling thread.
+   */
+  void flush();
+
+  /** @return the number of messages dropped because the ring was full. */
+  int64_t getDropped();
+
+private:
+  LogQueue();
+  ~LogQueue();
+  static void* run(void*);
+  int32_t drain();
+
+  Record mRecords[CAPACITY];
+  int64_t mTail;
+  int64_t mHead;
+  int64_t mDropped;
+  int32_t mRunning;
+  int32_t mSleeping;
+  bool mStopRequested;
+  pthread_t mThread;
+  // serializes consumers
+  pthread_mutex_t mDrainLock;
+  // guards starting, stopping and sleeping
+  pthread_mutex_t mLock;
+  pthread_cond_t mWakeup;
+};
+
+}}}
+
+#endif /* LOGQUEUE_H_ */
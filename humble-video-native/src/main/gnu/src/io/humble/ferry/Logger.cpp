@@ -18,8 +18,10 @@
  *******************************************************************************/
 
 #include "Logger.h"
+#include "LogQueue.h"
 #include "JNIHelper.h"
 #include <cstring>
+#include <sys/time.h>
 
 #include <iostream>
 
@@ -69,6 +71,72 @@ namespace io { namespace humble { namespace ferry {
   jmethodID Logger :: mLogMethod = 0;
 
   Mutex* Logger :: mClassMutex = 0;
+  int32_t Logger :: mAsynchronous = 0;
+  int32_t Logger :: mRateLimit = 0;
+  int64_t Logger :: mRateLimited = 0;
+
+  namespace {
+    /**
+     * Rate limiting state for one place in the code.  Sites hash into
+     * a small fixed table; two sites that collide just take turns
+     * owning the slot, which can only let extra messages through.
+     * Updates race benignly: the limit is approximate.
+     */
+    struct RateLimitSite
+    {
+      size_t mSite;
+      int64_t mWindowStart;
+      int32_t mCount;
+      int32_t mSuppressed;
+    };
+    const int32_t cNumRateLimitSites = 256;
+    const int64_t cRateLimitWindow = 1000; // milliseconds
+  }
+  static RateLimitSite sRateLimitSites[cNumRateLimitSites];
+
+  static int64_t
+  nowMillis()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (int64_t)tv.tv_sec*1000 + tv.tv_usec/1000;
+  }
+
+  /*
+   * Returns false if this site has used up its messages for this
+   * window.  Otherwise returns true, and sets suppressed to how many
+   * messages from this site were dropped in the window before.
+   */
+  static bool
+  rateLimit(int32_t limit, size_t site, int32_t* suppressed, int64_t* rateLimited)
+  {
+    *suppressed = 0;
+    if (limit <= 0)
+      return true;
+    RateLimitSite* entry = &sRateLimitSites[
+      ((site >> 3) * 2654435761U) % cNumRateLimitSites];
+    int64_t now = nowMillis();
+    if (__atomic_load_n(&entry->mSite, __ATOMIC_RELAXED) != site)
+    {
+      __atomic_store_n(&entry->mSite, site, __ATOMIC_RELAXED);
+      __atomic_store_n(&entry->mSuppressed, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&entry->mCount, 1, __ATOMIC_RELAXED);
+      __atomic_store_n(&entry->mWindowStart, now, __ATOMIC_RELAXED);
+      return true;
+    }
+    if (now - __atomic_load_n(&entry->mWindowStart, __ATOMIC_RELAXED) >= cRateLimitWindow)
+    {
+      *suppressed = __atomic_exchange_n(&entry->mSuppressed, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&entry->mCount, 1, __ATOMIC_RELAXED);
+      __atomic_store_n(&entry->mWindowStart, now, __ATOMIC_RELAXED);
+      return true;
+    }
+    if (__atomic_add_fetch(&entry->mCount, 1, __ATOMIC_RELAXED) <= limit)
+      return true;
+    __atomic_add_fetch(&entry->mSuppressed, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(rateLimited, 1, __ATOMIC_RELAXED);
+    return false;
+  }
 
   /*
    * This method formats the message with
@@ -85,6 +153,11 @@ namespace io { namespace humble { namespace ferry {
       if (aFormat && *aFormat)
       {
         bytesWritten += vsnprintf(msgBuf, bufLen, aFormat, ap);
+        if (bytesWritten < 0)
+          bytesWritten = 0;
+        else if (bytesWritten >= bufLen)
+          // truncated; no room for anything else.
+          return bufLen-1;
 
         if (aFilename && *aFilename) {
           // let's advance aFilename past the last /.
@@ -98,8 +171,10 @@ namespace io { namespace humble { namespace ferry {
           bufLen -= bytesWritten;
           msgBuf += bytesWritten;
 
-          bytesWritten += snprintf(msgBuf, bufLen, " (%s:%d)",
+          int suffix = snprintf(msgBuf, bufLen, " (%s:%d)",
               filename, lineNo);
+          if (suffix > 0)
+            bytesWritten += suffix < bufLen ? suffix : bufLen-1;
         }
       }
     }
@@ -124,6 +199,9 @@ namespace io { namespace humble { namespace ferry {
 
   Logger :: ~Logger()
   {
+    // don't leave records pointing at us in the queue.
+    if (__atomic_load_n(&mAsynchronous, __ATOMIC_ACQUIRE))
+      LogQueue::getQueue()->flush();
     JNIEnv *env=JNIHelper::sGetEnv();
     if (env)
     {
@@ -385,12 +463,113 @@ namespace io { namespace humble { namespace ferry {
   {
     bool didLog = false;
     if (mGlobalIsLogging[level] && mIsLogging[level])
+      didLog = this->submit(0, filename, line, level, fmt, ap);
+    return didLog;
+  }
+
+  bool
+  Logger :: logSiteVA(const void* site, const char* filename, int line,
+      Level level, const char *fmt, va_list ap)
+  {
+    bool didLog = false;
+    if (mGlobalIsLogging[level] && mIsLogging[level])
+      didLog = this->submit(site, filename, line, level, fmt, ap);
+    return didLog;
+  }
+
+  bool
+  Logger :: submit(const void* site, const char* filename, int line,
+      Level level, const char *fmt, va_list ap)
+  {
+    int32_t suppressed = 0;
+    int32_t limit = __atomic_load_n(&mRateLimit, __ATOMIC_RELAXED);
+    if (limit > 0)
     {
-      char msg[cMaxLogMessageLength+1];
-      formatMsg(msg, sizeof(msg), filename, line, fmt, ap);
-      didLog = this->doLog(level, msg);
+      size_t key = site ? (size_t)site :
+          filename ? (size_t)filename ^ ((size_t)line << 20) : (size_t)fmt;
+      if (!rateLimit(limit, key, &suppressed, &mRateLimited))
+        return false;
     }
-    return didLog;
+
+    if (__atomic_load_n(&mAsynchronous, __ATOMIC_RELAXED))
+    {
+      LogQueue* queue = LogQueue::getQueue();
+      LogQueue::Record* record = queue->reserve();
+      if (!record)
+        return false;
+      int len = formatMsg(record->mMessage, sizeof(record->mMessage),
+          filename, line, fmt, ap);
+      if (suppressed)
+        snprintf(record->mMessage+len, sizeof(record->mMessage)-len,
+            " [%d similar messages suppressed]", (int)suppressed);
+      record->mLogger = this;
+      record->mLevel = level;
+      queue->commit(record);
+      return true;
+    }
+
+    char msg[cMaxLogMessageLength+1];
+    int len = formatMsg(msg, sizeof(msg), filename, line, fmt, ap);
+    if (suppressed)
+      snprintf(msg+len, sizeof(msg)-len,
+          " [%d similar messages suppressed]", (int)suppressed);
+    return this->doLog(level, msg);
+  }
+
+  bool
+  Logger :: setAsynchronous(bool value)
+  {
+    LogQueue* queue = LogQueue::getQueue();
+    if (value)
+    {
+      if (!queue->start())
+        return false;
+      __atomic_store_n(&mAsynchronous, 1, __ATOMIC_RELEASE);
+    }
+    else
+    {
+      __atomic_store_n(&mAsynchronous, 0, __ATOMIC_RELEASE);
+      queue->stop();
+    }
+    return true;
+  }
+
+  bool
+  Logger :: isAsynchronous()
+  {
+    return __atomic_load_n(&mAsynchronous, __ATOMIC_RELAXED);
+  }
+
+  void
+  Logger :: flush()
+  {
+    if (__atomic_load_n(&mAsynchronous, __ATOMIC_ACQUIRE))
+      LogQueue::getQueue()->flush();
+  }
+
+  int64_t
+  Logger :: getDroppedMessages()
+  {
+    return LogQueue::getQueue()->getDropped();
+  }
+
+  void
+  Logger :: setRateLimit(int32_t messagesPerSecond)
+  {
+    __atomic_store_n(&mRateLimit, messagesPerSecond < 0 ? 0 : messagesPerSecond,
+        __ATOMIC_RELAXED);
+  }
+
+  int32_t
+  Logger :: getRateLimit()
+  {
+    return __atomic_load_n(&mRateLimit, __ATOMIC_RELAXED);
+  }
+
+  int64_t
+  Logger :: getRateLimitedMessages()
+  {
+    return __atomic_load_n(&mRateLimited, __ATOMIC_RELAXED);
   }
 
   bool
@@ -413,11 +592,7 @@ namespace io { namespace humble { namespace ferry {
   va_list ap; \
   va_start(ap, fmt); \
   if (mGlobalIsLogging[level] && mIsLogging[level]) \
-  { \
-    char msg[cMaxLogMessageLength+1]; \
-    formatMsg(msg, sizeof(msg), filename, line, fmt, ap); \
-    didLog = this->doLog(level, msg); \
-  } \
+    didLog = this->submit(0, filename, line, level, fmt, ap); \
   va_end(ap); \
   return didLog; \
   }
@@ -95,6 +95,16 @@ namespace io { namespace humble { namespace ferry {
     bool log(const char* filename, int lineNo, Level level, const char *format, ...);
 #ifndef SWIG // SWIG shouldn't know about this.
     bool logVA(const char* filename, int lineNo, Level level, const char *format, va_list ap);
+    /**
+     * Like logVA(), but rate limits by site rather than by filename
+     * and line number.  Use this when the format string or filename
+     * don't identify where a message comes from; for example when
+     * forwarding messages from another library's log callback.
+     *
+     * @param site Any pointer unique to where the message comes from.
+     */
+    bool logSiteVA(const void* site, const char* filename, int lineNo,
+        Level level, const char *format, va_list ap);
 #endif // SWIG
     /*
      * A series of convenience methods that model the slf4j
@@ -116,11 +126,60 @@ namespace io { namespace humble { namespace ferry {
     static void setGlobalIsLogging(Level level, bool value);
     const char * getName();
 
+    /**
+     * Turn asynchronous logging on or off for all loggers.
+     * <p>
+     * When on, logging threads format their message into a bounded
+     * ring buffer and return immediately; a separate thread passes
+     * messages on to Java or stderr.  If the ring is full the message
+     * is dropped and counted in #getDroppedMessages().  Messages longer
+     * than 1023 bytes are truncated.
+     * </p>
+     * <p>
+     * Turning it off logs anything still queued before returning.
+     * </p>
+     *
+     * @param value true for asynchronous logging.
+     * @return true if logging is now in the mode asked for.
+     */
+    static bool setAsynchronous(bool value);
+    /** @return true if logging is asynchronous. */
+    static bool isAsynchronous();
+    /**
+     * If logging is asynchronous, log everything queued so far before
+     * returning.
+     */
+    static void flush();
+    /**
+     * @return the number of messages dropped because the asynchronous
+     *   queue was full.
+     */
+    static int64_t getDroppedMessages();
+
+    /**
+     * Limit how many messages each place in the code can log per
+     * second.  Messages over the limit are dropped; the next message
+     * from that place to get through says how many were dropped.
+     *
+     * @param messagesPerSecond The limit, or 0 for no limit (the
+     *   default).
+     */
+    static void setRateLimit(int32_t messagesPerSecond);
+    /** @return the messages per second each place in the code may log. */
+    static int32_t getRateLimit();
+    /**
+     * @return the number of messages dropped by the rate limit.
+     */
+    static int64_t getRateLimitedMessages();
+
     virtual ~Logger();
 
   protected:
     Logger(const char* loggerName, jobject aJavaLogger);
   private:
+#ifndef SWIG
+    friend class LogQueue;
+#endif // SWIG
     static bool init();
     static void initJavaBindings(JavaVM* vm, void* closure);
     static bool mInitialized;
@@ -137,6 +196,8 @@ namespace io { namespace humble { namespace ferry {
     bool mPrintStackTrace;
 
     bool doLog(Level level, const char*msg);
+    bool submit(const void* site, const char* filename, int lineNo,
+        Level level, const char *format, va_list ap);
     bool doNativeLog(Level level, const char *msg);
     bool doJavaLog(Level level, const char* msg);
 
@@ -147,6 +208,9 @@ namespace io { namespace humble { namespace ferry {
 
     static Mutex *mClassMutex;
     static bool mGlobalIsLogging[5];
+    static int32_t mAsynchronous;
+    static int32_t mRateLimit;
+    static int64_t mRateLimited;
   };
 }}}
 
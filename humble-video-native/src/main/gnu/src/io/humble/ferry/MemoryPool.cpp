@@ -0,0 +1,524 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <cstring>
+
+#include <io/humble/ferry/config.h>
+// AUTOCONF will sometimes replace malloc with rpl_malloc; we don't want
+// that.
+#ifdef malloc
+#undef malloc
+#endif
+
+#include "MemoryPool.h"
+
+#if !defined(_WIN32) && !defined(__WIN32__) && !defined(__CYGWIN__) && !defined(VS_OS_WINDOWS)
+#include <sys/mman.h>
+#define VS_MEMORYPOOL_HAVE_MMAP 1
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+namespace io { namespace humble { namespace ferry
+{
+
+namespace {
+  /**
+   * Free blocks are chained through their own first bytes.
+   */
+  struct FreeBlock
+  {
+    FreeBlock* mNext;
+    size_t mCapacity;
+  };
+
+  const size_t cMinSizeClassCapacity = 256;
+  // 256 bytes through MemoryPool::MAX_SIZE_CLASS_CAPACITY (1MB)
+  const int32_t cNumSizeClasses = 13;
+  const size_t cPageSize = 4096;
+  // no thread caches more than this many bytes of one size class
+  const size_t cMaxThreadCacheBytesPerClass = 2*1024*1024;
+  const int32_t cMaxThreadCacheBlocksPerClass = 64;
+
+  struct ThreadCache
+  {
+    FreeBlock* mFree[cNumSizeClasses];
+    int32_t mCount[cNumSizeClasses];
+    int32_t mGeneration;
+  };
+}
+
+// Everything below is zero (or constant) initialized, so is safe to use
+// while the library is still loading.
+static pthread_mutex_t sLock = PTHREAD_MUTEX_INITIALIZER;
+static FreeBlock* sFree[cNumSizeClasses];
+static FreeBlock* sHuge;
+// blocks from mapHugePages(); these must be unmapped, not freed.
+static FreeBlock* sMapped;
+static bool sEnabled;
+static int64_t sHighWaterMark = MemoryPool::DEFAULT_HIGH_WATER_MARK;
+static int64_t sHits;
+static int64_t sMisses;
+static int64_t sBytesRetained;
+// bumped every time the pool is trimmed; thread caches from an older
+// generation are emptied before they are used again.
+static int32_t sGeneration;
+static int32_t sHugePageMode;
+static size_t sHugePageThreshold = MemoryPool::DEFAULT_HUGE_PAGE_THRESHOLD;
+static int64_t sHugePageBytes;
+static pthread_once_t sKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t sKey;
+
+static int32_t
+sizeClass(size_t size)
+{
+  if (size > MemoryPool::MAX_SIZE_CLASS_CAPACITY)
+    return -1;
+  int32_t retval = 0;
+  while ((cMinSizeClassCapacity << retval) < size)
+    ++retval;
+  return retval;
+}
+
+static int32_t
+maxThreadCacheBlocks(int32_t sizeClass)
+{
+  size_t retval = cMaxThreadCacheBytesPerClass / (cMinSizeClassCapacity << sizeClass);
+  if (retval > (size_t)cMaxThreadCacheBlocksPerClass)
+    retval = cMaxThreadCacheBlocksPerClass;
+  return (int32_t)retval;
+}
+
+static void
+freeToSystem(FreeBlock* block)
+{
+  __atomic_sub_fetch(&sBytesRetained, (int64_t)block->mCapacity, __ATOMIC_RELAXED);
+  ::free(block);
+}
+
+/**
+ * Map capacity bytes (a multiple of MemoryPool::HUGE_PAGE_SIZE) and
+ * ask for huge pages to back them.
+ */
+static void*
+mapHugePages(size_t capacity, int32_t mode)
+{
+#ifdef VS_MEMORYPOOL_HAVE_MMAP
+  void* retval = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (mode == MemoryPool::HUGE_PAGES_HUGETLB)
+    retval = mmap(0, capacity, PROT_READ|PROT_WRITE,
+        MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+#else
+  (void) mode;
+#endif
+  if (retval == MAP_FAILED)
+  {
+    // Transparent huge pages only back huge page aligned ranges, and
+    // mmap() only promises normal page alignment; so map an extra huge
+    // page and trim the ends off.
+    const size_t hugePage = MemoryPool::HUGE_PAGE_SIZE;
+    char* mapped = (char*)mmap(0, capacity + hugePage, PROT_READ|PROT_WRITE,
+        MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (mapped == (char*)MAP_FAILED)
+      return 0;
+    size_t head = (hugePage - ((size_t)mapped & (hugePage - 1))) & (hugePage - 1);
+    if (head)
+      munmap(mapped, head);
+    munmap(mapped + head + capacity, hugePage - head);
+    retval = mapped + head;
+#ifdef MADV_HUGEPAGE
+    (void) madvise(retval, capacity, MADV_HUGEPAGE);
+#endif
+  }
+  __atomic_add_fetch(&sHugePageBytes, (int64_t)capacity, __ATOMIC_RELAXED);
+  return retval;
+#else
+  (void) capacity;
+  (void) mode;
+  return 0;
+#endif
+}
+
+static void
+unmapHugePages(void* block, size_t capacity)
+{
+#ifdef VS_MEMORYPOOL_HAVE_MMAP
+  __atomic_sub_fetch(&sHugePageBytes, (int64_t)capacity, __ATOMIC_RELAXED);
+  munmap(block, capacity);
+#else
+  (void) block;
+  (void) capacity;
+#endif
+}
+
+/**
+ * Empty a thread cache, either back into the shared lists or back
+ * to the system.
+ */
+static void
+flushThreadCache(ThreadCache* cache, bool keep)
+{
+  if (keep)
+    pthread_mutex_lock(&sLock);
+  for(int32_t i = 0; i < cNumSizeClasses; i++)
+  {
+    FreeBlock* block = cache->mFree[i];
+    while(block)
+    {
+      FreeBlock* next = block->mNext;
+      if (keep) {
+        block->mNext = sFree[i];
+        sFree[i] = block;
+      } else
+        freeToSystem(block);
+      block = next;
+    }
+    cache->mFree[i] = 0;
+    cache->mCount[i] = 0;
+  }
+  if (keep)
+    pthread_mutex_unlock(&sLock);
+}
+
+static void
+destroyThreadCache(void* closure)
+{
+  ThreadCache* cache = (ThreadCache*)closure;
+  flushThreadCache(cache,
+      __atomic_load_n(&sEnabled, __ATOMIC_RELAXED) &&
+      cache->mGeneration == __atomic_load_n(&sGeneration, __ATOMIC_ACQUIRE));
+  ::free(cache);
+}
+
+static void
+makeThreadCacheKey()
+{
+  pthread_key_create(&sKey, destroyThreadCache);
+}
+
+static ThreadCache*
+getThreadCache()
+{
+  pthread_once(&sKeyOnce, makeThreadCacheKey);
+  ThreadCache* retval = (ThreadCache*)pthread_getspecific(sKey);
+  int32_t generation = __atomic_load_n(&sGeneration, __ATOMIC_ACQUIRE);
+  if (!retval)
+  {
+    retval = (ThreadCache*)calloc(1, sizeof(ThreadCache));
+    if (!retval)
+      return 0;
+    if (pthread_setspecific(sKey, retval))
+    {
+      ::free(retval);
+      return 0;
+    }
+    retval->mGeneration = generation;
+  }
+  else if (retval->mGeneration != generation)
+  {
+    flushThreadCache(retval, false);
+    retval->mGeneration = generation;
+  }
+  return retval;
+}
+
+void*
+MemoryPool :: allocate(size_t size, size_t* capacity)
+{
+  FreeBlock* block = 0;
+  int32_t cls = sizeClass(size);
+  size_t blockCapacity;
+
+  if (cls >= 0)
+  {
+    blockCapacity = cMinSizeClassCapacity << cls;
+    ThreadCache* cache = getThreadCache();
+    if (cache && cache->mFree[cls])
+    {
+      block = cache->mFree[cls];
+      cache->mFree[cls] = block->mNext;
+      --cache->mCount[cls];
+    }
+    else if (__atomic_load_n(&sFree[cls], __ATOMIC_RELAXED))
+    {
+      pthread_mutex_lock(&sLock);
+      block = sFree[cls];
+      if (block)
+        sFree[cls] = block->mNext;
+      pthread_mutex_unlock(&sLock);
+    }
+  }
+  else
+  {
+    blockCapacity = (size + cPageSize - 1) & ~(cPageSize - 1);
+    if (__atomic_load_n(&sHuge, __ATOMIC_RELAXED))
+    {
+      pthread_mutex_lock(&sLock);
+      FreeBlock** prev = &sHuge;
+      for(block = sHuge; block; prev = &block->mNext, block = block->mNext)
+        if (block->mCapacity == blockCapacity)
+        {
+          *prev = block->mNext;
+          break;
+        }
+      pthread_mutex_unlock(&sLock);
+    }
+  }
+
+  if (block)
+  {
+    __atomic_add_fetch(&sHits, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&sBytesRetained, (int64_t)blockCapacity, __ATOMIC_RELAXED);
+  }
+  else
+  {
+    __atomic_add_fetch(&sMisses, 1, __ATOMIC_RELAXED);
+    block = (FreeBlock*)malloc(blockCapacity);
+  }
+  if (capacity)
+    *capacity = block ? blockCapacity : 0;
+  return block;
+}
+
+void
+MemoryPool :: release(void* mem, size_t capacity)
+{
+  if (!mem)
+    return;
+  FreeBlock* block = (FreeBlock*)mem;
+  if (!__atomic_load_n(&sEnabled, __ATOMIC_RELAXED) ||
+      __atomic_load_n(&sBytesRetained, __ATOMIC_RELAXED) + (int64_t)capacity >
+      __atomic_load_n(&sHighWaterMark, __ATOMIC_RELAXED))
+  {
+    ::free(block);
+    return;
+  }
+  block->mCapacity = capacity;
+  __atomic_add_fetch(&sBytesRetained, (int64_t)capacity, __ATOMIC_RELAXED);
+
+  int32_t cls = sizeClass(capacity);
+  if (cls >= 0)
+  {
+    ThreadCache* cache = getThreadCache();
+    if (cache && cache->mCount[cls] < maxThreadCacheBlocks(cls))
+    {
+      block->mNext = cache->mFree[cls];
+      cache->mFree[cls] = block;
+      ++cache->mCount[cls];
+      return;
+    }
+  }
+  pthread_mutex_lock(&sLock);
+  FreeBlock** list = cls >= 0 ? &sFree[cls] : &sHuge;
+  block->mNext = *list;
+  *list = block;
+  pthread_mutex_unlock(&sLock);
+}
+
+void
+MemoryPool :: setEnabled(bool enabled)
+{
+  __atomic_store_n(&sEnabled, enabled, __ATOMIC_RELAXED);
+  if (!enabled)
+    trim();
+}
+
+bool
+MemoryPool :: isEnabled()
+{
+  return __atomic_load_n(&sEnabled, __ATOMIC_RELAXED);
+}
+
+void
+MemoryPool :: setHighWaterMark(int64_t bytes)
+{
+  __atomic_store_n(&sHighWaterMark, bytes < 0 ? 0 : bytes, __ATOMIC_RELAXED);
+  if (getBytesRetained() > bytes)
+    trim();
+}
+
+int64_t
+MemoryPool :: getHighWaterMark()
+{
+  return __atomic_load_n(&sHighWaterMark, __ATOMIC_RELAXED);
+}
+
+int64_t
+MemoryPool :: getHits()
+{
+  return __atomic_load_n(&sHits, __ATOMIC_RELAXED);
+}
+
+int64_t
+MemoryPool :: getMisses()
+{
+  return __atomic_load_n(&sMisses, __ATOMIC_RELAXED);
+}
+
+int64_t
+MemoryPool :: getBytesRetained()
+{
+  return __atomic_load_n(&sBytesRetained, __ATOMIC_RELAXED);
+}
+
+bool
+MemoryPool :: setHugePageMode(HugePageMode mode)
+{
+  switch(mode)
+  {
+    case HUGE_PAGES_NONE:
+      break;
+#ifdef VS_MEMORYPOOL_HAVE_MMAP
+    case HUGE_PAGES_TRANSPARENT:
+    case HUGE_PAGES_HUGETLB:
+      break;
+#endif
+    default:
+      return false;
+  }
+  __atomic_store_n(&sHugePageMode, (int32_t)mode, __ATOMIC_RELAXED);
+  return true;
+}
+
+MemoryPool::HugePageMode
+MemoryPool :: getHugePageMode()
+{
+  return (HugePageMode)__atomic_load_n(&sHugePageMode, __ATOMIC_RELAXED);
+}
+
+void
+MemoryPool :: setHugePageThreshold(size_t bytes)
+{
+  __atomic_store_n(&sHugePageThreshold, bytes, __ATOMIC_RELAXED);
+}
+
+size_t
+MemoryPool :: getHugePageThreshold()
+{
+  return __atomic_load_n(&sHugePageThreshold, __ATOMIC_RELAXED);
+}
+
+bool
+MemoryPool :: useHugePages(size_t size)
+{
+  return __atomic_load_n(&sHugePageMode, __ATOMIC_RELAXED) != HUGE_PAGES_NONE &&
+      size >= __atomic_load_n(&sHugePageThreshold, __ATOMIC_RELAXED);
+}
+
+void*
+MemoryPool :: allocateHugePages(size_t size, size_t* capacity)
+{
+  int32_t mode = __atomic_load_n(&sHugePageMode, __ATOMIC_RELAXED);
+  if (capacity)
+    *capacity = 0;
+  if (mode == HUGE_PAGES_NONE || !size)
+    return 0;
+  size_t blockCapacity = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  FreeBlock* block = 0;
+  if (__atomic_load_n(&sMapped, __ATOMIC_RELAXED))
+  {
+    pthread_mutex_lock(&sLock);
+    FreeBlock** prev = &sMapped;
+    for(block = sMapped; block; prev = &block->mNext, block = block->mNext)
+      if (block->mCapacity == blockCapacity)
+      {
+        *prev = block->mNext;
+        break;
+      }
+    pthread_mutex_unlock(&sLock);
+  }
+  if (block)
+  {
+    __atomic_add_fetch(&sHits, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&sBytesRetained, (int64_t)blockCapacity, __ATOMIC_RELAXED);
+  }
+  else
+  {
+    if (isEnabled())
+      __atomic_add_fetch(&sMisses, 1, __ATOMIC_RELAXED);
+    block = (FreeBlock*)mapHugePages(blockCapacity, mode);
+  }
+  if (block && capacity)
+    *capacity = blockCapacity;
+  return block;
+}
+
+void
+MemoryPool :: releaseHugePages(void* mem, size_t capacity)
+{
+  if (!mem)
+    return;
+  FreeBlock* block = (FreeBlock*)mem;
+  if (!__atomic_load_n(&sEnabled, __ATOMIC_RELAXED) ||
+      __atomic_load_n(&sBytesRetained, __ATOMIC_RELAXED) + (int64_t)capacity >
+      __atomic_load_n(&sHighWaterMark, __ATOMIC_RELAXED))
+  {
+    unmapHugePages(block, capacity);
+    return;
+  }
+  block->mCapacity = capacity;
+  __atomic_add_fetch(&sBytesRetained, (int64_t)capacity, __ATOMIC_RELAXED);
+  pthread_mutex_lock(&sLock);
+  block->mNext = sMapped;
+  sMapped = block;
+  pthread_mutex_unlock(&sLock);
+}
+
+int64_t
+MemoryPool :: getHugePageBytes()
+{
+  return __atomic_load_n(&sHugePageBytes, __ATOMIC_RELAXED);
+}
+
+void
+MemoryPool :: trim()
+{
+  __atomic_add_fetch(&sGeneration, 1, __ATOMIC_ACQ_REL);
+  pthread_mutex_lock(&sLock);
+  for(int32_t i = 0; i <= cNumSizeClasses; i++)
+  {
+    FreeBlock** list = i < cNumSizeClasses ? &sFree[i] : &sHuge;
+    FreeBlock* block = *list;
+    *list = 0;
+    while(block)
+    {
+      FreeBlock* next = block->mNext;
+      freeToSystem(block);
+      block = next;
+    }
+  }
+  FreeBlock* mapped = sMapped;
+  sMapped = 0;
+  pthread_mutex_unlock(&sLock);
+  while(mapped)
+  {
+    FreeBlock* next = mapped->mNext;
+    size_t capacity = mapped->mCapacity;
+    __atomic_sub_fetch(&sBytesRetained, (int64_t)capacity, __ATOMIC_RELAXED);
+    unmapHugePages(mapped, capacity);
+    mapped = next;
+  }
+  // and empty our own cache now, rather than next time.
+  (void) getThreadCache();
+}
+
+}}}
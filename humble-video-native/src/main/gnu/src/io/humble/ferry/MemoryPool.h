@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MEMORYPOOL_H_
+#define MEMORYPOOL_H_
+
+#include <cstdlib>
+
+#include <io/humble/ferry/Ferry.h>
+
+namespace io { namespace humble { namespace ferry {
+
+/**
+ * Internal Only.  A recycling allocator that sits underneath the
+ * JNIMemoryManager's NATIVE_BUFFERS memory models.
+ * <p>
+ * Without it every Buffer (and hence every picture, audio sample
+ * and packet payload) is a malloc() and free().  At 1080p that is
+ * several megabytes per frame, which fragments the heap and has the
+ * kernel handing back freshly zeroed pages every frame.  With the
+ * pool turned on, released blocks are kept and handed out again:
+ * </p>
+ * <ul>
+ * <li>Blocks up to #MAX_SIZE_CLASS_CAPACITY bytes are rounded up to a
+ * power-of-two size class.  Each thread keeps a small private cache of
+ * free blocks per class, and spills into (and refills from) a shared
+ * free list per class.</li>
+ * <li>Larger blocks are rounded up to a page and recycled only for
+ * requests that round to exactly the same size, which is what
+ * repeated same-resolution frames ask for.</li>
+ * <li>The pool never holds more than #getHighWaterMark() bytes of free
+ * blocks; anything released past that goes straight back to the
+ * system.</li>
+ * </ul>
+ * <p>
+ * The pool is off by default.
+ * </p>
+ * <p>
+ * Separately, blocks at or above #getHugePageThreshold() can be backed
+ * by huge pages (see #setHugePageMode(HugePageMode)), which saves TLB
+ * misses when SIMD code streams over a whole 4K frame.  Those blocks
+ * come from #allocateHugePages(size_t, size_t*) and are recycled by the
+ * pool like any other large block.
+ * </p>
+ */
+class VS_API_FERRY MemoryPool
+{
+public:
+  /** The largest block that goes in a size class. */
+  static const size_t MAX_SIZE_CLASS_CAPACITY=1024*1024;
+
+  /** The high water mark used unless #setHighWaterMark(int64_t) is called. */
+  static const int64_t DEFAULT_HIGH_WATER_MARK=256*1024*1024;
+
+  /** The size of a huge page; huge page blocks are a multiple of this. */
+  static const size_t HUGE_PAGE_SIZE=2*1024*1024;
+
+  /**
+   * The threshold used unless #setHugePageThreshold(size_t) is called.
+   * Smaller blocks would waste most of their huge page.
+   */
+  static const size_t DEFAULT_HUGE_PAGE_THRESHOLD=HUGE_PAGE_SIZE;
+
+  /**
+   * How to get huge pages for large blocks.
+   */
+  typedef enum HugePageMode {
+    /** Never; large blocks come from malloc(). */
+    HUGE_PAGES_NONE=0,
+    /**
+     * Map the block and madvise() it for transparent huge pages.  Needs
+     * /sys/kernel/mm/transparent_hugepage/enabled set to "always" or
+     * "madvise".
+     */
+    HUGE_PAGES_TRANSPARENT=1,
+    /**
+     * Map the block from the hugetlb pool the administrator reserved
+     * with /proc/sys/vm/nr_hugepages.  When that pool is empty, falls
+     * back to #HUGE_PAGES_TRANSPARENT.
+     */
+    HUGE_PAGES_HUGETLB=2,
+  } HugePageMode;
+
+  /**
+   * Get a block of memory.
+   *
+   * @param size The minimum number of bytes needed.
+   * @param capacity Set to the number of bytes actually in the block;
+   *   pass this back to #release(void*, size_t).
+   * @return the block, or null if out of memory.
+   */
+  static void* allocate(size_t size, size_t* capacity);
+
+  /**
+   * Give back a block from #allocate(size_t, size_t*).  It is kept for
+   * reuse if the pool is on and under its high water mark, and freed
+   * otherwise.
+   *
+   * @param block The block.
+   * @param capacity The capacity #allocate(size_t, size_t*) returned.
+   */
+  static void release(void* block, size_t capacity);
+
+  /**
+   * Turn pooling on or off.  Turning it off also frees every block the
+   * pool is holding.
+   */
+  static void setEnabled(bool enabled);
+  /** @return true if pooling is on. */
+  static bool isEnabled();
+
+  /**
+   * Set the most bytes of free blocks the pool will hold onto.  If the
+   * pool is already above this, it is trimmed.
+   */
+  static void setHighWaterMark(int64_t bytes);
+  /** @return the most bytes of free blocks the pool will hold onto. */
+  static int64_t getHighWaterMark();
+
+  /** @return the number of allocations served from the pool. */
+  static int64_t getHits();
+  /** @return the number of allocations that had to go to the system. */
+  static int64_t getMisses();
+  /** @return the number of bytes in free blocks the pool is holding. */
+  static int64_t getBytesRetained();
+
+  /**
+   * Set how large blocks get huge pages.  Blocks already allocated are
+   * unaffected.
+   *
+   * @param mode The mode.
+   * @return false if this platform does not support mode, in which case
+   *   the mode is not changed.
+   */
+  static bool setHugePageMode(HugePageMode mode);
+  /** @return how large blocks get huge pages. */
+  static HugePageMode getHugePageMode();
+
+  /**
+   * Set the size at and above which blocks are backed by huge pages.
+   */
+  static void setHugePageThreshold(size_t bytes);
+  /** @return the size at and above which blocks are backed by huge pages. */
+  static size_t getHugePageThreshold();
+
+  /**
+   * @return true if a block of size bytes should come from
+   *   #allocateHugePages(size_t, size_t*).
+   */
+  static bool useHugePages(size_t size);
+
+  /**
+   * Get a block of memory backed by huge pages. Blocks are reused from
+   * the pool when it is on, and mapped from the system otherwise.
+   *
+   * @param size The minimum number of bytes needed.
+   * @param capacity Set to the number of bytes actually in the block;
+   *   pass this back to #releaseHugePages(void*, size_t).
+   * @return the block, or null if out of memory or huge pages are
+   *   off.
+   */
+  static void* allocateHugePages(size_t size, size_t* capacity);
+
+  /**
+   * Give back a block from #allocateHugePages(size_t, size_t*).
+   *
+   * @param block The block.
+   * @param capacity The capacity #allocateHugePages(size_t, size_t*)
+   *   returned.
+   */
+  static void releaseHugePages(void* block, size_t capacity);
+
+  /** @return the number of bytes currently mapped for huge page blocks. */
+  static int64_t getHugePageBytes();
+
+  /**
+   * Free every block held in the shared free lists and in the calling
+   * thread's cache.  Other threads free their caches the next time they
+   * use the pool, or when they exit.
+   */
+  static void trim();
+
+private:
+  MemoryPool();
+};
+
+}}}
+#endif /* MEMORYPOOL_H_ */
@@ -20,6 +20,14 @@
 #include "Mutex.h"
 #include "JNIHelper.h"
 #include <cstdio>
+#include <sys/time.h>
+#include <time.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#define VS_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define VS_CPU_RELAX() do {} while(0)
+#endif
 
 namespace io { namespace humble { namespace ferry
 {
@@ -29,14 +37,48 @@ jmethodID Mutex :: mConstructorMethod = 0;
 
 bool Mutex :: mInitialized = false;
 
+/**
+ * A monotonic-ish clock for measuring how long we wait; only
+ * used on the contended path.
+ */
+static int64_t
+nowNanos()
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return ((int64_t)ts.tv_sec)*1000000000LL + ts.tv_nsec;
+#endif
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return ((int64_t)tv.tv_sec)*1000000000LL + ((int64_t)tv.tv_usec)*1000;
+}
+
 Mutex :: Mutex()
 {
   mLock = 0;
   mSpinCount = 0;
+  mIsNative = false;
+  mMaxSpins = 0;
+  mSpinEstimate = 0;
+  mAcquisitions = 0;
+  mContendedAcquisitions = 0;
+  mWaitTime = 0;
 }
 
 Mutex :: ~Mutex()
 {
+  if (mIsNative)
+  {
+    if (mSpinCount > 0)
+      fprintf(stderr, "Destroying mutex %p with non-zero spin count\n",
+          this);
+    while (mSpinCount > 0)
+      this->unlock();
+    pthread_mutex_destroy(&mNativeLock);
+    mIsNative = false;
+    return;
+  }
   JNIEnv *env = JNIHelper::sGetEnv();
   if (env)
   {
@@ -88,9 +130,69 @@ Mutex :: initJavaBindings(JavaVM*, void*)
   }
 }
 
+bool
+Mutex :: nativeLock()
+{
+  if (!pthread_mutex_trylock(&mNativeLock))
+    return false;
+
+  // someone else has it.  Spin for about as long as it took to get the
+  // lock the last few times we had to, but never more than mMaxSpins;
+  // if that doesn't do it, go to sleep in the kernel.
+  int64_t start = nowNanos();
+  int32_t maxSpins = mMaxSpins;
+  int32_t spinLimit = __atomic_load_n(&mSpinEstimate, __ATOMIC_RELAXED)*2 + 10;
+  if (spinLimit > maxSpins)
+    spinLimit = maxSpins;
+  int32_t spins = 0;
+  bool locked = false;
+  for(; spins < spinLimit; spins++)
+  {
+    VS_CPU_RELAX();
+    if (!pthread_mutex_trylock(&mNativeLock))
+    {
+      locked = true;
+      break;
+    }
+  }
+  if (!locked)
+  {
+    if (pthread_mutex_lock(&mNativeLock))
+      throw std::runtime_error("failed to lock native mutex");
+    spins = maxSpins;
+  }
+  // we hold the lock now, so we're the only ones updating the stats.
+  int32_t estimate = mSpinEstimate;
+  __atomic_store_n(&mSpinEstimate, estimate + (spins - estimate)/8,
+      __ATOMIC_RELAXED);
+  __atomic_store_n(&mWaitTime, mWaitTime + (nowNanos() - start),
+      __ATOMIC_RELAXED);
+  return true;
+}
+
+void
+Mutex :: nativeUnlock()
+{
+  if (mSpinCount <= 0)
+    throw std::runtime_error("unlock attempt on unlocked mutex");
+  --mSpinCount;
+  if (pthread_mutex_unlock(&mNativeLock))
+    throw std::runtime_error("failed attempt to unlock mutex");
+}
+
 void
 Mutex :: lock()
 {
+  if (mIsNative)
+  {
+    bool contended = nativeLock();
+    ++mSpinCount;
+    __atomic_store_n(&mAcquisitions, mAcquisitions + 1, __ATOMIC_RELAXED);
+    if (contended)
+      __atomic_store_n(&mContendedAcquisitions, mContendedAcquisitions + 1,
+          __ATOMIC_RELAXED);
+    return;
+  }
   if (!mInitialized)
     Mutex::init();
 
@@ -132,6 +234,11 @@ Mutex :: lock()
 void
 Mutex :: unlock()
 {
+  if (mIsNative)
+  {
+    nativeUnlock();
+    return;
+  }
   if (!mInitialized)
     Mutex::init();
 
@@ -230,6 +337,52 @@ Mutex :: make()
     env->DeleteLocalRef(newValue);
   return retval;
 }
+
+Mutex*
+Mutex :: makeNative(int32_t maxSpins)
+{
+  Mutex* retval = new Mutex();
+  retval->acquire();
+
+  pthread_mutexattr_t attr;
+  bool ok = !pthread_mutexattr_init(&attr);
+  // Java monitors are re-entrant, so we are too.
+  ok = ok && !pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  ok = ok && !pthread_mutex_init(&retval->mNativeLock, &attr);
+  pthread_mutexattr_destroy(&attr);
+  if (!ok)
+  {
+    VS_REF_RELEASE(retval);
+    throw std::bad_alloc();
+  }
+  retval->mIsNative = true;
+  retval->mMaxSpins = maxSpins < 0 ? 0 : maxSpins;
+  return retval;
+}
+
+bool
+Mutex :: isNative()
+{
+  return mIsNative;
+}
+
+int64_t
+Mutex :: getAcquisitions()
+{
+  return __atomic_load_n(&mAcquisitions, __ATOMIC_RELAXED);
+}
+
+int64_t
+Mutex :: getContendedAcquisitions()
+{
+  return __atomic_load_n(&mContendedAcquisitions, __ATOMIC_RELAXED);
+}
+
+int64_t
+Mutex :: getWaitTime()
+{
+  return __atomic_load_n(&mWaitTime, __ATOMIC_RELAXED);
+}
 }
 }
 }
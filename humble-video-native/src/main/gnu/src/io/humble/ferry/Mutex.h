@@ -20,6 +20,7 @@
 #ifndef MUTEX_H_
 #define MUTEX_H_
 
+#include <pthread.h>
 #include <io/humble/ferry/RefCounted.h>
 
 namespace io { namespace humble { namespace ferry {
@@ -30,20 +31,67 @@ namespace io { namespace humble { namespace ferry {
    * This object exists so that Native code can get access to 
    * thread safe locking objects if they need it.
    * </p><p>
-   * Implements a blocking Mutually-Exclusive lock
-   * by wrapping a Java lock.
-   * </p><p>
-   * If not running inside Java, lock() and unlock()
-   * are NO-OPs.
+   * Implements a blocking, re-entrant, Mutually-Exclusive lock.  There are
+   * two flavors:
    * </p>
+   * <ul>
+   * <li>#make() wraps a Java lock.  If not running inside Java, #make()
+   * returns null.</li>
+   * <li>#makeNative() uses a native pthread mutex (a futex on Linux) and
+   * works with or without a JVM.  Before blocking in the kernel, a
+   * contended lock() spins for a while, adapting how long it spins to how
+   * long the lock has recently been held.  It also keeps contention
+   * counters.</li>
+   * </ul>
    */
   class VS_API_FERRY Mutex : public RefCounted
   {
   public:
     static Mutex * make();
+#ifndef SWIG
+    /**
+     * The most times a contended #lock() on a native mutex will
+     * retry before blocking, unless told otherwise.
+     */
+    static const int32_t DEFAULT_MAX_SPINS=100;
+
+    /**
+     * Make a native mutex that does not depend on Java.
+     *
+     * @param maxSpins The most times a contended #lock() will retry
+     *   before blocking in the kernel.  0 means never spin.
+     * @return a new mutex.
+     * @throws std::bad_alloc if we cannot create the mutex.
+     */
+    static Mutex * makeNative(int32_t maxSpins=DEFAULT_MAX_SPINS);
+#endif // ! SWIG
 
     void lock();
     void unlock();
+
+    /**
+     * @return true if this is a native mutex; false if it wraps a Java lock.
+     */
+    bool isNative();
+
+    /**
+     * @return The number of times this mutex has been locked.  Always
+     *   0 for mutexes that wrap a Java lock.
+     */
+    int64_t getAcquisitions();
+
+    /**
+     * @return The number of times #lock() found this mutex held by another
+     *   thread.  Always 0 for mutexes that wrap a Java lock.
+     */
+    int64_t getContendedAcquisitions();
+
+    /**
+     * @return The total time, in nanoseconds, threads have spent spinning
+     *   or blocked waiting for this mutex.  Always 0 for mutexes that
+     *   wrap a Java lock.
+     */
+    int64_t getWaitTime();
   protected:
     Mutex();
     virtual ~Mutex();
@@ -51,6 +99,18 @@ namespace io { namespace humble { namespace ferry {
     jobject mLock;
     volatile int64_t mSpinCount;
 
+#ifndef SWIG
+    bool nativeLock();
+    void nativeUnlock();
+    bool mIsNative;
+    pthread_mutex_t mNativeLock;
+    int32_t mMaxSpins;
+    int32_t mSpinEstimate;
+    int64_t mAcquisitions;
+    int64_t mContendedAcquisitions;
+    int64_t mWaitTime;
+#endif // ! SWIG
+
     static bool init();
     static void initJavaBindings(JavaVM* vm, void* closure);
     static bool mInitialized;
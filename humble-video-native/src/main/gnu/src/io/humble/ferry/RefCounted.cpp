@@ -18,6 +18,7 @@
  *******************************************************************************/
 
 #include "RefCounted.h"
+#include "RefCountedRegistry.h"
 #include "AtomicInteger.h"
 #include "JNIHelper.h"
 //#include "Logger.h"
@@ -26,17 +27,14 @@
 
 namespace io { namespace humble { namespace ferry {
 
-  RefCounted :: RefCounted()
+  RefCounted :: RefCounted() : mRefCount(0)
   {
-    mRefCount = new AtomicInteger(0);
     mAllocator = 0;
+    mTypeStats = 0;
   }
 
   RefCounted :: ~RefCounted()
   {
-    if (mRefCount)
-      delete mRefCount;
-    mRefCount = 0;
     if (mAllocator)
       JNIHelper::sDeleteGlobalRef((jobject)mAllocator);
     mAllocator = 0;
@@ -63,14 +61,24 @@ namespace io { namespace humble { namespace ferry {
   RefCounted :: acquire()
   {
     //VS_LOG_DEBUG("acquire: %p", this);
-    return mRefCount->incrementAndGet();
+    // taking a new reference requires no ordering; the caller already
+    // holds a reference that keeps the object alive.
+    int32_t retval = mRefCount.incrementAndGet(AtomicInteger::MEMORY_ORDER_RELAXED);
+    // every factory acquires what it makes, and an object whose count
+    // drops to zero is destroyed, so this is the one time we see a new
+    // object with its concrete type in place.
+    if (retval == 1 && RefCountedRegistry::isEnabled())
+      mTypeStats = RefCountedRegistry::onCreate(this);
+    return retval;
   }
 
   int32_t
   RefCounted :: release()
   {
     //VS_LOG_DEBUG("release: %p", this);
-    int32_t retval = mRefCount->decrementAndGet();
+    // acquire-release so that every write made while holding a reference
+    // is visible to whichever thread ends up calling destroy().
+    int32_t retval = mRefCount.decrementAndGet(AtomicInteger::MEMORY_ORDER_ACQ_REL);
     if (!retval)
       this->destroy();
     return retval;
@@ -79,13 +87,15 @@ namespace io { namespace humble { namespace ferry {
   int32_t
   RefCounted :: getCurrentRefCount()
   {
-    return mRefCount->get();
+    return mRefCount.get(AtomicInteger::MEMORY_ORDER_RELAXED);
   }
 
   void
   RefCounted :: destroy()
   {
     //VS_LOG_DEBUG("destroy: %p", this);
+    RefCountedRegistry::onDestroy(
+        static_cast<RefCountedRegistry::TypeStats*>(mTypeStats));
     // by default just call the destructor
     delete this;
   }
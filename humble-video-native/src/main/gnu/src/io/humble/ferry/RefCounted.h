@@ -27,9 +27,9 @@
 #include <stdexcept>
 
 #include <io/humble/ferry/Ferry.h>
+#include <io/humble/ferry/AtomicInteger.h>
 
 namespace io { namespace humble { namespace ferry {
-  class AtomicInteger;
 
   /**
    * Parent of all Ferry objects -- it mains reference counts
@@ -141,15 +141,24 @@ namespace io { namespace humble { namespace ferry {
     virtual ~RefCounted();
 
     /**
-     * This is the internal reference count, represented as
-     * an AtomicInteger to make sure it is thread safe.
+     * This is the internal reference count.  It lives inline in the
+     * object (right after the vtable pointer, so it shares a cache line
+     * with the data every virtual call already touches) and is only ever
+     * updated with native atomic operations; no extra allocation and no
+     * calls into Java are needed to acquire or release an object.
      */
-    AtomicInteger* mRefCount;
+    AtomicInteger mRefCount;
 
     /**
      * Not part of public API.
      */
     void * mAllocator;
+
+    /**
+     * Not part of public API.  The RefCountedRegistry counters this
+     * object was counted against, or null if it was not counted.
+     */
+    void * mTypeStats;
   };
 
 #define VS_JNIUTILS_REFCOUNTED_MAKE(__class) \
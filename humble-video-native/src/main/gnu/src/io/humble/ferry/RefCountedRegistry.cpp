@@ -0,0 +1,188 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <typeinfo>
+#include <pthread.h>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+#include "RefCountedRegistry.h"
+#include "RefCounted.h"
+
+namespace io { namespace humble { namespace ferry {
+
+class RefCountedRegistry::TypeStats
+{
+public:
+  const std::type_info* mType;
+  char mName[128];
+  int64_t mLive;
+  int64_t mCreated;
+  int64_t mBytes;
+};
+
+bool RefCountedRegistry :: sEnabled = false;
+
+// Entries are filled in under sLock and then published by bumping
+// sNumTypes, so readers never need the lock.
+static RefCountedRegistry::TypeStats sTypes[RefCountedRegistry::MAX_TYPES];
+static int32_t sNumTypes;
+static pthread_mutex_t sLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+demangle(const std::type_info& type, char* name, size_t nameLen)
+{
+  const char* raw = type.name();
+  char* demangled = 0;
+#ifdef __GNUC__
+  int status = 0;
+  demangled = abi::__cxa_demangle(raw, 0, 0, &status);
+#endif
+  strncpy(name, demangled ? demangled : raw, nameLen-1);
+  name[nameLen-1] = 0;
+  free(demangled);
+}
+
+static RefCountedRegistry::TypeStats*
+findStats(const std::type_info& type)
+{
+  int32_t numTypes = __atomic_load_n(&sNumTypes, __ATOMIC_ACQUIRE);
+  for(int32_t i = 0; i < numTypes; i++)
+    if (*sTypes[i].mType == type)
+      return &sTypes[i];
+
+  RefCountedRegistry::TypeStats* retval = 0;
+  pthread_mutex_lock(&sLock);
+  // someone may have added it while we waited
+  numTypes = sNumTypes;
+  for(int32_t i = 0; i < numTypes && !retval; i++)
+    if (*sTypes[i].mType == type)
+      retval = &sTypes[i];
+  if (!retval && numTypes < RefCountedRegistry::MAX_TYPES)
+  {
+    retval = &sTypes[numTypes];
+    retval->mType = &type;
+    demangle(type, retval->mName, sizeof(retval->mName));
+    __atomic_store_n(&sNumTypes, numTypes+1, __ATOMIC_RELEASE);
+  }
+  pthread_mutex_unlock(&sLock);
+  return retval;
+}
+
+static RefCountedRegistry::TypeStats*
+getStats(int32_t index)
+{
+  if (index < 0 || index >= __atomic_load_n(&sNumTypes, __ATOMIC_ACQUIRE))
+    return 0;
+  return &sTypes[index];
+}
+
+void
+RefCountedRegistry :: setEnabled(bool enabled)
+{
+  __atomic_store_n(&sEnabled, enabled, __ATOMIC_RELAXED);
+}
+
+int32_t
+RefCountedRegistry :: getNumTypes()
+{
+  return __atomic_load_n(&sNumTypes, __ATOMIC_ACQUIRE);
+}
+
+const char*
+RefCountedRegistry :: getTypeName(int32_t index)
+{
+  TypeStats* stats = getStats(index);
+  return stats ? stats->mName : 0;
+}
+
+int32_t
+RefCountedRegistry :: findType(const char* name)
+{
+  if (!name)
+    return -1;
+  int32_t numTypes = getNumTypes();
+  for(int32_t i = 0; i < numTypes; i++)
+    if (!strcmp(sTypes[i].mName, name))
+      return i;
+  return -1;
+}
+
+int64_t
+RefCountedRegistry :: getLiveObjects(int32_t index)
+{
+  TypeStats* stats = getStats(index);
+  return stats ? __atomic_load_n(&stats->mLive, __ATOMIC_RELAXED) : 0;
+}
+
+int64_t
+RefCountedRegistry :: getCreatedObjects(int32_t index)
+{
+  TypeStats* stats = getStats(index);
+  return stats ? __atomic_load_n(&stats->mCreated, __ATOMIC_RELAXED) : 0;
+}
+
+int64_t
+RefCountedRegistry :: getBytes(int32_t index)
+{
+  TypeStats* stats = getStats(index);
+  return stats ? __atomic_load_n(&stats->mBytes, __ATOMIC_RELAXED) : 0;
+}
+
+RefCountedRegistry::TypeStats*
+RefCountedRegistry :: onCreate(RefCounted* obj)
+{
+  TypeStats* stats = obj ? findStats(typeid(*obj)) : 0;
+  if (stats)
+  {
+    __atomic_add_fetch(&stats->mLive, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->mCreated, 1, __ATOMIC_RELAXED);
+  }
+  return stats;
+}
+
+void
+RefCountedRegistry :: onDestroy(TypeStats* stats)
+{
+  if (stats)
+    __atomic_sub_fetch(&stats->mLive, 1, __ATOMIC_RELAXED);
+}
+
+RefCountedRegistry::TypeStats*
+RefCountedRegistry :: onBytesAcquired(RefCounted* owner, int64_t bytes)
+{
+  if (!owner || !isEnabled())
+    return 0;
+  TypeStats* stats = findStats(typeid(*owner));
+  if (stats)
+    __atomic_add_fetch(&stats->mBytes, bytes, __ATOMIC_RELAXED);
+  return stats;
+}
+
+void
+RefCountedRegistry :: onBytesReleased(TypeStats* stats, int64_t bytes)
+{
+  if (stats)
+    __atomic_sub_fetch(&stats->mBytes, bytes, __ATOMIC_RELAXED);
+}
+
+}}}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef REFCOUNTEDREGISTRY_H_
+#define REFCOUNTEDREGISTRY_H_
+
+#include <io/humble/ferry/Ferry.h>
+
+namespace io { namespace humble { namespace ferry {
+
+class RefCounted;
+
+/**
+ * Internal Only.  Counts RefCounted objects by their concrete type.
+ * <p>
+ * Off by default.  Once turned on with #setEnabled(bool), every
+ * RefCounted object made after that point is counted against its
+ * concrete type (for example io::humble::video::MediaPacketImpl)
+ * when it is first acquired, and counted out again when it is destroyed.
+ * Buffers also report how many bytes they hold, counted against the
+ * type that asked for the Buffer (or the Buffer itself if nobody did).
+ * </p><p>
+ * Types are numbered in the order they were first seen, and the numbers
+ * never change, so a dashboard can sample the counters by index from any
+ * thread while the pipeline runs.  Each counter is read atomically, but a
+ * sample of several counters is not a consistent snapshot.
+ * </p><p>
+ * Turning the registry off stops new objects from being counted; objects
+ * already counted are still counted out when destroyed.
+ * </p>
+ */
+class VS_API_FERRY RefCountedRegistry
+{
+public:
+  /**
+   * The most concrete types we keep counters for.  Types seen after
+   * that are not counted.
+   */
+  static const int32_t MAX_TYPES=256;
+
+  /**
+   * Turn counting on or off.
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * Is counting on?  A relaxed load; RefCounted checks this when an
+   * object is first acquired.
+   */
+  static bool isEnabled() {
+    return __atomic_load_n(&sEnabled, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @return The number of types seen since counting was first turned on.
+   */
+  static int32_t getNumTypes();
+
+  /**
+   * @param index A type number, from 0 to #getNumTypes()-1.
+   * @return The demangled name of that type, or null if index is out of
+   *   range.
+   */
+  static const char* getTypeName(int32_t index);
+
+  /**
+   * @param name A demangled type name.
+   * @return The number of the type with that name, or -1 if it has not
+   *   been seen.
+   */
+  static int32_t findType(const char* name);
+
+  /**
+   * @return The number of objects of that type that are alive now, or 0 if
+   *   index is out of range.
+   */
+  static int64_t getLiveObjects(int32_t index);
+
+  /**
+   * @return The number of objects of that type made while counting was on,
+   *   or 0 if index is out of range.
+   */
+  static int64_t getCreatedObjects(int32_t index);
+
+  /**
+   * @return The number of bytes of Buffer memory objects of that type hold
+   *   now, or 0 if index is out of range.
+   */
+  static int64_t getBytes(int32_t index);
+
+#ifndef SWIG
+  class TypeStats;
+
+  /**
+   * Count obj in.  Called by RefCounted when obj is first acquired.
+   *
+   * @return The counters to pass to #onDestroy(TypeStats*), or null if
+   *   the type could not be counted.
+   */
+  static TypeStats* onCreate(RefCounted* obj);
+
+  /**
+   * Count an object out.
+   */
+  static void onDestroy(TypeStats* stats);
+
+  /**
+   * Count bytes against the concrete type of owner.  Does nothing if
+   * counting is off.
+   *
+   * @return The counters to pass to #onBytesReleased(TypeStats*, int64_t),
+   *   or null if nothing was counted.
+   */
+  static TypeStats* onBytesAcquired(RefCounted* owner, int64_t bytes);
+
+  /**
+   * Give back bytes counted by #onBytesAcquired(RefCounted*, int64_t).
+   */
+  static void onBytesReleased(TypeStats* stats, int64_t bytes);
+#endif // ! SWIG
+
+private:
+  static bool sEnabled;
+};
+
+}}}
+
+#endif /*REFCOUNTEDREGISTRY_H_*/
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstdio>
+
+#include "Trace.h"
+#include "Logger.h"
+
+namespace io { namespace humble { namespace ferry {
+
+namespace {
+  class LoggerSink : public Trace::Sink
+  {
+  public:
+    LoggerSink() : mLogger(Logger::getStaticLogger("io.humble.trace")) {}
+    virtual ~LoggerSink() {}
+    virtual void onTrace(const char* filename, int lineNo, const char* message)
+    {
+      if (mLogger)
+        mLogger->log(filename, lineNo, Logger::LEVEL_TRACE, "%s", message);
+    }
+  private:
+    Logger* mLogger;
+  };
+}
+
+// zero initialized, so safe to use while the library is loading.
+int32_t Trace :: sEnabled;
+Trace::Sink* Trace :: sSink;
+
+Trace::Sink :: ~Sink()
+{
+}
+
+void
+Trace :: setSink(Sink* sink)
+{
+  __atomic_store_n(&sSink, sink, __ATOMIC_RELEASE);
+  __atomic_store_n(&sEnabled, sink ? 1 : 0, __ATOMIC_RELAXED);
+}
+
+Trace::Sink*
+Trace :: getSink()
+{
+  return __atomic_load_n(&sSink, __ATOMIC_ACQUIRE);
+}
+
+Trace::Sink*
+Trace :: getLoggerSink()
+{
+  static LoggerSink sLoggerSink;
+  return &sLoggerSink;
+}
+
+void
+Trace :: trace(const char* filename, int lineNo, const char* format, ...)
+{
+  va_list ap;
+  va_start(ap, format);
+  traceVA(filename, lineNo, format, ap);
+  va_end(ap);
+}
+
+void
+Trace :: traceVA(const char* filename, int lineNo, const char* format,
+    va_list ap)
+{
+  Sink* sink = getSink();
+  if (!sink || !format)
+    return;
+  char message[MAX_MESSAGE_LENGTH];
+  vsnprintf(message, sizeof(message), format, ap);
+  sink->onTrace(filename, lineNo, message);
+}
+
+}}}
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <cstdarg>
+
+#include <io/humble/ferry/Ferry.h>
+
+namespace io { namespace humble { namespace ferry {
+
+/**
+ * Internal Only.  Tracing for the per-packet and per-frame hot paths.
+ * <p>
+ * Trace sites are gated twice:
+ * </p>
+ * <ul>
+ * <li>At compile time: define VS_TRACE_DISABLED and every VS_TRACE
+ * site compiles to nothing (the arguments are still type checked).</li>
+ * <li>At run time: unless a Sink is attached with
+ * #setSink(Sink*), a site costs one relaxed load and a branch.  The
+ * message, and anything the site does to describe its arguments, is
+ * only formatted once a sink is attached.</li>
+ * </ul>
+ * <p>
+ * Use it like this:
+ * </p>
+ * <code>
+ *   VS_TRACE("read Demuxer@%p[e:%" PRIi64 "]", this, (int64_t)retval);
+ *
+ *   if (VS_TRACE_IS_ENABLED()) {
+ *     char descr[256];
+ *     pkt->logMetadata(descr, sizeof(descr));
+ *     VS_TRACE_EMIT("read Demuxer@%p[p:%s]", this, descr);
+ *   }
+ * </code>
+ * <p>
+ * Messages are formatted as "what Class@address[key:value;...]".
+ * </p>
+ */
+class VS_API_FERRY Trace
+{
+public:
+  /**
+   * Receives trace messages.  Sinks can be called from many threads at
+   * once.
+   */
+  class VS_API_FERRY Sink
+  {
+  public:
+    virtual ~Sink();
+    /**
+     * Called for every trace message.
+     *
+     * @param filename The file the message came from.
+     * @param lineNo The line the message came from.
+     * @param message The formatted message.
+     */
+    virtual void onTrace(const char* filename, int lineNo,
+        const char* message)=0;
+  };
+
+  /**
+   * Attach a sink, or detach the current one if sink is null.  The
+   * caller keeps ownership, and must keep the sink alive until some
+   * time after it is detached and no thread can still be inside it.
+   */
+  static void setSink(Sink* sink);
+  /** @return the attached sink, or null. */
+  static Sink* getSink();
+
+  /**
+   * @return a sink, never destroyed, that forwards messages to the
+   *   "io.humble.trace" Logger at Logger::LEVEL_TRACE.
+   */
+  static Sink* getLoggerSink();
+
+  /**
+   * The run time gate.
+   * @return true if a sink is attached.
+   */
+  static inline bool isEnabled() {
+    return __atomic_load_n(&sEnabled, __ATOMIC_RELAXED) != 0;
+  }
+
+  /**
+   * Format a message and hand it to the attached sink, if any.  Use
+   * the VS_TRACE macros rather than calling this directly.
+   */
+  static void trace(const char* filename, int lineNo, const char* format, ...)
+#ifdef __GNUC__
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+  static void traceVA(const char* filename, int lineNo, const char* format,
+      va_list ap);
+
+  /** The longest message, in bytes; longer ones are truncated. */
+  static const int MAX_MESSAGE_LENGTH=1024;
+
+private:
+  Trace();
+  static int32_t sEnabled;
+  static Sink* sSink;
+};
+
+}}}
+
+/*
+ * VS_TRACE_IS_ENABLED() : true if trace sites should do any work.
+ * VS_TRACE(...) : format and emit a message if enabled.
+ * VS_TRACE_EMIT(...) : format and emit a message; only call this
+ *   inside an if (VS_TRACE_IS_ENABLED()) block.
+ */
+#ifdef VS_TRACE_DISABLED
+#define VS_TRACE_IS_ENABLED() false
+#else
+#define VS_TRACE_IS_ENABLED() io::humble::ferry::Trace::isEnabled()
+#endif // VS_TRACE_DISABLED
+
+#define VS_TRACE_EMIT(...) \
+  io::humble::ferry::Trace::trace(__FILE__, __LINE__, __VA_ARGS__)
+
+#define VS_TRACE(...) \
+  do { \
+    if (VS_TRACE_IS_ENABLED()) \
+      VS_TRACE_EMIT(__VA_ARGS__); \
+  } while(0)
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,341 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <exception>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/HumbleException.h>
+#include <io/humble/ferry/CancellationToken.h>
+#include <io/humble/ferry/JNIHelper.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/BulkProbe.h>
+#include <io/humble/video/Demuxer.h>
+#include <io/humble/video/Global.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE.BulkProbe);
+
+using namespace io::humble::ferry;
+
+namespace io {
+namespace humble {
+namespace video {
+
+/** More threads than this just queue up on the same disks. */
+static const int32_t cMaxThreads = 256;
+
+static int64_t
+nowMicros()
+{
+  struct timeval now;
+  gettimeofday(&now, 0);
+  return now.tv_sec * 1000000LL + now.tv_usec;
+}
+
+BulkProbe::BulkProbe() {
+  mConcurrency = 1;
+  mTimeout = 0;
+  mNextFile = 0;
+  mRunning = false;
+  pthread_mutex_init(&mLock, 0);
+}
+
+BulkProbe::~BulkProbe() {
+  pthread_mutex_destroy(&mLock);
+}
+
+BulkProbe*
+BulkProbe::make(int32_t concurrency) {
+  if (concurrency <= 0)
+    VS_THROW(HumbleInvalidArgument("concurrency must be > 0"));
+  BulkProbe* retval = new BulkProbe();
+  VS_REF_ACQUIRE(retval);
+  retval->mConcurrency = concurrency;
+  return retval;
+}
+
+int32_t
+BulkProbe::add(const char* url) {
+  if (!url || !*url)
+    VS_THROW(HumbleInvalidArgument("no url passed in"));
+  FileSummary file;
+  file.url = url;
+  file.probed = false;
+  file.timedOut = false;
+  file.probeTime = 0;
+  file.duration = Global::NO_PTS;
+  file.startTime = Global::NO_PTS;
+  file.bitRate = 0;
+  pthread_mutex_lock(&mLock);
+  bool running = mRunning;
+  int32_t retval = (int32_t) mFiles.size();
+  try {
+    if (!running)
+      mFiles.push_back(file);
+  } catch (...) {
+    pthread_mutex_unlock(&mLock);
+    throw;
+  }
+  pthread_mutex_unlock(&mLock);
+  if (running)
+    VS_THROW(HumbleRuntimeError("cannot add files while running"));
+  return retval;
+}
+
+int32_t
+BulkProbe::run() {
+  pthread_mutex_lock(&mLock);
+  bool running = mRunning;
+  mRunning = true;
+  int32_t numFiles = getNumFiles();
+  pthread_mutex_unlock(&mLock);
+  if (running)
+    VS_THROW(HumbleRuntimeError("already running"));
+
+  int32_t numThreads = mConcurrency < numFiles ? mConcurrency : numFiles;
+  if (numThreads > cMaxThreads)
+    numThreads = cMaxThreads;
+  mNextFile = 0;
+
+  std::vector<pthread_t> threads;
+  try {
+    threads.resize(numThreads);
+  } catch (...) {
+    pthread_mutex_lock(&mLock);
+    mRunning = false;
+    pthread_mutex_unlock(&mLock);
+    throw;
+  }
+  int32_t started = 0;
+  for(; started < numThreads; started++)
+    if (pthread_create(&threads[started], 0, BulkProbe::workerRun, this))
+      break;
+  if (started < numThreads)
+    VS_LOG_WARN("could only start %d of %d probe threads", started, numThreads);
+  // with no threads at all, probe on this one
+  if (!started)
+    workerLoop();
+  for(int32_t i = 0; i < started; i++)
+    pthread_join(threads[i], 0);
+
+  int32_t retval = 0;
+  for(int32_t i = 0; i < numFiles; i++)
+    if (mFiles[i].probed)
+      ++retval;
+  pthread_mutex_lock(&mLock);
+  mRunning = false;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+void*
+BulkProbe::workerRun(void* arg) {
+  static_cast<BulkProbe*>(arg)->workerLoop();
+
+  // Java custom IO handlers attach this thread to the JVM; let it go.
+  JNIHelper* helper = JNIHelper::getHelper();
+  JavaVM* vm = helper ? helper->getVM() : 0;
+  JNIEnv* env = 0;
+  if (vm && vm->GetEnv((void**)(void*)&env, JNI_VERSION_1_2) == JNI_OK)
+    vm->DetachCurrentThread();
+  return 0;
+}
+
+void
+BulkProbe::workerLoop() {
+  int32_t numFiles = getNumFiles();
+  int32_t next;
+  while ((next = __atomic_fetch_add(&mNextFile, 1, __ATOMIC_RELAXED)) < numFiles)
+    probe(&mFiles[next]);
+}
+
+void
+BulkProbe::probe(FileSummary* file) {
+  file->probed = false;
+  file->timedOut = false;
+  file->error.clear();
+  file->format.clear();
+  file->duration = Global::NO_PTS;
+  file->startTime = Global::NO_PTS;
+  file->bitRate = 0;
+  file->streams.clear();
+
+  int64_t start = nowMicros();
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  if (mTimeout > 0)
+    token->setTimeout(mTimeout);
+  RefPointer<Demuxer> demuxer;
+  try {
+    demuxer = Demuxer::make();
+    // the demuxer's interrupt callback checks this, so a file that stalls
+    // in FFmpeg's I/O gives up once the deadline passes
+    demuxer->setCancellationToken(token.value());
+    demuxer->open(file->url.c_str(), 0, false, true, 0, 0);
+
+    AVFormatContext* ctx = demuxer->getFormatCtx();
+    if (ctx->iformat && ctx->iformat->name)
+      file->format = ctx->iformat->name;
+    if (ctx->duration != AV_NOPTS_VALUE)
+      file->duration = ctx->duration;
+    if (ctx->start_time != AV_NOPTS_VALUE)
+      file->startTime = ctx->start_time;
+    file->bitRate = ctx->bit_rate;
+    file->streams.resize(ctx->nb_streams);
+    for(uint32_t i = 0; i < ctx->nb_streams; i++) {
+      AVStream* st = ctx->streams[i];
+      StreamSummary* stream = &file->streams[i];
+      stream->type = st->codec->codec_type;
+      stream->codecId = st->codec->codec_id;
+      stream->width = st->codec->width;
+      stream->height = st->codec->height;
+      stream->sampleRate = st->codec->sample_rate;
+      stream->channels = st->codec->channels;
+      stream->timeBaseNum = st->time_base.num;
+      stream->timeBaseDen = st->time_base.den;
+    }
+    file->probed = true;
+    demuxer->close();
+  } catch (std::exception & e) {
+    file->error = e.what();
+    if (!file->probed)
+      file->streams.clear();
+    VS_LOG_DEBUG("could not probe %s: %s", file->url.c_str(), e.what());
+  }
+  file->timedOut = !file->probed && token->isTimedOut();
+  if (file->timedOut)
+    file->error = "timed out";
+  file->probeTime = nowMicros() - start;
+}
+
+BulkProbe::FileSummary*
+BulkProbe::getFile(int32_t file) {
+  pthread_mutex_lock(&mLock);
+  bool running = mRunning;
+  pthread_mutex_unlock(&mLock);
+  if (running)
+    VS_THROW(HumbleRuntimeError("cannot read results while running"));
+  if (file < 0 || file >= getNumFiles())
+    VS_THROW(HumbleInvalidArgument("file out of range"));
+  return &mFiles[file];
+}
+
+BulkProbe::StreamSummary*
+BulkProbe::getStream(int32_t file, int32_t stream) {
+  FileSummary* summary = getFile(file);
+  if (stream < 0 || stream >= (int32_t) summary->streams.size())
+    VS_THROW(HumbleInvalidArgument("stream out of range"));
+  return &summary->streams[stream];
+}
+
+const char*
+BulkProbe::getURL(int32_t file) {
+  return getFile(file)->url.c_str();
+}
+
+bool
+BulkProbe::isProbed(int32_t file) {
+  return getFile(file)->probed;
+}
+
+const char*
+BulkProbe::getErrorMessage(int32_t file) {
+  FileSummary* summary = getFile(file);
+  return summary->error.empty() ? 0 : summary->error.c_str();
+}
+
+bool
+BulkProbe::isTimedOut(int32_t file) {
+  return getFile(file)->timedOut;
+}
+
+int64_t
+BulkProbe::getProbeTime(int32_t file) {
+  return getFile(file)->probeTime;
+}
+
+const char*
+BulkProbe::getFormatName(int32_t file) {
+  FileSummary* summary = getFile(file);
+  return summary->format.empty() ? 0 : summary->format.c_str();
+}
+
+int64_t
+BulkProbe::getDuration(int32_t file) {
+  return getFile(file)->duration;
+}
+
+int64_t
+BulkProbe::getStartTime(int32_t file) {
+  return getFile(file)->startTime;
+}
+
+int32_t
+BulkProbe::getBitRate(int32_t file) {
+  return getFile(file)->bitRate;
+}
+
+int32_t
+BulkProbe::getNumStreams(int32_t file) {
+  return (int32_t) getFile(file)->streams.size();
+}
+
+MediaDescriptor::Type
+BulkProbe::getStreamType(int32_t file, int32_t stream) {
+  return (MediaDescriptor::Type) getStream(file, stream)->type;
+}
+
+Codec::ID
+BulkProbe::getStreamCodecID(int32_t file, int32_t stream) {
+  return (Codec::ID) getStream(file, stream)->codecId;
+}
+
+int32_t
+BulkProbe::getStreamWidth(int32_t file, int32_t stream) {
+  return getStream(file, stream)->width;
+}
+
+int32_t
+BulkProbe::getStreamHeight(int32_t file, int32_t stream) {
+  return getStream(file, stream)->height;
+}
+
+int32_t
+BulkProbe::getStreamSampleRate(int32_t file, int32_t stream) {
+  return getStream(file, stream)->sampleRate;
+}
+
+int32_t
+BulkProbe::getStreamChannels(int32_t file, int32_t stream) {
+  return getStream(file, stream)->channels;
+}
+
+int32_t
+BulkProbe::getStreamTimeBaseNumerator(int32_t file, int32_t stream) {
+  return getStream(file, stream)->timeBaseNum;
+}
+
+int32_t
+BulkProbe::getStreamTimeBaseDenominator(int32_t file, int32_t stream) {
+  return getStream(file, stream)->timeBaseDen;
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
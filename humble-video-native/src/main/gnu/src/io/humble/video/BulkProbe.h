@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef BULKPROBE_H_
+#define BULKPROBE_H_
+
+#include <io/humble/ferry/RefCounted.h>
+#include <io/humble/video/Codec.h>
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * Probes many media files at once and keeps a compact summary of each.
+ * <p>
+ * Opening a file and querying its streams with a Demuxer mostly waits on
+ * I/O, so probing a catalog one file at a time leaves the machine idle.
+ * Add the URLs with #add(String), then #run() opens each one and reads
+ * its stream meta data on a pool of native threads, #getConcurrency() at
+ * a time.
+ * </p><p>
+ * The results are read back by file and stream number, for example
+ * #getDuration(int) or #getStreamCodecID(int, int), so no Java objects
+ * are made per file or per stream.  Each file gets at most
+ * #getTimeout() microseconds; a file that takes longer is abandoned
+ * through FFmpeg's I/O interrupt callback and reported by
+ * #isTimedOut(int).
+ * </p><p>
+ * Each file is opened with a Demuxer, so custom protocols and the probe
+ * cache (see Global#setProbeCacheCapacity(int)) work as they do for a
+ * single file.
+ * </p>
+ */
+class VS_API_HUMBLEVIDEO BulkProbe : public io::humble::ferry::RefCounted
+{
+public:
+  /**
+   * Make an empty BulkProbe.
+   *
+   * @param concurrency How many files to probe at once; must be > 0.
+   */
+  static BulkProbe* make(int32_t concurrency);
+
+  /**
+   * @return How many files are probed at once.
+   */
+  int32_t getConcurrency() { return mConcurrency; }
+
+  /**
+   * Set the most time each file may take to open and probe.
+   *
+   * @param microseconds The time limit; 0 or less means no limit, the
+   *   default.
+   */
+  void setTimeout(int64_t microseconds) { mTimeout = microseconds; }
+
+  /**
+   * @return The time limit for each file in microseconds, or 0 for none.
+   */
+  int64_t getTimeout() { return mTimeout; }
+
+  /**
+   * Add a file to probe.
+   *
+   * @param url The URL to open, as for Demuxer#open.
+   * @return The number of the file, used to read its results.
+   * @throws HumbleRuntimeError if #run() is in progress.
+   */
+  int32_t add(const char* url);
+
+  /**
+   * @return The number of files added.
+   */
+  int32_t getNumFiles() { return (int32_t) mFiles.size(); }
+
+  /**
+   * Probe every file added, replacing any results from an earlier run.
+   * Blocks until all files are done.  Files cannot be added, and results
+   * cannot be read, from other threads until it returns.
+   *
+   * @return The number of files that were probed without error.
+   * @throws HumbleRuntimeError if #run() is already in progress.
+   */
+  int32_t run();
+
+  /**
+   * @return The URL of the given file.
+   */
+  const char* getURL(int32_t file);
+
+  /**
+   * @return true if the file was opened and probed.
+   */
+  bool isProbed(int32_t file);
+
+  /**
+   * @return Why the file could not be probed, or null if it was.
+   */
+  const char* getErrorMessage(int32_t file);
+
+  /**
+   * @return true if the file ran out of time.
+   */
+  bool isTimedOut(int32_t file);
+
+  /**
+   * @return How long opening and probing the file took, in microseconds.
+   */
+  int64_t getProbeTime(int32_t file);
+
+  /**
+   * @return The short name of the file's format, or null if it could not
+   *   be opened.
+   */
+  const char* getFormatName(int32_t file);
+
+  /**
+   * @return The file's duration in microseconds, or Global#NO_PTS if
+   *   unknown.
+   */
+  int64_t getDuration(int32_t file);
+
+  /**
+   * @return The file's start time in microseconds, or Global#NO_PTS if
+   *   unknown.
+   */
+  int64_t getStartTime(int32_t file);
+
+  /**
+   * @return The file's bit rate in bits per second, or 0 if unknown.
+   */
+  int32_t getBitRate(int32_t file);
+
+  /**
+   * @return The number of streams in the file; 0 if it could not be
+   *   probed.
+   */
+  int32_t getNumStreams(int32_t file);
+
+  /**
+   * @return The type of media in the given stream.
+   */
+  MediaDescriptor::Type getStreamType(int32_t file, int32_t stream);
+
+  /**
+   * @return The codec of the given stream.
+   */
+  Codec::ID getStreamCodecID(int32_t file, int32_t stream);
+
+  /**
+   * @return The width in pixels of a video stream, or 0.
+   */
+  int32_t getStreamWidth(int32_t file, int32_t stream);
+
+  /**
+   * @return The height in pixels of a video stream, or 0.
+   */
+  int32_t getStreamHeight(int32_t file, int32_t stream);
+
+  /**
+   * @return The sample rate of an audio stream, or 0.
+   */
+  int32_t getStreamSampleRate(int32_t file, int32_t stream);
+
+  /**
+   * @return The number of channels in an audio stream, or 0.
+   */
+  int32_t getStreamChannels(int32_t file, int32_t stream);
+
+  /**
+   * @return The numerator of the given stream's time base.
+   */
+  int32_t getStreamTimeBaseNumerator(int32_t file, int32_t stream);
+
+  /**
+   * @return The denominator of the given stream's time base.
+   */
+  int32_t getStreamTimeBaseDenominator(int32_t file, int32_t stream);
+
+#ifndef SWIG
+  /** What run() keeps for each stream. */
+  typedef struct StreamSummary {
+    int32_t type;
+    int32_t codecId;
+    int32_t width;
+    int32_t height;
+    int32_t sampleRate;
+    int32_t channels;
+    int32_t timeBaseNum;
+    int32_t timeBaseDen;
+  } StreamSummary;
+
+  /** What run() keeps for each file. */
+  typedef struct FileSummary {
+    std::string url;
+    std::string format;
+    bool probed;
+    std::string error;
+    bool timedOut;
+    int64_t probeTime;
+    int64_t duration;
+    int64_t startTime;
+    int32_t bitRate;
+    std::vector<StreamSummary> streams;
+  } FileSummary;
+#endif // ! SWIG
+
+protected:
+  BulkProbe();
+  virtual
+  ~BulkProbe();
+
+private:
+  static void* workerRun(void* arg);
+  void workerLoop();
+  void probe(FileSummary* file);
+  FileSummary* getFile(int32_t file);
+  StreamSummary* getStream(int32_t file, int32_t stream);
+
+  int32_t mConcurrency;
+  int64_t mTimeout;
+  std::vector<FileSummary> mFiles;
+  /** The next file a worker should take; only used during run(). */
+  volatile int32_t mNextFile;
+  /** Guards mRunning, and mFiles against add() while not running. */
+  pthread_mutex_t mLock;
+  /** Whether run() is in progress; mFiles may not change or be read. */
+  bool mRunning;
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* BULKPROBE_H_ */
@@ -29,6 +29,7 @@
 #include <io/humble/video/KeyValueBagImpl.h>
 #include <io/humble/video/MediaAudio.h>
 #include <io/humble/video/MediaPicture.h>
+#include <io/humble/video/RationalImpl.h>
 
 VS_LOG_SETUP(VS_CPP_PACKAGE.Coder);
 
@@ -42,6 +43,8 @@ Coder::Coder(Codec* codec, AVCodecContext* src, bool copySrc) {
   if (!codec)
     throw HumbleInvalidArgument("no codec passed in");
   mCodec.reset(codec, true);
+  mTimebaseSource.num = 0;
+  mTimebaseSource.den = 0;
 
   if (!src) {
     mCtx = avcodec_alloc_context3(codec->getCtx());
@@ -138,8 +141,14 @@ Coder::open(KeyValueBag* inputOptions, KeyValueBag* aUnsetOptions) {
 
 Rational*
 Coder::getTimeBase() {
-  if (!mTimebase || mTimebase->getNumerator() != mCtx->time_base.num || mTimebase->getDenominator() != mCtx->time_base.den)
-    mTimebase = Rational::make(mCtx->time_base.num, mCtx->time_base.den);
+  // compare against what the context held when we made mTimebase, not
+  // mTimebase itself; Rationals are reduced and the context's value may
+  // not be.
+  if (!mTimebase || mTimebaseSource.num != mCtx->time_base.num || mTimebaseSource.den != mCtx->time_base.den)
+  {
+    mTimebase = RationalImpl::intern(mCtx->time_base);
+    mTimebaseSource = mCtx->time_base;
+  }
   return mTimebase.get();
 }
 
@@ -152,6 +161,7 @@ Coder::setTimeBase(Rational* newTimeBase) {
   mTimebase.reset(newTimeBase, true);
   mCtx->time_base.num = newTimeBase->getNumerator();
   mCtx->time_base.den = newTimeBase->getDenominator();
+  mTimebaseSource = mCtx->time_base;
 }
 
 int
@@ -163,7 +173,7 @@ Coder::getBuffer(struct AVCodecContext *s, AVFrame *frame, int flags) {
   if (!(coder->mCodec->getCapabilities() & Codec::CAP_DR1))
     return avcodec_default_get_buffer2(s, frame, flags);
 
-  return coder->prepareFrame(frame, flags);
+  return coder->prepareFrame(s, frame, flags);
 }
 
 int32_t
@@ -284,6 +294,43 @@ Coder::setFlag2(Flag2 flag, bool value)
   }
 }
 
+void
+Coder::setThreadCount(int32_t count)
+{
+  if (count < 0)
+    VS_THROW(HumbleInvalidArgument("thread count must be >= 0"));
+  if (getState() != STATE_INITED)
+    VS_THROW(HumbleRuntimeError("Cannot set thread count after coder is opened"));
+  mCtx->thread_count = count;
+}
+
+void
+Coder::setThreadType(ThreadType type)
+{
+  if (getState() != STATE_INITED)
+    VS_THROW(HumbleRuntimeError("Cannot set thread type after coder is opened"));
+  mCtx->thread_type = type;
+}
+
+Coder::ThreadType
+Coder::getActiveThreadType()
+{
+  if (getState() == STATE_INITED)
+    return THREAD_NONE;
+  return (ThreadType)mCtx->active_thread_type;
+}
+
+int32_t
+Coder::getThreadDelay()
+{
+  if (!(getActiveThreadType() & THREAD_FRAME))
+    return 0;
+  // FFmpeg starts returning frames one packet early for FFV1
+  int32_t retval = mCtx->thread_count - 1;
+  if (mCtx->codec_id == AV_CODEC_ID_FFV1)
+    --retval;
+  return retval > 0 ? retval : 0;
+}
 
 } /* namespace video */
 } /* namespace humble */
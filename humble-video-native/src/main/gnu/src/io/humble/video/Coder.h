@@ -133,6 +133,24 @@ public:
 
   } Flag2;
 
+  /**
+   * The ways a Coder may split its work across threads. Values may be
+   * or-ed together; the Codec picks the best of those it supports.
+   */
+  typedef enum ThreadType {
+    /** Do all the work on the calling thread. */
+    THREAD_NONE = 0,
+    /**
+     * Work on several frames at once. Scales well, but a decoder holds
+     * back output by one frame per extra thread; see #getThreadDelay().
+     */
+    THREAD_FRAME = FF_THREAD_FRAME,
+    /** Work on several slices of one frame at once. Adds no delay. */
+    THREAD_SLICE = FF_THREAD_SLICE,
+    /** Use whichever of the above the Codec supports. */
+    THREAD_FRAME_AND_SLICE = FF_THREAD_FRAME | FF_THREAD_SLICE,
+  } ThreadType;
+
   /**
    * Open this Coder, using the given bag of Codec-specific options.
    *
@@ -351,6 +369,55 @@ public:
    */
   virtual void setFlag2(Flag2 flag, bool value);
 
+  /**
+   * Set how many threads this Coder may use. Coders use one thread
+   * unless told otherwise.
+   *
+   * @param count The number of threads, or 0 to use one per CPU
+   *   (plus one, so a thread waiting on memory does not idle a core).
+   * @throws InvalidArgument if count is negative.
+   * @throws RuntimeException if this Coder is already open.
+   */
+  virtual void setThreadCount(int32_t count);
+
+  /**
+   * Before open, the thread count asked for (0 meaning one per CPU); after
+   * open, the number of threads actually in use.
+   */
+  virtual int32_t getThreadCount() { return mCtx->thread_count; }
+
+  /**
+   * Set which kinds of threading this Coder may use. The default is
+   * #THREAD_FRAME_AND_SLICE. Low latency callers, such as a live player,
+   * may prefer #THREAD_SLICE.
+   *
+   * @throws RuntimeException if this Coder is already open.
+   */
+  virtual void setThreadType(ThreadType type);
+
+  /**
+   * The kinds of threading this Coder may use.
+   */
+  virtual ThreadType getThreadType() { return (ThreadType)mCtx->thread_type; }
+
+  /**
+   * The kind of threading this Coder actually uses, which depends on
+   * the Codec and the thread count. #THREAD_NONE until opened.
+   */
+  virtual ThreadType getActiveThreadType();
+
+  /**
+   * The number of packets a frame-threaded Decoder takes in before it
+   * returns its first frame, and so the number of frames it still holds
+   * when the input runs out. Always 0 before open and when frame
+   * threading is not active.
+   * <p>
+   * Those frames only come out if the Decoder is drained by passing null
+   * packets until no complete frame comes back.
+   * </p>
+   */
+  virtual int32_t getThreadDelay();
+
 #ifndef SWIG
   virtual void* getCtx() { return getCodecCtx(); }
   virtual AVCodecContext* getCodecCtx() { return mCtx; }
@@ -359,10 +426,11 @@ public:
 protected:
   virtual void setState(State state);
   /*
-   * Override to make a more specific allocator for frames.
+   * Override to make a more specific allocator for frames. ctx is the
+   * context asking, which for frame threads is a copy of ours.
    */
-  virtual int prepareFrame(AVFrame* frame, int flags) {
-    return avcodec_default_get_buffer2(mCtx, frame, flags);
+  virtual int prepareFrame(AVCodecContext* ctx, AVFrame* frame, int flags) {
+    return avcodec_default_get_buffer2(ctx, frame, flags);
   }
   Coder(Codec* codec, AVCodecContext* src, bool copySrc);
   virtual
@@ -385,6 +453,8 @@ private:
 
   io::humble::ferry::RefPointer<Codec> mCodec;
   io::humble::ferry::RefPointer<Rational> mTimebase;
+  // the mCtx->time_base that mTimebase was made from
+  AVRational mTimebaseSource;
 
   State mState;
 };
@@ -51,6 +51,16 @@ Container::~Container() {
   VS_LOG_TRACE("Destroyed: %p");
 }
 
+void
+Container::setCancellationToken(CancellationToken* token) {
+  mCancellationToken.reset(token, true);
+}
+
+CancellationToken*
+Container::getCancellationToken() {
+  return mCancellationToken.get();
+}
+
 int
 Container::url_read(void*h, unsigned char* buf, int size) {
   int retval = -1;
@@ -97,6 +107,7 @@ Container::Stream::Stream(Container* container, int32_t index) {
   mIndex = index;
   mLastDts = Global::NO_PTS;
   mCachedCtx = 0;
+  mCoderChecked = false;
   mCtx = mContainer->getFormatCtx()->streams[index];
 }
 
@@ -115,6 +126,23 @@ Container::Stream::getCoder() {
   if (!mCoder && ctx->oformat) {
       VS_THROW(HumbleRuntimeError("Got null encoder on MuxerStream which should not be possible"));
   }
+  if (!mCoder && !mCoderChecked && ctx->iformat) {
+    // Decoders are made the first time someone asks, so streams a caller
+    // never reads (or has deselected) cost nothing. Some streams will have
+    // no decoder available.
+    mCoderChecked = true;
+    RefPointer<Codec> codec = Codec::findDecodingCodec((Codec::ID)stream->codec->codec_id);
+    if (codec) {
+      // make a copy of the decoder so we decouple it from the container
+      // completely
+      mCoder = Decoder::make(codec.value(), stream->codec, true);
+    } else {
+      VS_LOG_DEBUG("noDecoderAvailable Container@%p[i=%"PRId32";codec_id:%"PRId32"];",
+                   mContainer,
+                   stream->index,
+                   stream->codec->codec_id);
+    }
+  }
   return mCoder.get();
 }
 
@@ -167,31 +195,13 @@ Container::doSetupStreams() {
     // now let's initialize our stream object.
     Stream* stream = new Stream(this, i);
     mStreams.push_back(stream);
-    if (ctx->iformat) {
-      // if a input format, we try to set up the decoder objects here. Some streams
-      // will have no decoder objects available.
-      RefPointer<Codec> codec = Codec::findDecodingCodec((Codec::ID)avStream->codec->codec_id);
-      RefPointer<Coder> coder;
-      if (codec) {
-        // make a copy of the decoder so we decouple it from the container
-        // completely
-        coder = Decoder::make(codec.value(), avStream->codec, true);
-        stream->setCoder(coder.value());
-      } else {
-        VS_LOG_DEBUG("noDecoderAvailable Container@%p[i=%"PRId32";codec_id:%"PRId32"];",
-                     this,
-                     avStream->index,
-                     avStream->codec->codec_id);
-      }
 #ifdef VS_DEBUG
-      VS_LOG_TRACE("newStreamFound Container@%p[i=%"PRId32";c=%p;tb=%"PRId32"/%"PRId32";]",
-                   this,
-                   (int32_t)avStream->index,
-                   coder.value(),
-                   (int32_t)avStream->time_base.num,
-                   (int32_t)avStream->time_base.den);
+    VS_LOG_TRACE("newStreamFound Container@%p[i=%"PRId32";tb=%"PRId32"/%"PRId32";]",
+                 this,
+                 (int32_t)avStream->index,
+                 (int32_t)avStream->time_base.num,
+                 (int32_t)avStream->time_base.den);
 #endif
-    }
   }
 }
 
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include <io/humble/ferry/HumbleException.h>
+#include <io/humble/ferry/CancellationToken.h>
 #include <io/humble/video/HumbleVideo.h>
 #include <io/humble/video/Rational.h>
 #include <io/humble/video/Property.h>
@@ -97,7 +98,38 @@ public:
   virtual int32_t
   getNumStreams();
 
+  /**
+   * Attach a token that cancels this container's blocking methods.
+   * <p>
+   * While a token is attached, FFmpeg's I/O loops and Humble Video check
+   * only the token, and never ask Java whether the thread was
+   * interrupted.  To have Thread#interrupt() still stop a blocked call, see
+   * CancellationToken#bridgeInterrupts().
+   * </p><p>
+   * Do not change the token while another thread is using this container.
+   * </p>
+   *
+   * @param token The token to check, or null to go back to checking
+   *   whether the calling thread has been interrupted.
+   */
+  virtual void
+  setCancellationToken(io::humble::ferry::CancellationToken* token);
+
+  /**
+   * @return The token set with #setCancellationToken(CancellationToken),
+   *   or null.
+   */
+  virtual io::humble::ferry::CancellationToken*
+  getCancellationToken();
+
 #ifndef SWIG
+  /**
+   * The attached token, without taking a reference.  Called from
+   * FFmpeg's interrupt callback.
+   */
+  io::humble::ferry::CancellationToken*
+  peekCancellationToken() { return mCancellationToken.value(); }
+
   virtual void* getCtx() { return getFormatCtx(); }
   virtual AVFormatContext* getFormatCtx()=0;
 
@@ -145,11 +177,16 @@ public:
     AVStream*
     getCtx() { return mCtx; }
 
+    /**
+     * The stream's Decoder or Encoder.  On a Demuxer the Decoder is made
+     * the first time this is called; null if no decoder is available.
+     */
     Coder*
     getCoder();
 
     void setCoder(Coder* coder) {
       mCoder.reset(coder, true);
+      mCoderChecked = true;
     }
     void popCoder() {
       AVStream* ctx = getCtx();
@@ -170,6 +207,8 @@ public:
     Container* mContainer;
     AVStream* mCtx;
     AVCodecContext *mCachedCtx;
+    /** Has getCoder already tried to make a decoder? */
+    bool mCoderChecked;
   };
   Stream* getStream(int32_t i);
   /** Temporarily caches the libavformat managed AVCodecContext objects
@@ -196,6 +235,7 @@ protected:
   void doSetupStreams();
 private:
   std::vector<Stream*> mStreams;
+  io::humble::ferry::RefPointer<io::humble::ferry::CancellationToken> mCancellationToken;
 
 };
 
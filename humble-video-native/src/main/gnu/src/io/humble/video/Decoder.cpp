@@ -27,12 +27,14 @@
 #include <io/humble/ferry/HumbleException.h>
 #include <io/humble/ferry/RefPointer.h>
 #include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/Trace.h>
 #include <io/humble/video/VideoExceptions.h>
 #include <io/humble/video/IndexEntryImpl.h>
 #include <io/humble/video/MediaAudio.h>
 #include <io/humble/video/MediaPictureImpl.h>
 #include <io/humble/video/MediaPacketImpl.h>
 #include <io/humble/video/MediaSubtitleImpl.h>
+#include <io/humble/video/PictureBufferPool.h>
 
 VS_LOG_SETUP(VS_CPP_PACKAGE.Decoder);
 
@@ -51,13 +53,25 @@ Decoder::Decoder(Codec* codec, AVCodecContext* src, bool copy) : Coder(codec, sr
 
   mSamplesSinceLastTimeStampDiscontinuity = 0;
   mAudioDiscontinuityStartingTimeStamp = Global::NO_PTS;
+  mDrained = false;
+  mFrame = av_frame_alloc();
+  if (!mFrame)
+    throw std::bad_alloc();
+
+  if (getCodecType() == MediaDescriptor::MEDIA_VIDEO) {
+    mPictureBuffers = PictureBufferPool::make();
+    // video allocation is safe on any thread, so frame threads need not
+    // wait on the caller's thread to get a picture.
+    getCodecCtx()->thread_safe_callbacks = 1;
+  }
 
-  VS_LOG_TRACE("Created: %p", this);
+  VS_TRACE("Created: %p", this);
 }
 
 
 Decoder::~Decoder() {
-  VS_LOG_TRACE("Destroyed: %p", this);
+  VS_TRACE("Destroyed: %p", this);
+  av_frame_free(&mFrame);
 }
 
 void
@@ -65,12 +79,49 @@ Decoder::flush() {
   if (getState() != STATE_OPENED)
     throw HumbleRuntimeError("Attempt to flush Decoder when not opened");
   avcodec_flush_buffers(getCodecCtx());
+  mDrained = false;
+}
+
+void
+Decoder::viewPacket(AVPacket* view, AVPacket* src, int32_t byteOffset) {
+  av_init_packet(view);
+  if (src) {
+    // shares src's data, buffer and side data; never free the view
+    *view = *src;
+    view->data = view->data + byteOffset;
+    view->size = view->size - byteOffset;
+  } else {
+    view->data = 0;
+    view->size = 0;
+  }
+}
+
+void
+Decoder::beginDecode(bool draining) {
+  if (draining || !mDrained)
+    return;
+  // FFmpeg decoders, frame-threaded ones above all, are not fit to take
+  // new packets once they have given up their last frame.
+  VS_LOG_TRACE("Flushing drained Decoder@%p before decoding", this);
+  avcodec_flush_buffers(getCodecCtx());
+  mDrained = false;
+}
+
+void
+Decoder::endDecode(bool draining, int32_t retval, int gotFrame) {
+  if (draining && retval >= 0 && !gotFrame)
+    mDrained = true;
 }
 
 int
-Decoder::prepareFrame(AVFrame* frame, int flags) {
-  if (!mCachedMedia)
-    return Coder::prepareFrame(frame, flags);
+Decoder::prepareFrame(AVCodecContext* ctx, AVFrame* frame, int flags) {
+  if (getCodecType() == MediaDescriptor::MEDIA_VIDEO && mPictureBuffers)
+    return mPictureBuffers->getBuffer(ctx, frame, flags);
+
+  // frame threads decode with copies of our context, and their frames
+  // may come out of a later call for different media.
+  if (!mCachedMedia || ctx != getCodecCtx())
+    return Coder::prepareFrame(ctx, frame, flags);
 
   switch (getCodecType()) {
   case MediaDescriptor::MEDIA_AUDIO: {
@@ -79,19 +130,14 @@ Decoder::prepareFrame(AVFrame* frame, int flags) {
         audio->getSampleRate() != frame->sample_rate ||
         audio->getChannelLayout() != frame->channel_layout ||
         audio->getFormat() != frame->format)
-      return Coder::prepareFrame(frame, flags);
+      return Coder::prepareFrame(ctx, frame, flags);
     av_frame_unref(frame);
     // reuse our audio frame.
     av_frame_ref(frame, audio->getCtx());
   }
   break;
-  case MediaDescriptor::MEDIA_VIDEO: {
-    // reusing video frames is too tricky given all the alignments; so we
-    // just let FFmpeg allocate it.
-    // adventurous souls can try changing this later.
-    return Coder::prepareFrame(frame, flags);
-  }
-  break;
+  case MediaDescriptor::MEDIA_VIDEO:
+    return Coder::prepareFrame(ctx, frame, flags);
   default:
     VS_LOG_ERROR("Got unknown codec type to allocate for");
     break;
@@ -99,6 +145,69 @@ Decoder::prepareFrame(AVFrame* frame, int flags) {
   return 0;
 }
 
+void
+Decoder::setPictureBufferPooling(bool pooled) {
+  if (getState() != STATE_INITED)
+    VS_THROW(HumbleRuntimeError("Cannot change picture buffer pooling after Decoder is opened"));
+  if (getCodecType() != MediaDescriptor::MEDIA_VIDEO)
+    return;
+  if (!pooled)
+    mPictureBuffers = 0;
+  else if (!mPictureBuffers)
+    mPictureBuffers = PictureBufferPool::make();
+}
+
+bool
+Decoder::isPictureBufferPooling() {
+  return mPictureBuffers.value() != 0;
+}
+
+int64_t
+Decoder::getPictureBufferPoolHits() {
+  return mPictureBuffers ? mPictureBuffers->getHits() : 0;
+}
+
+int64_t
+Decoder::getPictureBufferPoolMisses() {
+  return mPictureBuffers ? mPictureBuffers->getMisses() : 0;
+}
+
+int64_t
+Decoder::getPictureBufferPoolBytesRetained() {
+  return mPictureBuffers ? mPictureBuffers->getBytesRetained() : 0;
+}
+
+void
+Decoder::setSkipFrame(Discard discard) {
+  // frame threads pick this up from the context before every packet.
+  getCodecCtx()->skip_frame = (enum AVDiscard) discard;
+}
+
+Decoder::Discard
+Decoder::getSkipFrame() {
+  return (Discard) getCodecCtx()->skip_frame;
+}
+
+void
+Decoder::setSkipLoopFilter(Discard discard) {
+  getCodecCtx()->skip_loop_filter = (enum AVDiscard) discard;
+}
+
+Decoder::Discard
+Decoder::getSkipLoopFilter() {
+  return (Discard) getCodecCtx()->skip_loop_filter;
+}
+
+void
+Decoder::setSkipIDCT(Discard discard) {
+  getCodecCtx()->skip_idct = (enum AVDiscard) discard;
+}
+
+Decoder::Discard
+Decoder::getSkipIDCT() {
+  return (Discard) getCodecCtx()->skip_idct;
+}
+
 int64_t
 Decoder::rebase(int64_t ts, MediaPacket* packet) {
   if (!packet)
@@ -166,29 +275,17 @@ Decoder::decodeAudio(MediaAudio* output, MediaPacket* aPacket,
   // let's get the ffmpeg structures
   AVPacket* inPkt = packet ? packet->getCtx() : 0;
 
-  // now we're going to copy the inPkt to do the byte-offset stuff. This
-  // will copy by reference.
+  // FFmpeg only reads the packet, so a view that starts byteOffset bytes
+  // in will do; no need to copy it or take a reference.
   AVPacket tmp;
   AVPacket* pkt = &tmp;
-  av_init_packet(pkt);
-  if (inPkt) {
-    // copy in the actual packet
-    av_copy_packet(pkt, inPkt);
-    // now, adjust the data and size pointers
-    pkt->data = pkt->data + byteOffset;
-    pkt->size = pkt->size - byteOffset;
-  } else {
-    pkt->data = 0;
-    pkt->size = 0;
-  }
+  viewPacket(pkt, inPkt, byteOffset);
   // 'empty' out the input samples
   output->setComplete(false);
 
-  AVFrame *frame = av_frame_alloc();
-  if (!frame)
-    VS_THROW(HumbleBadAlloc());
+  AVFrame *frame = mFrame;
   /** DO NOT THROW EXCEPTIONS **/
-  // create a frame to decode into, so that FFmpeg doesn't get knickers
+  // decode into our own frame, so that FFmpeg doesn't get knickers
   // in a twist re: allocation; but we will attempt to re-use our output
   // frame by setting a call back that Coder::getBuffer2 will use.
 
@@ -196,9 +293,9 @@ Decoder::decodeAudio(MediaAudio* output, MediaPacket* aPacket,
   // reset the frame timestamp so ffmpeg doesn't get confused
   output->setTimeStamp(Global::NO_PTS);
   // try out decode
+  beginDecode(!inPkt);
   retval = avcodec_decode_audio4(getCodecCtx(), frame, &got_frame, pkt);
-  // always free the packet so that we don't have an exception make us leak it.
-  av_free_packet(pkt);
+  endDecode(!inPkt, retval, got_frame);
   if (got_frame) {
     RefPointer<Rational> coderBase = getTimeBase();
 
@@ -252,28 +349,27 @@ Decoder::decodeAudio(MediaAudio* output, MediaPacket* aPacket,
     // calculate the next time stamp based on the audio samples
     mSamplesSinceLastTimeStampDiscontinuity += frame->nb_samples;
 
-    // copy the output frame to our frame
-    output->copy(frame, true);
+    // hand our frame's references to the output; no new ones needed
+    output->move(frame, true);
     RefPointer<Rational> tb = getTimeBase();
     output->setTimeBase(tb.value());
   }
   // release the temporary reference
   mCachedMedia = 0;
   av_frame_unref(frame);
-  av_freep(&frame);
-
-#ifdef VS_DEBUG
-  char outDescr[256]; *outDescr = 0;
-  char inDescr[256]; *inDescr = 0;
-  if (aPacket) aPacket->logMetadata(inDescr, sizeof(inDescr));
-  if (output) output->logMetadata(outDescr, sizeof(outDescr));
-  VS_LOG_TRACE("decodeAudio Decoder@%p[out:%s;in:%s;offset:%lld;decoded:%" PRIi64,
-               this,
-               outDescr,
-               inDescr,
-               (int64_t)byteOffset,
-               (int64_t)retval);
-#endif
+
+  if (VS_TRACE_IS_ENABLED()) {
+    char outDescr[256]; *outDescr = 0;
+    char inDescr[256]; *inDescr = 0;
+    if (aPacket) aPacket->logMetadata(inDescr, sizeof(inDescr));
+    if (output) output->logMetadata(outDescr, sizeof(outDescr));
+    VS_TRACE_EMIT("decodeAudio Decoder@%p[out:%s;in:%s;offset:%" PRIi64 ";decoded:%" PRIi64 "]",
+                  this,
+                  outDescr,
+                  inDescr,
+                  (int64_t)byteOffset,
+                  (int64_t)retval);
+  }
 
   /** END DO NOT THROW EXCEPTIONS **/
   FfmpegException::check(retval, "Error while decoding ");
@@ -286,7 +382,6 @@ Decoder::decodeVideo(MediaPicture* aOutput, MediaPacket* aPacket,
   MediaPictureImpl* output = dynamic_cast<MediaPictureImpl*>(aOutput);
   MediaPacketImpl* packet = dynamic_cast<MediaPacketImpl*>(aPacket);
 
-  RefPointer<Codec> codec = getCodec();
   if (getCodecType() != MediaDescriptor::MEDIA_VIDEO)
     VS_THROW(HumbleRuntimeError("Attempting to decode video on non-video decoder"));
 
@@ -322,43 +417,38 @@ Decoder::decodeVideo(MediaPicture* aOutput, MediaPacket* aPacket,
   // let's get the ffmpeg structures
   AVPacket* inPkt = packet ? packet->getCtx() : 0;
 
-  // now we're going to copy the inPkt to do the byte-offset stuff. This
-  // will copy by reference.
+  // FFmpeg only reads the packet, so a view that starts byteOffset bytes
+  // in will do; no need to copy it or take a reference.
   AVPacket tmp;
   AVPacket* pkt = &tmp;
-  av_init_packet(pkt);
-  if (inPkt) {
-    // copy in the actual packet
-    av_copy_packet(pkt, inPkt);
-    // now, adjust the data and size pointers
-    pkt->data = pkt->data + byteOffset;
-    pkt->size = pkt->size - byteOffset;
-  } else {
-    pkt->data = 0;
-    pkt->size = 0;
-  }
+  viewPacket(pkt, inPkt, byteOffset);
   // 'empty' out the input samples
   output->setComplete(false);
 
-  AVFrame *frame = av_frame_alloc();
-  if (!frame)
-    VS_THROW(HumbleBadAlloc());
+  AVFrame *frame = mFrame;
   /** DO NOT THROW EXCEPTIONS **/
-  // create a frame to decode into, so that FFmpeg doesn't get knickers
+  // decode into our own frame, so that FFmpeg doesn't get knickers
   // in a twist re: allocation; but we will attempt to re-use our output
   // frame by setting a call back that Coder::getBuffer2 will use.
 
   mCachedMedia.reset(output, true);
   // try out decode
+  beginDecode(!inPkt);
   retval = avcodec_decode_video2(getCodecCtx(), frame, &got_frame, pkt);
-  // always free the packet so that we don't have an exception make us leak it.
-  av_free_packet(pkt);
+  endDecode(!inPkt, retval, got_frame);
   if (got_frame) {
     // never allow a video frame without a guessed best effort timestamp.
     if (frame->pts == Global::NO_PTS)
       frame->pts = frame->best_effort_timestamp;
-    // copy the output frame to our frame
-    output->copy(frame, true);
+    // hand our frame's references to the output; no new ones needed
+    output->move(frame, true);
+    // and let it hand out the Buffers we decoded into
+    AVFrame* decoded = output->getCtx();
+    for(int32_t i = 0; mPictureBuffers && i < AV_NUM_DATA_POINTERS && decoded->buf[i]; i++) {
+      RefPointer<Buffer> plane = mPictureBuffers->getBuffer(decoded->buf[i]);
+      if (plane)
+        output->setDataBuffer(i, plane.value());
+    }
     RefPointer<Rational> tb = getTimeBase();
     output->setTimeBase(tb.value());
     mSamplesSinceLastTimeStampDiscontinuity += 1;
@@ -366,20 +456,19 @@ Decoder::decodeVideo(MediaPicture* aOutput, MediaPacket* aPacket,
   // release the temporary reference
   mCachedMedia = 0;
   av_frame_unref(frame);
-  av_freep(&frame);
-
-#ifdef VS_DEBUG
-  char outDescr[256]; *outDescr = 0;
-  char inDescr[256]; *inDescr = 0;
-  if (aPacket) aPacket->logMetadata(inDescr, sizeof(inDescr));
-  if (aOutput) aOutput->logMetadata(outDescr, sizeof(outDescr));
-  VS_LOG_TRACE("decodeVideo Decoder@%p[out:%s;in:%s;offset:%lld;decoded:%" PRIi64,
-               this,
-               outDescr,
-               inDescr,
-               (int64_t)byteOffset,
-               (int64_t)retval);
-#endif
+
+  if (VS_TRACE_IS_ENABLED()) {
+    char outDescr[256]; *outDescr = 0;
+    char inDescr[256]; *inDescr = 0;
+    if (aPacket) aPacket->logMetadata(inDescr, sizeof(inDescr));
+    if (aOutput) aOutput->logMetadata(outDescr, sizeof(outDescr));
+    VS_TRACE_EMIT("decodeVideo Decoder@%p[out:%s;in:%s;offset:%" PRIi64 ";decoded:%" PRIi64 "]",
+                  this,
+                  outDescr,
+                  inDescr,
+                  (int64_t)byteOffset,
+                  (int64_t)retval);
+  }
   /** END DO NOT THROW EXCEPTIONS **/
   FfmpegException::check(retval, "Error while decoding ");
   return retval;
@@ -37,6 +37,10 @@ namespace io {
 namespace humble {
 namespace video {
 
+#ifndef SWIG
+class PictureBufferPool;
+#endif
+
 /**
  * Decodes MediaPacket objects into MediaAudio, MediaPicture or MediaSubtitle objects.
  */
@@ -64,6 +68,12 @@ public:
   /**
    * Flush this Decoder, getting rid of any cached packets (call after seek).
    * Next packet given to decode should be a key packet.
+   * <p>
+   * Frames still held back by frame threads are thrown away too; to get
+   * them out instead, drain the Decoder by decoding null packets until no
+   * complete frame comes back. Once drained, the next packet decoded
+   * flushes the Decoder first, so it too should be a key packet.
+   * </p>
    */
   virtual void flush();
 
@@ -101,6 +111,12 @@ public:
    * in memory managed by you, then pass in a MediaPicture allocated without
    * a buffer to DecodeVideo, and then copy that into your own media picture.
    * </p>
+   * <p>
+   * A frame-threaded Decoder (see Coder#setThreadCount(int32_t)) returns
+   * no picture for the first Coder#getThreadDelay() packets it is given,
+   * and holds back as many at the end; pass null packets until the
+   * picture is no longer complete to get them.
+   * </p>
    *
    * @param output The MediaPicture we decode. Caller must check if it is complete on return.
    * @param packet  The packet we're attempting to decode from.
@@ -133,6 +149,105 @@ public:
   virtual int32_t decode(MediaSampled * output,
       MediaPacket *packet, int32_t byteOffset);
 
+  /**
+   * Set whether a video Decoder decodes into memory it keeps and reuses
+   * once every MediaPicture using it lets go. It is on by default.
+   * <p>
+   * Pooled planes are laid out just as FFmpeg would lay them out, and
+   * MediaPicture#getData(int) returns the very Buffer the Decoder wrote
+   * into rather than a new one each call. A Buffer held on to is never
+   * written into again, so holding one is safe but defeats the pool.
+   * </p>
+   *
+   * @throws RuntimeException if this Decoder is already open.
+   */
+  virtual void setPictureBufferPooling(bool pooled);
+
+  /**
+   * @return Whether this Decoder pools picture memory. Always false for
+   *   a Decoder that is not for video.
+   */
+  virtual bool isPictureBufferPooling();
+
+  /**
+   * @return How many picture planes were served from the pool.
+   */
+  virtual int64_t getPictureBufferPoolHits();
+
+  /**
+   * @return How many picture planes had to be allocated because the pool
+   *   had none free.
+   */
+  virtual int64_t getPictureBufferPoolMisses();
+
+  /**
+   * @return The bytes of picture memory the pool holds waiting to be
+   *   reused.
+   */
+  virtual int64_t getPictureBufferPoolBytesRetained();
+
+  /**
+   * Which frames, or which parts of the work on a frame, a Decoder may
+   * skip. Each level skips everything the levels above it skip.
+   */
+  typedef enum Discard {
+    /** Skip nothing, not even empty packets. */
+    DISCARD_NONE = AVDISCARD_NONE,
+    /** Skip only useless packets, such as empty ones. The default. */
+    DISCARD_DEFAULT = AVDISCARD_DEFAULT,
+    /** Skip frames no other frame refers to. */
+    DISCARD_NONREF = AVDISCARD_NONREF,
+    /** Skip bidirectionally predicted frames. */
+    DISCARD_BIDIR = AVDISCARD_BIDIR,
+    /** Skip everything but intra frames. */
+    DISCARD_NONINTRA = AVDISCARD_NONINTRA,
+    /** Skip everything but key frames. */
+    DISCARD_NONKEY = AVDISCARD_NONKEY,
+    /** Skip everything. */
+    DISCARD_ALL = AVDISCARD_ALL,
+  } Discard;
+
+  /**
+   * Set which frames this Decoder skips without decoding. A skipped
+   * packet is consumed but no picture comes back for it.
+   * <p>
+   * With DISCARD_NONKEY a video Decoder only decodes key frames, which
+   * is all a thumbnail or scrubbing preview needs. How closely each level
+   * is honoured is up to the codec; H.264, MPEG-1/2/4 and VC-1 honour
+   * them all. May be changed at any time, even while decoding.
+   * </p>
+   */
+  virtual void setSkipFrame(Discard discard);
+
+  /**
+   * @return Which frames this Decoder skips.
+   */
+  virtual Discard getSkipFrame();
+
+  /**
+   * Set for which frames this Decoder skips the in-loop deblocking
+   * filter. Skipping it is much cheaper but leaves block edges visible,
+   * and the error carries into the frames predicted from them.
+   * May be changed at any time.
+   */
+  virtual void setSkipLoopFilter(Discard discard);
+
+  /**
+   * @return For which frames this Decoder skips the loop filter.
+   */
+  virtual Discard getSkipLoopFilter();
+
+  /**
+   * Set for which frames this Decoder skips the inverse transform, giving
+   * a rough picture for much less work. May be changed at any time.
+   */
+  virtual void setSkipIDCT(Discard discard);
+
+  /**
+   * @return For which frames this Decoder skips the inverse transform.
+   */
+  virtual Discard getSkipIDCT();
+
 
   /**
    * Decode this packet into output.
@@ -157,12 +272,21 @@ protected:
   virtual
   ~Decoder();
 
-  virtual int prepareFrame(AVFrame* frame, int flags);
+  virtual int prepareFrame(AVCodecContext* ctx, AVFrame* frame, int flags);
 private:
   int64_t rebase(int64_t ts, MediaPacket* packet);
+  static void viewPacket(AVPacket* view, AVPacket* src, int32_t byteOffset);
+  void beginDecode(bool draining);
+  void endDecode(bool draining, int32_t retval, int gotFrame);
   io::humble::ferry::RefPointer<MediaRaw> mCachedMedia;
   int64_t mAudioDiscontinuityStartingTimeStamp;
   int64_t mSamplesSinceLastTimeStampDiscontinuity;
+  /** What FFmpeg decodes into; kept empty between calls. */
+  AVFrame* mFrame;
+  /** Has a null packet come back without a frame since the last flush? */
+  bool mDrained;
+  /** Where video frames are decoded into, unless pooling is off. */
+  io::humble::ferry::RefPointer<PictureBufferPool> mPictureBuffers;
 };
 
 } /* namespace video */
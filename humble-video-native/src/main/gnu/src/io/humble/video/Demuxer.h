@@ -21,9 +21,11 @@
 #define DEMUXER_H_
 
 #include <io/humble/video/MediaPacket.h>
+#include <io/humble/video/MediaPacketBatch.h>
 #include <io/humble/video/Container.h>
 #include <io/humble/video/DemuxerStream.h>
 #include <io/humble/video/DemuxerFormat.h>
+#include <io/humble/video/IOStatistics.h>
 
 #include <io/humble/ferry/RefPointer.h>
 #include <io/humble/ferry/HumbleException.h>
@@ -115,6 +117,39 @@ public:
   virtual int32_t
   getInputBufferLength()=0;
 
+  /**
+   * Count and time every read and seek this Demuxer makes; see
+   * #getIOStatistics().  Works for customio protocols and for any
+   * protocol FFmpeg reads as a stream of bytes (file, http, tcp...), but
+   * not for formats that do their own networking, such as RTSP.
+   * <p>
+   * An instrumented Demuxer also tunes its buffer: unless
+   * #setInputBufferLength(int) was called, it opens with the length
+   * learned from earlier instrumented Demuxers on the same server (or,
+   * for local files, in the same directory), chosen to match how far
+   * they read between seeks.
+   * </p>
+   *
+   * @param instrumented Whether to instrument the next open.
+   * @throws RuntimeException if this Demuxer has already been opened.
+   */
+  virtual void
+  setIOInstrumented(bool instrumented)=0;
+
+  /**
+   * @return Whether I/O is (or will be, once opened) instrumented.
+   */
+  virtual bool
+  isIOInstrumented()=0;
+
+  /**
+   * @return A snapshot of this Demuxer's I/O so far, or the totals at
+   *   close if it has been closed; null if I/O was not instrumented.
+   *   Safe to call from any thread.
+   */
+  virtual IOStatistics*
+  getIOStatistics()=0;
+
   /**
    * Open this container and make it ready for reading, optionally
    * reading as far into the container as necessary to find all streams.
@@ -170,6 +205,71 @@ public:
   virtual DemuxerStream*
   getStream(int32_t streamIndex)=0;
 
+  /**
+   * Select or deselect a stream.
+   * <p>
+   * All streams start selected.  A deselected stream is discarded inside
+   * FFmpeg: #read(MediaPacket) never returns its packets, many formats
+   * (MP4 and MOV among them) skip over its data without reading it, and
+   * no Decoder is made for it.  Deselected streams are also ignored when
+   * #seek(int, long, long, long, int) looks for a place every active
+   * stream can start from.
+   * </p><p>
+   * Packets from a deselected stream already read ahead are dropped.
+   * </p>
+   *
+   * @param streamIndex The stream, from 0 to #getNumStreams()-1.
+   * @param selected true to read the stream; false to discard it.
+   */
+  virtual void
+  setStreamSelected(int32_t streamIndex, bool selected)=0;
+
+  /**
+   * @param streamIndex The stream, from 0 to #getNumStreams()-1.
+   * @return true unless the stream was deselected with
+   *   #setStreamSelected(int, boolean).
+   */
+  virtual bool
+  isStreamSelected(int32_t streamIndex)=0;
+
+  /**
+   * Select every stream of one media type, and deselect all the others.
+   * For example, pass MediaDescriptor.Type.MEDIA_AUDIO to extract only
+   * the audio from a movie.
+   *
+   * @param type The type of stream to keep.
+   * @return The number of streams selected.
+   */
+  virtual int32_t
+  selectStreams(MediaDescriptor::Type type)=0;
+
+  /**
+   * Have #read(MediaPacket) and #readBatch(MediaPacketBatch) return only
+   * the key packets of a stream and drop the rest.
+   * <p>
+   * A thumbnailer or scrubbing preview only needs key frames, and this
+   * keeps the rest from ever reaching a Decoder.  Formats that support it
+   * (AVI, FLV, ASF, RealMedia and NUT) skip over the dropped packets'
+   * data without reading it; others read them and throw them away.
+   * </p><p>
+   * Turning this on selects the stream if it was deselected, and
+   * #setStreamSelected(int, boolean) turns it off again.
+   * </p>
+   *
+   * @param streamIndex The stream, from 0 to #getNumStreams()-1.
+   * @param keyFramesOnly true to drop all but key packets; false to
+   *   return every packet.
+   */
+  virtual void
+  setKeyFramesOnly(int32_t streamIndex, bool keyFramesOnly)=0;
+
+  /**
+   * @param streamIndex The stream, from 0 to #getNumStreams()-1.
+   * @return true if only key packets are read from the stream.
+   */
+  virtual bool
+  isKeyFramesOnly(int32_t streamIndex)=0;
+
   /**
    * Reads the next packet in the Demuxer into the Packet.  This method will
    * release any buffers currently held by this packet and allocate
@@ -189,6 +289,30 @@ public:
   virtual int32_t
   read(MediaPacket *packet)=0;
 
+  /**
+   * Reads up to MediaPacketBatch#getCapacity() packets in one call.
+   * <p>
+   * Does the same work as calling #read(MediaPacket) once per packet,
+   * but crosses from Java to native code once per batch and looks up each
+   * stream's Coder and time base once per batch rather than once per
+   * packet, which matters when remuxing many small packets.
+   * </p><p>
+   * Reading stops early at end of file, on an error, or when a
+   * non-blocking source has nothing more yet.  If packets were read before
+   * an error, they are returned and the error is reported by the next
+   * read.
+   * </p>
+   *
+   * @param batch [In/Out] The batch to fill; MediaPacketBatch#getSize() is
+   *   set to the number of packets read.
+   *
+   * @return The number of packets read (0 if a non-blocking source had
+   *   none ready), or <0 at end of file.
+   * @throws RuntimeException if an error occurs and no packets were read.
+   */
+  virtual int32_t
+  readBatch(MediaPacketBatch *batch)=0;
+
   /**
    * Attempts to read all the meta data in this stream, potentially by reading ahead
    * and decoding packets.
@@ -198,11 +322,24 @@ public:
    * to get all meta data.  Take care when you call it.
    * </p><p>After this method is called, other meta data methods like #getDuration() should
    * work.</p>
+   * <p>
+   * If Global#setProbeCacheCapacity(int) has turned the probe cache on and
+   * this file was probed before, the earlier results are reused and
+   * nothing is read.
+   * </p>
    *
    */
   virtual void
   queryStreamMetaData()=0;
 
+  /**
+   * @return How long, in microseconds, the probe cache saved
+   *   #queryStreamMetaData() on this Demuxer: the time the original probe
+   *   took, or 0 if this Demuxer probed the file itself.
+   */
+  virtual int64_t
+  getProbeTimeSaved()=0;
+
   /**
    * Gets the duration, if known, of this container.
    *
@@ -317,6 +454,86 @@ public:
   virtual void
   setReadRetryCount(int32_t count)=0;
 
+  /**
+   * Turns background read-ahead on or off.
+   * <p>
+   * With read-ahead on, the first #read(MediaPacket) starts a native
+   * thread that keeps demuxing into a bounded queue, and #read(MediaPacket)
+   * takes packets from that queue, so a slow disk or network only stalls
+   * the caller once the queue runs dry.  The queue is full once any one of
+   * the limits is reached.
+   * </p><p>
+   * #seek(int, long, long, long, int) and #close() interrupt the read in
+   * progress rather than wait on a stalled source, and throw away the
+   * queue.  Other calls that need the container to themselves, such as
+   * #pause(), #setStreamSelected(int, boolean) and
+   * #queryStreamMetaData(), wait for the packet in progress so nothing
+   * is lost; pausing keeps the queue.  A custom protocol handler is only
+   * interrupted through its own CancellationToken.  While a read or one
+   * of those calls is waiting on the read-ahead thread, a
+   * CancellationToken set on this Demuxer (or Thread#interrupt()) still
+   * ends it.
+   * </p><p>
+   * Read-ahead is ignored for containers where
+   * #canStreamsBeAddedDynamically() is true.  Off by default.
+   * </p>
+   *
+   * @param maxPackets The most packets to queue.  <= 0 turns read-ahead
+   *   off; packets already queued are still returned first.
+   * @param maxBytes The most bytes of packet data to queue, or <= 0 for no
+   *   byte limit.
+   * @param maxDuration The most time, in microseconds, between the oldest
+   *   and newest queued packets, or <= 0 for no time limit.
+   */
+  virtual void
+  setReadAhead(int32_t maxPackets, int32_t maxBytes, int64_t maxDuration)=0;
+
+  /**
+   * @return The packet limit set by #setReadAhead(int, int, long); 0
+   *   if read-ahead is off.
+   */
+  virtual int32_t
+  getReadAheadMaxPackets()=0;
+
+  /**
+   * @return The byte limit set by #setReadAhead(int, int, long).
+   */
+  virtual int32_t
+  getReadAheadMaxBytes()=0;
+
+  /**
+   * @return The time limit set by #setReadAhead(int, int, long).
+   */
+  virtual int64_t
+  getReadAheadMaxDuration()=0;
+
+  /**
+   * @return The number of packets waiting in the read-ahead queue now.
+   */
+  virtual int32_t
+  getReadAheadQueuedPackets()=0;
+
+  /**
+   * @return The bytes of packet data waiting in the read-ahead queue now.
+   */
+  virtual int64_t
+  getReadAheadQueuedBytes()=0;
+
+  /**
+   * @return The number of times #read(MediaPacket) found the read-ahead
+   *   queue empty and had to wait.  If this keeps growing the source is
+   *   slower than the caller, or the queue is too small to hide its stalls.
+   */
+  virtual int64_t
+  getReadAheadEmptyStalls()=0;
+
+  /**
+   * @return The number of times the read-ahead thread found the queue full
+   *   and had to wait for the caller.
+   */
+  virtual int64_t
+  getReadAheadFullStalls()=0;
+
   /**
    * Can streams be added dynamically to this container?
    *
@@ -396,8 +613,8 @@ public:
    *
    * Seeking will be done so that the point from which all active streams
    * can be presented successfully will be closest to ts and within min/max_ts.
-   * Active streams are all streams that have Stream.getDiscardSetting <
-   * Codec.DISCARD_ALL.
+   * Active streams are all streams selected with
+   * #setStreamSelected(int, boolean).
    *
    * If flags contain SeekFlags.SEEK_BYTE, then all timestamps are in bytes and
    * are the file position (this may not be supported by all demuxers).
@@ -423,6 +640,55 @@ public:
   seek(int32_t stream_index, int64_t min_ts, int64_t ts,
       int64_t max_ts, int32_t flags)=0;
 
+  /**
+   * Reads the whole file, adding every keyframe to its stream's index
+   * (see ContainerStream#getIndexEntry(int)), and then seeks back to the
+   * start.
+   * <p>
+   * Formats with no index of their own (MPEG-TS, raw H.264, FLV without
+   * keyframe metadata) otherwise make #seek(int, long, long, long, int)
+   * scan the file.  Save the result with #saveSeekIndex(String) and
+   * later opens of the same file will seek by binary search instead.
+   * </p>
+   *
+   * @return The number of keyframes indexed.
+   * @throws RuntimeException if the Demuxer is not open, or a read fails.
+   */
+  virtual int32_t
+  buildSeekIndex()=0;
+
+  /**
+   * Writes the keyframe entries of every stream's index to a sidecar
+   * file, along with the size and modification time of the media file, so
+   * #loadSeekIndex(String) can tell if it is out of date.
+   *
+   * @param filename Where to write the index, or null to write it next to
+   *   the media file with ".hvidx" added to its name.
+   * @return The number of entries written.
+   * @throws RuntimeException if the Demuxer is not open, was not opened on
+   *   a local file, or the index cannot be written.
+   */
+  virtual int32_t
+  saveSeekIndex(const char* filename)=0;
+
+  /**
+   * Adds the entries of a sidecar file written by #saveSeekIndex(String)
+   * to this Demuxer's stream indexes.
+   * <p>
+   * #queryStreamMetaData() already does this for the default sidecar
+   * name, so this is only needed for index files kept elsewhere.  The file is ignored if the
+   * media file's size or modification time has changed, if it has a
+   * different number of streams or a stream's time base differs, or if it
+   * was written by an incompatible version.
+   * </p>
+   *
+   * @param filename The index file, or null for the default name.
+   * @return The number of entries added, or <0 if there was no usable
+   *   index.
+   */
+  virtual int32_t
+  loadSeekIndex(const char* filename)=0;
+
   /**
    * Gets the AVFormatContext.max_delay property if possible.
    * @return The max delay, error code otherwise.
@@ -22,14 +22,24 @@
  *  Created on: Jul 2, 2013
  *      Author: aclarke
  */
+#include <sys/time.h>
+#include <unistd.h>
+
 #include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/Trace.h>
 #include <io/humble/ferry/JNIHelper.h>
+#include <io/humble/video/IndexEntry.h>
 #include <io/humble/video/customio/URLProtocolManager.h>
+#include <io/humble/video/customio/InstrumentedURLProtocolHandler.h>
 #include "Global.h"
+#include "FfmpegURLProtocolHandler.h"
 #include "DemuxerImpl.h"
 #include "MediaPacketImpl.h"
 #include "KeyValueBagImpl.h"
 #include "VideoExceptions.h"
+#include "RationalImpl.h"
+#include "ProbeCache.h"
+#include "SeekIndexFile.h"
 
 VS_LOG_SETUP(VS_CPP_PACKAGE.Demuxer);
 
@@ -45,15 +55,37 @@ DemuxerImpl::DemuxerImpl() {
   mReadRetryMax = 1;
   mInputBufferLength = 2048;
   mIOHandler = 0;
+  mInputBufferLengthSet = false;
+  mIOInstrumented = false;
+  mIOInstrument = 0;
+  pthread_mutex_init(&mIOStatisticsLock, 0);
+  mPendingReadError = 0;
+  mSeekIndexLoaded = false;
+  mProbeTimeSaved = 0;
+  mReadAheadMaxPackets = 0;
+  mReadAheadMaxBytes = 0;
+  mReadAheadMaxDuration = 0;
+  mReadAheadBytes = 0;
+  mReadAheadEmptyStalls = 0;
+  mReadAheadFullStalls = 0;
+  mReadAheadStatus = 0;
+  mReadAheadRunning = false;
+  mReadAheadStop = false;
+  mReadAheadDone = false;
+  mReadAheadAbort = 0;
+  mReadAheadFileSize = -1;
+  pthread_mutex_init(&mReadAheadLock, 0);
+  pthread_cond_init(&mReadAheadNotEmpty, 0);
+  pthread_cond_init(&mReadAheadNotFull, 0);
   mCtx = avformat_alloc_context();
   if (!mCtx) {
     VS_THROW(HumbleBadAlloc());
   }
   // Set up thread interrupt capabilities
-  mCtx->interrupt_callback.callback = Global::avioInterruptCB;
-  mCtx->interrupt_callback.opaque = this;
+  mCtx->interrupt_callback.callback = DemuxerImpl::interruptCB;
+  mCtx->interrupt_callback.opaque = static_cast<Container*>(this);
   mState = STATE_INITED;
-  VS_LOG_TRACE("Created: %p");
+  VS_TRACE("Created: %p", this);
 }
 
 DemuxerImpl::~DemuxerImpl() {
@@ -64,9 +96,15 @@ DemuxerImpl::~DemuxerImpl() {
         this->getURL());
     (void) this->close();
   }
+  stopReadAhead(true);
+  flushReadAhead();
   if (mCtx)
     avformat_free_context(mCtx);
-  VS_LOG_TRACE("Destroyed: %p");
+  pthread_cond_destroy(&mReadAheadNotFull);
+  pthread_cond_destroy(&mReadAheadNotEmpty);
+  pthread_mutex_destroy(&mReadAheadLock);
+  pthread_mutex_destroy(&mIOStatisticsLock);
+  VS_TRACE("Destroyed: %p", this);
 }
 
 AVFormatContext*
@@ -91,6 +129,7 @@ DemuxerImpl::open(const char *url, DemuxerFormat* format,
     bool streamsCanBeAddedDynamically, bool queryMetaData,
     KeyValueBag* options, KeyValueBag* optionsNotSet)
 {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   AVFormatContext* ctx = this->getFormatCtx();
   int retval = -1;
   if (mState != STATE_INITED) {
@@ -116,6 +155,22 @@ DemuxerImpl::open(const char *url, DemuxerFormat* format,
          URLProtocolHandler::URL_RDONLY_MODE,
          0);
 
+  if (mIOInstrumented) {
+    // FFmpeg's own protocols get a handler too, so they can be counted
+    if (!mIOHandler && FfmpegURLProtocolHandler::isAvioURL(url, ctx->iformat))
+      mIOHandler = new FfmpegURLProtocolHandler(&ctx->interrupt_callback);
+    if (mIOHandler) {
+      pthread_mutex_lock(&mIOStatisticsLock);
+      mIOInstrument = new InstrumentedURLProtocolHandler(mIOHandler);
+      mIOHandler = mIOInstrument;
+      mIOStatisticsAtClose = 0;
+      pthread_mutex_unlock(&mIOStatisticsLock);
+      if (!mInputBufferLengthSet)
+        mInputBufferLength = InstrumentedURLProtocolHandler::getTunedBufferLength(
+            url, URLProtocolHandler::URL_RDONLY_MODE, mInputBufferLength);
+    }
+  }
+
   if (mIOHandler) {
     ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
     // free and realloc the input buffer length
@@ -171,9 +226,9 @@ DemuxerImpl::open(const char *url, DemuxerFormat* format,
     mState = STATE_ERROR;
     FfmpegException::check(retval, "Error opening url: %s; ", url);
   }
-  VS_LOG_TRACE("open Demuxer@%p[url:%s;]",
-               this,
-               this->getURL());
+  VS_TRACE("open Demuxer@%p[url:%s;]",
+           this,
+           this->getURL());
   if (queryMetaData)
     queryStreamMetaData();
   return;
@@ -186,6 +241,7 @@ DemuxerImpl::setInputBufferLength(int32_t size) {
   if (mState != STATE_INITED)
     VS_THROW(HumbleRuntimeError("Demuxer object has already been opened"));
   mInputBufferLength = size;
+  mInputBufferLengthSet = true;
 }
 
 int32_t
@@ -193,6 +249,30 @@ DemuxerImpl::getInputBufferLength() {
   return mInputBufferLength;
 }
 
+void
+DemuxerImpl::setIOInstrumented(bool instrumented) {
+  if (mState != STATE_INITED)
+    VS_THROW(HumbleRuntimeError("Demuxer object has already been opened"));
+  mIOInstrumented = instrumented;
+}
+
+IOStatistics*
+DemuxerImpl::getIOStatistics() {
+  RefPointer<IOStatistics> retval;
+  pthread_mutex_lock(&mIOStatisticsLock);
+  try {
+    if (mIOInstrument)
+      retval = IOStatistics::make(mIOInstrument, mInputBufferLength);
+    else
+      retval = mIOStatisticsAtClose;
+  } catch (std::exception &) {
+    pthread_mutex_unlock(&mIOStatisticsLock);
+    throw;
+  }
+  pthread_mutex_unlock(&mIOStatisticsLock);
+  return retval.get();
+}
+
 int32_t
 DemuxerImpl::getNumStreams() {
   if (!(mState == STATE_OPENED ||
@@ -205,6 +285,7 @@ DemuxerImpl::getNumStreams() {
 
 void
 DemuxerImpl::close() {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   int32_t retval=-1;
   if (!(mState == STATE_OPENED ||
       mState == STATE_PLAYING ||
@@ -212,6 +293,10 @@ DemuxerImpl::close() {
     VS_THROW(HumbleRuntimeError("Attempt to close container when not opened, playing or paused"));
   }
 
+  // the read-ahead thread must be off the context before we free it.
+  stopReadAhead(true);
+  flushReadAhead();
+
   // we need to remember the avio context
   AVIOContext* pb = this->getFormatCtx()->pb;
 
@@ -240,6 +325,18 @@ DemuxerImpl::doCloseFileHandles(AVIOContext* pb)
     retval = mIOHandler->url_close();
     if (pb) av_freep(&pb->buffer);
     av_free(pb);
+    if (mIOInstrument) {
+      // keep the totals around for callers that ask after closing
+      pthread_mutex_lock(&mIOStatisticsLock);
+      try {
+        mIOStatisticsAtClose = IOStatistics::make(mIOInstrument,
+            mInputBufferLength);
+      } catch (std::exception &) {
+        mIOStatisticsAtClose = 0;
+      }
+      mIOInstrument = 0;
+      pthread_mutex_unlock(&mIOStatisticsLock);
+    }
     delete mIOHandler;
     mIOHandler = 0;
   } else
@@ -259,18 +356,176 @@ DemuxerImpl::getStream(int32_t position) {
   return DemuxerStream::make(this, position);
 }
 
+void
+DemuxerImpl::setStreamSelected(int32_t streamIndex, bool selected) {
+  if (!(mState == STATE_OPENED ||
+      mState == STATE_PLAYING ||
+      mState == STATE_PAUSED)) {
+    VS_THROW(HumbleRuntimeError("Attempt to select Demuxer stream when not opened, playing or paused is ignored"));
+  }
+  AVStream* avStream = ((Container*)this)->getStream(streamIndex)->getCtx();
+  enum AVDiscard discard = selected ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+  if (avStream->discard == discard)
+    return;
+  // the read-ahead thread reads discard, so keep it off the context.
+  stopReadAhead(false);
+  avStream->discard = discard;
+  if (selected)
+    return;
+
+  pthread_mutex_lock(&mReadAheadLock);
+  std::deque<QueuedPacket>::iterator it = mReadAheadQueue.begin();
+  while (it != mReadAheadQueue.end()) {
+    if (it->packet.stream_index == streamIndex) {
+      mReadAheadBytes -= it->packet.size;
+      av_free_packet(&it->packet);
+      it = mReadAheadQueue.erase(it);
+    } else
+      ++it;
+  }
+  pthread_mutex_unlock(&mReadAheadLock);
+}
+
+bool
+DemuxerImpl::isStreamSelected(int32_t streamIndex) {
+  if (!(mState == STATE_OPENED ||
+      mState == STATE_PLAYING ||
+      mState == STATE_PAUSED)) {
+    VS_THROW(HumbleRuntimeError("Attempt to query Demuxer stream selection when not opened, playing or paused is ignored"));
+  }
+  AVStream* avStream = ((Container*)this)->getStream(streamIndex)->getCtx();
+  return avStream->discard < AVDISCARD_ALL;
+}
+
+int32_t
+DemuxerImpl::selectStreams(MediaDescriptor::Type type) {
+  int32_t n = getNumStreams();
+  int32_t retval = 0;
+  for(int32_t i = 0; i < n; i++) {
+    AVStream* avStream = ((Container*)this)->getStream(i)->getCtx();
+    bool selected = avStream->codec->codec_type == (enum AVMediaType)type;
+    setStreamSelected(i, selected);
+    if (selected)
+      ++retval;
+  }
+  return retval;
+}
+
+void
+DemuxerImpl::setKeyFramesOnly(int32_t streamIndex, bool keyFramesOnly) {
+  if (!(mState == STATE_OPENED ||
+      mState == STATE_PLAYING ||
+      mState == STATE_PAUSED)) {
+    VS_THROW(HumbleRuntimeError("Attempt to filter Demuxer stream when not opened, playing or paused is ignored"));
+  }
+  AVStream* avStream = ((Container*)this)->getStream(streamIndex)->getCtx();
+  // some demuxers skip non-key data themselves at this level; readPacket
+  // drops what the others return.
+  enum AVDiscard discard = keyFramesOnly ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+  if (avStream->discard == discard)
+    return;
+  stopReadAhead(false);
+  avStream->discard = discard;
+  if (!keyFramesOnly)
+    return;
+
+  pthread_mutex_lock(&mReadAheadLock);
+  std::deque<QueuedPacket>::iterator it = mReadAheadQueue.begin();
+  while (it != mReadAheadQueue.end()) {
+    if (isDropped(&it->packet)) {
+      mReadAheadBytes -= it->packet.size;
+      av_free_packet(&it->packet);
+      it = mReadAheadQueue.erase(it);
+    } else
+      ++it;
+  }
+  pthread_mutex_unlock(&mReadAheadLock);
+}
+
+bool
+DemuxerImpl::isKeyFramesOnly(int32_t streamIndex) {
+  if (!(mState == STATE_OPENED ||
+      mState == STATE_PLAYING ||
+      mState == STATE_PAUSED)) {
+    VS_THROW(HumbleRuntimeError("Attempt to query Demuxer stream filter when not opened, playing or paused is ignored"));
+  }
+  AVStream* avStream = ((Container*)this)->getStream(streamIndex)->getCtx();
+  return avStream->discard == AVDISCARD_NONKEY;
+}
+
+bool
+DemuxerImpl::isDropped(AVPacket* packet) {
+  if (packet->flags & AV_PKT_FLAG_KEY)
+    return false;
+  AVFormatContext* ctx = getFormatCtx();
+  if (packet->stream_index < 0 ||
+      packet->stream_index >= (int32_t)ctx->nb_streams)
+    return false;
+  return ctx->streams[packet->stream_index]->discard == AVDISCARD_NONKEY;
+}
+
 int32_t
 DemuxerImpl::read(MediaPacket* ipkt) {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   int32_t retval = -1;
   MediaPacketImpl* pkt = dynamic_cast<MediaPacketImpl*>(ipkt);
   if (pkt)
+    retval = readPacket(pkt, 0);
+  return checkReadResult(retval);
+}
+
+int32_t
+DemuxerImpl::readBatch(MediaPacketBatch* batch) {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
+  if (!batch)
+    VS_THROW(HumbleInvalidArgument("no batch passed in"));
+
+  std::vector<StreamInfo> streams;
+  int32_t capacity = batch->getCapacity();
+  int32_t numRead = 0;
+  int32_t retval = 0;
+  batch->setSize(0);
+  while (numRead < capacity)
+  {
+    // MediaPacketBatch only ever holds packets it made itself.
+    MediaPacketImpl* pkt = static_cast<MediaPacketImpl*>(
+        batch->peekPacket(numRead));
+    retval = readPacket(pkt, &streams);
+    if (retval < 0 || !pkt->isComplete())
+      break;
+    ++numRead;
+  }
+  batch->setSize(numRead);
+  if (numRead > 0)
   {
-    pkt->reset(0);
-    AVPacket* packet=pkt->getCtx();
+    // hand back what we have; the next read reports the error.
+    if (retval < 0 && retval != AVERROR_EOF && retval != AVERROR(EAGAIN))
+      mPendingReadError = retval;
+    VS_CHECK_INTERRUPT(true);
+    return numRead;
+  }
+  return checkReadResult(retval);
+}
+
+int32_t
+DemuxerImpl::readPacket(MediaPacketImpl* pkt, std::vector<StreamInfo>* streams) {
+  int32_t retval = -1;
+  pkt->reset(0);
+  AVPacket* packet=pkt->getCtx();
 
+  pkt->setComplete(false, pkt->getSize());
+  if (mPendingReadError)
+  {
+    retval = mPendingReadError;
+    mPendingReadError = 0;
+  }
+  else for(;;)
+  {
     int32_t numReads=0;
-    pkt->setComplete(false, pkt->getSize());
-    do
+    if (mReadAheadRunning || !mReadAheadQueue.empty() ||
+        (mReadAheadMaxPackets > 0 && startReadAhead()))
+      retval = readAheadPop(packet);
+    else do
     {
       retval = av_read_frame(this->getFormatCtx(),
           packet);
@@ -278,38 +533,61 @@ DemuxerImpl::read(MediaPacket* ipkt) {
     }
     while (retval == AVERROR(EAGAIN) &&
         (mReadRetryMax < 0 || numReads <= mReadRetryMax));
+    // skip the non-key packets of keyframes-only streams
+    if (retval < 0 || !isDropped(packet))
+      break;
+    av_free_packet(packet);
+  }
 
-    // and let's try to set the packet time base if known
-    if (retval >= 0) {
-      if (pkt->getStreamIndex() >= 0)
-      {
-        // Get a Container Stream rather than a DemuxerStream; this avoids unnecessarily
-        // recreating all the demuxer streams, decoders and codecs.
-        Container::Stream* stream = ((Container*)this)->getStream(pkt->getStreamIndex());
-        if (stream)
-        {
-          // let's set the packet coder.
-          RefPointer<Coder> coder = stream->getCoder();
-          pkt->setCoder(coder.value());
-          AVStream* avStream = stream->getCtx();
-          RefPointer<Rational> streamBase = Rational::make(avStream->time_base.num,
-                                                           avStream->time_base.den);
-          if (streamBase)
-          {
-            pkt->setTimeBase(streamBase.value());
-          }
-        }
+  // and let's try to set the packet time base if known
+  if (retval >= 0) {
+    int32_t index = pkt->getStreamIndex();
+    if (index >= 0)
+    {
+      StreamInfo info;
+      StreamInfo* stream = &info;
+      if (streams) {
+        // look each stream up once per batch
+        if ((int32_t)streams->size() <= index)
+          streams->resize(index+1);
+        stream = &(*streams)[index];
       }
-
-      pkt->setComplete(pkt->getSize()>0, pkt->getSize());
+      if (!stream->known)
+        lookupStream(index, stream);
+      pkt->setCoder(stream->coder.value());
+      if (stream->timeBase)
+        pkt->setTimeBase(stream->timeBase.value());
     }
+
+    pkt->setComplete(pkt->getSize()>0, pkt->getSize());
+  }
+  if (VS_TRACE_IS_ENABLED()) {
     char descr[256];
     pkt->logMetadata(descr, sizeof(descr));
-    VS_LOG_TRACE("read Demuxer@%p[p:%s;e:%"  PRIi64 "]",
-                 this,
-                 descr,
-                 (int64_t)retval);
+    VS_TRACE_EMIT("read Demuxer@%p[p:%s;e:%"  PRIi64 "]",
+                  this,
+                  descr,
+                  (int64_t)retval);
+  }
+  return retval;
+}
+
+void
+DemuxerImpl::lookupStream(int32_t index, StreamInfo* info) {
+  info->known = true;
+  // Get a Container Stream rather than a DemuxerStream; this avoids unnecessarily
+  // recreating all the demuxer streams, decoders and codecs.
+  Container::Stream* stream = ((Container*)this)->getStream(index);
+  if (stream)
+  {
+    info->coder = stream->getCoder();
+    AVStream* avStream = stream->getCtx();
+    info->timeBase = RationalImpl::intern(avStream->time_base);
   }
+}
+
+int32_t
+DemuxerImpl::checkReadResult(int32_t retval) {
   VS_CHECK_INTERRUPT(true);
   // If we do not have enoughd ata, set retval to 0 and return. The caller
   // should know to call again given that 0 bytes returned with incomplete
@@ -325,13 +603,30 @@ DemuxerImpl::read(MediaPacket* ipkt) {
 
 void
 DemuxerImpl::queryStreamMetaData() {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   if (!(mState == STATE_OPENED ||
       mState == STATE_PLAYING ||
       mState == STATE_PAUSED)) {
     VS_THROW(HumbleRuntimeError("Attempt to query stream information from container when not opened, playing or paused"));
   }
+  stopReadAhead(false);
   if (!mStreamInfoGotten) {
-    FfmpegException::check(avformat_find_stream_info(this->getFormatCtx(), 0), "could not queryStreamMetaData on: %s; ", getURL());
+    AVFormatContext* ctx = this->getFormatCtx();
+    std::string key;
+    bool cacheable = ProbeCache::getCapacity() > 0 &&
+        ProbeCache::makeKey(ctx, getURL(), isCustomIO(), &key);
+    mProbeTimeSaved = cacheable ? ProbeCache::restore(key, ctx) : -1;
+    if (mProbeTimeSaved < 0) {
+      mProbeTimeSaved = 0;
+      struct timeval start;
+      struct timeval end;
+      gettimeofday(&start, 0);
+      FfmpegException::check(avformat_find_stream_info(ctx, 0), "could not queryStreamMetaData on: %s; ", getURL());
+      gettimeofday(&end, 0);
+      if (cacheable)
+        ProbeCache::store(key, ctx, (end.tv_sec - start.tv_sec) * 1000000LL +
+            (end.tv_usec - start.tv_usec));
+    }
     mStreamInfoGotten = true;
   }
   Container::doSetupStreams();
@@ -340,6 +635,14 @@ DemuxerImpl::queryStreamMetaData() {
   {
     VS_LOG_WARN("Could not find streams in input container");
   }
+  else if (!mSeekIndexLoaded)
+  {
+    // a sidecar index, if someone saved one, makes seeking cheap.  Not
+    // done in open, as looking at the streams before this sets up their
+    // decoders from whatever the header alone said.
+    mSeekIndexLoaded = true;
+    (void) loadSeekIndex(0);
+  }
 }
 
 int64_t
@@ -358,6 +661,10 @@ DemuxerImpl::getFileSize() {
   AVFormatContext* ctx = this->getFormatCtx();
   if (ctx->iformat && (ctx->iformat->flags & AVFMT_NOFILE))
     retval = 0;
+  else if (mReadAheadRunning)
+    // avio_size may seek, so do not touch the context under the
+    // read-ahead thread; the size from when it started will do.
+    retval = FFMAX(0, mReadAheadFileSize);
   else {
     retval = avio_size(ctx->pb);
     retval = FFMAX(0, retval);
@@ -415,6 +722,68 @@ DemuxerImpl::setReadRetryCount(int32_t count) {
     mReadRetryMax = count;
 }
 
+void
+DemuxerImpl::setReadAhead(int32_t maxPackets, int32_t maxBytes,
+    int64_t maxDuration) {
+  if (maxPackets <= 0)
+    // packets already queued are still handed out by read().
+    stopReadAhead(false);
+  pthread_mutex_lock(&mReadAheadLock);
+  mReadAheadMaxPackets = FFMAX(0, maxPackets);
+  mReadAheadMaxBytes = FFMAX(0, maxBytes);
+  mReadAheadMaxDuration = FFMAX(0, maxDuration);
+  // the limits may have grown
+  pthread_cond_signal(&mReadAheadNotFull);
+  pthread_mutex_unlock(&mReadAheadLock);
+}
+
+int32_t
+DemuxerImpl::getReadAheadMaxPackets() {
+  return mReadAheadMaxPackets;
+}
+
+int32_t
+DemuxerImpl::getReadAheadMaxBytes() {
+  return mReadAheadMaxBytes;
+}
+
+int64_t
+DemuxerImpl::getReadAheadMaxDuration() {
+  return mReadAheadMaxDuration;
+}
+
+int32_t
+DemuxerImpl::getReadAheadQueuedPackets() {
+  pthread_mutex_lock(&mReadAheadLock);
+  int32_t retval = mReadAheadQueue.size();
+  pthread_mutex_unlock(&mReadAheadLock);
+  return retval;
+}
+
+int64_t
+DemuxerImpl::getReadAheadQueuedBytes() {
+  pthread_mutex_lock(&mReadAheadLock);
+  int64_t retval = mReadAheadBytes;
+  pthread_mutex_unlock(&mReadAheadLock);
+  return retval;
+}
+
+int64_t
+DemuxerImpl::getReadAheadEmptyStalls() {
+  pthread_mutex_lock(&mReadAheadLock);
+  int64_t retval = mReadAheadEmptyStalls;
+  pthread_mutex_unlock(&mReadAheadLock);
+  return retval;
+}
+
+int64_t
+DemuxerImpl::getReadAheadFullStalls() {
+  pthread_mutex_lock(&mReadAheadLock);
+  int64_t retval = mReadAheadFullStalls;
+  pthread_mutex_unlock(&mReadAheadLock);
+  return retval;
+}
+
 bool
 DemuxerImpl::canStreamsBeAddedDynamically() {
   return this->getFormatCtx()->ctx_flags & AVFMTCTX_NOHEADER;
@@ -453,10 +822,15 @@ DemuxerImpl::getMaxDelay() {
 int32_t
 DemuxerImpl::seek(int32_t stream_index, int64_t min_ts, int64_t ts,
     int64_t max_ts, int32_t flags) {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   if (mState != STATE_OPENED)
   {
     VS_THROW(HumbleRuntimeError("Can only seek on OPEN (not paused or playing) Demuxers"));
   }
+  // anything read ahead is from before the seek, so do not wait for a
+  // stalled source to finish the packet in progress either.
+  stopReadAhead(true);
+  flushReadAhead();
   int32_t retval = avformat_seek_file(this->getFormatCtx(),
       stream_index,
       min_ts,
@@ -469,12 +843,129 @@ DemuxerImpl::seek(int32_t stream_index, int64_t min_ts, int64_t ts,
   return retval;
 }
 
+int32_t
+DemuxerImpl::buildSeekIndex() {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
+  if (mState != STATE_OPENED)
+  {
+    VS_THROW(HumbleRuntimeError("Can only build a seek index on OPEN (not paused or playing) Demuxers"));
+  }
+  // everything read ahead is thrown away, and we seek back to the start.
+  stopReadAhead(true);
+  flushReadAhead();
+  mPendingReadError = 0;
+
+  AVFormatContext* ctx = this->getFormatCtx();
+  int64_t startTime = ctx->start_time;
+  std::vector<RefPointer<DemuxerStream> > streams;
+  int32_t count = 0;
+  int32_t numRetries = 0;
+  int32_t retval;
+  AVPacket packet;
+  av_init_packet(&packet);
+  packet.data = 0;
+  packet.size = 0;
+  while ((retval = av_read_frame(ctx, &packet)) >= 0 || retval == AVERROR(EAGAIN)) {
+    if (retval < 0) {
+      // nothing yet from a non-blocking source; give up after as many
+      // retries as read() would, and back off rather than spin.
+      if ((mReadRetryMax >= 0 && ++numRetries > mReadRetryMax) ||
+          interruptCB(static_cast<Container*>(this)))
+        break;
+      usleep(1000);
+      continue;
+    }
+    numRetries = 0;
+    int64_t timeStamp = packet.dts != Global::NO_PTS ? packet.dts : packet.pts;
+    if ((packet.flags & AV_PKT_FLAG_KEY) && packet.pos >= 0 &&
+        timeStamp != Global::NO_PTS && packet.stream_index >= 0) {
+      // some demuxers (FLV for one) index keyframes themselves as they
+      // read, by where the frame's tag starts; packet.pos may point past
+      // that, so never replace an entry of theirs.
+      AVStream* avStream = ctx->streams[packet.stream_index];
+      int found = av_index_search_timestamp(avStream, timeStamp,
+          AVSEEK_FLAG_BACKWARD | AVSEEK_FLAG_ANY);
+      if (found >= 0 && avStream->index_entries[found].timestamp == timeStamp)
+        ++count;
+      else {
+        // streams can turn up part way through, so look them up as we go.
+        if ((size_t)packet.stream_index >= streams.size())
+          streams.resize(packet.stream_index+1);
+        RefPointer<DemuxerStream>& stream = streams[packet.stream_index];
+        if (!stream)
+          stream = getStream(packet.stream_index);
+        RefPointer<IndexEntry> entry = IndexEntry::make(packet.pos, timeStamp,
+            IndexEntry::INDEX_FLAG_KEYFRAME, packet.size, 0);
+        if (stream->addIndexEntry(entry.value()) >= 0)
+          ++count;
+      }
+    }
+    av_free_packet(&packet);
+  }
+  VS_CHECK_INTERRUPT(true);
+  if (retval != AVERROR_EOF)
+    FfmpegException::check(retval, "could not build seek index for: %s; ", getURL());
+
+  // back to the start, which the new index makes cheap.
+  retval = av_seek_frame(ctx, -1, startTime == Global::NO_PTS ? 0 : startTime,
+      AVSEEK_FLAG_BACKWARD);
+  FfmpegException::check(retval, "could not seek to start after building seek index for: %s; ", getURL());
+  return count;
+}
+
+bool
+DemuxerImpl::getSeekIndexPath(const char* filename, std::string* indexPath,
+    std::string* mediaPath) {
+  if (!SeekIndexFile::getMediaPath(getURL(), mediaPath))
+    return false;
+  if (filename && *filename)
+    *indexPath = filename;
+  else
+    *indexPath = SeekIndexFile::getDefaultPath(*mediaPath);
+  return true;
+}
+
+int32_t
+DemuxerImpl::saveSeekIndex(const char* filename) {
+  if (!(mState == STATE_OPENED ||
+      mState == STATE_PLAYING ||
+      mState == STATE_PAUSED)) {
+    VS_THROW(HumbleRuntimeError("Attempt to save seek index from container when not opened, playing or paused"));
+  }
+  std::string indexPath;
+  std::string mediaPath;
+  if (!getSeekIndexPath(filename, &indexPath, &mediaPath))
+    VS_THROW(HumbleIOException::make("seek indexes can only be saved for local files: %s", getURL()));
+  int32_t retval = SeekIndexFile::write(indexPath.c_str(), mediaPath.c_str(), this);
+  if (retval < 0)
+    VS_THROW(HumbleIOException::make("could not write seek index: %s", indexPath.c_str()));
+  return retval;
+}
+
+int32_t
+DemuxerImpl::loadSeekIndex(const char* filename) {
+  if (!(mState == STATE_OPENED ||
+      mState == STATE_PLAYING ||
+      mState == STATE_PAUSED)) {
+    VS_THROW(HumbleRuntimeError("Attempt to load seek index into container when not opened, playing or paused"));
+  }
+  std::string indexPath;
+  std::string mediaPath;
+  if (!getSeekIndexPath(filename, &indexPath, &mediaPath))
+    return -1;
+  return SeekIndexFile::read(indexPath.c_str(), mediaPath.c_str(), this);
+}
+
 void
 DemuxerImpl::pause() {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   if (mState != STATE_PLAYING)
   {
     VS_THROW(HumbleRuntimeError("Can only pause containers in PLAYING state."));
   }
+  // keep what was read ahead, and the packet being read; the next read
+  // after play() returns them first.
+  stopReadAhead(false);
   int32_t retval = av_read_pause(this->getFormatCtx());
   FfmpegException::check(retval, "Could not pause url: %s; ", getURL());
   mState = STATE_PAUSED;
@@ -482,6 +973,7 @@ DemuxerImpl::pause() {
 
 void
 DemuxerImpl::play() {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   if (mState != STATE_PAUSED || mState != STATE_OPENED)
   {
     VS_THROW(HumbleRuntimeError("Can only play containers in OPENED or PAUSED states"));
@@ -497,8 +989,15 @@ DemuxerImpl::doOpen(const char* url, AVDictionary** options)
   int32_t retval=0;
   AVFormatContext* ctx = this->getFormatCtx();
 
-  if (mIOHandler)
+  if (mIOHandler) {
+    // FFmpeg's protocols take their options (headers, timeouts and so on)
+    // from the same dictionary as when avformat_open_input opens them
+    FfmpegURLProtocolHandler* ffmpegHandler = mIOInstrument ?
+        dynamic_cast<FfmpegURLProtocolHandler*>(mIOInstrument->getDelegate()) : 0;
+    if (ffmpegHandler)
+      ffmpegHandler->setOptions(options);
     retval = mIOHandler->url_open(url, URLProtocolHandler::URL_RDONLY_MODE);
+  }
 
   if (retval >= 0) {
     AVIOContext* pb = ctx->pb;
@@ -514,6 +1013,280 @@ DemuxerImpl::doOpen(const char* url, AVDictionary** options)
   return retval;
 }
 
+bool
+DemuxerImpl::isCustomIO()
+{
+  URLProtocolHandler* handler = mIOInstrument ? mIOInstrument->getDelegate() :
+      mIOHandler;
+  // reading through FFmpeg's own protocols just to count is not custom IO
+  return handler && !dynamic_cast<FfmpegURLProtocolHandler*>(handler);
+}
+
+int
+DemuxerImpl::interruptCB(void* opaque)
+{
+  DemuxerImpl* self = static_cast<DemuxerImpl*>(static_cast<Container*>(opaque));
+  if (self && __atomic_load_n(&self->mReadAheadAbort, __ATOMIC_ACQUIRE))
+    return 1;
+  return Global::avioInterruptCB(opaque);
+}
+
+void*
+DemuxerImpl::readAheadRun(void* arg)
+{
+  static_cast<DemuxerImpl*>(arg)->readAheadLoop();
+
+  // Java custom IO handlers attach this thread to the JVM; let it go.
+  JNIHelper* helper = JNIHelper::getHelper();
+  JavaVM* vm = helper ? helper->getVM() : 0;
+  JNIEnv* env = 0;
+  if (vm && vm->GetEnv((void**)(void*)&env, JNI_VERSION_1_2) == JNI_OK)
+    vm->DetachCurrentThread();
+  return 0;
+}
+
+void
+DemuxerImpl::readAheadLoop()
+{
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
+  AVFormatContext* ctx = mCtx;
+
+  pthread_mutex_lock(&mReadAheadLock);
+  while (!mReadAheadStop && !mReadAheadStatus)
+  {
+    if (isReadAheadFull())
+    {
+      ++mReadAheadFullStalls;
+      while (!mReadAheadStop && isReadAheadFull())
+        pthread_cond_wait(&mReadAheadNotFull, &mReadAheadLock);
+      continue;
+    }
+    pthread_mutex_unlock(&mReadAheadLock);
+
+    QueuedPacket queued;
+    av_init_packet(&queued.packet);
+    queued.packet.data = 0;
+    queued.packet.size = 0;
+    queued.time = Global::NO_PTS;
+    int32_t retval = av_read_frame(ctx, &queued.packet);
+    if (retval >= 0)
+    {
+      // the packet may point into the demuxer's own buffers, which the
+      // next av_read_frame reuses; it must own its data to wait in a queue.
+      retval = av_dup_packet(&queued.packet);
+      if (retval < 0)
+        av_free_packet(&queued.packet);
+      else
+      {
+        AVStream* stream = ctx->streams[queued.packet.stream_index];
+        int64_t ts = queued.packet.dts != Global::NO_PTS ?
+            queued.packet.dts : queued.packet.pts;
+        if (ts != Global::NO_PTS)
+          queued.time = av_rescale(ts, AV_TIME_BASE*(int64_t)stream->time_base.num,
+              stream->time_base.den);
+      }
+    }
+    else if (retval == AVERROR(EAGAIN))
+      // nothing yet from a non-blocking source; back off rather than spin.
+      usleep(1000);
+
+    pthread_mutex_lock(&mReadAheadLock);
+    if (retval >= 0)
+    {
+      mReadAheadQueue.push_back(queued);
+      mReadAheadBytes += queued.packet.size;
+      pthread_cond_signal(&mReadAheadNotEmpty);
+    }
+    else if (retval != AVERROR(EAGAIN))
+    {
+      mReadAheadStatus = retval;
+      pthread_cond_signal(&mReadAheadNotEmpty);
+    }
+  }
+  mReadAheadDone = true;
+  pthread_cond_broadcast(&mReadAheadNotEmpty);
+  pthread_mutex_unlock(&mReadAheadLock);
+}
+
+bool
+DemuxerImpl::isReadAheadFull()
+{
+  // never full when empty, so one oversized packet still gets through.
+  if (mReadAheadQueue.empty())
+    return false;
+  if ((int32_t)mReadAheadQueue.size() >= mReadAheadMaxPackets)
+    return true;
+  if (mReadAheadMaxBytes > 0 && mReadAheadBytes >= mReadAheadMaxBytes)
+    return true;
+  if (mReadAheadMaxDuration > 0)
+  {
+    int64_t oldest = mReadAheadQueue.front().time;
+    int64_t newest = mReadAheadQueue.back().time;
+    if (oldest != Global::NO_PTS && newest != Global::NO_PTS &&
+        newest - oldest >= mReadAheadMaxDuration)
+      return true;
+  }
+  return false;
+}
+
+bool
+DemuxerImpl::startReadAhead()
+{
+  if (canStreamsBeAddedDynamically())
+    // av_read_frame could grow the stream list under the caller.
+    return false;
+
+  // Decoders are copied from the stream's codec context, which
+  // av_read_frame may update, so make them for every stream that can
+  // produce packets before the thread starts.
+  int32_t n = getNumStreams();
+  for(int32_t i = 0; i < n; i++) {
+    Container::Stream* stream = ((Container*)this)->getStream(i);
+    if (stream->getCtx()->discard < AVDISCARD_ALL)
+      stream->getCoder();
+  }
+
+  // getFileSize cannot ask the context while the thread reads from it.
+  AVFormatContext* ctx = getFormatCtx();
+  mReadAheadFileSize = ctx->iformat && (ctx->iformat->flags & AVFMT_NOFILE) ?
+      0 : avio_size(ctx->pb);
+
+  pthread_mutex_lock(&mReadAheadLock);
+  mReadAheadStop = false;
+  mReadAheadDone = false;
+  mReadAheadStatus = 0;
+  pthread_mutex_unlock(&mReadAheadLock);
+  __atomic_store_n(&mReadAheadAbort, 0, __ATOMIC_RELEASE);
+
+  if (pthread_create(&mReadAheadThread, 0, readAheadRun, this))
+  {
+    VS_LOG_WARN("Could not start read-ahead thread; reading %s on the caller's thread",
+        getURL());
+    setReadAhead(0, 0, 0);
+    return false;
+  }
+  mReadAheadRunning = true;
+  return true;
+}
+
+void
+DemuxerImpl::stopReadAhead(bool discard)
+{
+  if (!mReadAheadRunning)
+    return;
+  bool interrupt = discard;
+  pthread_mutex_lock(&mReadAheadLock);
+  mReadAheadStop = true;
+  pthread_cond_signal(&mReadAheadNotFull);
+  // let the packet in progress finish so it is queued rather than lost,
+  // unless the caller is throwing it away or gives up on a stalled source.
+  while (!interrupt && !mReadAheadDone)
+  {
+    waitReadAhead(&mReadAheadNotEmpty);
+    if (!mReadAheadDone && CancellationToken::sIsCancelled(0))
+      interrupt = true;
+  }
+  pthread_mutex_unlock(&mReadAheadLock);
+
+  if (interrupt)
+    __atomic_store_n(&mReadAheadAbort, 1, __ATOMIC_RELEASE);
+  pthread_join(mReadAheadThread, 0);
+  mReadAheadRunning = false;
+  __atomic_store_n(&mReadAheadAbort, 0, __ATOMIC_RELEASE);
+  if (!interrupt)
+    return;
+
+  // the abort was ours, not the source's; neither report it nor let it
+  // stick to the I/O context.
+  pthread_mutex_lock(&mReadAheadLock);
+  if (mReadAheadStatus == AVERROR_EXIT)
+    mReadAheadStatus = 0;
+  pthread_mutex_unlock(&mReadAheadLock);
+  AVIOContext* pb = getFormatCtx()->pb;
+  if (pb && pb->error == AVERROR_EXIT)
+  {
+    pb->error = 0;
+    pb->eof_reached = 0;
+  }
+}
+
+void
+DemuxerImpl::waitReadAhead(pthread_cond_t* cond)
+{
+  // wake up now and then so a cancelled caller does not wait forever on a
+  // stalled source.
+  struct timeval now;
+  struct timespec until;
+  gettimeofday(&now, 0);
+  until.tv_sec = now.tv_sec;
+  until.tv_nsec = now.tv_usec*1000 + 10*1000*1000;
+  if (until.tv_nsec >= 1000*1000*1000) {
+    ++until.tv_sec;
+    until.tv_nsec -= 1000*1000*1000;
+  }
+  pthread_cond_timedwait(cond, &mReadAheadLock, &until);
+}
+
+void
+DemuxerImpl::flushReadAhead()
+{
+  pthread_mutex_lock(&mReadAheadLock);
+  while (!mReadAheadQueue.empty())
+  {
+    av_free_packet(&mReadAheadQueue.front().packet);
+    mReadAheadQueue.pop_front();
+  }
+  mReadAheadBytes = 0;
+  mReadAheadStatus = 0;
+  pthread_mutex_unlock(&mReadAheadLock);
+}
+
+int32_t
+DemuxerImpl::readAheadPop(AVPacket* packet)
+{
+  int32_t retval = 0;
+  bool finished = false;
+
+  pthread_mutex_lock(&mReadAheadLock);
+  if (mReadAheadQueue.empty() && !mReadAheadStatus && mReadAheadRunning)
+  {
+    ++mReadAheadEmptyStalls;
+    do
+    {
+      waitReadAhead(&mReadAheadNotEmpty);
+      if (mReadAheadQueue.empty() && !mReadAheadStatus &&
+          CancellationToken::sIsCancelled(0))
+        retval = AVERROR_EXIT;
+    } while (!retval && mReadAheadQueue.empty() && !mReadAheadStatus);
+  }
+
+  if (!mReadAheadQueue.empty())
+  {
+    // the caller reset its packet, so there is nothing to free first.
+    *packet = mReadAheadQueue.front().packet;
+    mReadAheadQueue.pop_front();
+    mReadAheadBytes -= packet->size;
+    pthread_cond_signal(&mReadAheadNotFull);
+    retval = 0;
+  }
+  else if (!retval)
+  {
+    retval = mReadAheadStatus ? mReadAheadStatus : AVERROR(EAGAIN);
+    // end of file stays put until a seek; anything else is reported once
+    // and the next read starts over.
+    if (retval != AVERROR_EOF)
+    {
+      mReadAheadStatus = 0;
+      finished = true;
+    }
+  }
+  pthread_mutex_unlock(&mReadAheadLock);
+
+  if (finished)
+    stopReadAhead(false);
+  return retval;
+}
+
 } /* namespace video */
 } /* namespace humble */
 } /* namespace io */
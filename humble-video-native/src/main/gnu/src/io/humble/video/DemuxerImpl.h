@@ -31,12 +31,17 @@
 #include <io/humble/video/DemuxerStream.h>
 #include <io/humble/video/customio/URLProtocolHandler.h>
 
+#include <deque>
+#include <string>
 #include <vector>
+#include <pthread.h>
 
 namespace io {
 namespace humble {
 namespace video {
 
+class MediaPacketImpl;
+
 class DemuxerImpl : public io::humble::video::Demuxer
 {
 public:
@@ -54,6 +59,15 @@ public:
   virtual int32_t
   getInputBufferLength();
 
+  virtual void
+  setIOInstrumented(bool instrumented);
+
+  virtual bool
+  isIOInstrumented() { return mIOInstrumented; }
+
+  virtual IOStatistics*
+  getIOStatistics();
+
   virtual void
   open(const char *url, DemuxerFormat* format, bool streamsCanBeAddedDynamically,
       bool queryStreamMetaData, KeyValueBag* options,
@@ -68,12 +82,33 @@ public:
   virtual DemuxerStream*
   getStream(int32_t streamIndex);
 
+  virtual void
+  setStreamSelected(int32_t streamIndex, bool selected);
+
+  virtual bool
+  isStreamSelected(int32_t streamIndex);
+
+  virtual int32_t
+  selectStreams(MediaDescriptor::Type type);
+
+  virtual void
+  setKeyFramesOnly(int32_t streamIndex, bool keyFramesOnly);
+
+  virtual bool
+  isKeyFramesOnly(int32_t streamIndex);
+
   virtual int32_t
   read(MediaPacket *packet);
 
+  virtual int32_t
+  readBatch(MediaPacketBatch *batch);
+
   virtual void
   queryStreamMetaData();
 
+  virtual int64_t
+  getProbeTimeSaved() { return mProbeTimeSaved; }
+
   virtual int64_t
   getDuration();
 
@@ -107,6 +142,30 @@ public:
   virtual void
   setReadRetryCount(int32_t count);
 
+  virtual void
+  setReadAhead(int32_t maxPackets, int32_t maxBytes, int64_t maxDuration);
+
+  virtual int32_t
+  getReadAheadMaxPackets();
+
+  virtual int32_t
+  getReadAheadMaxBytes();
+
+  virtual int64_t
+  getReadAheadMaxDuration();
+
+  virtual int32_t
+  getReadAheadQueuedPackets();
+
+  virtual int64_t
+  getReadAheadQueuedBytes();
+
+  virtual int64_t
+  getReadAheadEmptyStalls();
+
+  virtual int64_t
+  getReadAheadFullStalls();
+
   virtual bool
   canStreamsBeAddedDynamically();
 
@@ -129,6 +188,15 @@ public:
   seek(int32_t stream_index, int64_t min_ts, int64_t ts,
       int64_t max_ts, int32_t flags);
 
+  virtual int32_t
+  buildSeekIndex();
+
+  virtual int32_t
+  saveSeekIndex(const char* filename);
+
+  virtual int32_t
+  loadSeekIndex(const char* filename);
+
   virtual void
   play();
 
@@ -143,15 +211,93 @@ protected:
 
 private:
   int32_t doOpen(const char*, AVDictionary**);
+  bool isCustomIO();
   int32_t doCloseFileHandles(AVIOContext* pb);
+
+  static int interruptCB(void* opaque);
+  static void* readAheadRun(void* arg);
+  void readAheadLoop();
+  bool isReadAheadFull();
+  bool startReadAhead();
+  /**
+   * Stop the read-ahead thread.  Waits for the packet being read so it is
+   * queued rather than lost, but interrupts the read at once if discard
+   * is true, or once the caller is cancelled.
+   */
+  void stopReadAhead(bool discard);
+  /** Wait a little on cond; call with mReadAheadLock held. */
+  void waitReadAhead(pthread_cond_t* cond);
+  void flushReadAhead();
+  int32_t readAheadPop(AVPacket* packet);
+
+  /** What a packet read from a stream gets stamped with. */
+  typedef struct StreamInfo {
+    StreamInfo() : known(false) {}
+    bool known;
+    io::humble::ferry::RefPointer<Coder> coder;
+    io::humble::ferry::RefPointer<Rational> timeBase;
+  } StreamInfo;
+
+  int32_t readPacket(MediaPacketImpl* pkt, std::vector<StreamInfo>* streams);
+  bool isDropped(AVPacket* packet);
+  void lookupStream(int32_t index, StreamInfo* info);
+  int32_t checkReadResult(int32_t retval);
+  bool getSeekIndexPath(const char* filename, std::string* indexPath,
+      std::string* mediaPath);
+
+  /** A packet waiting in the read-ahead queue. */
+  typedef struct QueuedPacket {
+    AVPacket packet;
+    /** dts (or pts) in microseconds, or Global::NO_PTS. */
+    int64_t time;
+  } QueuedPacket;
+
   State mState;
   bool mStreamInfoGotten;
   AVFormatContext* mCtx;
   int32_t mReadRetryMax;
   int32_t mInputBufferLength;
   io::humble::video::customio::URLProtocolHandler* mIOHandler;
+  bool mInputBufferLengthSet;
+  bool mIOInstrumented;
+  /** mIOHandler, if it is instrumented. */
+  io::humble::video::customio::InstrumentedURLProtocolHandler* mIOInstrument;
+  /** Only read or changed with mIOStatisticsLock held. */
+  io::humble::ferry::RefPointer<IOStatistics> mIOStatisticsAtClose;
+  pthread_mutex_t mIOStatisticsLock;
   io::humble::ferry::RefPointer<DemuxerFormat> mFormat;
   io::humble::ferry::RefPointer<KeyValueBag> mMetaData;
+  /** An error hit by readBatch after it had already read packets. */
+  int32_t mPendingReadError;
+  /** Has queryStreamMetaData looked for a sidecar seek index yet? */
+  bool mSeekIndexLoaded;
+  /** What the probe cache saved queryStreamMetaData, in microseconds. */
+  int64_t mProbeTimeSaved;
+
+  // Everything below is shared with the read-ahead thread and guarded by
+  // mReadAheadLock unless noted.
+  std::deque<QueuedPacket> mReadAheadQueue;
+  int32_t mReadAheadMaxPackets;
+  int32_t mReadAheadMaxBytes;
+  int64_t mReadAheadMaxDuration;
+  int64_t mReadAheadBytes;
+  int64_t mReadAheadEmptyStalls;
+  int64_t mReadAheadFullStalls;
+  /** The error that ended the read-ahead thread, or 0. */
+  int32_t mReadAheadStatus;
+  /** Only touched by the thread that owns this Demuxer. */
+  bool mReadAheadRunning;
+  bool mReadAheadStop;
+  /** Set by the read-ahead thread as it finishes. */
+  bool mReadAheadDone;
+  /** Read by interruptCB without the lock. */
+  volatile int32_t mReadAheadAbort;
+  /** What getFileSize returns while the thread runs.  Owner thread only. */
+  int64_t mReadAheadFileSize;
+  pthread_t mReadAheadThread;
+  pthread_mutex_t mReadAheadLock;
+  pthread_cond_t mReadAheadNotEmpty;
+  pthread_cond_t mReadAheadNotFull;
 };
 
 } /* namespace video */
@@ -25,6 +25,7 @@
 
 #include "Encoder.h"
 #include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/Trace.h>
 #include <io/humble/ferry/HumbleException.h>
 #include <io/humble/video/MediaPacketImpl.h>
 
@@ -62,11 +63,11 @@ Encoder::Encoder(Codec* codec, AVCodecContext* src, bool copySrc) : Coder(codec,
   mNumDroppedFrames = 0;
   mLastPtsEncoded = Global::NO_PTS;
 
-  VS_LOG_TRACE("Created: %p", this);
+  VS_TRACE("Created: %p", this);
 }
 
 Encoder::~Encoder() {
-  VS_LOG_TRACE("Destroyed: %p", this);
+  VS_TRACE("Destroyed: %p", this);
 }
 
 Encoder*
@@ -228,21 +229,21 @@ Encoder::open(KeyValueBag * inputOptions, KeyValueBag* unsetOptions) {
             getChannelLayout(), getSampleFormat());
 
       }
-      VS_LOG_TRACE("open Encoder@%p[t=AUDIO;sr=%"PRId32";c:%"PRId32";cl:%"PRId32";f=%"PRId32";]",
-                   this,
-                   (int32_t)getSampleRate(),
-                   (int32_t)getChannels(),
-                   (int32_t)getChannelLayout(),
-                   (int32_t)getSampleFormat());
+      VS_TRACE("open Encoder@%p[t=AUDIO;sr=%"PRId32";c:%"PRId32";cl:%"PRId32";f=%"PRId32";]",
+               this,
+               (int32_t)getSampleRate(),
+               (int32_t)getChannels(),
+               (int32_t)getChannelLayout(),
+               (int32_t)getSampleFormat());
 
     }
     break;
     case MediaDescriptor::MEDIA_VIDEO: {
-      VS_LOG_TRACE("open Encoder@%p[t=VIDEO;d=%"PRId32"x%"PRId32";f:%"PRId32";]",
-                   this,
-                   (int32_t)getWidth(),
-                   (int32_t)getHeight(),
-                   (int32_t)getPixelFormat());
+      VS_TRACE("open Encoder@%p[t=VIDEO;d=%"PRId32"x%"PRId32";f:%"PRId32";]",
+               this,
+               (int32_t)getWidth(),
+               (int32_t)getHeight(),
+               (int32_t)getPixelFormat());
     }
     break;
     default:
@@ -340,17 +341,17 @@ Encoder::encodeVideo(MediaPacket* aOutput, MediaPicture* aFrame) {
     output->setTimeBase(coderTb.value());
     output->setComplete(out->size > 0, out->size);
   }
-#ifdef VS_DEBUG
-  char outDescr[256]; *outDescr = 0;
-  char inDescr[256]; *inDescr = 0;
-  if (aFrame) aFrame->logMetadata(inDescr, sizeof(inDescr));
-  if (aOutput) aOutput->logMetadata(outDescr, sizeof(outDescr));
-  VS_LOG_TRACE("encodeVideo Encoder@%p[out:%s;in:%s;encoded:%" PRIi64,
-               this,
-               outDescr,
-               inDescr,
-               (int64_t)e);
-#endif
+  if (VS_TRACE_IS_ENABLED()) {
+    char outDescr[256]; *outDescr = 0;
+    char inDescr[256]; *inDescr = 0;
+    if (aFrame) aFrame->logMetadata(inDescr, sizeof(inDescr));
+    if (aOutput) aOutput->logMetadata(outDescr, sizeof(outDescr));
+    VS_TRACE_EMIT("encodeVideo Encoder@%p[out:%s;in:%s;encoded:%" PRIi64 "]",
+                  this,
+                  outDescr,
+                  inDescr,
+                  (int64_t)e);
+  }
 
   FfmpegException::check(e, "could not encode video ");
 }
@@ -442,19 +443,17 @@ Encoder::encodeAudioInternal (MediaPacket* aOutput, MediaAudio* samples)
   {
     output->setComplete (false, 0);
   }
-#ifdef VS_DEBUG
-  {
+  if (VS_TRACE_IS_ENABLED()) {
     char outDescr[256]; *outDescr = 0;
     char inDescr[256]; *inDescr = 0;
     if (inputAudio) inputAudio->logMetadata(inDescr, sizeof(inDescr));
     if (aOutput) aOutput->logMetadata(outDescr, sizeof(outDescr));
-    VS_LOG_TRACE("encodeAudio Encoder@%p[out:%s;in:%s;encoded:%" PRIi64 "]",
-                 this,
-                 aOutput ? outDescr : "(null)",
-                     inputAudio ? inDescr : "(null)",
-                         (int64_t)e);
+    VS_TRACE_EMIT("encodeAudio Encoder@%p[out:%s;in:%s;encoded:%" PRIi64 "]",
+                  this,
+                  aOutput ? outDescr : "(null)",
+                      inputAudio ? inDescr : "(null)",
+                          (int64_t)e);
   }
-#endif
 
   FfmpegException::check (e, "could not encode audio ");
 }
@@ -518,34 +517,30 @@ Encoder::encodeAudio(MediaPacket* aOutput, MediaAudio* samples) {
         // pull the sink.
         mAudioSink->getAudio(mFilteredAudio.value());
 
-#ifdef VS_DEBUG
-        {
+        if (VS_TRACE_IS_ENABLED()) {
           char outDescr[256]; *outDescr = 0;
           char inDescr[256]; *inDescr = 0;
           if (samples) samples->logMetadata(inDescr, sizeof(inDescr));
           if (mFilteredAudio) mFilteredAudio->logMetadata(outDescr, sizeof(outDescr));
-          VS_LOG_TRACE("encodeAudio filterAudio Encoder@%p[out:%s;in:%s];",
-                       this,
-                       mFilteredAudio ? outDescr : "(null)",
-                           samples ? inDescr : "(null)");
+          VS_TRACE_EMIT("encodeAudio filterAudio Encoder@%p[out:%s;in:%s];",
+                        this,
+                        mFilteredAudio ? outDescr : "(null)",
+                            samples ? inDescr : "(null)");
         }
-#endif
 
         if (mFilteredAudio->isComplete()) {
           encodeAudioInternal(output, mFilteredAudio.value());
         } else {
-#ifdef VS_DEBUG
-          {
+          if (VS_TRACE_IS_ENABLED()) {
             char outDescr[256]; *outDescr = 0;
             char inDescr[256]; *inDescr = 0;
             if (samples) samples->logMetadata(inDescr, sizeof(inDescr));
             if (aOutput) aOutput->logMetadata(outDescr, sizeof(outDescr));
-            VS_LOG_TRACE("encodeAudio Encoder@%p[out:%s;in:%s;message:not enough audio staged yet]",
-                         this,
-                         aOutput ? outDescr : "(null)",
-                             samples ? inDescr : "(null)");
+            VS_TRACE_EMIT("encodeAudio Encoder@%p[out:%s;in:%s;message:not enough audio staged yet]",
+                          this,
+                          aOutput ? outDescr : "(null)",
+                              samples ? inDescr : "(null)");
           }
-#endif
         }
       } else {
         encodeAudioInternal(output, samples);
@@ -558,18 +553,16 @@ Encoder::encodeAudio(MediaPacket* aOutput, MediaAudio* samples) {
         do {
           mAudioSink->getAudio(mFilteredAudio.value());
 
-#ifdef VS_DEBUG
-          {
+          if (VS_TRACE_IS_ENABLED()) {
             char outDescr[256]; *outDescr = 0;
             char inDescr[256]; *inDescr = 0;
             if (samples) samples->logMetadata(inDescr, sizeof(inDescr));
             if (mFilteredAudio) mFilteredAudio->logMetadata(outDescr, sizeof(outDescr));
-            VS_LOG_TRACE("encodeAudio filterAudio Encoder@%p[out:%s;in:%s];",
-                         this,
-                         mFilteredAudio ? outDescr : "(null)",
-                             samples ? inDescr : "(null)");
+            VS_TRACE_EMIT("encodeAudio filterAudio Encoder@%p[out:%s;in:%s];",
+                          this,
+                          mFilteredAudio ? outDescr : "(null)",
+                              samples ? inDescr : "(null)");
           }
-#endif
 
           if (mFilteredAudio->isComplete()) {
             encodeAudioInternal(output, mFilteredAudio.value());
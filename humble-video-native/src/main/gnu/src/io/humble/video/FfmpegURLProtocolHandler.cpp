@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+
+#include <io/humble/video/FfmpegURLProtocolHandler.h>
+
+using namespace io::humble::video::customio;
+
+namespace io {
+namespace humble {
+namespace video {
+
+FfmpegURLProtocolHandler::FfmpegURLProtocolHandler(
+    const AVIOInterruptCB* interrupt) : URLProtocolHandler(0) {
+  mInterrupt.callback = interrupt ? interrupt->callback : 0;
+  mInterrupt.opaque = interrupt ? interrupt->opaque : 0;
+  mPb = 0;
+  mOptions = 0;
+}
+
+FfmpegURLProtocolHandler::~FfmpegURLProtocolHandler() {
+  if (mPb)
+    url_close();
+}
+
+bool
+FfmpegURLProtocolHandler::isAvioURL(const char* url, AVInputFormat* format) {
+  if (!url || !avio_find_protocol_name(url))
+    return false;
+  if (format)
+    return !(format->flags & AVFMT_NOFILE);
+  // the same file-name-only probe avformat_open_input makes first
+  AVProbeData pd;
+  memset(&pd, 0, sizeof(pd));
+  pd.filename = url;
+  int score = AVPROBE_SCORE_RETRY;
+  return !av_probe_input_format2(&pd, 0, &score);
+}
+
+const char*
+FfmpegURLProtocolHandler::getProtocolName() {
+  return "ffmpeg";
+}
+
+int
+FfmpegURLProtocolHandler::url_open(const char* url, int flags) {
+  if (mPb)
+    url_close();
+  int avioFlags;
+  switch(flags) {
+    case URL_RDONLY_MODE:
+      avioFlags = AVIO_FLAG_READ;
+      break;
+    case URL_WRONLY_MODE:
+      avioFlags = AVIO_FLAG_WRITE;
+      break;
+    default:
+      avioFlags = AVIO_FLAG_READ_WRITE;
+      break;
+  }
+  int retval = avio_open2(&mPb, url, avioFlags | AVIO_FLAG_DIRECT,
+      &mInterrupt, mOptions);
+  mOptions = 0;
+  return retval;
+}
+
+int
+FfmpegURLProtocolHandler::url_close() {
+  if (!mPb)
+    return -1;
+  return avio_closep(&mPb);
+}
+
+int
+FfmpegURLProtocolHandler::url_read(unsigned char* buf, int size) {
+  if (!mPb || !mPb->read_packet)
+    return -1;
+  // avio_read would keep calling the protocol until all size bytes came
+  // in, stalling a live tcp or http input; hand back what one call gets
+  int retval = mPb->read_packet(mPb->opaque, buf, size);
+  if (retval > 0)
+    // avio_seek works out SEEK_CUR and short seeks from pos
+    mPb->pos += retval;
+  // customio handlers report end of file as 0
+  return retval == AVERROR_EOF ? 0 : retval;
+}
+
+int
+FfmpegURLProtocolHandler::url_write(const unsigned char* buf, int size) {
+  if (!mPb)
+    return -1;
+  avio_write(mPb, buf, size);
+  return mPb->error < 0 ? mPb->error : size;
+}
+
+int64_t
+FfmpegURLProtocolHandler::url_seek(int64_t position, int whence) {
+  if (!mPb)
+    return -1;
+  if (whence & SK_SEEK_SIZE)
+    return avio_size(mPb);
+  return avio_seek(mPb, position, whence);
+}
+
+URLProtocolHandler::SeekableFlags
+FfmpegURLProtocolHandler::url_seekflags(const char*, int) {
+  return mPb && mPb->seekable ? SK_SEEKABLE_NORMAL : SK_NOT_SEEKABLE;
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef FFMPEGURLPROTOCOLHANDLER_H_
+#define FFMPEGURLPROTOCOLHANDLER_H_
+
+#include <io/humble/video/HumbleVideo.h>
+#include <io/humble/video/FfmpegIncludes.h>
+#include <io/humble/video/customio/URLProtocolHandler.h>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * Internal Only.  A URLProtocolHandler that reads and writes through
+ * FFmpeg's own protocols (file, http, tcp and so on), so a Demuxer or
+ * Muxer can put an InstrumentedURLProtocolHandler in front of a URL that
+ * no customio protocol claims.
+ * <p>
+ * The FFmpeg context is opened with AVIO_FLAG_DIRECT, so every call goes
+ * straight to the protocol and the only buffer is the one the Demuxer or
+ * Muxer gives FFmpeg. A read returns whatever one protocol call delivers,
+ * which may be less than asked for.
+ * </p><p>
+ * Only use it for URLs #isAvioURL(const char*, AVInputFormat*) accepts;
+ * FFmpeg opens the rest (rtsp://, image sequences and other formats that
+ * do their own I/O) without an AVIOContext, so there is nothing to wrap.
+ * </p>
+ */
+class FfmpegURLProtocolHandler : public io::humble::video::customio::URLProtocolHandler
+{
+public:
+  /**
+   * @param interrupt Checked while a call blocks; copied.
+   */
+  FfmpegURLProtocolHandler(const AVIOInterruptCB* interrupt);
+  virtual ~FfmpegURLProtocolHandler();
+
+  /**
+   * @param url The URL a Demuxer is about to open.
+   * @param format The input format asked for, or null to probe.
+   * @return true if FFmpeg would read the URL through one of its avio
+   *   protocols, as avformat_open_input decides when it has no
+   *   AVIOContext; false for formats that do their own I/O and for URLs
+   *   no protocol claims.
+   */
+  static bool isAvioURL(const char* url, AVInputFormat* format);
+
+  /**
+   * Set the options the next #url_open(const char*, int) passes to
+   * avio_open2.  As there, the options the protocol uses are removed and
+   * the rest left for the format.  Only used by the next open.
+   *
+   * @param options The options, which must outlive the open; may be null.
+   */
+  void setOptions(AVDictionary** options) { mOptions = options; }
+
+  virtual const char* getProtocolName();
+
+  virtual int url_open(const char *url, int flags);
+  virtual int url_close();
+  virtual int url_read(unsigned char* buf, int size);
+  virtual int url_write(const unsigned char* buf, int size);
+  virtual int64_t url_seek(int64_t position, int whence);
+  virtual SeekableFlags url_seekflags(const char* url, int flags);
+
+private:
+  AVIOInterruptCB mInterrupt;
+  AVIOContext* mPb;
+  AVDictionary** mOptions;
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* FFMPEGURLPROTOCOLHANDLER_H_ */
@@ -19,15 +19,19 @@
 
 #include <cmath>
 #include <cstring>
+#include <pthread.h>
 
 #include <io/humble/ferry/JNIHelper.h>
 #include <io/humble/ferry/Logger.h>
 #include <io/humble/ferry/Mutex.h>
+#include <io/humble/ferry/RefCountedRegistry.h>
 
 
 #include <io/humble/video/Global.h>
+#include <io/humble/video/Container.h>
 #include <io/humble/video/FfmpegIncludes.h>
 #include <io/humble/video/VideoExceptions.h>
+#include <io/humble/video/ProbeCache.h>
 
 /**
  * WARNING: Do not use logging in this class, and do
@@ -42,6 +46,16 @@ namespace io { namespace humble { namespace video
   using namespace io::humble::ferry;
 
   Global* Global::sGlobal = 0;
+
+  /*
+   * The mutexes FFmpeg's lock manager has asked us for.  We keep
+   * them so we can report how contended they are.  The slots are only
+   * touched with sLockManagerMutexesLock held, so a mutex cannot be
+   * destroyed while its statistics are being read.
+   */
+  static const int32_t cMaxLockManagerMutexes = 8;
+  static Mutex* sLockManagerMutexes[cMaxLockManagerMutexes];
+  static pthread_mutex_t sLockManagerMutexesLock = PTHREAD_MUTEX_INITIALIZER;
   /*
    * This function will be called back by Ffmpeg anytime
    * it wants to log.  We then use it to dump
@@ -98,19 +112,20 @@ namespace io { namespace humble { namespace video
       --len;
     }
     if (len > 0)
-      // it's not useful to pass in filenames and line numbers here.
-      ffmpegLogger->logVA(0, 0, logLevel, revisedFmt, va);
+      // it's not useful to pass in filenames and line numbers here;
+      // but FFmpeg's format strings are constants, so they tell us
+      // where the message came from for rate limiting.
+      ffmpegLogger->logSiteVA(fmt, 0, 0, logLevel, revisedFmt, va);
   }
 
   int
-  Global :: avioInterruptCB(void*)
+  Global :: avioInterruptCB(void* opaque)
   {
-    JNIHelper* helper = JNIHelper::getHelper();
-    int retval = 0;
-    if (helper) {
-      retval = helper->isInterrupted();
-    }
-    return retval;
+    // FFmpeg calls this in tight loops while it waits on I/O, so when the
+    // container has a token this must stay a single atomic load.
+    Container* container = static_cast<Container*>(opaque);
+    return CancellationToken::sIsCancelled(
+        container ? container->peekCancellationToken() : 0) ? 1 : 0;
   }
   
   static int humblevideo_lockmgr_cb(void** ctx, enum AVLockOp op)
@@ -124,11 +139,30 @@ namespace io { namespace humble { namespace video
     switch(op)
     {
       case AV_LOCK_CREATE:
-        mutex = io::humble::ferry::Mutex::make();
+        try {
+          mutex = io::humble::ferry::Mutex::makeNative();
+        } catch (std::bad_alloc &) {
+          mutex = 0;
+        }
         *ctx = mutex;
-        retval = !!mutex;
+        // FFmpeg wants 0 on success
+        retval = !mutex;
+        pthread_mutex_lock(&sLockManagerMutexesLock);
+        for(int32_t i = 0; mutex && i < cMaxLockManagerMutexes; i++) {
+          if (!sLockManagerMutexes[i]) {
+            sLockManagerMutexes[i] = mutex;
+            break;
+          }
+        }
+        pthread_mutex_unlock(&sLockManagerMutexesLock);
         break;
       case AV_LOCK_DESTROY:
+        pthread_mutex_lock(&sLockManagerMutexesLock);
+        for(int32_t i = 0; mutex && i < cMaxLockManagerMutexes; i++)
+          if (sLockManagerMutexes[i] == mutex)
+            sLockManagerMutexes[i] = 0;
+        pthread_mutex_unlock(&sLockManagerMutexesLock);
+        // no reader can still be looking at it now
         if (mutex) mutex->release();
         *ctx = 0;
         break;
@@ -178,7 +212,7 @@ namespace io { namespace humble { namespace video
     io::humble::ferry::JNIHelper::sRegisterTerminationCallback(
         Global::destroyStaticGlobal,
         this);
-    mLock = io::humble::ferry::Mutex::make();
+    mLock = io::humble::ferry::Mutex::makeNative();
     mDefaultTimeBase = Rational::make(1, Global::DEFAULT_PTS_PER_SECOND);
   }
 
@@ -271,6 +305,122 @@ namespace io { namespace humble { namespace video
 //    fprintf(stderr, "FFmpeg logging level = %d\n", av_log_get_level());
   }
 
+  int64_t
+  Global :: sumLockStatistic(int64_t (Mutex::*stat)())
+  {
+    Global* ctx = sGlobal;
+    int64_t retval = 0;
+    if (ctx && ctx->mLock)
+      retval += (ctx->mLock->*stat)();
+    pthread_mutex_lock(&sLockManagerMutexesLock);
+    for(int32_t i = 0; i < cMaxLockManagerMutexes; i++) {
+      Mutex* mutex = sLockManagerMutexes[i];
+      if (mutex)
+        retval += (mutex->*stat)();
+    }
+    pthread_mutex_unlock(&sLockManagerMutexesLock);
+    return retval;
+  }
+
+  int64_t
+  Global :: getLockAcquisitions()
+  {
+    Global::init();
+    return sumLockStatistic(&Mutex::getAcquisitions);
+  }
+
+  int64_t
+  Global :: getLockContendedAcquisitions()
+  {
+    Global::init();
+    return sumLockStatistic(&Mutex::getContendedAcquisitions);
+  }
+
+  int64_t
+  Global :: getLockWaitTime()
+  {
+    Global::init();
+    return sumLockStatistic(&Mutex::getWaitTime);
+  }
+
+  void
+  Global :: setObjectCounting(bool enabled)
+  {
+    RefCountedRegistry::setEnabled(enabled);
+  }
+
+  bool
+  Global :: isObjectCounting()
+  {
+    return RefCountedRegistry::isEnabled();
+  }
+
+  int32_t
+  Global :: getNumObjectTypes()
+  {
+    return RefCountedRegistry::getNumTypes();
+  }
+
+  const char*
+  Global :: getObjectTypeName(int32_t index)
+  {
+    return RefCountedRegistry::getTypeName(index);
+  }
+
+  int64_t
+  Global :: getLiveObjects(int32_t index)
+  {
+    return RefCountedRegistry::getLiveObjects(index);
+  }
+
+  int64_t
+  Global :: getCreatedObjects(int32_t index)
+  {
+    return RefCountedRegistry::getCreatedObjects(index);
+  }
+
+  int64_t
+  Global :: getObjectBytes(int32_t index)
+  {
+    return RefCountedRegistry::getBytes(index);
+  }
+
+  void
+  Global :: setProbeCacheCapacity(int32_t entries)
+  {
+    ProbeCache::setCapacity(entries);
+  }
+
+  int32_t
+  Global :: getProbeCacheCapacity()
+  {
+    return ProbeCache::getCapacity();
+  }
+
+  void
+  Global :: clearProbeCache()
+  {
+    ProbeCache::clear();
+  }
+
+  int64_t
+  Global :: getProbeCacheHits()
+  {
+    return ProbeCache::getHits();
+  }
+
+  int64_t
+  Global :: getProbeCacheMisses()
+  {
+    return ProbeCache::getMisses();
+  }
+
+  int64_t
+  Global :: getProbeCacheTimeSaved()
+  {
+    return ProbeCache::getTimeSaved();
+  }
+
   Rational*
   Global::getDefaultTimeBase()
   {
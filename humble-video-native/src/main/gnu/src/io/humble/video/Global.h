@@ -118,9 +118,13 @@ namespace io { namespace humble { namespace video
 
     /**
      * Internal Only.  Do not call.
-     * Checks to determine if there is
+     * FFmpeg's interrupt callback.  Checks whether the blocking operation
+     * on a container should stop.
+     *
+     * @param container The Container* the AVFormatContext belongs to.
+     * @return 1 if FFmpeg should give up; 0 otherwise.
      */
-    static int avioInterruptCB(void*);
+    static int avioInterruptCB(void* container);
 
     /**
      * Internal Only.  Call to relese globals.
@@ -154,10 +158,132 @@ namespace io { namespace humble { namespace video
      */
     static void setFFmpegLoggingLevel(int32_t level);
 
+    /**
+     * Get the number of times the global Humble Video lock and the locks
+     * FFmpeg takes (for example around opening and closing codecs) have
+     * been acquired.
+     * @return the number of acquisitions.
+     */
+    static int64_t getLockAcquisitions();
+
+    /**
+     * Get the number of times a thread tried to take the global Humble Video
+     * lock or one of FFmpeg's locks while another thread held it.
+     * @return the number of contended acquisitions.
+     */
+    static int64_t getLockContendedAcquisitions();
+
+    /**
+     * Get the total time threads have spent waiting for the global Humble
+     * Video lock and FFmpeg's locks.
+     * @return the wait time, in nanoseconds.
+     */
+    static int64_t getLockWaitTime();
+
+    /**
+     * Turn counting of native objects by type on or off.
+     * <p>
+     * Off by default.  While on, every native object made (packets,
+     * pictures, audio, buffers, rationals, coders and so on) is counted
+     * against its concrete type, and buffers count their bytes against
+     * the type that asked for them.  This costs a few atomic
+     * adds per object made and destroyed, so leave it off unless you are
+     * chasing memory growth.
+     * </p><p>
+     * The counters can be sampled from any thread while media is being
+     * processed.  Objects made while counting was off are never counted.
+     * </p>
+     * @param enabled true to count.
+     */
+    static void setObjectCounting(bool enabled);
+
+    /**
+     * @return true if native objects are being counted.
+     * @see #setObjectCounting(boolean)
+     */
+    static bool isObjectCounting();
+
+    /**
+     * @return The number of native types counted so far.  Types are
+     *   numbered from 0 in the order they were first seen, and a type
+     *   keeps its number.
+     */
+    static int32_t getNumObjectTypes();
+
+    /**
+     * @param index A type number from 0 to #getNumObjectTypes()-1.
+     * @return The native name of that type (for example
+     *   "io::humble::video::MediaPacketImpl"), or null.
+     */
+    static const char* getObjectTypeName(int32_t index);
+
+    /**
+     * @param index A type number from 0 to #getNumObjectTypes()-1.
+     * @return The number of objects of that type alive now.
+     */
+    static int64_t getLiveObjects(int32_t index);
+
+    /**
+     * @param index A type number from 0 to #getNumObjectTypes()-1.
+     * @return The number of objects of that type made while counting
+     *   was on.
+     */
+    static int64_t getCreatedObjects(int32_t index);
+
+    /**
+     * @param index A type number from 0 to #getNumObjectTypes()-1.
+     * @return The bytes of Buffer memory objects of that type hold now.
+     */
+    static int64_t getObjectBytes(int32_t index);
+
+    /**
+     * Turn on the probe cache, and set how many files it remembers.
+     * <p>
+     * Demuxer#queryStreamMetaData() normally decodes the first part of a
+     * file to learn its codec parameters, which is the slow part of
+     * opening most media.  With the cache on, what it learned is kept
+     * (keyed by path, size and modification time for local files, or by
+     * size and a hash of the first 64 KiB for custom IO) and reused the
+     * next time the same file is opened in this process.  Useful for
+     * services that open the same assets over and over.
+     * </p>
+     * @param entries How many files to remember; 0 (the default) turns the
+     *   cache off and empties it.
+     */
+    static void setProbeCacheCapacity(int32_t entries);
+
+    /**
+     * @return How many files the probe cache remembers; 0 if it is off.
+     */
+    static int32_t getProbeCacheCapacity();
+
+    /**
+     * Empty the probe cache, for example after media files are replaced
+     * in ways that keep their size and modification time.
+     */
+    static void clearProbeCache();
+
+    /**
+     * @return The number of probes the cache has answered.
+     */
+    static int64_t getProbeCacheHits();
+
+    /**
+     * @return The number of cacheable probes the cache could not answer.
+     */
+    static int64_t getProbeCacheMisses();
+
+    /**
+     * @return The total time, in microseconds, the original probes took
+     *   for every probe the cache has answered.
+     */
+    static int64_t getProbeCacheTimeSaved();
+
   private:
     Global();
     virtual ~Global();
     static void destroyStaticGlobal(JavaVM*vm,void*closure);
+    static int64_t sumLockStatistic(int64_t (io::humble::ferry::Mutex::*stat)());
 
     static Global* sGlobal;
     io::humble::ferry::Mutex* mLock;
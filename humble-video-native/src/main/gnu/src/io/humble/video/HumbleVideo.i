@@ -33,6 +33,10 @@
 #include <io/humble/video/MediaPicture.h>
 #include <io/humble/video/MediaSubtitle.h>
 #include <io/humble/video/MediaPacket.h>
+#include <io/humble/video/MediaPacketBatch.h>
+#include <io/humble/video/BulkProbe.h>
+#include <io/humble/video/IOStatistics.h>
+#include <io/humble/video/Thumbnailer.h>
 #include <io/humble/video/Configurable.h>
 #include <io/humble/video/MediaResampler.h>
 #include <io/humble/video/MediaPictureResampler.h>
@@ -89,6 +93,7 @@ Java_io_humble_video_Video_init(JNIEnv *env, jclass)
 
 %pragma(java) jniclassimports=%{
 import io.humble.ferry.Buffer;
+import io.humble.ferry.CancellationToken;
 %}
 
 %pragma(java) moduleimports=%{
@@ -186,6 +191,8 @@ import io.humble.ferry.Buffer;
 %include <io/humble/video/MediaPicture.swg>
 %include <io/humble/video/MediaSubtitle.swg>
 %include <io/humble/video/MediaPacket.swg>
+%include <io/humble/video/MediaPacketBatch.h>
+%include <io/humble/video/IOStatistics.h>
 %include <io/humble/video/Configurable.swg>
 %include <io/humble/video/MediaResampler.h>
 %include <io/humble/video/MediaPictureResampler.swg>
@@ -204,6 +211,8 @@ import io.humble.ferry.Buffer;
 %include <io/humble/video/DemuxerStream.swg>
 %include <io/humble/video/Muxer.swg>
 %include <io/humble/video/Demuxer.swg>
+%include <io/humble/video/BulkProbe.h>
+%include <io/humble/video/Thumbnailer.swg>
 %include <io/humble/video/FilterType.swg>
 %include <io/humble/video/FilterGraph.swg>
 %include <io/humble/video/Filter.swg>
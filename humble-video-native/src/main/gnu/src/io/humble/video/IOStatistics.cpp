@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+
+#include <io/humble/video/IOStatistics.h>
+
+using namespace io::humble::ferry;
+using namespace io::humble::video::customio;
+
+namespace io {
+namespace humble {
+namespace video {
+
+IOStatistics::IOStatistics() {
+  mBufferLength = 0;
+  mBytesRead = 0;
+  mBytesWritten = 0;
+  mSeekDistance = 0;
+  memset(mCalls, 0, sizeof(mCalls));
+  memset(mErrors, 0, sizeof(mErrors));
+  memset(mLatency, 0, sizeof(mLatency));
+  memset(mBuckets, 0, sizeof(mBuckets));
+}
+
+IOStatistics::~IOStatistics() {
+}
+
+IOStatistics*
+IOStatistics::make(InstrumentedURLProtocolHandler* handler,
+    int32_t bufferLength) {
+  IOStatistics* retval = new IOStatistics();
+  VS_REF_ACQUIRE(retval);
+  retval->mBufferLength = bufferLength;
+  if (handler) {
+    retval->mBytesRead = handler->getBytesRead();
+    retval->mBytesWritten = handler->getBytesWritten();
+    retval->mSeekDistance = handler->getSeekDistance();
+    for(int32_t i = 0; i < NUM_OPERATIONS; i++) {
+      InstrumentedURLProtocolHandler::Operation op =
+          (InstrumentedURLProtocolHandler::Operation)i;
+      retval->mCalls[i] = handler->getCalls(op);
+      retval->mErrors[i] = handler->getErrors(op);
+      retval->mLatency[i] = handler->getTotalLatency(op);
+      for(int32_t j = 0; j < NUM_BUCKETS; j++)
+        retval->mBuckets[i][j] = handler->getLatencyCount(op, j);
+    }
+  }
+  return retval;
+}
+
+int32_t
+IOStatistics::getNumLatencyBuckets() {
+  return NUM_BUCKETS;
+}
+
+int64_t
+IOStatistics::getLatencyBucketStart(int32_t bucket) {
+  if (bucket < 0 || bucket >= NUM_BUCKETS)
+    return -1;
+  return bucket ? 1LL << bucket : 0;
+}
+
+void
+IOStatistics::resetTunedBufferLengths() {
+  InstrumentedURLProtocolHandler::resetTunedBufferLengths();
+}
+
+int64_t
+IOStatistics::getCalls(Operation op) {
+  return isValid(op) ? mCalls[op] : 0;
+}
+
+int64_t
+IOStatistics::getErrors(Operation op) {
+  return isValid(op) ? mErrors[op] : 0;
+}
+
+int64_t
+IOStatistics::getTotalLatency(Operation op) {
+  return isValid(op) ? mLatency[op] : 0;
+}
+
+int64_t
+IOStatistics::getLatencyCount(Operation op, int32_t bucket) {
+  if (!isValid(op) || bucket < 0 || bucket >= NUM_BUCKETS)
+    return 0;
+  return mBuckets[op][bucket];
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef IOSTATISTICS_H_
+#define IOSTATISTICS_H_
+
+#include <io/humble/ferry/RefCounted.h>
+#include <io/humble/video/HumbleVideo.h>
+#include <io/humble/video/customio/InstrumentedURLProtocolHandler.h>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * What a Demuxer or Muxer's I/O has done so far: bytes, calls, seeks,
+ * errors and how long the calls took.
+ * <p>
+ * Turn it on with Demuxer#setIOInstrumented(boolean) or
+ * Muxer#setIOInstrumented(boolean) before opening, then ask for a
+ * snapshot with getIOStatistics() at any time, from any thread; the
+ * snapshot does not change after it is taken.  It counts the calls
+ * FFmpeg makes to fill (or drain) the Demuxer's input buffer (or the
+ * Muxer's output buffer), so together with #getBufferLength() it tells
+ * whether a slow job is waiting on I/O.
+ * </p><p>
+ * Latencies are counted in power of 2 buckets; see
+ * #getLatencyBucketStart(int).
+ * </p>
+ */
+class VS_API_HUMBLEVIDEO IOStatistics : public io::humble::ferry::RefCounted
+{
+public:
+  /** The kinds of call counted; the same order as the handler's. */
+  typedef enum Operation {
+    READ=0,
+    WRITE=1,
+    SEEK=2,
+  } Operation;
+
+  /**
+   * @return The number of latency buckets.
+   */
+  static int32_t getNumLatencyBuckets();
+
+  /**
+   * @return The shortest latency, in microseconds, counted in the given
+   *   bucket; each bucket ends where the next starts, and the last has no
+   *   end.  -1 if bucket is out of range.
+   */
+  static int64_t getLatencyBucketStart(int32_t bucket);
+
+  /**
+   * Forget the buffer lengths learned by instrumented Demuxers and Muxers
+   * for the protocols they used, so the next ones start from the
+   * defaults again.
+   */
+  static void resetTunedBufferLengths();
+
+  /**
+   * @return The buffer length the Demuxer or Muxer gave FFmpeg when it
+   *   opened.
+   */
+  int32_t getBufferLength() { return mBufferLength; }
+
+  int64_t getBytesRead() { return mBytesRead; }
+
+  int64_t getBytesWritten() { return mBytesWritten; }
+
+  /**
+   * @return The bytes skipped or rewound by seeks, added up.
+   */
+  int64_t getSeekDistance() { return mSeekDistance; }
+
+  /**
+   * @return The successful calls of the given kind.
+   */
+  int64_t getCalls(Operation op);
+
+  /**
+   * @return The calls of the given kind that returned an error.
+   */
+  int64_t getErrors(Operation op);
+
+  /**
+   * @return The microseconds spent in calls of the given kind.
+   */
+  int64_t getTotalLatency(Operation op);
+
+  /**
+   * @return How many calls of the given kind took a time in the given
+   *   bucket, or 0 if bucket is out of range.
+   */
+  int64_t getLatencyCount(Operation op, int32_t bucket);
+
+#ifndef SWIG
+  /**
+   * Take a snapshot of what handler has counted.
+   */
+  static IOStatistics* make(
+      io::humble::video::customio::InstrumentedURLProtocolHandler* handler,
+      int32_t bufferLength);
+#endif // ! SWIG
+
+protected:
+  IOStatistics();
+  virtual
+  ~IOStatistics();
+
+private:
+  static const int32_t NUM_OPERATIONS=
+      io::humble::video::customio::InstrumentedURLProtocolHandler::NUM_OPERATIONS;
+  static const int32_t NUM_BUCKETS=
+      io::humble::video::customio::InstrumentedURLProtocolHandler::NUM_LATENCY_BUCKETS;
+  static bool isValid(Operation op) { return op >= 0 && op < NUM_OPERATIONS; }
+
+  int32_t mBufferLength;
+  int64_t mBytesRead;
+  int64_t mBytesWritten;
+  int64_t mSeekDistance;
+  int64_t mCalls[NUM_OPERATIONS];
+  int64_t mErrors[NUM_OPERATIONS];
+  int64_t mLatency[NUM_OPERATIONS];
+  int64_t mBuckets[NUM_OPERATIONS][NUM_BUCKETS];
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* IOSTATISTICS_H_ */
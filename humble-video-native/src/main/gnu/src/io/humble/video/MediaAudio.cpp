@@ -28,6 +28,7 @@
 #include <io/humble/ferry/Logger.h>
 #include <io/humble/ferry/HumbleException.h>
 #include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/RationalImpl.h>
 
 using namespace io::humble::ferry;
 
@@ -116,7 +117,7 @@ MediaAudio::make(io::humble::ferry::Buffer* buffer, int32_t numSamples,
   // free them and replace them with their own objects, so we
   // must let mFrame->buf[] and mFrame->extended_buf[] win.
   RefPointer<MediaAudio> retval = make();
-  RefPointer<Rational> tb = Rational::make(1,sampleRate); // a sensible default.
+  RefPointer<Rational> tb = RationalImpl::intern(1,sampleRate); // a sensible default.
   retval->setTimeBase(tb.value());
   AVFrame* frame = retval->mFrame;
   av_frame_set_sample_rate(frame, sampleRate);
@@ -177,7 +178,7 @@ MediaAudio::copy(AVFrame* src, bool complete) {
   if (!src)
     VS_THROW(HumbleInvalidArgument("no src"));
   // release any memory we have
-  RefPointer<Rational> timeBase = Rational::make(1, src->sample_rate); // a default
+  RefPointer<Rational> timeBase = RationalImpl::intern(1, src->sample_rate); // a default
   setTimeBase(timeBase.value());
   av_frame_unref(mFrame);
   // and copy any data in.
@@ -185,6 +186,17 @@ MediaAudio::copy(AVFrame* src, bool complete) {
   mComplete=complete;
 }
 
+void
+MediaAudio::move(AVFrame* src, bool complete) {
+  if (!src)
+    VS_THROW(HumbleInvalidArgument("no src"));
+  RefPointer<Rational> timeBase = RationalImpl::intern(1, src->sample_rate); // a default
+  setTimeBase(timeBase.value());
+  av_frame_unref(mFrame);
+  av_frame_move_ref(mFrame, src);
+  mComplete=complete;
+}
+
 MediaAudio*
 MediaAudio::make(MediaAudio* src, bool copy) {
   Global::init();
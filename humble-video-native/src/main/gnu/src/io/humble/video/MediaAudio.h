@@ -583,6 +583,9 @@ public:
   virtual AVFrame* getCtx();
   // Copies data from src into this context, first releasing any memory we have.
   virtual void copy(AVFrame* src, bool complete);
+  // Like copy, but takes src's references rather than adding new ones,
+  // leaving src empty.
+  virtual void move(AVFrame* src, bool complete);
   virtual int64_t logMetadata(char *, size_t);
 #endif
 
@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/HumbleException.h>
+#include <io/humble/video/MediaPacketBatch.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE.MediaPacketBatch);
+
+using namespace io::humble::ferry;
+
+namespace io {
+namespace humble {
+namespace video {
+
+MediaPacketBatch::MediaPacketBatch() {
+  mSize = 0;
+}
+
+MediaPacketBatch::~MediaPacketBatch() {
+}
+
+MediaPacketBatch*
+MediaPacketBatch::make(int32_t capacity) {
+  if (capacity <= 0)
+    VS_THROW(HumbleInvalidArgument("capacity must be > 0"));
+  // held until fully built, so a throw part way through frees it.
+  RefPointer<MediaPacketBatch> retval;
+  retval.reset(new MediaPacketBatch(), true);
+  retval->mPackets.resize(capacity);
+  for(int32_t i = 0; i < capacity; i++)
+    retval->mPackets[i] = MediaPacket::make();
+  return retval.get();
+}
+
+MediaPacket*
+MediaPacketBatch::getPacket(int32_t index) {
+  if (index < 0 || index >= getCapacity())
+    VS_THROW(HumbleInvalidArgument("index out of range"));
+  return mPackets[index].get();
+}
+
+void
+MediaPacketBatch::setSize(int32_t size) {
+  mSize = size < 0 ? 0 : (size > getCapacity() ? getCapacity() : size);
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
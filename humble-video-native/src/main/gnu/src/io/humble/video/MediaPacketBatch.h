@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MEDIAPACKETBATCH_H_
+#define MEDIAPACKETBATCH_H_
+
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/MediaPacket.h>
+
+#include <vector>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * A fixed set of MediaPackets that Demuxer#readBatch(MediaPacketBatch)
+ * fills in one call.
+ * <p>
+ * The batch always holds the same packet objects, and each call to
+ * Demuxer#readBatch(MediaPacketBatch) refills them from the start, so
+ * Java callers can fetch every packet once with #getPacket(int) and keep
+ * using them.  Anything that must outlive the next batch should be copied
+ * with MediaPacket#make(MediaPacket, boolean).
+ * </p>
+ */
+class VS_API_HUMBLEVIDEO MediaPacketBatch : public io::humble::ferry::RefCounted
+{
+public:
+  /**
+   * Make a batch of empty packets.
+   *
+   * @param capacity The number of packets; must be > 0.
+   */
+  static MediaPacketBatch* make(int32_t capacity);
+
+  /**
+   * @return The number of packets in this batch.
+   */
+  int32_t getCapacity() { return (int32_t) mPackets.size(); }
+
+  /**
+   * @return The number of packets filled by the last read; packets
+   *   0 to getSize()-1 hold data.
+   */
+  int32_t getSize() { return mSize; }
+
+  /**
+   * @param index Which packet, from 0 to #getCapacity()-1.
+   * @return The packet at that position.  The same object is returned
+   *   every time.
+   */
+  MediaPacket* getPacket(int32_t index);
+
+#ifndef SWIG
+  /** Set the number of filled packets. */
+  void setSize(int32_t size);
+  /** The packet at index without taking a reference; index is not checked. */
+  MediaPacket* peekPacket(int32_t index) { return mPackets[index].value(); }
+#endif // ! SWIG
+
+protected:
+  MediaPacketBatch();
+  virtual
+  ~MediaPacketBatch();
+
+private:
+  std::vector<io::humble::ferry::RefPointer<MediaPacket> > mPackets;
+  int32_t mSize;
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* MEDIAPACKETBATCH_H_ */
@@ -47,6 +47,7 @@ MediaPictureImpl::MediaPictureImpl() :
 }
 
 MediaPictureImpl::~MediaPictureImpl() {
+  resetDataBuffers();
   av_frame_free(&mFrame);
 }
 
@@ -183,6 +184,8 @@ MediaPictureImpl::make(MediaPictureImpl* src, bool copy) {
     // then do the reference
     retval->mComplete = src->mComplete;
     av_frame_ref(retval->mFrame, src->mFrame);
+    for(int32_t i = 0; i < AV_NUM_DATA_POINTERS; i++)
+      retval->mDataBuffers[i] = src->mDataBuffers[i];
   }
   // set the timebase
   retval->setComplete(src->isComplete());
@@ -195,6 +198,7 @@ MediaPictureImpl::copy(AVFrame* src, bool complete) {
   if (!src)
     VS_THROW(HumbleInvalidArgument("no src"));
   // release any memory we have
+  resetDataBuffers();
   av_frame_unref(mFrame);
   // and copy any data in.
   av_frame_ref(mFrame, src);
@@ -203,6 +207,28 @@ MediaPictureImpl::copy(AVFrame* src, bool complete) {
   mComplete=complete;
 }
 
+void
+MediaPictureImpl::move(AVFrame* src, bool complete) {
+  if (!src)
+    VS_THROW(HumbleInvalidArgument("no src"));
+  resetDataBuffers();
+  av_frame_unref(mFrame);
+  av_frame_move_ref(mFrame, src);
+  mComplete=complete;
+}
+
+void
+MediaPictureImpl::setDataBuffer(int32_t plane, Buffer* buffer) {
+  validatePlane(plane);
+  mDataBuffers[plane].reset(buffer, true);
+}
+
+void
+MediaPictureImpl::resetDataBuffers() {
+  for(int32_t i = 0; i < AV_NUM_DATA_POINTERS; i++)
+    mDataBuffers[i] = 0;
+}
+
 void
 MediaPictureImpl::setComplete(bool val) {
   mComplete = val;
@@ -227,6 +253,12 @@ MediaPictureImpl::getData(int32_t plane) {
   // it in an Buffer
   // now we're guaranteed that we should have a plane.
   RefPointer<Buffer> buffer;
+  // the Buffer we decoded into, unless the plane has since changed or
+  // been cropped so it no longer starts where the Buffer does.
+  Buffer* known = mDataBuffers[plane].value();
+  if (known && mFrame->data[plane] &&
+      mFrame->data[plane] == known->getBytes(0, 1))
+    return mDataBuffers[plane].get();
   if (mFrame->buf[plane])
     buffer = AVBufferSupport::wrapAVBuffer(this,
         mFrame->buf[plane], mFrame->data[plane], mFrame->buf[plane]->size);
@@ -28,6 +28,7 @@
 
 #include <io/humble/ferry/HumbleException.h>
 #include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/RefPointer.h>
 #include <io/humble/video/MediaPicture.h>
 
 namespace io {
@@ -50,6 +51,19 @@ public:
 
   void copy(AVFrame*, bool complete);
 
+  /**
+   * Like #copy, but takes src's references rather than adding new ones,
+   * leaving src empty.
+   */
+  void move(AVFrame* src, bool complete);
+
+  /**
+   * Tell this picture which Buffer holds a plane it got from #copy, so
+   * #getData returns that rather than wrapping the plane anew.
+   * Forgotten on the next #copy.
+   */
+  void setDataBuffer(int32_t plane, io::humble::ferry::Buffer* buffer);
+
   virtual io::humble::ferry::Buffer*
   getData(int32_t plane);
 
@@ -144,7 +158,13 @@ protected:
 
 private:
   void validatePlane(int32_t plane);
+  void resetDataBuffers();
   AVFrame* mFrame;
+  /**
+   * Buffers behind mFrame's planes, if known. Dropped before mFrame is
+   * unreferenced, so a pool sees its Buffers are free again.
+   */
+  io::humble::ferry::RefPointer<io::humble::ferry::Buffer> mDataBuffers[AV_NUM_DATA_POINTERS];
   bool     mComplete;
 };
 
@@ -25,13 +25,17 @@
 
 #include <io/humble/ferry/JNIHelper.h>
 #include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/Trace.h>
 #include <io/humble/video/customio/URLProtocolManager.h>
+#include <io/humble/video/customio/InstrumentedURLProtocolHandler.h>
 
 #include "Muxer.h"
+#include "FfmpegURLProtocolHandler.h"
 #include "Decoder.h"
 #include "VideoExceptions.h"
 #include "KeyValueBagImpl.h"
 #include "MediaPacketImpl.h"
+#include "RationalImpl.h"
 
 VS_LOG_SETUP(VS_CPP_PACKAGE.Muxer);
 
@@ -62,6 +66,10 @@ Muxer::Muxer(MuxerFormat* format, const char* filename,
   mState = STATE_INITED;
   mIOHandler = 0;
   mBufferLength = 2048;
+  mBufferLengthSet = false;
+  mIOInstrumented = false;
+  mIOInstrument = 0;
+  pthread_mutex_init(&mIOStatisticsLock, 0);
 
   mCtx = 0;
   int e = avformat_alloc_output_context2(&mCtx, format ? format->getCtx() : 0, formatName,
@@ -72,7 +80,7 @@ Muxer::Muxer(MuxerFormat* format, const char* filename,
   }
   if (!filename || !*filename) mCtx->filename[0] = 0;
   mCtx->interrupt_callback.callback = Global::avioInterruptCB;
-  mCtx->interrupt_callback.opaque = this;
+  mCtx->interrupt_callback.opaque = static_cast<Container*>(this);
 
   // now let's look at the output format; it should have been guessed.
   if (!format) {
@@ -96,7 +104,7 @@ Muxer::Muxer(MuxerFormat* format, const char* filename,
               filename, formatName));
     }
   }
-  VS_LOG_TRACE("Created: %p", this);
+  VS_TRACE("Created: %p", this);
 }
 
 Muxer::~Muxer() {
@@ -113,7 +121,8 @@ Muxer::~Muxer() {
     }
     avformat_free_context(mCtx);
   }
-  VS_LOG_TRACE("Destroyed: %p", this);
+  pthread_mutex_destroy(&mIOStatisticsLock);
+  VS_TRACE("Destroyed: %p", this);
 }
 
 Muxer*
@@ -138,6 +147,7 @@ Muxer::setOutputBufferLength(int32_t size) {
   if (mState != STATE_INITED)
   VS_THROW(HumbleRuntimeError("Muxer object has already been opened"));
   mBufferLength = size;
+  mBufferLengthSet = true;
 }
 
 int32_t
@@ -145,8 +155,33 @@ Muxer::getOutputBufferLength() {
   return mBufferLength;
 }
 
+void
+Muxer::setIOInstrumented(bool instrumented) {
+  if (mState != STATE_INITED)
+    VS_THROW(HumbleRuntimeError("Muxer object has already been opened"));
+  mIOInstrumented = instrumented;
+}
+
+IOStatistics*
+Muxer::getIOStatistics() {
+  RefPointer<IOStatistics> retval;
+  pthread_mutex_lock(&mIOStatisticsLock);
+  try {
+    if (mIOInstrument)
+      retval = IOStatistics::make(mIOInstrument, mBufferLength);
+    else
+      retval = mIOStatisticsAtClose;
+  } catch (std::exception &) {
+    pthread_mutex_unlock(&mIOStatisticsLock);
+    throw;
+  }
+  pthread_mutex_unlock(&mIOStatisticsLock);
+  return retval.get();
+}
+
 void
 Muxer::open(KeyValueBag *aInputOptions, KeyValueBag* aOutputOptions) {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   AVFormatContext* ctx = this->getFormatCtx();
   int retval = -1;
   if (mState != STATE_INITED) {
@@ -165,6 +200,22 @@ Muxer::open(KeyValueBag *aInputOptions, KeyValueBag* aOutputOptions) {
   mIOHandler = URLProtocolManager::findHandler(mCtx->filename,
       URLProtocolHandler::URL_WRONLY_MODE, 0);
 
+  if (mIOInstrumented) {
+    // FFmpeg's own protocols get a handler too, so they can be counted
+    if (!mIOHandler && (!fmt || !(fmt->flags & AVFMT_NOFILE)))
+      mIOHandler = new FfmpegURLProtocolHandler(&ctx->interrupt_callback);
+    if (mIOHandler) {
+      pthread_mutex_lock(&mIOStatisticsLock);
+      mIOInstrument = new InstrumentedURLProtocolHandler(mIOHandler);
+      mIOHandler = mIOInstrument;
+      mIOStatisticsAtClose = 0;
+      pthread_mutex_unlock(&mIOStatisticsLock);
+      if (!mBufferLengthSet)
+        mBufferLength = InstrumentedURLProtocolHandler::getTunedBufferLength(
+            url, URLProtocolHandler::URL_WRONLY_MODE, mBufferLength);
+    }
+  }
+
   if (mIOHandler) {
     ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
     // free and realloc the input buffer length
@@ -238,11 +289,13 @@ Muxer::open(KeyValueBag *aInputOptions, KeyValueBag* aOutputOptions) {
 
   mState = STATE_OPENED;
   // let's log the state of the world.
-  logOpen(this);
+  if (VS_TRACE_IS_ENABLED())
+    logOpen(this);
 }
 
 void
 Muxer::close() {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   if (getState() != STATE_OPENED) {
     VS_THROW(HumbleRuntimeError::make("closed container that was not open"));
   }
@@ -256,6 +309,17 @@ Muxer::close() {
   }
   if (mIOHandler) {
     e = mIOHandler->url_close();
+    if (mIOInstrument) {
+      // keep the totals around for callers that ask after closing
+      pthread_mutex_lock(&mIOStatisticsLock);
+      try {
+        mIOStatisticsAtClose = IOStatistics::make(mIOInstrument, mBufferLength);
+      } catch (std::exception &) {
+        mIOStatisticsAtClose = 0;
+      }
+      mIOInstrument = 0;
+      pthread_mutex_unlock(&mIOStatisticsLock);
+    }
   } else if (!(ctx->flags & AVFMT_NOFILE))
     e = avio_close(ctx->pb);
   FfmpegException::check(e, "could not close url ");
@@ -329,13 +393,13 @@ Muxer::addNewStream(Coder* aCoder) {
 
 
   // let's log the state of the world.
-  VS_LOG_TRACE("addNewStream Muxer@%p[i:%"PRId32";c:%p;tb:%"PRId32"/%"PRId32"]",
-               this,
-               (int32_t)avStream->index,
-               coder.value(),
-               (int32_t)avStream->time_base.num,
-               (int32_t)avStream->time_base.den
-               );
+  VS_TRACE("addNewStream Muxer@%p[i:%"PRId32";c:%p;tb:%"PRId32"/%"PRId32"]",
+           this,
+           (int32_t)avStream->index,
+           coder.value(),
+           (int32_t)avStream->time_base.num,
+           (int32_t)avStream->time_base.den
+           );
   return r.get();
 }
 
@@ -357,65 +421,57 @@ Muxer::getStream(int32_t i) {
 void
 Muxer::logWrite(Muxer* muxer, MediaPacket* in, MediaPacket* out, int32_t retval)
 {
-  // necessary to avoid a compiler warning in release mode since
-  // in that case, this is a NO_OP method.
-  (void) muxer;
-  (void) in;
-  (void) out;
-  (void) retval;
-#ifdef VS_DEBUG
+  // callers check VS_TRACE_IS_ENABLED() first.
   char inDescr[256];
   char outDescr[256];
   if (in)
     in->logMetadata(inDescr, sizeof(inDescr));
   if (out)
     out->logMetadata(outDescr, sizeof(outDescr));
-  VS_LOG_TRACE("write Muxer@%p[out:%s;in:%s;e:%"  PRIi64 "]",
-               muxer,
-               out?outDescr:"(null)",
-               in?inDescr:"(null)",
-               (int64_t)retval);
-#endif // VS_DEBUG
+  VS_TRACE_EMIT("write Muxer@%p[out:%s;in:%s;e:%"  PRIi64 "]",
+                muxer,
+                out?outDescr:"(null)",
+                in?inDescr:"(null)",
+                (int64_t)retval);
 }
 
 void
 Muxer::logOpen(Muxer* muxer) {
-  (void) muxer;
-#ifdef VS_DEBUG
-  // We only do this in debug mode. Because a muxer can have effectively
-  // an unlimited number of strings, we need to build our log up piece meal.
+  // callers check VS_TRACE_IS_ENABLED() first.
+  // Because a muxer can have effectively an unlimited number of
+  // streams, we need to build our log up piece meal.
 
   int32_t n = muxer->getNumStreams();
 
-  char msg[4096];
-  char* buf = msg;
-  size_t bufSize = sizeof(msg);
-  int32_t chars = snprintf(buf, bufSize, "open Muxer@%p[u:%s;n:%"PRId32";", muxer,
+  char msg[Trace::MAX_MESSAGE_LENGTH];
+  size_t used = 0;
+  int32_t chars = snprintf(msg, sizeof(msg), "open Muxer@%p[u:%s;n:%"PRId32";", muxer,
                            muxer->getURL(),
                            (int32_t)n);
-  buf += chars;
-  bufSize -= chars;
+  if (chars > 0)
+    used += chars;
 
-  for(int i = 0; i < n; i++) {
+  for(int i = 0; i < n && used < sizeof(msg); i++) {
     Container::Stream* s = ((Container*)muxer)->getStream(i);
     RefPointer<Coder> c = s->getCoder();
     AVStream* avStream = s->getCtx();
-    chars = snprintf(buf, bufSize, "s@%"PRId32"[c:%p;tb:%"PRId32"/%"PRId32"];",
+    chars = snprintf(msg+used, sizeof(msg)-used, "s@%"PRId32"[c:%p;tb:%"PRId32"/%"PRId32"];",
            (int32_t)i,
            c.value(),
            (int32_t)avStream->time_base.num,
            (int32_t)avStream->time_base.den
     );
-    buf+= chars;
-    bufSize -= chars;
+    if (chars > 0)
+      used += chars;
   }
-  chars = snprintf(buf, bufSize, "]");
-  VS_LOG_TRACE(msg);
-#endif
+  if (used < sizeof(msg))
+    snprintf(msg+used, sizeof(msg)-used, "]");
+  VS_TRACE_EMIT("%s", msg);
 }
 
 bool
 Muxer::write(MediaPacket* aPacket, bool forceInterleave) {
+  CancellationToken::Scope cancellationScope(peekCancellationToken());
   MediaPacketImpl* packet = dynamic_cast<MediaPacketImpl*>(aPacket);
   bool allDataFlushed = false;
 
@@ -475,7 +531,8 @@ Muxer::write(MediaPacket* aPacket, bool forceInterleave) {
   else
     e = av_write_frame(getFormatCtx(), out);
   popCoders();
-  Muxer::logWrite(this, aPacket, outPacket.value(), e);
+  if (VS_TRACE_IS_ENABLED())
+    Muxer::logWrite(this, aPacket, outPacket.value(), e);
   FfmpegException::check(e, "Could not write packet to muxer ");
   if (e == 1)
     allDataFlushed = true;
@@ -501,12 +558,16 @@ Muxer::stampOutputPacket(Container::Stream* stream, MediaPacket* packet) {
 
   AVStream* avStream = stream->getCtx();
 
-  io::humble::ferry::RefPointer<Rational> thisBase = Rational::make(avStream->time_base.num, avStream->time_base.den);
-  io::humble::ferry::RefPointer<Rational> packetBase = packet->getTimeBase();
-  if (!thisBase || !packetBase) {
+  // work with plain AVRationals; this runs for every packet written.
+  const AVRational thisBase = avStream->time_base;
+  io::humble::ferry::RefPointer<Rational> packetRational = packet->getTimeBase();
+  if (!packetRational) {
     VS_THROW(HumbleRuntimeError("no timebases on either stream or packet"));
   }
-  if (thisBase->compareTo(packetBase.value()) == 0) {
+  AVRational packetBase;
+  packetBase.num = packetRational->getNumerator();
+  packetBase.den = packetRational->getDenominator();
+  if (av_cmp_q(thisBase, packetBase) == 0) {
     // it's already got the right time values
     return;
   }
@@ -516,14 +577,16 @@ Muxer::stampOutputPacket(Container::Stream* stream, MediaPacket* packet) {
   int64_t pts = packet->getPts();
 
   if (duration >= 0)
-    duration = thisBase->rescale(duration, packetBase.value(),
-      Rational::ROUND_DOWN);
+    duration = Rational::rescale(duration, thisBase.num, thisBase.den,
+      packetBase.num, packetBase.den, Rational::ROUND_DOWN);
 
   if (pts != Global::NO_PTS) {
-    pts = thisBase->rescale(pts, packetBase.value(), Rational::ROUND_DOWN);
+    pts = Rational::rescale(pts, thisBase.num, thisBase.den,
+      packetBase.num, packetBase.den, Rational::ROUND_DOWN);
   }
   if (dts != Global::NO_PTS) {
-    dts = thisBase->rescale(dts, packetBase.value(), Rational::ROUND_DOWN);
+    dts = Rational::rescale(dts, thisBase.num, thisBase.den,
+      packetBase.num, packetBase.den, Rational::ROUND_DOWN);
     if (stream->getLastDts() != Global::NO_PTS && dts == stream->getLastDts()) {
       // adjust for rounding; we never want to insert a frame that
       // is not monotonically increasing.  Note we only do this if
@@ -543,7 +606,8 @@ Muxer::stampOutputPacket(Container::Stream* stream, MediaPacket* packet) {
   packet->setDuration(duration);
   packet->setPts(pts);
   packet->setDts(dts);
-  packet->setTimeBase(thisBase.value());
+  io::humble::ferry::RefPointer<Rational> interned = RationalImpl::intern(thisBase);
+  packet->setTimeBase(interned.value());
 }
 
 
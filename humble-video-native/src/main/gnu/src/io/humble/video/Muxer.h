@@ -31,11 +31,13 @@
 #include <io/humble/video/KeyValueBag.h>
 #include <io/humble/video/MuxerStream.h>
 #include <io/humble/video/Encoder.h>
+#include <io/humble/video/IOStatistics.h>
 
 #ifndef SWIG
 #ifdef MUXER_H_
 
 #include <io/humble/video/customio/URLProtocolHandler.h>
+#include <pthread.h>
 
 #endif
 #endif // ! SWIG
@@ -163,6 +165,38 @@ public:
   virtual int32_t
   getOutputBufferLength();
 
+  /**
+   * Count and time every write and seek this Muxer makes; see
+   * #getIOStatistics().  Works for customio protocols and for any
+   * protocol FFmpeg writes as a stream of bytes, but not for formats that
+   * do their own networking, such as RTSP.
+   * <p>
+   * An instrumented Muxer also tunes its buffer: unless
+   * #setOutputBufferLength(int) was called, it opens with the length
+   * learned from earlier instrumented Muxers on the same server (or, for
+   * local files, in the same directory).
+   * </p>
+   *
+   * @param instrumented Whether to instrument the next open.
+   * @throws RuntimeException if this Muxer has already been opened.
+   */
+  virtual void
+  setIOInstrumented(bool instrumented);
+
+  /**
+   * @return Whether I/O is (or will be, once opened) instrumented.
+   */
+  virtual bool
+  isIOInstrumented() { return mIOInstrumented; }
+
+  /**
+   * @return A snapshot of this Muxer's I/O so far, or the totals at close
+   *   if it has been closed; null if I/O was not instrumented.  Safe to
+   *   call from any thread.
+   */
+  virtual IOStatistics*
+  getIOStatistics();
+
   /**
    * Adds a new stream that will have packets written to it.
    *
@@ -212,11 +246,12 @@ public:
 protected:
   virtual AVFormatContext* getFormatCtx() { return mCtx; }
   /**
-   * Function to log the write event as a trace
+   * Function to log the write event as a trace; only call if
+   * VS_TRACE_IS_ENABLED().
    */
   static void logWrite(Muxer* muxer, MediaPacket* in, MediaPacket* out, int32_t retval);
   /**
-   * Log an open.
+   * Log an open as a trace; only call if VS_TRACE_IS_ENABLED().
    */
   static void logOpen(Muxer*);
 
@@ -238,6 +273,13 @@ private:
 
   io::humble::ferry::RefPointer<MuxerFormat> mFormat;
   int32_t mBufferLength;
+  bool mBufferLengthSet;
+  bool mIOInstrumented;
+  /** mIOHandler, if it is instrumented. */
+  io::humble::video::customio::InstrumentedURLProtocolHandler* mIOInstrument;
+  /** Only read or changed with mIOStatisticsLock held. */
+  io::humble::ferry::RefPointer<IOStatistics> mIOStatisticsAtClose;
+  pthread_mutex_t mIOStatisticsLock;
 };
 
 } /* namespace video */
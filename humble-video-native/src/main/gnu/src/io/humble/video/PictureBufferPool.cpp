@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/video/PictureBufferPool.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE.PictureBufferPool);
+
+using namespace io::humble::ferry;
+
+namespace io {
+namespace humble {
+namespace video {
+
+// Planes start on a 64 byte boundary, which is at least as strict as
+// any STRIDE_ALIGN FFmpeg is built with. JNIMemoryManager may be set to
+// align less strictly, so each Buffer has room to round its start up.
+// Like FFmpeg we leave 16 more bytes at the end of each plane for SIMD
+// code that reads past it.
+static const int32_t PLANE_ALIGN=64;
+static const int32_t PLANE_PADDING=16 + PLANE_ALIGN - 1;
+
+PictureBufferPool::PictureBufferPool() {
+  pthread_mutex_init(&mLock, 0);
+  mWidth = 0;
+  mHeight = 0;
+  mFormat = AV_PIX_FMT_NONE;
+  mGeneration = 0;
+  memset(mLineSize, 0, sizeof(mLineSize));
+  memset(mPlaneSize, 0, sizeof(mPlaneSize));
+  mHits = 0;
+  mMisses = 0;
+  mBytesRetained = 0;
+}
+
+PictureBufferPool::~PictureBufferPool() {
+  // every handed out slot holds a reference, so only free ones are left
+  emptyFreeLists();
+  pthread_mutex_destroy(&mLock);
+}
+
+PictureBufferPool*
+PictureBufferPool::make() {
+  PictureBufferPool* retval = new PictureBufferPool();
+  VS_REF_ACQUIRE(retval);
+  return retval;
+}
+
+bool
+PictureBufferPool::configure(AVCodecContext* ctx, AVFrame* frame) {
+  if (mFormat == frame->format && mWidth == frame->width &&
+      mHeight == frame->height)
+    return true;
+
+  // the same arithmetic as update_frame_pool in libavcodec/utils.c
+  int w = frame->width;
+  int h = frame->height;
+  int align[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(ctx, &w, &h, align);
+
+  uint8_t* data[4];
+  int linesize[4];
+  int unaligned;
+  do {
+    // align the widest line and let the others follow, rather than
+    // aligning each, so ratios between linesizes are kept.
+    if (av_image_fill_linesizes(linesize,
+        (enum AVPixelFormat)frame->format, w) < 0)
+      return false;
+    w += w & ~(w - 1);
+
+    unaligned = 0;
+    for (int i = 0; i < 4; i++)
+      unaligned |= linesize[i] % align[i];
+  } while (unaligned);
+
+  int total = av_image_fill_pointers(data,
+      (enum AVPixelFormat)frame->format, h, 0, linesize);
+  if (total < 0)
+    return false;
+
+  int32_t size[4] = { 0, 0, 0, 0 };
+  int i = 0;
+  for (; i < 3 && data[i + 1]; i++)
+    size[i] = data[i + 1] - data[i];
+  size[i] = total - (data[i] - data[0]);
+
+  emptyFreeLists();
+  ++mGeneration;
+  for (i = 0; i < 4; i++) {
+    mLineSize[i] = linesize[i];
+    mPlaneSize[i] = size[i] ? size[i] + PLANE_PADDING : 0;
+  }
+  mWidth = frame->width;
+  mHeight = frame->height;
+  mFormat = frame->format;
+  VS_LOG_TRACE("PictureBufferPool@%p now %dx%d (%d): [%d, %d, %d, %d]",
+      this, mWidth, mHeight, mFormat,
+      mPlaneSize[0], mPlaneSize[1], mPlaneSize[2], mPlaneSize[3]);
+  return true;
+}
+
+PictureBufferPool::Slot*
+PictureBufferPool::takeSlot(int32_t plane) {
+  Slot* slot = 0;
+  if (!mFree[plane].empty()) {
+    slot = mFree[plane].back();
+    mFree[plane].pop_back();
+    mBytesRetained -= mPlaneSize[plane];
+    ++mHits;
+  } else {
+    Buffer* buffer = Buffer::make(0, Buffer::BUFFER_UINT8, mPlaneSize[plane], true);
+    if (!buffer)
+      return 0;
+    uint8_t* bytes = (uint8_t*)buffer->getBytes(0, mPlaneSize[plane]);
+    int32_t offset = (int32_t)(-(uintptr_t)bytes & (PLANE_ALIGN - 1));
+    if (offset) {
+      // hand out a Buffer that starts at the aligned byte, so the plane
+      // and the Buffer MediaPicture#getData returns still agree.
+      Buffer* aligned = Buffer::make(0, bytes + offset,
+          mPlaneSize[plane] - offset, Buffer::refCountedFreeFunc, buffer);
+      if (!aligned) {
+        buffer->release();
+        return 0;
+      }
+      buffer = aligned;
+    }
+    slot = new Slot;
+    slot->pool = this;
+    slot->buffer = buffer;
+    slot->plane = plane;
+    slot->generation = mGeneration;
+    mSlots.insert(slot);
+    ++mMisses;
+  }
+  return slot;
+}
+
+int
+PictureBufferPool::getBuffer(AVCodecContext* ctx, AVFrame* frame, int flags) {
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(
+      (enum AVPixelFormat)frame->format);
+  if (!desc || frame->data[0] || frame->width <= 0 || frame->height <= 0 ||
+      (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_PSEUDOPAL |
+          AV_PIX_FMT_FLAG_HWACCEL)))
+    return avcodec_default_get_buffer2(ctx, frame, flags);
+
+  int retval = 0;
+  pthread_mutex_lock(&mLock);
+  if (!configure(ctx, frame)) {
+    pthread_mutex_unlock(&mLock);
+    return avcodec_default_get_buffer2(ctx, frame, flags);
+  }
+  memset(frame->data, 0, sizeof(frame->data));
+  memset(frame->linesize, 0, sizeof(frame->linesize));
+  frame->extended_data = frame->data;
+  for (int32_t i = 0; i < 4 && mPlaneSize[i]; i++) {
+    Slot* slot = takeSlot(i);
+    if (!slot) {
+      retval = AVERROR(ENOMEM);
+      break;
+    }
+    int32_t size = slot->buffer->getBufferSize();
+    uint8_t* data = (uint8_t*)slot->buffer->getBytes(0, size);
+    frame->buf[i] = av_buffer_create(data, size,
+        PictureBufferPool::releaseSlot, slot, 0);
+    if (!frame->buf[i]) {
+      freeSlot(slot);
+      retval = AVERROR(ENOMEM);
+      break;
+    }
+    // the slot's reference on us is given up in releaseSlot
+    acquire();
+    frame->data[i] = data;
+    frame->linesize[i] = mLineSize[i];
+  }
+  pthread_mutex_unlock(&mLock);
+  if (retval < 0)
+    av_frame_unref(frame);
+  return retval;
+}
+
+Buffer*
+PictureBufferPool::getBuffer(AVBufferRef* ref) {
+  if (!ref)
+    return 0;
+  Slot* slot = static_cast<Slot*>(av_buffer_get_opaque(ref));
+  Buffer* retval = 0;
+  pthread_mutex_lock(&mLock);
+  if (mSlots.count(slot)) {
+    retval = slot->buffer;
+    retval->acquire();
+  }
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+void
+PictureBufferPool::releaseSlot(void* opaque, uint8_t* data) {
+  Slot* slot = static_cast<Slot*>(opaque);
+  PictureBufferPool* pool = slot->pool;
+  (void) data;
+  pool->recycle(slot);
+  // may delete the pool if its Decoder is gone
+  pool->release();
+}
+
+void
+PictureBufferPool::recycle(Slot* slot) {
+  pthread_mutex_lock(&mLock);
+  // a Buffer someone else still holds cannot be written into again
+  if (slot->generation == mGeneration &&
+      slot->buffer->getCurrentRefCount() == 1) {
+    mFree[slot->plane].push_back(slot);
+    mBytesRetained += mPlaneSize[slot->plane];
+  } else
+    freeSlot(slot);
+  pthread_mutex_unlock(&mLock);
+}
+
+void
+PictureBufferPool::freeSlot(Slot* slot) {
+  mSlots.erase(slot);
+  slot->buffer->release();
+  delete slot;
+}
+
+void
+PictureBufferPool::emptyFreeLists() {
+  for (int32_t i = 0; i < 4; i++) {
+    for (size_t j = 0; j < mFree[i].size(); j++)
+      freeSlot(mFree[i][j]);
+    mFree[i].clear();
+  }
+  mBytesRetained = 0;
+}
+
+int64_t
+PictureBufferPool::getHits() {
+  pthread_mutex_lock(&mLock);
+  int64_t retval = mHits;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int64_t
+PictureBufferPool::getMisses() {
+  pthread_mutex_lock(&mLock);
+  int64_t retval = mMisses;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int64_t
+PictureBufferPool::getBytesRetained() {
+  pthread_mutex_lock(&mLock);
+  int64_t retval = mBytesRetained;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PICTUREBUFFERPOOL_H_
+#define PICTUREBUFFERPOOL_H_
+
+#include <set>
+#include <vector>
+#include <pthread.h>
+
+#include <io/humble/ferry/Buffer.h>
+#include <io/humble/ferry/RefCounted.h>
+#include <io/humble/video/HumbleVideo.h>
+#include <io/humble/video/FfmpegIncludes.h>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * Internal Only.  Hands a video Decoder's get_buffer2 callback picture
+ * planes backed by Buffer objects, and takes them back for the next
+ * frame once FFmpeg and every MediaPicture are done with them.
+ * <p>
+ * Planes are laid out, aligned and padded the way
+ * avcodec_default_get_buffer2 lays them out, and the pool only holds
+ * planes for one width, height and pixel format at a time; a new
+ * geometry empties it. Formats with a palette and hardware formats are
+ * left to FFmpeg.
+ * </p><p>
+ * A plane whose Buffer is still held by someone else (say Java code that
+ * called MediaPicture#getData(int)) when FFmpeg lets go of it is not
+ * reused; it lives on as long as that holder needs it.
+ * </p><p>
+ * Every method may be called from any thread, which is what lets a
+ * frame-threaded Decoder allocate from its worker threads.
+ * </p>
+ */
+class PictureBufferPool : public io::humble::ferry::RefCounted
+{
+public:
+  static PictureBufferPool* make();
+
+  /**
+   * Fill in frame's planes for its width, height and format, as a
+   * get_buffer2 callback would.
+   *
+   * @param ctx The context asking; it may be a frame thread's copy.
+   * @return 0 on success, or a negative FFmpeg error.
+   */
+  int getBuffer(AVCodecContext* ctx, AVFrame* frame, int flags);
+
+  /**
+   * @return The Buffer behind ref if it came from this pool, or null.
+   *   The caller must release it.
+   */
+  io::humble::ferry::Buffer* getBuffer(AVBufferRef* ref);
+
+  /** @return The number of planes handed out that were reused. */
+  int64_t getHits();
+  /** @return The number of planes that had to be allocated. */
+  int64_t getMisses();
+  /** @return The bytes held in planes waiting to be reused. */
+  int64_t getBytesRetained();
+
+protected:
+  PictureBufferPool();
+  virtual
+  ~PictureBufferPool();
+
+private:
+  /** A plane, handed to FFmpeg as the opaque of its AVBufferRef. */
+  typedef struct Slot {
+    PictureBufferPool* pool;
+    io::humble::ferry::Buffer* buffer;
+    int32_t plane;
+    int32_t generation;
+  } Slot;
+
+  static void releaseSlot(void* opaque, uint8_t* data);
+  bool configure(AVCodecContext* ctx, AVFrame* frame);
+  Slot* takeSlot(int32_t plane);
+  void recycle(Slot* slot);
+  void freeSlot(Slot* slot);
+  void emptyFreeLists();
+
+  pthread_mutex_t mLock;
+  int32_t mWidth;
+  int32_t mHeight;
+  int32_t mFormat;
+  /** Bumped whenever the geometry changes; old planes are then freed. */
+  int32_t mGeneration;
+  int mLineSize[4];
+  int32_t mPlaneSize[4];
+  std::vector<Slot*> mFree[4];
+  /** Every Slot not yet freed, free or handed out. */
+  std::set<Slot*> mSlots;
+  int64_t mHits;
+  int64_t mMisses;
+  int64_t mBytesRetained;
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* PICTUREBUFFERPOOL_H_ */
@@ -0,0 +1,374 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <vector>
+#include <pthread.h>
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/video/ProbeCache.h>
+#include <io/humble/video/SeekIndexFile.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE.ProbeCache);
+
+namespace io {
+namespace humble {
+namespace video {
+
+// how much of a custom IO source we hash to recognize it
+static const int32_t HASH_BYTES = 64*1024;
+
+namespace {
+
+struct CachedStream {
+  AVRational timeBase;
+  AVRational rFrameRate;
+  AVRational avgFrameRate;
+  AVRational sampleAspectRatio;
+  int64_t startTime;
+  int64_t duration;
+  int64_t numFrames;
+  int codecInfoNumFrames;
+  /** Codec parameters only; never opened. */
+  AVCodecContext* codec;
+};
+
+struct Entry {
+  std::string key;
+  int64_t duration;
+  int64_t startTime;
+  int bitRate;
+  int64_t probeTime;
+  std::vector<CachedStream> streams;
+};
+
+typedef std::list<Entry*> EntryList;
+typedef std::map<std::string, EntryList::iterator> EntryMap;
+
+// most recently used first
+EntryList sEntries;
+EntryMap sIndex;
+int32_t sCapacity = 0;
+int64_t sHits = 0;
+int64_t sMisses = 0;
+int64_t sTimeSaved = 0;
+pthread_mutex_t sLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Copy from's extradata into a new padded buffer in *data, or set *data
+ * to 0 if there is none. Returns false only if the buffer cannot be
+ * allocated.
+ */
+bool
+copyExtradata(const AVCodecContext* from, uint8_t** data) {
+  *data = 0;
+  if (!from->extradata || from->extradata_size <= 0)
+    return true;
+  *data = (uint8_t*) av_mallocz(from->extradata_size +
+      FF_INPUT_BUFFER_PADDING_SIZE);
+  if (!*data)
+    return false;
+  memcpy(*data, from->extradata, from->extradata_size);
+  return true;
+}
+
+/**
+ * Copy the probed parameters of from into to, which takes ownership of
+ * extradata (a copy made by copyExtradata). Cannot fail.
+ */
+void
+setCodecParameters(AVCodecContext* to, const AVCodecContext* from,
+    uint8_t* extradata) {
+  to->codec_type = from->codec_type;
+  to->codec_id = from->codec_id;
+  to->codec_tag = from->codec_tag;
+  to->bit_rate = from->bit_rate;
+  to->profile = from->profile;
+  to->level = from->level;
+  to->time_base = from->time_base;
+  to->ticks_per_frame = from->ticks_per_frame;
+  to->width = from->width;
+  to->height = from->height;
+  to->coded_width = from->coded_width;
+  to->coded_height = from->coded_height;
+  to->pix_fmt = from->pix_fmt;
+  to->has_b_frames = from->has_b_frames;
+  to->sample_aspect_ratio = from->sample_aspect_ratio;
+  to->field_order = from->field_order;
+  to->color_range = from->color_range;
+  to->color_primaries = from->color_primaries;
+  to->color_trc = from->color_trc;
+  to->colorspace = from->colorspace;
+  to->chroma_sample_location = from->chroma_sample_location;
+  to->sample_rate = from->sample_rate;
+  to->channels = from->channels;
+  to->channel_layout = from->channel_layout;
+  to->sample_fmt = from->sample_fmt;
+  to->frame_size = from->frame_size;
+  to->block_align = from->block_align;
+  to->bits_per_coded_sample = from->bits_per_coded_sample;
+  to->bits_per_raw_sample = from->bits_per_raw_sample;
+
+  av_freep(&to->extradata);
+  to->extradata = extradata;
+  to->extradata_size = extradata ? from->extradata_size : 0;
+}
+
+bool
+copyCodecParameters(AVCodecContext* to, const AVCodecContext* from) {
+  uint8_t* extradata;
+  if (!copyExtradata(from, &extradata))
+    return false;
+  setCodecParameters(to, from, extradata);
+  return true;
+}
+
+void
+freeEntry(Entry* entry) {
+  for(size_t i = 0; i < entry->streams.size(); i++)
+    avcodec_free_context(&entry->streams[i].codec);
+  delete entry;
+}
+
+/** Drop least recently used entries until there are at most max. */
+void
+trim(size_t max) {
+  while (sEntries.size() > max) {
+    Entry* entry = sEntries.back();
+    sIndex.erase(entry->key);
+    sEntries.pop_back();
+    freeEntry(entry);
+  }
+}
+
+/** Could this cached stream describe a stream the header found? */
+bool
+matches(const CachedStream& cached, const AVStream* st) {
+  const AVCodecContext* codec = st->codec;
+  if (!codec)
+    return false;
+  if (codec->codec_type != AVMEDIA_TYPE_UNKNOWN &&
+      codec->codec_type != cached.codec->codec_type)
+    return false;
+  if (codec->codec_id != AV_CODEC_ID_NONE &&
+      codec->codec_id != cached.codec->codec_id)
+    return false;
+  return true;
+}
+
+/** FNV-1a, 64 bit. */
+uint64_t
+hash(const unsigned char* data, int32_t len) {
+  uint64_t h = 14695981039346656037ULL;
+  for(int32_t i = 0; i < len; i++) {
+    h ^= data[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+}
+
+void
+ProbeCache::setCapacity(int32_t entries) {
+  pthread_mutex_lock(&sLock);
+  sCapacity = entries > 0 ? entries : 0;
+  trim(sCapacity);
+  pthread_mutex_unlock(&sLock);
+}
+
+int32_t
+ProbeCache::getCapacity() {
+  pthread_mutex_lock(&sLock);
+  int32_t retval = sCapacity;
+  pthread_mutex_unlock(&sLock);
+  return retval;
+}
+
+void
+ProbeCache::clear() {
+  pthread_mutex_lock(&sLock);
+  trim(0);
+  pthread_mutex_unlock(&sLock);
+}
+
+int64_t
+ProbeCache::getHits() {
+  pthread_mutex_lock(&sLock);
+  int64_t retval = sHits;
+  pthread_mutex_unlock(&sLock);
+  return retval;
+}
+
+int64_t
+ProbeCache::getMisses() {
+  pthread_mutex_lock(&sLock);
+  int64_t retval = sMisses;
+  pthread_mutex_unlock(&sLock);
+  return retval;
+}
+
+int64_t
+ProbeCache::getTimeSaved() {
+  pthread_mutex_lock(&sLock);
+  int64_t retval = sTimeSaved;
+  pthread_mutex_unlock(&sLock);
+  return retval;
+}
+
+bool
+ProbeCache::makeKey(AVFormatContext* ctx, const char* url, bool customIO,
+    std::string* key) {
+  if (!ctx || !ctx->iformat)
+    return false;
+  char buf[1024];
+  if (!customIO) {
+    std::string path;
+    int64_t size;
+    int64_t mtime;
+    if (!SeekIndexFile::getMediaPath(url, &path) ||
+        !SeekIndexFile::getFileStamp(path.c_str(), &size, &mtime))
+      return false;
+    snprintf(buf, sizeof(buf), "file|%s|%lld|%lld|", ctx->iformat->name,
+        (long long)size, (long long)mtime);
+    *key = std::string(buf) + path;
+    return true;
+  }
+
+  AVIOContext* pb = ctx->pb;
+  if (!pb || !pb->seekable)
+    return false;
+  int64_t size = avio_size(pb);
+  int64_t position = avio_tell(pb);
+  if (size <= 0 || position < 0 || avio_seek(pb, 0, SEEK_SET) < 0)
+    return false;
+  std::vector<unsigned char> data(HASH_BYTES);
+  int32_t len = avio_read(pb, &data[0], HASH_BYTES);
+  // put the demuxer back where it was, whatever happened
+  if (avio_seek(pb, position, SEEK_SET) < 0 || len <= 0)
+    return false;
+  snprintf(buf, sizeof(buf), "hash|%s|%lld|%016llx", ctx->iformat->name,
+      (long long)size, (unsigned long long)hash(&data[0], len));
+  *key = buf;
+  return true;
+}
+
+int64_t
+ProbeCache::restore(const std::string& key, AVFormatContext* ctx) {
+  int64_t retval = -1;
+  pthread_mutex_lock(&sLock);
+  EntryMap::iterator found = sIndex.find(key);
+  Entry* entry = found == sIndex.end() ? 0 : *found->second;
+  bool usable = entry && entry->streams.size() == ctx->nb_streams;
+  for(uint32_t i = 0; usable && i < ctx->nb_streams; i++)
+    usable = matches(entry->streams[i], ctx->streams[i]);
+  // make every copy that can fail before touching any stream, so a failed
+  // restore leaves the context exactly as the header read left it
+  std::vector<uint8_t*> extradata(usable ? ctx->nb_streams : 0, (uint8_t*)0);
+  for(uint32_t i = 0; usable && i < ctx->nb_streams; i++)
+    usable = copyExtradata(entry->streams[i].codec, &extradata[i]);
+  if (!usable)
+    for(size_t i = 0; i < extradata.size(); i++)
+      av_free(extradata[i]);
+  for(uint32_t i = 0; usable && i < ctx->nb_streams; i++) {
+    const CachedStream& cached = entry->streams[i];
+    AVStream* st = ctx->streams[i];
+    st->time_base = cached.timeBase;
+    st->r_frame_rate = cached.rFrameRate;
+    st->avg_frame_rate = cached.avgFrameRate;
+    st->sample_aspect_ratio = cached.sampleAspectRatio;
+    st->start_time = cached.startTime;
+    st->duration = cached.duration;
+    st->nb_frames = cached.numFrames;
+    st->codec_info_nb_frames = cached.codecInfoNumFrames;
+    setCodecParameters(st->codec, cached.codec, extradata[i]);
+  }
+  if (usable) {
+    ctx->duration = entry->duration;
+    ctx->start_time = entry->startTime;
+    ctx->bit_rate = entry->bitRate;
+    // most recently used goes to the front
+    sEntries.splice(sEntries.begin(), sEntries, found->second);
+    retval = entry->probeTime;
+    ++sHits;
+    sTimeSaved += retval;
+  } else
+    ++sMisses;
+  pthread_mutex_unlock(&sLock);
+  if (entry && !usable)
+    VS_LOG_DEBUG("not using cached probe for %s; the streams do not match",
+        key.c_str());
+  return retval;
+}
+
+void
+ProbeCache::store(const std::string& key, AVFormatContext* ctx,
+    int64_t probeTime) {
+  Entry* entry = new Entry();
+  entry->key = key;
+  entry->duration = ctx->duration;
+  entry->startTime = ctx->start_time;
+  entry->bitRate = ctx->bit_rate;
+  entry->probeTime = probeTime;
+  entry->streams.resize(ctx->nb_streams);
+  bool ok = true;
+  for(uint32_t i = 0; i < ctx->nb_streams; i++) {
+    CachedStream* cached = &entry->streams[i];
+    AVStream* st = ctx->streams[i];
+    cached->timeBase = st->time_base;
+    cached->rFrameRate = st->r_frame_rate;
+    cached->avgFrameRate = st->avg_frame_rate;
+    cached->sampleAspectRatio = st->sample_aspect_ratio;
+    cached->startTime = st->start_time;
+    cached->duration = st->duration;
+    cached->numFrames = st->nb_frames;
+    cached->codecInfoNumFrames = st->codec_info_nb_frames;
+    cached->codec = avcodec_alloc_context3(0);
+    ok = ok && cached->codec && st->codec &&
+        copyCodecParameters(cached->codec, st->codec);
+  }
+  if (!ok) {
+    freeEntry(entry);
+    return;
+  }
+
+  pthread_mutex_lock(&sLock);
+  if (sCapacity > 0) {
+    EntryMap::iterator found = sIndex.find(key);
+    if (found != sIndex.end()) {
+      freeEntry(*found->second);
+      sEntries.erase(found->second);
+      sIndex.erase(found);
+    }
+    sEntries.push_front(entry);
+    sIndex[key] = sEntries.begin();
+    entry = 0;
+    trim(sCapacity);
+  }
+  pthread_mutex_unlock(&sLock);
+  if (entry)
+    // turned off while we probed
+    freeEntry(entry);
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
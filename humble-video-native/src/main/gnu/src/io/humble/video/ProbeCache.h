@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PROBECACHE_H_
+#define PROBECACHE_H_
+
+#include <string>
+#include <io/humble/video/HumbleVideo.h>
+#include <io/humble/video/FfmpegIncludes.h>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * Internal Only.  A process-wide cache of what avformat_find_stream_info
+ * learned about a file, so opening the same media again can skip decoding
+ * its first few seconds.
+ * <p>
+ * Local files are keyed by path, size and modification time.  Anything
+ * read through custom IO is keyed by its size and a hash of its first
+ * 64 KiB, which is enough to tell apart the assets of a thumbnailing
+ * service but is not a full content hash.  Both keys include the input
+ * format.  Entries are dropped least recently used first.
+ * </p><p>
+ * A hit restores each stream's codec parameters (including extradata),
+ * time base, frame rates and duration, and the container's duration,
+ * start time and bit rate.  If the header alone found a different number
+ * of streams, or streams of a different type, the entry is not used.
+ * </p>
+ */
+class ProbeCache
+{
+public:
+  /**
+   * How many files to remember.  0, the default, turns the cache off and
+   * empties it.
+   */
+  static void setCapacity(int32_t entries);
+  static int32_t getCapacity();
+
+  /** Forget everything.  The counters are not reset. */
+  static void clear();
+
+  static int64_t getHits();
+  static int64_t getMisses();
+  /** The total probing time hits have saved, in microseconds. */
+  static int64_t getTimeSaved();
+
+  /**
+   * Work out the cache key for an opened, not yet probed, context.
+   *
+   * @param customIO true if ctx->pb reads through a URLProtocolHandler;
+   *   its first bytes are hashed and its position restored.
+   * @return false if this input cannot be cached (for example a network
+   *   stream or a pipe).
+   */
+  static bool makeKey(AVFormatContext* ctx, const char* url, bool customIO,
+      std::string* key);
+
+  /**
+   * Restore a cached probe into ctx.
+   *
+   * @return The time the original probe took, in microseconds, or <0 on a
+   *   miss (in which case ctx is untouched).
+   */
+  static int64_t restore(const std::string& key, AVFormatContext* ctx);
+
+  /**
+   * Remember a probe of ctx that took probeTime microseconds.
+   */
+  static void store(const std::string& key, AVFormatContext* ctx,
+      int64_t probeTime);
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* PROBECACHE_H_ */
@@ -24,6 +24,12 @@
 
 namespace io { namespace humble { namespace video
 {
+  // Open addressed; slots are filled once and never emptied.  A process
+  // that sees more distinct timebases than this just gets unshared
+  // objects for the extras.
+  static const int32_t cInternTableSize = 256;
+  static RationalImpl* sInterned[cInternTableSize];
+  static int64_t sNumAllocated;
 
   RationalImpl :: RationalImpl()
   {
@@ -31,6 +37,8 @@ namespace io { namespace humble { namespace video
     mRational.den = 1;
     mRational.num = 0;
     mInitialized = false;
+    mInterned = false;
+    __atomic_add_fetch(&sNumAllocated, 1, __ATOMIC_RELAXED);
   }
 
   RationalImpl :: ~RationalImpl()
@@ -137,6 +145,58 @@ namespace io { namespace humble { namespace video
     }
     return result;
   }
+  RationalImpl *
+  RationalImpl :: intern(int32_t num, int32_t den)
+  {
+    AVRational value;
+    value.num = num;
+    value.den = den;
+    return intern(value);
+  }
+
+  RationalImpl *
+  RationalImpl :: intern(AVRational value)
+  {
+    // reduce the same way init() does so we hand back what make() would
+    AVRational key;
+    av_reduce(&key.num, &key.den, value.num, value.den,
+        FFMAX(value.den, value.num));
+
+    uint32_t hash = ((uint32_t)key.num * 2654435761U) ^ (uint32_t)key.den;
+    for(int32_t probe = 0; probe < cInternTableSize; probe++)
+    {
+      RationalImpl** slot = &sInterned[(hash + probe) % cInternTableSize];
+      RationalImpl* current = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+      if (!current)
+      {
+        RationalImpl* candidate = RationalImpl::make(key.num, key.den);
+        candidate->mInterned = true;
+        if (__atomic_compare_exchange_n(slot, &current, candidate,
+            false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+          // the table keeps the reference make() gave us
+          candidate->acquire();
+          return candidate;
+        }
+        // someone beat us to this slot; current is now what they put there
+        VS_REF_RELEASE(candidate);
+      }
+      if (current->mRational.num == key.num &&
+          current->mRational.den == key.den)
+      {
+        current->acquire();
+        return current;
+      }
+    }
+    return RationalImpl::make(key.num, key.den);
+  }
+
+  int64_t
+  RationalImpl :: getNumAllocated()
+  {
+    return __atomic_load_n(&sNumAllocated, __ATOMIC_RELAXED);
+  }
+
   int32_t
   RationalImpl :: compareTo(Rational *other)
   {
@@ -168,6 +228,12 @@ namespace io { namespace humble { namespace video
   RationalImpl :: reduce(int64_t num, int64_t den, int64_t max)
   {
     int32_t result = 0;
+    if (mInterned)
+    {
+      // shared objects must not change under the other holders
+      AVRational ignored;
+      return av_reduce(&ignored.num, &ignored.den, num, den, max);
+    }
     result =  av_reduce(&mRational.num, &mRational.den,
         num, den, max);
     return result;
@@ -82,6 +82,44 @@ namespace io { namespace humble { namespace video
      * @return A new Rational; caller must call release.
      */
     static RationalImpl *make(int32_t num, int32_t den);
+
+    /**
+     * Get a shared Rational equal to value.
+     * <p>
+     * Streams use only a handful of timebases, so the per-packet and
+     * per-frame paths use this rather than #make(int32_t,int32_t).  The
+     * first call for a value makes the object; after that this is a table
+     * lookup and an #acquire().  Native code should keep plain AVRational
+     * values and only intern when it has to hand a Rational to a
+     * Media object.
+     * </p><p>
+     * Interned objects are never freed and cannot be changed; #reduce
+     * leaves them alone.
+     * </p>
+     *
+     * @param value The value, which is reduced exactly as
+     *   #make(int32_t,int32_t) would reduce it.
+     * @return A reference the caller must release.
+     */
+    static RationalImpl *intern(AVRational value);
+    static RationalImpl *intern(int32_t num, int32_t den);
+
+    /**
+     * @return true if this object came from #intern(AVRational).
+     */
+    bool isInterned() { return mInterned; }
+
+    /**
+     * @return The value as a plain AVRational.
+     */
+    AVRational getValueAsAVRational() { return mRational; }
+
+    /**
+     * Internal Only.  The number of RationalImpl objects made so far in
+     * this process; used by tests to check that hot paths do not
+     * allocate.
+     */
+    static int64_t getNumAllocated();
     
     virtual int64_t rescale(int64_t origValue,
         Rational* origBase,
@@ -107,6 +145,7 @@ namespace io { namespace humble { namespace video
     // note not a pointer.
     AVRational mRational;
     bool mInitialized;
+    bool mInterned;
   };
 
 }}}
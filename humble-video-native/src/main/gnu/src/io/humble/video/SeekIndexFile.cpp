@@ -0,0 +1,333 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/Demuxer.h>
+#include <io/humble/video/DemuxerStream.h>
+#include <io/humble/video/IndexEntry.h>
+#include <io/humble/video/SeekIndexFile.h>
+#include <io/humble/video/customio/URLProtocolManager.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE.SeekIndexFile);
+
+using namespace io::humble::ferry;
+
+namespace io {
+namespace humble {
+namespace video {
+
+// "HVSEEKIX", then the version, then everything little-endian.
+static const char MAGIC[8] = { 'H', 'V', 'S', 'E', 'E', 'K', 'I', 'X' };
+// magic, version, stream count, file size, mtime seconds and nanoseconds
+static const size_t HEADER_SIZE = 8 + 4 + 4 + 8 + 8 + 8;
+// time base and entry count
+static const size_t STREAM_HEADER_SIZE = 4 + 4 + 4;
+// position, timestamp, flags, size, min distance
+static const size_t ENTRY_SIZE = 8 + 8 + 4 + 4 + 4;
+// far more than hours of keyframes; anything bigger is not ours.
+static const int64_t MAX_FILE_SIZE = 256*1024*1024;
+
+namespace {
+
+/** The size and modification time an index was built against. */
+struct FileStamp {
+  int64_t size;
+  int64_t mtime;
+  int64_t mtimeNsec;
+};
+
+struct Entry {
+  int64_t position;
+  int64_t timeStamp;
+  int32_t flags;
+  int32_t size;
+  int32_t minDistance;
+};
+
+struct StreamEntries {
+  int32_t timeBaseNum;
+  int32_t timeBaseDen;
+  std::vector<Entry> entries;
+};
+
+bool
+getStamp(const char* path, FileStamp* stamp) {
+  struct stat info;
+  if (!path || stat(path, &info) < 0 || !S_ISREG(info.st_mode))
+    return false;
+  stamp->size = info.st_size;
+  stamp->mtime = info.st_mtime;
+#if defined(__linux__)
+  stamp->mtimeNsec = info.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+  stamp->mtimeNsec = info.st_mtimespec.tv_nsec;
+#else
+  stamp->mtimeNsec = 0;
+#endif
+  return true;
+}
+
+void
+put32(std::vector<unsigned char>* out, int32_t value) {
+  uint32_t v = (uint32_t) value;
+  for(int i = 0; i < 4; i++)
+    out->push_back((unsigned char)(v >> (8*i)));
+}
+
+void
+put64(std::vector<unsigned char>* out, int64_t value) {
+  uint64_t v = (uint64_t) value;
+  for(int i = 0; i < 8; i++)
+    out->push_back((unsigned char)(v >> (8*i)));
+}
+
+int32_t
+get32(const unsigned char* in) {
+  uint32_t v = 0;
+  for(int i = 0; i < 4; i++)
+    v |= ((uint32_t)in[i]) << (8*i);
+  return (int32_t) v;
+}
+
+int64_t
+get64(const unsigned char* in) {
+  uint64_t v = 0;
+  for(int i = 0; i < 8; i++)
+    v |= ((uint64_t)in[i]) << (8*i);
+  return (int64_t) v;
+}
+
+/** Parse a whole index file; false if it is not one we can use. */
+bool
+parse(const std::vector<unsigned char>& data, const FileStamp& stamp,
+    std::vector<StreamEntries>* streams) {
+  size_t len = data.size();
+  if (len < HEADER_SIZE || memcmp(&data[0], MAGIC, sizeof(MAGIC)))
+    return false;
+  const unsigned char* p = &data[0] + sizeof(MAGIC);
+  if (get32(p) != SeekIndexFile::VERSION)
+    return false;
+  int32_t numStreams = get32(p+4);
+  if (get64(p+8) != stamp.size || get64(p+16) != stamp.mtime ||
+      get64(p+24) != stamp.mtimeNsec)
+    return false;
+
+  size_t offset = HEADER_SIZE;
+  // a corrupt count must not size anything beyond what the file can hold
+  if (numStreams < 0 ||
+      (size_t)numStreams > (len - offset) / STREAM_HEADER_SIZE)
+    return false;
+  streams->resize(numStreams);
+  for(int32_t i = 0; i < numStreams; i++) {
+    if (len - offset < STREAM_HEADER_SIZE)
+      return false;
+    p = &data[offset];
+    StreamEntries* stream = &(*streams)[i];
+    stream->timeBaseNum = get32(p);
+    stream->timeBaseDen = get32(p+4);
+    int64_t numEntries = (uint32_t) get32(p+8);
+    offset += STREAM_HEADER_SIZE;
+    if ((int64_t)((len - offset) / ENTRY_SIZE) < numEntries)
+      return false;
+    stream->entries.resize((size_t)numEntries);
+    for(int64_t j = 0; j < numEntries; j++) {
+      p = &data[offset];
+      Entry* entry = &stream->entries[(size_t)j];
+      entry->position = get64(p);
+      entry->timeStamp = get64(p+8);
+      entry->flags = get32(p+16);
+      entry->size = get32(p+20);
+      entry->minDistance = get32(p+24);
+      offset += ENTRY_SIZE;
+    }
+  }
+  return offset == len;
+}
+
+}
+
+bool
+SeekIndexFile::getMediaPath(const char* url, std::string* mediaPath) {
+  if (!url || !*url)
+    return false;
+  FileStamp stamp;
+  if (getStamp(url, &stamp)) {
+    *mediaPath = url;
+    return true;
+  }
+  char proto[256];
+  const char* protocol = customio::URLProtocolManager::parseProtocol(proto,
+      sizeof(proto), url);
+  if (!protocol)
+    return false;
+  const char* path = url + strlen(protocol);
+  if (*path == ':' || *path == ',')
+    ++path;
+  if (!getStamp(path, &stamp))
+    return false;
+  *mediaPath = path;
+  return true;
+}
+
+bool
+SeekIndexFile::getFileStamp(const char* path, int64_t* size, int64_t* mtime) {
+  FileStamp stamp;
+  if (!getStamp(path, &stamp))
+    return false;
+  *size = stamp.size;
+  *mtime = stamp.mtime * 1000000000LL + stamp.mtimeNsec;
+  return true;
+}
+
+std::string
+SeekIndexFile::getDefaultPath(const std::string& mediaPath) {
+  return mediaPath + ".hvidx";
+}
+
+int32_t
+SeekIndexFile::write(const char* indexPath, const char* mediaPath,
+    Demuxer* demuxer) {
+  FileStamp stamp;
+  if (!indexPath || !demuxer || !getStamp(mediaPath, &stamp))
+    return -1;
+
+  std::vector<unsigned char> data;
+  data.insert(data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+  put32(&data, VERSION);
+  int32_t numStreams = demuxer->getNumStreams();
+  put32(&data, numStreams);
+  put64(&data, stamp.size);
+  put64(&data, stamp.mtime);
+  put64(&data, stamp.mtimeNsec);
+
+  int32_t total = 0;
+  for(int32_t i = 0; i < numStreams; i++) {
+    RefPointer<DemuxerStream> stream = demuxer->getStream(i);
+    RefPointer<Rational> timeBase = stream->getTimeBase();
+    put32(&data, timeBase ? timeBase->getNumerator() : 0);
+    put32(&data, timeBase ? timeBase->getDenominator() : 0);
+    // the count goes here once we know how many are keyframes
+    size_t countOffset = data.size();
+    put32(&data, 0);
+    int32_t count = 0;
+    int32_t numEntries = stream->getNumIndexEntries();
+    for(int32_t j = 0; j < numEntries; j++) {
+      RefPointer<IndexEntry> entry = stream->getIndexEntry(j);
+      if (!entry || !entry->isKeyFrame())
+        continue;
+      put64(&data, entry->getPosition());
+      put64(&data, entry->getTimeStamp());
+      put32(&data, entry->getFlags());
+      put32(&data, entry->getSize());
+      put32(&data, entry->getMinDistance());
+      ++count;
+    }
+    std::vector<unsigned char> countBytes;
+    put32(&countBytes, count);
+    memcpy(&data[countOffset], &countBytes[0], countBytes.size());
+    total += count;
+  }
+
+  std::string tmpPath = std::string(indexPath) + ".tmp";
+  FILE* file = fopen(tmpPath.c_str(), "wb");
+  if (!file)
+    return -1;
+  bool ok = fwrite(&data[0], 1, data.size(), file) == data.size();
+  ok = (fclose(file) == 0) && ok;
+#ifdef _WIN32
+  // rename will not replace a file on Windows
+  if (ok)
+    (void) remove(indexPath);
+#endif
+  if (!ok || rename(tmpPath.c_str(), indexPath) != 0) {
+    (void) remove(tmpPath.c_str());
+    return -1;
+  }
+  VS_LOG_TRACE("wrote %d index entries for %s to %s", total, mediaPath,
+      indexPath);
+  return total;
+}
+
+int32_t
+SeekIndexFile::read(const char* indexPath, const char* mediaPath,
+    Demuxer* demuxer) {
+  FileStamp stamp;
+  FileStamp indexStamp;
+  if (!demuxer || !getStamp(mediaPath, &stamp) ||
+      !getStamp(indexPath, &indexStamp) || indexStamp.size > MAX_FILE_SIZE)
+    return -1;
+
+  std::vector<unsigned char> data((size_t)indexStamp.size);
+  FILE* file = fopen(indexPath, "rb");
+  if (!file)
+    return -1;
+  bool ok = data.empty() || fread(&data[0], 1, data.size(), file) == data.size();
+  fclose(file);
+
+  // check all of it before adding anything
+  std::vector<StreamEntries> streams;
+  if (!ok || !parse(data, stamp, &streams)) {
+    VS_LOG_DEBUG("ignoring out of date or unreadable index %s for %s",
+        indexPath, mediaPath);
+    return -1;
+  }
+  int32_t numStreams = demuxer->getNumStreams();
+  if ((int32_t)streams.size() != numStreams) {
+    VS_LOG_DEBUG("ignoring index %s; it has %d streams, not %d",
+        indexPath, (int32_t)streams.size(), numStreams);
+    return -1;
+  }
+  std::vector<RefPointer<DemuxerStream> > demuxerStreams(numStreams);
+  for(int32_t i = 0; i < numStreams; i++) {
+    demuxerStreams[i] = demuxer->getStream(i);
+    RefPointer<Rational> timeBase = demuxerStreams[i]->getTimeBase();
+    if (!timeBase ||
+        timeBase->getNumerator() != streams[i].timeBaseNum ||
+        timeBase->getDenominator() != streams[i].timeBaseDen) {
+      VS_LOG_DEBUG("ignoring index %s; stream %d has a different time base",
+          indexPath, i);
+      return -1;
+    }
+  }
+
+  int32_t total = 0;
+  for(int32_t i = 0; i < numStreams; i++) {
+    const std::vector<Entry>& entries = streams[i].entries;
+    for(size_t j = 0; j < entries.size(); j++) {
+      const Entry& e = entries[j];
+      RefPointer<IndexEntry> entry = IndexEntry::make(e.position, e.timeStamp,
+          e.flags, e.size, e.minDistance);
+      if (demuxerStreams[i]->addIndexEntry(entry.value()) >= 0)
+        ++total;
+    }
+  }
+  VS_LOG_TRACE("read %d index entries for %s from %s", total, mediaPath,
+      indexPath);
+  return total;
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef SEEKINDEXFILE_H_
+#define SEEKINDEXFILE_H_
+
+#include <string>
+#include <io/humble/video/HumbleVideo.h>
+
+namespace io {
+namespace humble {
+namespace video {
+
+class Demuxer;
+
+/**
+ * Internal Only.  Reads and writes the keyframe index of a Demuxer's
+ * streams to a sidecar file, so formats with no index of their own
+ * (MPEG-TS, raw H.264, FLV without keyframe metadata) can seek without
+ * scanning.
+ * <p>
+ * The file holds only keyframe entries, and remembers the size and
+ * modification time of the media file it was built from; if either has
+ * changed, or the streams no longer match in number or time base, the
+ * whole file is ignored.  It is written to a temporary name and renamed
+ * into place, so a reader never sees half a file.
+ * </p>
+ */
+class SeekIndexFile
+{
+public:
+  /** Bumped whenever the layout changes; older files are ignored. */
+  static const int32_t VERSION=1;
+
+  /**
+   * Find the local file behind a Demuxer URL, dropping any protocol
+   * prefix (for example "file:" or "mmap:").
+   *
+   * @return true, and the path in mediaPath, if url names a local file.
+   */
+  static bool getMediaPath(const char* url, std::string* mediaPath);
+
+  /**
+   * Get the size and modification time of a regular file.
+   *
+   * @param mtime Set to the modification time in nanoseconds, though
+   *   some platforms only keep seconds.
+   * @return false if path is not a regular file.
+   */
+  static bool getFileStamp(const char* path, int64_t* size, int64_t* mtime);
+
+  /**
+   * @return The default sidecar path for a media file: the same name with
+   *   ".hvidx" added.
+   */
+  static std::string getDefaultPath(const std::string& mediaPath);
+
+  /**
+   * Write the keyframe entries of every stream in demuxer.
+   *
+   * @return The number of entries written, or <0 if the file could not be
+   *   written.
+   */
+  static int32_t write(const char* indexPath, const char* mediaPath,
+      Demuxer* demuxer);
+
+  /**
+   * Add the entries in an index file to the streams of demuxer.  Nothing
+   * is added unless the file has exactly the Demuxer's streams.
+   *
+   * @return The number of entries added, or <0 if there is no index file
+   *   or it does not match the media file.
+   */
+  static int32_t read(const char* indexPath, const char* mediaPath,
+      Demuxer* demuxer);
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* SEEKINDEXFILE_H_ */
@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/HumbleException.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/Thumbnailer.h>
+#include <io/humble/video/DemuxerStream.h>
+#include <io/humble/video/Global.h>
+#include <io/humble/video/IndexEntry.h>
+#include <io/humble/video/Rational.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE.Thumbnailer);
+
+using namespace io::humble::ferry;
+
+namespace io {
+namespace humble {
+namespace video {
+
+/** Lets a seek go back as far as it must to reach a key frame. */
+static const int64_t cEarliestTimeStamp = -0x7fffffffffffffffLL - 1;
+
+Thumbnailer::Thumbnailer() {
+  mStreamIndex = -1;
+}
+
+Thumbnailer::~Thumbnailer() {
+}
+
+Thumbnailer*
+Thumbnailer::make(Demuxer* demuxer, int32_t streamIndex) {
+  if (!demuxer)
+    VS_THROW(HumbleInvalidArgument("no demuxer passed in"));
+  if (demuxer->getState() != Demuxer::STATE_OPENED)
+    VS_THROW(HumbleRuntimeError("Can only thumbnail OPEN (not paused or playing) Demuxers"));
+
+  int32_t n = demuxer->getNumStreams();
+  RefPointer<Decoder> decoder;
+  if (streamIndex < 0) {
+    for(int32_t i = 0; i < n && streamIndex < 0; i++) {
+      RefPointer<DemuxerStream> stream = demuxer->getStream(i);
+      decoder = stream->getDecoder();
+      if (decoder && decoder->getCodecType() == MediaDescriptor::MEDIA_VIDEO)
+        streamIndex = i;
+    }
+  } else if (streamIndex < n) {
+    RefPointer<DemuxerStream> stream = demuxer->getStream(streamIndex);
+    decoder = stream->getDecoder();
+  }
+  if (streamIndex < 0 || streamIndex >= n || !decoder ||
+      decoder->getCodecType() != MediaDescriptor::MEDIA_VIDEO)
+    VS_THROW(HumbleInvalidArgument("no video stream to thumbnail"));
+
+  for(int32_t i = 0; i < n; i++)
+    demuxer->setStreamSelected(i, i == streamIndex);
+  demuxer->setKeyFramesOnly(streamIndex, true);
+  decoder->setSkipFrame(Decoder::DISCARD_NONKEY);
+
+  // held until fully built, so a throw part way through frees it.
+  RefPointer<Thumbnailer> retval;
+  retval.reset(new Thumbnailer(), true);
+  retval->mDemuxer.reset(demuxer, true);
+  retval->mDecoder = decoder;
+  retval->mPacket = MediaPacket::make();
+  retval->mStreamIndex = streamIndex;
+  return retval.get();
+}
+
+MediaPicture*
+Thumbnailer::getKeyFrame(int64_t timeStamp) {
+  if (mDecoder->getState() == Coder::STATE_INITED)
+    mDecoder->open(0, 0);
+  else
+    mDecoder->flush();
+
+  if (mDemuxer->seek(mStreamIndex, cEarliestTimeStamp, timeStamp, timeStamp,
+      0) < 0)
+    return 0;
+  RefPointer<MediaPicture> picture = MediaPicture::make(
+      mDecoder->getWidth(),
+      mDecoder->getHeight(),
+      mDecoder->getPixelFormat());
+  return decodeInto(picture.value()) ? picture.get() : 0;
+}
+
+bool
+Thumbnailer::decodeInto(MediaPicture* picture) {
+  while (mDemuxer->read(mPacket.value()) >= 0) {
+    if (mPacket->getStreamIndex() != mStreamIndex || !mPacket->isComplete())
+      continue;
+    int32_t byteOffset = 0;
+    do {
+      int32_t used = mDecoder->decodeVideo(picture, mPacket.value(), byteOffset);
+      if (picture->isComplete())
+        return true;
+      if (used <= 0)
+        break;
+      byteOffset += used;
+    } while (byteOffset < mPacket->getSize());
+    // a Decoder that reorders, or runs frame threads, holds the frame
+    // back until it is drained.
+    mDecoder->decodeVideo(picture, 0, 0);
+    if (picture->isComplete())
+      return true;
+  }
+  return false;
+}
+
+int32_t
+Thumbnailer::run(int32_t count) {
+  if (count <= 0)
+    VS_THROW(HumbleInvalidArgument("count must be > 0"));
+  mThumbnails.clear();
+
+  RefPointer<DemuxerStream> stream = mDemuxer->getStream(mStreamIndex);
+  int64_t start = stream->getStartTime();
+  if (start == Global::NO_PTS)
+    start = 0;
+  int64_t duration = getStreamDuration(stream.value());
+  if (duration <= 0)
+    count = 1;
+  bool indexed = stream->getNumIndexEntries() > 0;
+
+  int64_t last = Global::NO_PTS;
+  for(int32_t i = 0; i < count; i++) {
+    // the middle of the i'th of count equal parts
+    int64_t target = start;
+    if (duration > 0)
+      target += av_rescale(duration, 2*i+1, 2*count);
+    if (indexed) {
+      RefPointer<IndexEntry> entry = stream->findTimeStampEntryInIndex(target,
+          Demuxer::SEEK_BACKWARD);
+      if (!entry)
+        entry = stream->findTimeStampEntryInIndex(target, 0);
+      if (entry) {
+        if (entry->getTimeStamp() == last)
+          continue;
+        last = entry->getTimeStamp();
+        target = last;
+      }
+    }
+    RefPointer<MediaPicture> picture = getKeyFrame(target);
+    if (!picture)
+      continue;
+    if (!indexed) {
+      // without an index, parts that share a key frame are only found out
+      // by decoding it.
+      if (picture->getTimeStamp() == last)
+        continue;
+      last = picture->getTimeStamp();
+    }
+    mThumbnails.push_back(picture);
+  }
+  VS_LOG_DEBUG("%d thumbnails of stream %d (%s index)", getNumThumbnails(),
+      mStreamIndex, indexed ? "with" : "no");
+  return getNumThumbnails();
+}
+
+MediaPicture*
+Thumbnailer::getThumbnail(int32_t n) {
+  if (n < 0 || n >= getNumThumbnails())
+    VS_THROW(HumbleInvalidArgument("no such thumbnail"));
+  return mThumbnails[n].get();
+}
+
+int64_t
+Thumbnailer::getStreamDuration(DemuxerStream* stream) {
+  int64_t duration = stream->getDuration();
+  if (duration != Global::NO_PTS && duration > 0)
+    return duration;
+  // fall back on the container's, in microseconds
+  duration = mDemuxer->getDuration();
+  RefPointer<Rational> timeBase = stream->getTimeBase();
+  if (duration == Global::NO_PTS || duration <= 0 || !timeBase)
+    return 0;
+  return Rational::rescale(duration,
+      timeBase->getNumerator(), timeBase->getDenominator(),
+      1, Global::DEFAULT_PTS_PER_SECOND, Rational::ROUND_DOWN);
+}
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
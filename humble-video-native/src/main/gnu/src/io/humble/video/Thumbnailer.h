@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef THUMBNAILER_H_
+#define THUMBNAILER_H_
+
+#include <io/humble/ferry/RefCounted.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/Decoder.h>
+#include <io/humble/video/Demuxer.h>
+#include <io/humble/video/MediaPacket.h>
+#include <io/humble/video/MediaPicture.h>
+
+#include <vector>
+
+namespace io {
+namespace humble {
+namespace video {
+
+/**
+ * Makes thumbnails of a video stream by decoding only a few of its key
+ * frames.
+ * <p>
+ * Decoding a whole movie to pick out a dozen pictures spends nearly all
+ * its time on frames that are thrown away.  A Thumbnailer instead picks
+ * #run(int) evenly spaced times, finds the key frame at or before each
+ * one in the stream's index (see ContainerStream#getIndexEntry(int)),
+ * seeks straight to it and decodes just that frame.  The Demuxer only
+ * returns key packets (see Demuxer#setKeyFramesOnly(int, boolean)) and
+ * the Decoder skips anything else it is given (see
+ * Decoder#setSkipFrame(Decoder.Discard)).
+ * </p><p>
+ * A stream with no index is thumbnailed the same way, leaving it to
+ * Demuxer#seek(int, long, long, long, int) to find each key frame; build
+ * one first with Demuxer#buildSeekIndex() if the format's seeking is slow.
+ * </p><p>
+ * The Thumbnailer takes over the Demuxer: it deselects every other stream
+ * and seeks wherever it needs to.
+ * </p>
+ */
+class VS_API_HUMBLEVIDEO Thumbnailer : public io::humble::ferry::RefCounted
+{
+public:
+  /**
+   * Make a Thumbnailer for one video stream of an opened Demuxer.
+   * @param demuxer The Demuxer to read from; must be open and not
+   *   playing or paused.
+   * @param streamIndex The video stream, or -1 for the first one.
+   * @throws InvalidArgument if demuxer is null or the stream is not a
+   *   video stream.
+   */
+  static Thumbnailer* make(Demuxer* demuxer, int32_t streamIndex);
+
+  /**
+   * @return The Demuxer read from.
+   */
+  Demuxer* getDemuxer() { return mDemuxer.get(); }
+
+  /**
+   * @return The stream thumbnailed.
+   */
+  int32_t getStreamIndex() { return mStreamIndex; }
+
+  /**
+   * The Decoder used.  It is opened by the first thumbnail made, so set
+   * anything else on it, such as Coder#setThreadCount(int), before then.
+   * Decoder#setSkipLoopFilter(Decoder.Discard) makes each thumbnail
+   * cheaper still, at some cost in quality.
+   */
+  Decoder* getDecoder() { return mDecoder.get(); }
+
+  /**
+   * Seek to the key frame at or before a time stamp and decode it.
+   * @param timeStamp The time stamp, in the stream's time base.
+   * @return A new picture, or null if no key frame could be decoded
+   *   from there to the end of the stream.
+   * @throws RuntimeException if the Decoder cannot be opened.
+   */
+  MediaPicture* getKeyFrame(int64_t timeStamp);
+
+  /**
+   * Make thumbnails at count evenly spaced times, replacing any from an
+   * earlier run.
+   * <p>
+   * Each of the count equal parts of the stream is represented by the
+   * key frame at or before its middle.  A stream with fewer key frames
+   * than that gets fewer thumbnails, as parts that share a key frame
+   * share a thumbnail.  If the stream's duration is not known, only the
+   * first key frame is used.
+   * </p>
+   * @param count How many thumbnails to make; must be > 0.
+   * @return The number of thumbnails made.
+   * @throws InvalidArgument if count <= 0.
+   */
+  int32_t run(int32_t count);
+
+  /**
+   * @return The number of thumbnails the last #run(int) made.
+   */
+  int32_t getNumThumbnails() { return (int32_t) mThumbnails.size(); }
+
+  /**
+   * @param n The thumbnail, from 0 to #getNumThumbnails()-1.
+   * @return The picture; MediaPicture#getTimeStamp() says where in the
+   *   stream it is from.
+   * @throws InvalidArgument if n is out of range.
+   */
+  MediaPicture* getThumbnail(int32_t n);
+
+protected:
+  Thumbnailer();
+  virtual
+  ~Thumbnailer();
+
+private:
+  int64_t getStreamDuration(DemuxerStream* stream);
+  bool decodeInto(MediaPicture* picture);
+
+  io::humble::ferry::RefPointer<Demuxer> mDemuxer;
+  io::humble::ferry::RefPointer<Decoder> mDecoder;
+  io::humble::ferry::RefPointer<MediaPacket> mPacket;
+  int32_t mStreamIndex;
+  std::vector<io::humble::ferry::RefPointer<MediaPicture> > mThumbnails;
+};
+
+} /* namespace video */
+} /* namespace humble */
+} /* namespace io */
+#endif /* THUMBNAILER_H_ */
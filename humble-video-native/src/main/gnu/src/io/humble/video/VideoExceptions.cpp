@@ -45,6 +45,10 @@ FfmpegException::check(int32_t error, const char* fmt, ...) {
     VS_CHECK_INTERRUPT(true);
     return;
   }
+  // FFmpeg gives up with AVERROR_EXIT when our interrupt callback
+  // tells it to; report that as an interruption, not a failure.
+  if (error == AVERROR_EXIT)
+    VS_CHECK_INTERRUPT(true);
 
   const size_t bufLen = 1048;
   char buf[bufLen];
@@ -25,18 +25,19 @@
 #include <io/humble/ferry/JNIHelper.h>
 #include <io/humble/video/customio/FfmpegIO.h>
 #include <io/humble/video/customio/JavaURLProtocolManager.h>
+#include <io/humble/video/customio/MmapURLProtocolManager.h>
+#include <io/humble/video/customio/PrefetchURLProtocolManager.h>
+#include <io/humble/video/customio/MemoryRingURLProtocolManager.h>
 
 using namespace io::humble::ferry;
 using namespace io::humble::video::customio;
 
 // we need to have a non-exception raising  interrupt check here
 #undef VS_CHECK_INTERRUPT
-#define VS_CHECK_INTERRUPT(retval, __COND__) do { \
-    if (__COND__) { \
-      JNIHelper* helper = JNIHelper::getHelper(); \
-      if (helper && helper->isInterrupted()) \
-        (retval) = EINTR > 0 ? -EINTR : EINTR; \
-        } \
+#define VS_CHECK_INTERRUPT(handler, retval, __COND__) do { \
+    if ((__COND__) && CancellationToken::sIsCancelled( \
+        (handler) ? (handler)->getCancellationToken() : 0)) \
+      (retval) = EINTR > 0 ? -EINTR : EINTR; \
 } while(0)
 
 VS_API_HUMBLE_VIDEO_CUSTOMIO void VS_API_CALL Java_io_humble_video_customio_FfmpegIO_init(JNIEnv *env, jclass)
@@ -91,6 +92,79 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
   return retval;
 }
 
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerMmapProtocol(
+    JNIEnv *jenv, jclass, jstring aProtoName)
+{
+  int retval = -1;
+  const char *protoName= NULL;
+  protoName = jenv->GetStringUTFChars(aProtoName, NULL);
+  if (protoName != NULL)
+  {
+    // Like Java protocols, the manager lives until it is unregistered.
+    if (MmapURLProtocolManager::registerProtocol(protoName))
+      retval = 0;
+    jenv->ReleaseStringUTFChars(aProtoName, protoName);
+    protoName = NULL;
+  }
+  return retval;
+}
+
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerPrefetchProtocol(
+    JNIEnv *jenv, jclass, jstring aProtoName, jint blockSize, jint blocksAhead,
+    jboolean directIO)
+{
+  int retval = -1;
+  const char *protoName= NULL;
+  protoName = jenv->GetStringUTFChars(aProtoName, NULL);
+  if (protoName != NULL)
+  {
+    // Like Java protocols, the manager lives until it is unregistered.
+    if (PrefetchURLProtocolManager::registerProtocol(protoName, blockSize,
+        blocksAhead, directIO == JNI_TRUE))
+      retval = 0;
+    jenv->ReleaseStringUTFChars(aProtoName, protoName);
+    protoName = NULL;
+  }
+  return retval;
+}
+
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerMemoryRingProtocol(
+    JNIEnv *jenv, jclass, jstring aProtoName, jint capacity, jboolean blocking)
+{
+  int retval = -1;
+  const char *protoName= NULL;
+  protoName = jenv->GetStringUTFChars(aProtoName, NULL);
+  if (protoName != NULL)
+  {
+    // Like Java protocols, the manager lives until it is unregistered.
+    if (MemoryRingURLProtocolManager::registerProtocol(protoName, capacity,
+        blocking == JNI_TRUE))
+      retval = 0;
+    jenv->ReleaseStringUTFChars(aProtoName, protoName);
+    protoName = NULL;
+  }
+  return retval;
+}
+
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1getMemoryRingStatistics(
+    JNIEnv *jenv, jclass, jstring url, jlongArray javaStats)
+{
+  int retval = -1;
+  const char *nativeURL = jenv->GetStringUTFChars(url, NULL);
+  if (nativeURL != NULL)
+  {
+    int64_t stats[MemoryRing::NUM_STATS];
+    jsize len = javaStats ? jenv->GetArrayLength(javaStats) : 0;
+    retval = MemoryRingURLProtocolManager::getStatistics(nativeURL, stats,
+        len < MemoryRing::NUM_STATS ? len : MemoryRing::NUM_STATS);
+    if (retval > 0)
+      jenv->SetLongArrayRegion(javaStats, 0, retval, (const jlong*)stats);
+    jenv->ReleaseStringUTFChars(url, nativeURL);
+    nativeURL = NULL;
+  }
+  return retval;
+}
+
 VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1open(
     JNIEnv * jenv, jclass, jobject handle, jstring url, jint flags)
 {
@@ -109,7 +183,7 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
         throw std::runtime_error(message);
       }
       retval = handleVal->url_open(nativeURL, flags);
-      VS_CHECK_INTERRUPT(retval, 1);
+      VS_CHECK_INTERRUPT(handleVal, retval, 1);
     }
     catch(std::exception & e)
     {
@@ -159,7 +233,7 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
   {
     if (handleVal)
       retval = handleVal->url_read((uint8_t*)byteArray, buflen);
-    VS_CHECK_INTERRUPT(retval, retval < 0 || retval < buflen);
+    VS_CHECK_INTERRUPT(handleVal, retval, retval < 0 || retval < buflen);
   }
   catch(std::exception & e)
   {
@@ -199,7 +273,7 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
   {
     if (handleVal)
       retval = handleVal->url_write((uint8_t*)byteArray, buflen);
-    VS_CHECK_INTERRUPT(retval, retval < 0 || retval != buflen);
+    VS_CHECK_INTERRUPT(handleVal, retval, retval < 0 || retval != buflen);
   }
   catch(std::exception & e)
   {
@@ -225,6 +299,49 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
   return retval;
 }
 
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1writeDirect(
+    JNIEnv *jenv, jclass, jobject handle, jobject javaBuf, jint offset, jint buflen)
+{
+  URLProtocolHandler* handleVal= NULL;
+
+  jint retval = -1;
+
+  handleVal = (URLProtocolHandler*)JNIHelper::sGetPointer(handle);
+
+  // no copy in or out of the Java heap; the handler reads the buffer itself
+  uint8_t* bytes = (uint8_t*)jenv->GetDirectBufferAddress(javaBuf);
+  jlong capacity = jenv->GetDirectBufferCapacity(javaBuf);
+  if (!bytes || offset < 0 || buflen < 0 || offset + (jlong)buflen > capacity)
+    return -1;
+  try
+  {
+    if (handleVal)
+      retval = handleVal->url_write(bytes + offset, buflen);
+    VS_CHECK_INTERRUPT(handleVal, retval, retval < 0 || retval != buflen);
+  }
+  catch(std::exception & e)
+  {
+    // we don't let a native exception override a java exception
+    if (!jenv->ExceptionCheck())
+    {
+      jclass cls=jenv->FindClass("java/lang/RuntimeException");
+      jenv->ThrowNew(cls, e.what());
+    }
+    retval = -1;
+  }
+  catch(...)
+  {
+    // we don't let a native exception override a java exception
+    if (!jenv->ExceptionCheck())
+    {
+      jclass cls=jenv->FindClass("java/lang/RuntimeException");
+      jenv->ThrowNew(cls, "Unhandled and unknown native exception");
+    }
+    retval = -1;
+  }
+  return retval;
+}
+
 VS_API_HUMBLE_VIDEO_CUSTOMIO jlong VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1seek(
     JNIEnv *jenv, jclass, jobject handle, jlong position, jint whence)
 {
@@ -237,7 +354,7 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jlong VS_API_CALL Java_io_humble_video_customio_Ffm
   {
     if (handleVal)
       retval = handleVal->url_seek((int64_t)position, whence);
-    VS_CHECK_INTERRUPT(retval, 1);
+    VS_CHECK_INTERRUPT(handleVal, retval, 1);
   }
   catch(std::exception & e)
   {
@@ -274,7 +391,7 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
   {
     if (handleVal)
       retval = handleVal->url_close();
-    VS_CHECK_INTERRUPT(retval, 1);
+    VS_CHECK_INTERRUPT(handleVal, retval, 1);
   }
   catch(std::exception & e)
   {
@@ -33,6 +33,18 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO void VS_API_CALL Java_io_humble_video_customio_Ffmp
 VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerProtocolHandler
   (JNIEnv *, jclass, jstring, jobject);
 
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerMmapProtocol
+  (JNIEnv *, jclass, jstring);
+
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerPrefetchProtocol
+  (JNIEnv *, jclass, jstring, jint, jint, jboolean);
+
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1registerMemoryRingProtocol
+  (JNIEnv *, jclass, jstring, jint, jboolean);
+
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1getMemoryRingStatistics
+  (JNIEnv *, jclass, jstring, jlongArray);
+
 VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1open
   (JNIEnv *, jclass, jobject, jstring, jint);
 
@@ -42,6 +54,9 @@ VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_Ffmp
 VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1write
   (JNIEnv *, jclass, jobject, jbyteArray, jint);
 
+VS_API_HUMBLE_VIDEO_CUSTOMIO jint VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1writeDirect
+  (JNIEnv *, jclass, jobject, jobject, jint, jint);
+
 VS_API_HUMBLE_VIDEO_CUSTOMIO jlong VS_API_CALL Java_io_humble_video_customio_FfmpegIO_native_1url_1seek
   (JNIEnv *, jclass, jobject, jlong, jint);
 
@@ -0,0 +1,340 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <io/humble/ferry/Logger.h>
+
+#include <io/humble/video/customio/InstrumentedURLProtocolHandler.h>
+#include <io/humble/video/customio/URLProtocolManager.h>
+
+using namespace io::humble::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+
+// What closed handlers have taught us, keyed by where and which direction.
+static std::map<std::string, int32_t> sTunedLengths;
+static pthread_mutex_t sTunedLock = PTHREAD_MUTEX_INITIALIZER;
+
+static int64_t
+nowMicros()
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return ((int64_t)ts.tv_sec)*1000000LL + ts.tv_nsec/1000;
+#endif
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return ((int64_t)tv.tv_sec)*1000000LL + tv.tv_usec;
+}
+
+static std::string
+tuningKey(const char* url, int flags)
+{
+  char proto[256];
+  const char* protocol = URLProtocolManager::parseProtocol(proto, sizeof(proto), url);
+  std::string key = protocol ? protocol : "file";
+  const char* rest = url ? url : "";
+  if (protocol)
+    rest += strlen(protocol) + 1;
+  size_t length;
+  if (!strncmp(rest, "//", 2))
+    // the same server
+    length = 2 + strcspn(rest + 2, "/?#");
+  else {
+    // the same directory
+    length = 0;
+    for(const char* p = rest; *p; p++)
+      if (*p == '/' || *p == '\\')
+        length = p - rest + 1;
+  }
+  key += ":";
+  key.append(rest, length);
+  key += flags == URLProtocolHandler::URL_RDONLY_MODE ? "<" : ">";
+  return key;
+}
+
+static int32_t
+floorPowerOf2(int64_t n)
+{
+  int32_t retval = InstrumentedURLProtocolHandler::MIN_TUNED_BUFFER_LENGTH;
+  while (retval < InstrumentedURLProtocolHandler::MAX_TUNED_BUFFER_LENGTH &&
+      (int64_t)retval*2 <= n)
+    retval *= 2;
+  return retval;
+}
+
+InstrumentedURLProtocolHandler :: InstrumentedURLProtocolHandler(
+    URLProtocolHandler* delegate) : URLProtocolHandler(0)
+{
+  mDelegate = delegate;
+  mFlags = URL_RDONLY_MODE;
+  mOpen = false;
+  mPosition = 0;
+  memset(mCalls, 0, sizeof(mCalls));
+  memset(mErrors, 0, sizeof(mErrors));
+  memset(mLatency, 0, sizeof(mLatency));
+  memset(mBuckets, 0, sizeof(mBuckets));
+  mBytesRead = 0;
+  mBytesWritten = 0;
+  mSeekDistance = 0;
+}
+
+InstrumentedURLProtocolHandler :: ~InstrumentedURLProtocolHandler()
+{
+  delete mDelegate;
+}
+
+const char*
+InstrumentedURLProtocolHandler :: getProtocolName()
+{
+  return mDelegate ? mDelegate->getProtocolName() : 0;
+}
+
+URLProtocolManager*
+InstrumentedURLProtocolHandler :: getProtocolManager()
+{
+  return mDelegate ? mDelegate->getProtocolManager() : 0;
+}
+
+void
+InstrumentedURLProtocolHandler :: record(Operation op, int64_t start, bool ok)
+{
+  int64_t elapsed = nowMicros() - start;
+  if (elapsed < 0)
+    elapsed = 0;
+  int32_t bucket = 0;
+  while (bucket < NUM_LATENCY_BUCKETS-1 && (elapsed >> (bucket+1)))
+    ++bucket;
+  __atomic_add_fetch(ok ? &mCalls[op] : &mErrors[op], 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&mLatency[op], elapsed, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&mBuckets[op][bucket], 1, __ATOMIC_RELAXED);
+}
+
+int
+InstrumentedURLProtocolHandler :: url_open(const char *url, int flags)
+{
+  if (!mDelegate)
+    return -1;
+  // the delegate cannot see our token, so hand it on
+  if (getCancellationToken())
+    mDelegate->setCancellationToken(getCancellationToken());
+  int retval = mDelegate->url_open(url, flags);
+  if (retval >= 0)
+  {
+    mURL = url ? url : "";
+    mFlags = flags;
+    mOpen = true;
+    mPosition = 0;
+  }
+  return retval;
+}
+
+int
+InstrumentedURLProtocolHandler :: url_close()
+{
+  if (!mDelegate)
+    return -1;
+  int retval = mDelegate->url_close();
+  if (mOpen)
+    tune();
+  mOpen = false;
+  return retval;
+}
+
+int
+InstrumentedURLProtocolHandler :: url_read(unsigned char* buf, int size)
+{
+  if (!mDelegate)
+    return -1;
+  int64_t start = nowMicros();
+  int retval = mDelegate->url_read(buf, size);
+  record(OP_READ, start, retval >= 0);
+  if (retval > 0)
+  {
+    __atomic_add_fetch(&mBytesRead, retval, __ATOMIC_RELAXED);
+    mPosition += retval;
+  }
+  return retval;
+}
+
+int
+InstrumentedURLProtocolHandler :: url_write(const unsigned char* buf, int size)
+{
+  if (!mDelegate)
+    return -1;
+  int64_t start = nowMicros();
+  int retval = mDelegate->url_write(buf, size);
+  record(OP_WRITE, start, retval >= 0);
+  if (retval > 0)
+  {
+    __atomic_add_fetch(&mBytesWritten, retval, __ATOMIC_RELAXED);
+    mPosition += retval;
+  }
+  return retval;
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: url_seek(int64_t position, int whence)
+{
+  if (!mDelegate)
+    return -1;
+  // asking for the size does not move anything, so it is not a seek
+  if (whence & SK_SEEK_SIZE)
+    return mDelegate->url_seek(position, whence);
+  int64_t start = nowMicros();
+  int64_t retval = mDelegate->url_seek(position, whence);
+  record(OP_SEEK, start, retval >= 0);
+  if (retval >= 0)
+  {
+    int64_t distance = retval > mPosition ? retval - mPosition :
+        mPosition - retval;
+    __atomic_add_fetch(&mSeekDistance, distance, __ATOMIC_RELAXED);
+    mPosition = retval;
+  }
+  return retval;
+}
+
+URLProtocolHandler::SeekableFlags
+InstrumentedURLProtocolHandler :: url_seekflags(const char* url, int flags)
+{
+  return mDelegate ? mDelegate->url_seekflags(url, flags) : SK_NOT_SEEKABLE;
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getCalls(Operation op)
+{
+  if (op < 0 || op >= NUM_OPERATIONS)
+    return 0;
+  return __atomic_load_n(&mCalls[op], __ATOMIC_RELAXED);
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getErrors(Operation op)
+{
+  if (op < 0 || op >= NUM_OPERATIONS)
+    return 0;
+  return __atomic_load_n(&mErrors[op], __ATOMIC_RELAXED);
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getTotalLatency(Operation op)
+{
+  if (op < 0 || op >= NUM_OPERATIONS)
+    return 0;
+  return __atomic_load_n(&mLatency[op], __ATOMIC_RELAXED);
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getLatencyCount(Operation op, int32_t bucket)
+{
+  if (op < 0 || op >= NUM_OPERATIONS || bucket < 0 ||
+      bucket >= NUM_LATENCY_BUCKETS)
+    return 0;
+  return __atomic_load_n(&mBuckets[op][bucket], __ATOMIC_RELAXED);
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getBytesRead()
+{
+  return __atomic_load_n(&mBytesRead, __ATOMIC_RELAXED);
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getBytesWritten()
+{
+  return __atomic_load_n(&mBytesWritten, __ATOMIC_RELAXED);
+}
+
+int64_t
+InstrumentedURLProtocolHandler :: getSeekDistance()
+{
+  return __atomic_load_n(&mSeekDistance, __ATOMIC_RELAXED);
+}
+
+void
+InstrumentedURLProtocolHandler :: tune()
+{
+  int64_t bytes;
+  int64_t calls;
+  if (mFlags == URL_RDONLY_MODE) {
+    bytes = getBytesRead();
+    calls = getCalls(OP_READ);
+  } else if (mFlags == URL_WRONLY_MODE) {
+    bytes = getBytesWritten();
+    calls = getCalls(OP_WRITE);
+  } else
+    return;
+  // too little to learn anything from
+  if (calls < 4)
+    return;
+  int64_t run = bytes / (getCalls(OP_SEEK) + 1);
+  int32_t target = floorPowerOf2(run / 8);
+
+  std::string key = tuningKey(mURL.c_str(), mFlags);
+  pthread_mutex_lock(&sTunedLock);
+  std::map<std::string, int32_t>::iterator it = sTunedLengths.find(key);
+  if (it != sTunedLengths.end())
+  {
+    int32_t old = it->second;
+    if (target > old*2)
+      target = old*2;
+    else if (target < old/2)
+      target = old/2;
+    it->second = target;
+  }
+  else
+    sTunedLengths[key] = target;
+  pthread_mutex_unlock(&sTunedLock);
+  VS_LOG_DEBUG("%s: %lld bytes in %lld calls and %lld seeks; next buffer length %d",
+      key.c_str(), (long long)bytes, (long long)calls,
+      (long long)getCalls(OP_SEEK), target);
+}
+
+int32_t
+InstrumentedURLProtocolHandler :: getTunedBufferLength(const char* url,
+    int flags, int32_t defaultLength)
+{
+  int32_t retval = defaultLength;
+  std::string key = tuningKey(url, flags);
+  pthread_mutex_lock(&sTunedLock);
+  std::map<std::string, int32_t>::iterator it = sTunedLengths.find(key);
+  if (it != sTunedLengths.end())
+    retval = it->second;
+  pthread_mutex_unlock(&sTunedLock);
+  return retval;
+}
+
+void
+InstrumentedURLProtocolHandler :: resetTunedBufferLengths()
+{
+  pthread_mutex_lock(&sTunedLock);
+  sTunedLengths.clear();
+  pthread_mutex_unlock(&sTunedLock);
+}
+
+}}}}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef INSTRUMENTEDURLPROTOCOLHANDLER_H_
+#define INSTRUMENTEDURLPROTOCOLHANDLER_H_
+
+#include <string>
+
+#include <io/humble/video/customio/URLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+  {
+  /**
+   * Wraps any other handler and counts what passes through it: bytes and
+   * calls for reads and writes, seeks and how far they jump, errors, and
+   * a latency histogram for each kind of call.
+   * <p>
+   * The counters are written by whichever thread does the I/O and may be
+   * read from any other thread while it does; each one is read
+   * atomically, but a sample of several is not a consistent snapshot.
+   * </p><p>
+   * When a handler that was opened for reading or for writing (but not
+   * both) is closed, what it saw is used to tune the buffer length the
+   * next open of a URL in the same place and direction should use; see
+   * #getTunedBufferLength(const char*, int, int32_t).
+   * </p>
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO InstrumentedURLProtocolHandler : public URLProtocolHandler
+  {
+  public:
+    typedef enum Operation {
+      OP_READ=0,
+      OP_WRITE,
+      OP_SEEK,
+      NUM_OPERATIONS
+    } Operation;
+
+    /**
+     * Latencies are counted in power of 2 buckets: bucket 0 holds calls
+     * that took under 2 microseconds, bucket n (n > 0) calls that took
+     * from 2^n up to 2^(n+1) microseconds, and the last bucket everything
+     * slower.
+     */
+    static const int32_t NUM_LATENCY_BUCKETS=24;
+
+    /** The smallest buffer length #getTunedBufferLength will suggest. */
+    static const int32_t MIN_TUNED_BUFFER_LENGTH=4096;
+    /** The largest buffer length #getTunedBufferLength will suggest. */
+    static const int32_t MAX_TUNED_BUFFER_LENGTH=1024*1024;
+
+    /**
+     * @param delegate The handler that does the I/O; deleted with this
+     *   handler.
+     */
+    InstrumentedURLProtocolHandler(URLProtocolHandler* delegate);
+    virtual ~InstrumentedURLProtocolHandler();
+
+    virtual const char* getProtocolName();
+    virtual URLProtocolManager *getProtocolManager();
+
+    URLProtocolHandler* getDelegate() { return mDelegate; }
+
+    // Now, let's have our forwarding functions
+    virtual int url_open(const char *url, int flags);
+    virtual int url_close();
+    virtual int url_read(unsigned char* buf, int size);
+    virtual int url_write(const unsigned char* buf, int size);
+    virtual int64_t url_seek(int64_t position, int whence);
+    virtual SeekableFlags url_seekflags(const char* url, int flags);
+
+    /** @return Successful calls of the given kind so far. */
+    int64_t getCalls(Operation op);
+    /** @return Calls of the given kind that returned an error. */
+    int64_t getErrors(Operation op);
+    /** @return The microseconds spent in calls of the given kind. */
+    int64_t getTotalLatency(Operation op);
+    /**
+     * @return How many calls of the given kind fell into the given latency
+     *   bucket, or 0 if op or bucket is out of range.
+     */
+    int64_t getLatencyCount(Operation op, int32_t bucket);
+    int64_t getBytesRead();
+    int64_t getBytesWritten();
+    /** @return The bytes skipped or rewound by seeks, added up. */
+    int64_t getSeekDistance();
+
+    /**
+     * The buffer length to use for the next open of url, learned from the
+     * handlers that were closed before it.
+     * <p>
+     * The aim is one call per sequential run: a buffer much shorter than
+     * the bytes read (or written) between seeks costs calls, and one much
+     * longer than that reads bytes that the next seek throws away.  The
+     * suggestion is the largest power of 2 no more than an eighth of the
+     * average run, between #MIN_TUNED_BUFFER_LENGTH and
+     * #MAX_TUNED_BUFFER_LENGTH, and moves at most a factor of 2 per close
+     * so one odd file does not undo what many others taught it.
+     * </p><p>
+     * What is learned is kept apart by protocol (the part of the URL
+     * before the first ':'; anything without one counts as "file"), by
+     * server for URLs with one (everything after "//" up to the next '/',
+     * '?' or '#') and by directory for the rest, and by whether it was
+     * read or written: different servers or disks need not behave alike.
+     * </p>
+     *
+     * @param url The URL about to be opened.
+     * @param flags The URLProtocolHandler::OpenFlags it will be opened with.
+     * @param defaultLength What to return if nothing has been learned.
+     */
+    static int32_t getTunedBufferLength(const char* url, int flags,
+        int32_t defaultLength);
+
+    /** Forget every tuned buffer length. */
+    static void resetTunedBufferLengths();
+
+  private:
+    void record(Operation op, int64_t start, bool ok);
+    void tune();
+
+    URLProtocolHandler* mDelegate;
+    std::string mURL;
+    int mFlags;
+    bool mOpen;
+    int64_t mPosition;
+
+    // updated with relaxed atomics so other threads may sample them.
+    int64_t mCalls[NUM_OPERATIONS];
+    int64_t mErrors[NUM_OPERATIONS];
+    int64_t mLatency[NUM_OPERATIONS];
+    int64_t mBuckets[NUM_OPERATIONS][NUM_LATENCY_BUCKETS];
+    int64_t mBytesRead;
+    int64_t mBytesWritten;
+    int64_t mSeekDistance;
+  };
+  }}}}
+#endif /*INSTRUMENTEDURLPROTOCOLHANDLER_H_*/
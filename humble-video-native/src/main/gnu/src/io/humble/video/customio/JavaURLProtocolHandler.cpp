@@ -68,11 +68,23 @@ JavaURLProtocolHandler :: JavaURLProtocolHandler(
     JavaURLProtocolManager* mgr,
     jobject aJavaProtocolHandler) : URLProtocolHandler(mgr)
 {
+  mJavaProtoHandler = NULL;
+  mJavaUrlReadDirect_mid = NULL;
+  mJavaUrlWriteDirect_mid = NULL;
+  mJavaBufferClear_mid = NULL;
+  mDirectBuffer = NULL;
+  mDirectAddress = NULL;
+  mDirectCapacity = 0;
   cacheJavaMethods(aJavaProtocolHandler);
 }
 
 JavaURLProtocolHandler :: ~JavaURLProtocolHandler()
 {
+  if (mDirectBuffer)
+  {
+    JNIHelper::sDeleteGlobalRef(mDirectBuffer);
+    mDirectBuffer = NULL;
+  }
   if (mJavaProtoHandler)
   {
     JNIHelper::sDeleteGlobalRef(mJavaProtoHandler);
@@ -106,6 +118,74 @@ JavaURLProtocolHandler :: cacheJavaMethods(jobject aProtoHandler)
   mJavaUrlIsStreamed_mid = env->GetMethodID(cls, "isStreamed",
       "(Ljava/lang/String;I)Z");
 
+  // IDirectURLProtocolHandler adds ByteBuffer overloads; handlers that
+  // do not have them get the byte[] methods.
+  mJavaUrlReadDirect_mid = env->GetMethodID(cls, "read",
+      "(Ljava/nio/ByteBuffer;I)I");
+  if (!mJavaUrlReadDirect_mid)
+    env->ExceptionClear();
+  mJavaUrlWriteDirect_mid = env->GetMethodID(cls, "write",
+      "(Ljava/nio/ByteBuffer;I)I");
+  if (!mJavaUrlWriteDirect_mid)
+    env->ExceptionClear();
+  if (mJavaUrlReadDirect_mid || mJavaUrlWriteDirect_mid)
+  {
+    jclass bufferCls = env->FindClass("java/nio/Buffer");
+    if (bufferCls)
+    {
+      mJavaBufferClear_mid = env->GetMethodID(bufferCls, "clear",
+          "()Ljava/nio/Buffer;");
+      env->DeleteLocalRef(bufferCls);
+    }
+    if (!mJavaBufferClear_mid)
+    {
+      env->ExceptionClear();
+      mJavaUrlReadDirect_mid = NULL;
+      mJavaUrlWriteDirect_mid = NULL;
+    }
+  }
+  env->DeleteLocalRef(cls);
+}
+
+jobject
+JavaURLProtocolHandler :: getDirectBuffer(JNIEnv* env, unsigned char* buf,
+    int size)
+{
+  // FFmpeg almost always passes the same AVIO buffer with the same size,
+  // so the ByteBuffer over it is made once and then just rewound.
+  if (buf != mDirectAddress || size != mDirectCapacity)
+  {
+    if (mDirectBuffer)
+      env->DeleteGlobalRef(mDirectBuffer);
+    mDirectBuffer = NULL;
+    mDirectAddress = NULL;
+    mDirectCapacity = 0;
+
+    jobject local = env->NewDirectByteBuffer(buf, size);
+    if (!local)
+    {
+      // this JVM cannot wrap native memory; fall back to byte arrays.
+      env->ExceptionClear();
+      mJavaUrlReadDirect_mid = NULL;
+      mJavaUrlWriteDirect_mid = NULL;
+      return NULL;
+    }
+    mDirectBuffer = env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    if (!mDirectBuffer)
+      return NULL;
+    mDirectAddress = buf;
+    mDirectCapacity = size;
+  }
+  else
+  {
+    // position 0, limit size, whatever the last call did to it.
+    jobject self = env->CallObjectMethod(mDirectBuffer, mJavaBufferClear_mid);
+    JavaURLProtocolHandler_CheckException(env);
+    if (self)
+      env->DeleteLocalRef(self);
+  }
+  return mDirectBuffer;
 }
 
 int
@@ -140,7 +220,7 @@ JavaURLProtocolHandler :: url_open(const char *url, int flags)
   if (jUrl)
     env->DeleteLocalRef(jUrl);
 
-  VS_CHECK_INTERRUPT(true);
+  VS_CHECK_CANCELLED(getCancellationToken(), true);
   return retval;
 }
 
@@ -168,7 +248,7 @@ JavaURLProtocolHandler :: url_close()
     VS_LOG_DEBUG("Got unknown exception");
     retval = -1;
   }
-  VS_CHECK_INTERRUPT(true);
+  VS_CHECK_CANCELLED(getCancellationToken(), true);
 
   return retval;
 }
@@ -200,7 +280,7 @@ JavaURLProtocolHandler :: url_seek(int64_t position,
     VS_LOG_DEBUG("Got unknown exception");
     retval = -1;
   }
-  VS_CHECK_INTERRUPT(true);
+  VS_CHECK_CANCELLED(getCancellationToken(), true);
   return retval;
 }
 
@@ -217,20 +297,33 @@ JavaURLProtocolHandler :: url_read(unsigned char* buf, int size)
   try
   {
     JavaURLProtocolHandler_CheckException(env);
-    byteArray = env->NewByteArray(size);
-    JavaURLProtocolHandler_CheckException(env);
-    // read into the Java byte array
-    if (byteArray)
+    jobject directBuffer = 0;
+    if (mJavaUrlReadDirect_mid && size > 0)
+      directBuffer = getDirectBuffer(env, buf, size);
+    if (directBuffer)
     {
-      retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlRead_mid,
-          byteArray, size);
+      // the Java handler reads straight into FFmpeg's buffer
+      retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlReadDirect_mid,
+          directBuffer, size);
       JavaURLProtocolHandler_CheckException(env);
     }
-    // now, copy into the C array, but only up to retval.
-    if (retval > 0)
+    else
     {
-      env->GetByteArrayRegion(byteArray, 0, retval, (jbyte*)buf);
+      byteArray = env->NewByteArray(size);
       JavaURLProtocolHandler_CheckException(env);
+      // read into the Java byte array
+      if (byteArray)
+      {
+        retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlRead_mid,
+            byteArray, size);
+        JavaURLProtocolHandler_CheckException(env);
+      }
+      // now, copy into the C array, but only up to retval.
+      if (retval > 0)
+      {
+        env->GetByteArrayRegion(byteArray, 0, retval, (jbyte*)buf);
+        JavaURLProtocolHandler_CheckException(env);
+      }
     }
   }
   catch (std::exception& e)
@@ -247,7 +340,7 @@ JavaURLProtocolHandler :: url_read(unsigned char* buf, int size)
   // is not returning to Java soon.
   if (byteArray)
     env->DeleteLocalRef(byteArray);
-  VS_CHECK_INTERRUPT(retval < 0 || retval != size);
+  VS_CHECK_CANCELLED(getCancellationToken(), retval < 0 || retval != size);
   return retval;
 }
 
@@ -264,19 +357,34 @@ JavaURLProtocolHandler :: url_write(const unsigned char* buf, int size)
   try
   {
     JavaURLProtocolHandler_CheckException(env);
-    byteArray = env->NewByteArray(size);
-    JavaURLProtocolHandler_CheckException(env);
-
-    // copy the data passed into the new java byteArray
-    if (byteArray)
+    jobject directBuffer = 0;
+    if (mJavaUrlWriteDirect_mid && size > 0)
+      // Java must not write to it, but ByteBuffers have no const.
+      directBuffer = getDirectBuffer(env, const_cast<unsigned char*>(buf),
+          size);
+    if (directBuffer)
     {
-      env->SetByteArrayRegion(byteArray, 0, size, (jbyte*)buf);
+      // the Java handler writes straight from FFmpeg's buffer
+      retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlWriteDirect_mid,
+          directBuffer, size);
       JavaURLProtocolHandler_CheckException(env);
-
-      // write from the Java byte array
-      retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlWrite_mid,
-          byteArray, size);
+    }
+    else
+    {
+      byteArray = env->NewByteArray(size);
       JavaURLProtocolHandler_CheckException(env);
+
+      // copy the data passed into the new java byteArray
+      if (byteArray)
+      {
+        env->SetByteArrayRegion(byteArray, 0, size, (jbyte*)buf);
+        JavaURLProtocolHandler_CheckException(env);
+
+        // write from the Java byte array
+        retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlWrite_mid,
+            byteArray, size);
+        JavaURLProtocolHandler_CheckException(env);
+      }
     }
   }
   catch (std::exception & e)
@@ -294,7 +402,7 @@ JavaURLProtocolHandler :: url_write(const unsigned char* buf, int size)
   // is not returning to Java soon.
   if (byteArray)
     env->DeleteLocalRef(byteArray);
-  VS_CHECK_INTERRUPT(retval < 0 || retval != size);
+  VS_CHECK_CANCELLED(getCancellationToken(), retval < 0 || retval != size);
 
   return retval;
 }
@@ -44,6 +44,7 @@ namespace io { namespace humble { namespace video { namespace customio
 
   private:
     void cacheJavaMethods(jobject aProtoHandler);
+    jobject getDirectBuffer(JNIEnv* env, unsigned char* buf, int size);
     jobject mJavaProtoHandler;
     jmethodID mJavaUrlOpen_mid;
     jmethodID mJavaUrlClose_mid;
@@ -52,6 +53,18 @@ namespace io { namespace humble { namespace video { namespace customio
     jmethodID mJavaUrlSeek_mid;
     jmethodID mJavaUrlIsStreamed_mid;
 
+    // Only set if the Java handler is an IDirectURLProtocolHandler.
+    jmethodID mJavaUrlReadDirect_mid;
+    jmethodID mJavaUrlWriteDirect_mid;
+    jmethodID mJavaBufferClear_mid;
+    /**
+     * A global ref to a java.nio.ByteBuffer over mDirectAddress, kept
+     * until FFmpeg hands us a different buffer (which it rarely does).
+     */
+    jobject mDirectBuffer;
+    unsigned char* mDirectAddress;
+    int mDirectCapacity;
+
   };
   }}}}
 #endif /*JAVAURLPROTOCOLHANDLER_H_*/
@@ -0,0 +1,311 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/time.h>
+
+#include <io/humble/ferry/Logger.h>
+
+#include <io/humble/video/customio/MemoryRingURLProtocolHandler.h>
+#include <io/humble/video/customio/MemoryRingURLProtocolManager.h>
+
+using namespace io::humble::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+
+// A sleeping side wakes this often to check for cancellation.
+static const int32_t WAIT_NANOS=10*1000*1000;
+
+MemoryRing :: MemoryRing(int32_t capacity)
+{
+  mCapacity = 4096;
+  while (mCapacity < capacity)
+    mCapacity <<= 1;
+  mData = (unsigned char*)malloc(mCapacity);
+  if (!mData)
+    throw std::bad_alloc();
+  mWritten = 0;
+  mRead = 0;
+  mWriterDone = 0;
+  mReaderDone = 0;
+  mWriterWaiting = 0;
+  mReaderWaiting = 0;
+  mHighWater = 0;
+  mWriterStalls = 0;
+  mReaderStalls = 0;
+  pthread_mutex_init(&mLock, 0);
+  pthread_cond_init(&mCond, 0);
+}
+
+MemoryRing :: ~MemoryRing()
+{
+  pthread_cond_destroy(&mCond);
+  pthread_mutex_destroy(&mLock);
+  free(mData);
+}
+
+int32_t
+MemoryRing :: write(const unsigned char* buf, int32_t size, bool blocking,
+    CancellationToken* token)
+{
+  if (!buf || size < 0)
+    return -EINVAL;
+  int32_t retval = 0;
+  int64_t mask = mCapacity - 1;
+  bool stalled = false;
+  while (retval < size)
+  {
+    if (__atomic_load_n(&mReaderDone, __ATOMIC_ACQUIRE))
+      return -EPIPE;
+    int64_t written = mWritten; // only we change it
+    int64_t room = mCapacity - (written - __atomic_load_n(&mRead, __ATOMIC_ACQUIRE));
+    if (room <= 0)
+    {
+      if (!stalled)
+        __atomic_add_fetch(&mWriterStalls, 1, __ATOMIC_RELAXED);
+      stalled = true;
+      if (!blocking)
+        break;
+      if (!wait(&mWriterWaiting, true, token))
+        return retval > 0 ? retval : -EINTR;
+      continue;
+    }
+    int64_t len = size - retval < room ? size - retval : room;
+    int64_t offset = written & mask;
+    int64_t first = mCapacity - offset < len ? mCapacity - offset : len;
+    memcpy(mData + offset, buf + retval, first);
+    memcpy(mData, buf + retval + first, len - first);
+    __atomic_store_n(&mWritten, written + len, __ATOMIC_RELEASE);
+    retval += len;
+    stalled = false;
+
+    int64_t buffered = written + len - __atomic_load_n(&mRead, __ATOMIC_ACQUIRE);
+    if (buffered > mHighWater)
+      __atomic_store_n(&mHighWater, buffered, __ATOMIC_RELAXED);
+    wake(&mReaderWaiting);
+  }
+  if (!retval && size > 0)
+    return -EAGAIN;
+  return retval;
+}
+
+int32_t
+MemoryRing :: read(unsigned char* buf, int32_t size, bool blocking,
+    CancellationToken* token)
+{
+  if (!buf || size < 0)
+    return -EINVAL;
+  int64_t mask = mCapacity - 1;
+  int64_t available = 0;
+  int64_t readPos = mRead; // only we change it
+  bool stalled = false;
+  while (size > 0)
+  {
+    // read done before written, so a producer that writes and then
+    // finishes is never mistaken for one that finished with nothing left.
+    int32_t done = __atomic_load_n(&mWriterDone, __ATOMIC_ACQUIRE);
+    available = __atomic_load_n(&mWritten, __ATOMIC_ACQUIRE) - readPos;
+    if (available > 0 || done)
+      break;
+    if (!stalled)
+      __atomic_add_fetch(&mReaderStalls, 1, __ATOMIC_RELAXED);
+    stalled = true;
+    if (!blocking)
+      return -EAGAIN;
+    if (!wait(&mReaderWaiting, false, token))
+      return -EINTR;
+  }
+  int64_t len = size < available ? size : available;
+  if (len <= 0)
+    return 0;
+  int64_t offset = readPos & mask;
+  int64_t first = mCapacity - offset < len ? mCapacity - offset : len;
+  memcpy(buf, mData + offset, first);
+  memcpy(buf + first, mData, len - first);
+  __atomic_store_n(&mRead, readPos + len, __ATOMIC_RELEASE);
+  wake(&mWriterWaiting);
+  return (int32_t)len;
+}
+
+void
+MemoryRing :: finishWriting()
+{
+  __atomic_store_n(&mWriterDone, 1, __ATOMIC_RELEASE);
+  wake(&mReaderWaiting);
+}
+
+void
+MemoryRing :: finishReading()
+{
+  __atomic_store_n(&mReaderDone, 1, __ATOMIC_RELEASE);
+  wake(&mWriterWaiting);
+}
+
+bool
+MemoryRing :: wait(volatile int32_t* waiting, bool forWriter,
+    CancellationToken* token)
+{
+  bool retval = true;
+  pthread_mutex_lock(&mLock);
+  // Announce we are going to sleep, then look again: the other side
+  // publishes its position before it checks the flag, so either we see
+  // its update here or it sees our flag and signals us.
+  __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+  bool ready;
+  if (forWriter)
+    ready = __atomic_load_n(&mReaderDone, __ATOMIC_SEQ_CST) ||
+        __atomic_load_n(&mWritten, __ATOMIC_RELAXED) -
+        __atomic_load_n(&mRead, __ATOMIC_SEQ_CST) < mCapacity;
+  else
+    ready = __atomic_load_n(&mWriterDone, __ATOMIC_SEQ_CST) ||
+        __atomic_load_n(&mWritten, __ATOMIC_SEQ_CST) >
+        __atomic_load_n(&mRead, __ATOMIC_RELAXED);
+  if (!ready)
+  {
+    struct timeval now;
+    struct timespec until;
+    gettimeofday(&now, 0);
+    until.tv_sec = now.tv_sec;
+    until.tv_nsec = now.tv_usec*1000 + WAIT_NANOS;
+    if (until.tv_nsec >= 1000*1000*1000) {
+      ++until.tv_sec;
+      until.tv_nsec -= 1000*1000*1000;
+    }
+    pthread_cond_timedwait(&mCond, &mLock, &until);
+  }
+  __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&mLock);
+  if (!ready && CancellationToken::sIsCancelled(token))
+    retval = false;
+  return retval;
+}
+
+void
+MemoryRing :: wake(volatile int32_t* waiting)
+{
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiting, __ATOMIC_RELAXED))
+  {
+    pthread_mutex_lock(&mLock);
+    pthread_cond_broadcast(&mCond);
+    pthread_mutex_unlock(&mLock);
+  }
+}
+
+int32_t
+MemoryRing :: getStatistics(int64_t* stats, int32_t numStats)
+{
+  if (!stats || numStats <= 0)
+    return 0;
+  int64_t values[NUM_STATS];
+  int64_t read = __atomic_load_n(&mRead, __ATOMIC_ACQUIRE);
+  int64_t written = __atomic_load_n(&mWritten, __ATOMIC_ACQUIRE);
+  values[STAT_CAPACITY] = mCapacity;
+  values[STAT_BUFFERED] = written - read;
+  values[STAT_HIGH_WATER] = __atomic_load_n(&mHighWater, __ATOMIC_RELAXED);
+  values[STAT_BYTES_WRITTEN] = written;
+  values[STAT_BYTES_READ] = read;
+  values[STAT_WRITER_STALLS] = __atomic_load_n(&mWriterStalls, __ATOMIC_RELAXED);
+  values[STAT_READER_STALLS] = __atomic_load_n(&mReaderStalls, __ATOMIC_RELAXED);
+  int32_t retval = numStats < NUM_STATS ? numStats : NUM_STATS;
+  memcpy(stats, values, retval * sizeof(int64_t));
+  return retval;
+}
+
+MemoryRingURLProtocolHandler :: MemoryRingURLProtocolHandler(
+    MemoryRingURLProtocolManager* mgr, bool blocking) : URLProtocolHandler(mgr)
+{
+  mRingManager = mgr;
+  mBlocking = blocking;
+  mWriter = false;
+  mRing = 0;
+}
+
+MemoryRingURLProtocolHandler :: ~MemoryRingURLProtocolHandler()
+{
+  if (mRing)
+    url_close();
+}
+
+int
+MemoryRingURLProtocolHandler :: url_open(const char *url, int flags)
+{
+  if (!url || !*url)
+    return -1;
+  if (mRing)
+    url_close();
+  mWriter = flags != URL_RDONLY_MODE;
+  mRing = mRingManager->attach(url, mWriter);
+  if (!mRing)
+  {
+    VS_LOG_ERROR("%s already has a %s open", url, mWriter ? "writer" : "reader");
+    return -EBUSY;
+  }
+  return 0;
+}
+
+int
+MemoryRingURLProtocolHandler :: url_close()
+{
+  if (!mRing)
+    return -1;
+  if (mWriter)
+    mRing->finishWriting();
+  else
+    mRing->finishReading();
+  mRingManager->detach(mRing, mWriter);
+  mRing = 0;
+  return 0;
+}
+
+int
+MemoryRingURLProtocolHandler :: url_read(unsigned char* buf, int size)
+{
+  if (!mRing || mWriter)
+    return -1;
+  return mRing->read(buf, size, mBlocking, getCancellationToken());
+}
+
+int
+MemoryRingURLProtocolHandler :: url_write(const unsigned char* buf, int size)
+{
+  if (!mRing || !mWriter)
+    return -1;
+  return mRing->write(buf, size, mBlocking, getCancellationToken());
+}
+
+int64_t
+MemoryRingURLProtocolHandler :: url_seek(int64_t, int)
+{
+  return -1;
+}
+
+URLProtocolHandler::SeekableFlags
+MemoryRingURLProtocolHandler :: url_seekflags(const char*, int)
+{
+  return URLProtocolHandler::SK_NOT_SEEKABLE;
+}
+
+}}}}
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MEMORYRINGURLPROTOCOLHANDLER_H_
+#define MEMORYRINGURLPROTOCOLHANDLER_H_
+
+#include <pthread.h>
+
+#include <io/humble/video/customio/URLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+  {
+  class MemoryRingURLProtocolManager;
+
+  /**
+   * A bounded ring of bytes passed from one producer thread to one
+   * consumer thread.
+   * <p>
+   * The data path is lock free: each side owns one position counter and
+   * publishes it with a release store, so a write and a read never wait on
+   * each other unless the ring is full or empty.  Only then does the
+   * waiting side sleep on a condition variable, and the other side takes
+   * the lock only when it knows someone is asleep.
+   * </p><p>
+   * Rings are made and shared by MemoryRingURLProtocolManager; most code
+   * uses them through MemoryRingURLProtocolHandler.
+   * </p>
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO MemoryRing
+  {
+  public:
+    /** The statistics #getStatistics(int64_t*, int32_t) fills in. */
+    typedef enum Statistic {
+      /** The most bytes the ring holds. */
+      STAT_CAPACITY=0,
+      /** The bytes written but not yet read. */
+      STAT_BUFFERED=1,
+      /** The most bytes the ring has held at once. */
+      STAT_HIGH_WATER=2,
+      /** The bytes written since the ring was made. */
+      STAT_BYTES_WRITTEN=3,
+      /** The bytes read since the ring was made. */
+      STAT_BYTES_READ=4,
+      /** How many writes found the ring full. */
+      STAT_WRITER_STALLS=5,
+      /** How many reads found the ring empty. */
+      STAT_READER_STALLS=6,
+      NUM_STATS=7
+    } Statistic;
+
+    /**
+     * @param capacity The most bytes to hold; rounded up to a power of 2.
+     */
+    MemoryRing(int32_t capacity);
+    ~MemoryRing();
+
+    /**
+     * Copy bytes into the ring.  Only the producer thread may call this.
+     *
+     * @param blocking If true, wait for room until everything is written.
+     * @param token Checked while waiting; may be null.
+     * @return The bytes written; -EAGAIN if the ring is full and blocking
+     *   is false; -EPIPE if the consumer has gone; -EINTR if cancelled
+     *   while waiting.
+     */
+    int32_t write(const unsigned char* buf, int32_t size, bool blocking,
+        io::humble::ferry::CancellationToken* token);
+
+    /**
+     * Copy bytes out of the ring.  Only the consumer thread may call this.
+     *
+     * @param blocking If true, wait until there is something to read.
+     * @param token Checked while waiting; may be null.
+     * @return The bytes read; 0 once the producer has finished and
+     *   everything has been read; -EAGAIN if the ring is empty and
+     *   blocking is false; -EINTR if cancelled while waiting.
+     */
+    int32_t read(unsigned char* buf, int32_t size, bool blocking,
+        io::humble::ferry::CancellationToken* token);
+
+    /** The producer is done; the consumer reads what is left, then EOF. */
+    void finishWriting();
+    /** The consumer is done; the producer's writes fail from now on. */
+    void finishReading();
+
+    /**
+     * @param stats Filled in with up to numStats values, indexed by
+     *   Statistic.
+     * @return The number of values filled in.
+     */
+    int32_t getStatistics(int64_t* stats, int32_t numStats);
+
+  private:
+    MemoryRing(const MemoryRing&);
+    MemoryRing& operator=(const MemoryRing&);
+
+    bool wait(volatile int32_t* waiting, bool forWriter,
+        io::humble::ferry::CancellationToken* token);
+    void wake(volatile int32_t* waiting);
+
+    unsigned char* mData;
+    int64_t mCapacity;
+    // Each side owns one counter and only reads the other's; they never
+    // wrap, so the bytes buffered is always mWritten - mRead.
+    volatile int64_t mWritten;
+    volatile int64_t mRead;
+    volatile int32_t mWriterDone;
+    volatile int32_t mReaderDone;
+    volatile int32_t mWriterWaiting;
+    volatile int32_t mReaderWaiting;
+    volatile int64_t mHighWater;
+    volatile int64_t mWriterStalls;
+    volatile int64_t mReaderStalls;
+    pthread_mutex_t mLock;
+    pthread_cond_t mCond;
+  };
+
+  /**
+   * One end of a MemoryRing: opened read only it is the consumer, usually
+   * a Demuxer; opened for writing it is the producer.
+   * <p>
+   * Both ends open the same URL, for example "memring:camera1", and
+   * whichever opens first makes the ring.  Each ring takes one producer
+   * and one consumer.  Closing the producer marks the end of the stream,
+   * so the consumer sees EOF once it has read everything; closing the
+   * consumer makes further writes fail.  The ring goes away when both
+   * ends are closed.
+   * </p><p>
+   * The stream cannot seek.
+   * </p>
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO MemoryRingURLProtocolHandler : public URLProtocolHandler
+  {
+  public:
+    MemoryRingURLProtocolHandler(MemoryRingURLProtocolManager* mgr,
+        bool blocking);
+    virtual ~MemoryRingURLProtocolHandler();
+
+    // Now, let's have our forwarding functions
+    virtual int url_open(const char *url, int flags);
+    virtual int url_close();
+    virtual int url_read(unsigned char* buf, int size);
+    virtual int url_write(const unsigned char* buf, int size);
+    virtual int64_t url_seek(int64_t position, int whence);
+    virtual SeekableFlags url_seekflags(const char* url, int flags);
+
+  private:
+    MemoryRingURLProtocolManager* mRingManager;
+    bool mBlocking;
+    bool mWriter;
+    MemoryRing* mRing;
+  };
+  }}}}
+#endif /*MEMORYRINGURLPROTOCOLHANDLER_H_*/
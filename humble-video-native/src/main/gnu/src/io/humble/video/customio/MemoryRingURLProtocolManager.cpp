@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <new>
+
+#include <io/humble/video/customio/MemoryRingURLProtocolManager.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+MemoryRingURLProtocolManager*
+MemoryRingURLProtocolManager :: registerProtocol(const char *aProtocolName,
+    int32_t capacity, bool blocking)
+{
+  MemoryRingURLProtocolManager* mgr = new MemoryRingURLProtocolManager(
+      aProtocolName, capacity, blocking);
+  return dynamic_cast<MemoryRingURLProtocolManager*>(URLProtocolManager::registerProtocol(mgr));
+}
+
+MemoryRingURLProtocolManager :: MemoryRingURLProtocolManager(
+    const char * aProtocolName, int32_t capacity, bool blocking) :
+    URLProtocolManager(aProtocolName)
+{
+  mCapacity = capacity > 0 ? capacity : DEFAULT_CAPACITY;
+  mBlocking = blocking;
+  pthread_mutex_init(&mLock, 0);
+}
+
+MemoryRingURLProtocolManager :: ~MemoryRingURLProtocolManager()
+{
+  std::map<std::string, RingEntry>::iterator it;
+  for(it = mRings.begin(); it != mRings.end(); ++it)
+    delete it->second.ring;
+  pthread_mutex_destroy(&mLock);
+}
+
+MemoryRingURLProtocolHandler *
+MemoryRingURLProtocolManager :: getHandler(const char *, int)
+{
+  return new MemoryRingURLProtocolHandler(this, mBlocking);
+}
+
+MemoryRing*
+MemoryRingURLProtocolManager :: attach(const char* url, bool writer)
+{
+  MemoryRing* retval = 0;
+  pthread_mutex_lock(&mLock);
+  try {
+    std::map<std::string, RingEntry>::iterator it = mRings.find(url);
+    if (it == mRings.end())
+    {
+      RingEntry entry;
+      entry.ring = new MemoryRing(mCapacity);
+      entry.writerAttached = entry.readerAttached = false;
+      entry.writerUsed = entry.readerUsed = false;
+      it = mRings.insert(std::make_pair(std::string(url), entry)).first;
+    }
+    RingEntry* entry = &it->second;
+    bool* attached = writer ? &entry->writerAttached : &entry->readerAttached;
+    bool* used = writer ? &entry->writerUsed : &entry->readerUsed;
+    if (!*used)
+    {
+      *attached = *used = true;
+      retval = entry->ring;
+    }
+  } catch (std::bad_alloc &) {
+    retval = 0;
+  }
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+void
+MemoryRingURLProtocolManager :: detach(MemoryRing* ring, bool writer)
+{
+  MemoryRing* dead = 0;
+  pthread_mutex_lock(&mLock);
+  std::map<std::string, RingEntry>::iterator it;
+  for(it = mRings.begin(); it != mRings.end(); ++it)
+  {
+    RingEntry* entry = &it->second;
+    if (entry->ring != ring)
+      continue;
+    if (writer)
+      entry->writerAttached = false;
+    else
+      entry->readerAttached = false;
+    // a producer may finish before its consumer shows up, so the ring
+    // lives until both ends have come and gone
+    if (entry->writerUsed && entry->readerUsed &&
+        !entry->writerAttached && !entry->readerAttached)
+    {
+      dead = ring;
+      mRings.erase(it);
+    }
+    break;
+  }
+  pthread_mutex_unlock(&mLock);
+  delete dead;
+}
+
+int32_t
+MemoryRingURLProtocolManager :: getStatistics(const char* url, int64_t* stats,
+    int32_t numStats)
+{
+  MemoryRingURLProtocolManager* mgr = dynamic_cast<MemoryRingURLProtocolManager*>(
+      URLProtocolManager::findProtocol(0, url, 0, 0));
+  if (!mgr)
+    return -1;
+  int32_t retval = -1;
+  pthread_mutex_lock(&mgr->mLock);
+  std::map<std::string, RingEntry>::iterator it = mgr->mRings.find(url);
+  if (it != mgr->mRings.end())
+    retval = it->second.ring->getStatistics(stats, numStats);
+  pthread_mutex_unlock(&mgr->mLock);
+  return retval;
+}
+}}}}
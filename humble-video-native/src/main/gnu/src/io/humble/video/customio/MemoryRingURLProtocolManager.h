@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MEMORYRINGURLPROTOCOLMANAGER_H_
+#define MEMORYRINGURLPROTOCOLMANAGER_H_
+
+#include <map>
+#include <string>
+#include <pthread.h>
+
+#include <io/humble/video/customio/URLProtocolManager.h>
+#include <io/humble/video/customio/MemoryRingURLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+  /**
+   * Hands out MemoryRingURLProtocolHandler objects, and keeps the rings
+   * they share, one per URL.
+   * <p>
+   * A live source can then hand bytes straight to a Demuxer: the producer
+   * opens "memring:name" for writing and writes into it, and the Demuxer
+   * opens the same URL.  No file, pipe or socket sits in between.
+   * </p>
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO MemoryRingURLProtocolManager : public URLProtocolManager
+  {
+  public:
+    /** The ring size used if none is given. */
+    static const int32_t DEFAULT_CAPACITY=4*1024*1024;
+
+    /**
+     * Returns a URLProtocol handler for the given url and flags
+     *
+     * @return a {@link URLProtocolHandler} or NULL if none can be created.
+     */
+    MemoryRingURLProtocolHandler* getHandler(const char* url, int flags);
+
+    /**
+     * Convenience method that creates a MemoryRingURLProtocolManager and
+     * registers with the URLProtocolManager global methods.
+     *
+     * @param aProtocolName The protocol, for example "memring".
+     * @param capacity The bytes each ring holds, rounded up to a power of
+     *   2.  <= 0 means #DEFAULT_CAPACITY.
+     * @param blocking If true, a write to a full ring waits for room and a
+     *   read from an empty ring waits for data.  If false they return
+     *   -EAGAIN instead.
+     */
+    static MemoryRingURLProtocolManager* registerProtocol(const char *aProtocolName,
+        int32_t capacity, bool blocking);
+
+    /**
+     * Read a ring's fill level and counters.
+     *
+     * @param url The URL both ends opened.
+     * @param stats Filled in with up to numStats values, indexed by
+     *   MemoryRing::Statistic.
+     * @return The number of values filled in, or -1 if no ring is open on
+     *   that URL.
+     */
+    static int32_t getStatistics(const char* url, int64_t* stats,
+        int32_t numStats);
+
+    /**
+     * Find or make the ring for url and add one end to it.
+     *
+     * @return The ring, or null if that end is already open.
+     */
+    MemoryRing* attach(const char* url, bool writer);
+    /**
+     * Remove one end; the ring is deleted once both ends have attached and
+     * detached again.  A ring only one end ever used lives until this
+     * manager is unregistered.
+     */
+    void detach(MemoryRing* ring, bool writer);
+
+  protected:
+    MemoryRingURLProtocolManager(const char *aProtocolName,
+        int32_t capacity, bool blocking);
+    virtual ~MemoryRingURLProtocolManager();
+
+  private:
+    /** A ring and which of its ends are open. */
+    typedef struct RingEntry {
+      MemoryRing* ring;
+      bool writerAttached;
+      bool readerAttached;
+      /** Each end may attach once per ring. */
+      bool writerUsed;
+      bool readerUsed;
+    } RingEntry;
+
+    int32_t mCapacity;
+    bool mBlocking;
+    std::map<std::string, RingEntry> mRings;
+    pthread_mutex_t mLock;
+  };
+}}}}
+#endif /*MEMORYRINGURLPROTOCOLMANAGER_H_*/
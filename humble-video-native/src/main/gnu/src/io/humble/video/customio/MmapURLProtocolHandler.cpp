@@ -0,0 +1,287 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <io/humble/ferry/Logger.h>
+
+#include <io/humble/video/customio/MmapURLProtocolHandler.h>
+#include <io/humble/video/customio/MmapURLProtocolManager.h>
+
+using namespace io::humble::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+
+MmapURLProtocolHandler :: MmapURLProtocolHandler(
+    MmapURLProtocolManager* mgr) : URLProtocolHandler(mgr)
+{
+  mFd = -1;
+  mData = 0;
+  mSize = 0;
+  mPosition = 0;
+  mSequential = true;
+  mReadSinceJump = 0;
+  mAdvisedTo = 0;
+}
+
+MmapURLProtocolHandler :: ~MmapURLProtocolHandler()
+{
+  reset();
+}
+
+void
+MmapURLProtocolHandler :: reset()
+{
+  (void) url_close();
+}
+
+#ifndef _WIN32
+void
+MmapURLProtocolHandler :: advise(int64_t position, int64_t length, int advice)
+{
+  if (!mData || position >= mSize || length <= 0)
+    return;
+  // madvise wants a page aligned start
+  static const int64_t pageSize = sysconf(_SC_PAGESIZE);
+  int64_t start = position - position % pageSize;
+  int64_t end = position + length;
+  if (end > mSize)
+    end = mSize;
+  (void) madvise(mData + start, (size_t)(end - start), advice);
+}
+
+int
+MmapURLProtocolHandler :: url_open(const char *url, int flags)
+{
+  if (!url || !*url)
+    return -1;
+  reset();
+  if (flags != URLProtocolHandler::URL_RDONLY_MODE)
+  {
+    VS_LOG_DEBUG("can only open files for reading: %s", url);
+    return -1;
+  }
+
+  // The URL MAY contain a protocol string.  Find it now.
+  char proto[256];
+  const char* protocol = URLProtocolManager::parseProtocol(proto, sizeof(proto), url);
+  if (protocol)
+  {
+    size_t protoLen = strlen(protocol);
+    // skip past it
+    url = url + protoLen;
+    if (*url == ':' || *url == ',')
+      ++url;
+  }
+
+  mFd = open(url, O_RDONLY);
+  if (mFd < 0)
+    return -1;
+
+  struct stat info;
+  if (fstat(mFd, &info) < 0 || (uint64_t)info.st_size > (size_t)-1)
+  {
+    VS_LOG_DEBUG("could not map: %s", url);
+    url_close();
+    return -1;
+  }
+  mSize = info.st_size;
+  if (mSize > 0)
+  {
+    void* data = mmap(0, (size_t)mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+    if (data == MAP_FAILED)
+    {
+      VS_LOG_DEBUG("could not map: %s", url);
+      url_close();
+      return -1;
+    }
+    mData = (unsigned char*)data;
+    // demuxers mostly read front to back; assume that until they seek.
+    advise(0, mSize, MADV_SEQUENTIAL);
+  }
+  return 0;
+}
+
+int
+MmapURLProtocolHandler :: url_close()
+{
+  if (mFd < 0)
+    return -1;
+  if (mData)
+    munmap(mData, (size_t)mSize);
+  int retval = close(mFd);
+  mFd = -1;
+  mData = 0;
+  mSize = 0;
+  mPosition = 0;
+  mSequential = true;
+  mReadSinceJump = 0;
+  mAdvisedTo = 0;
+  return retval;
+}
+
+int
+MmapURLProtocolHandler :: url_read(unsigned char* buf, int size)
+{
+  if (mFd < 0 || size < 0)
+    return -1;
+  // no system call here; that is the point of mapping.  See the class
+  // docs for what happens if the file shrinks.
+  int64_t available = mSize - mPosition;
+  if (available <= 0)
+    return 0;
+  if (size > available)
+    size = (int)available;
+
+  mReadSinceJump += size;
+  if (!mSequential && mReadSinceJump >= READ_AHEAD_WINDOW)
+  {
+    // the demuxer has settled down to reading straight through again.
+    advise(0, mSize, MADV_SEQUENTIAL);
+    mSequential = true;
+    mAdvisedTo = mPosition;
+  }
+  if (mSequential)
+  {
+    // keep the kernel a window ahead of us, half a window at a time so we
+    // do not make a system call on every read.
+    if (mPosition + size + READ_AHEAD_WINDOW/2 > mAdvisedTo)
+    {
+      int64_t from = mAdvisedTo > mPosition ? mAdvisedTo : mPosition;
+      int64_t to = mPosition + size + READ_AHEAD_WINDOW;
+      advise(from, to - from, MADV_WILLNEED);
+      mAdvisedTo = to;
+    }
+  }
+  else if (size > 4096)
+    // no read-ahead in random mode, so fault in a multi-page read at once.
+    advise(mPosition, size, MADV_WILLNEED);
+
+  memcpy(buf, mData + mPosition, size);
+  mPosition += size;
+  return size;
+}
+
+int64_t
+MmapURLProtocolHandler :: url_seek(int64_t position,
+    int whence)
+{
+  if (mFd < 0)
+    return -1;
+
+  int64_t newPosition;
+  switch(whence) {
+    case SK_SEEK_SET:
+      newPosition = position;
+      break;
+    case SK_SEEK_CUR:
+      newPosition = mPosition + position;
+      break;
+    case SK_SEEK_END:
+      newPosition = mSize + position;
+      break;
+    case SK_SEEK_SIZE:
+      return url_getsize();
+    default:
+      return -1;
+  }
+  if (newPosition < 0)
+    return -1;
+
+  int64_t distance = newPosition - mPosition;
+  if (distance < 0)
+    distance = -distance;
+  if (distance > READ_AHEAD_WINDOW)
+  {
+    // a real jump (not just FFmpeg re-reading its buffer), so stop the
+    // kernel reading ahead of a position we have left.
+    if (mSequential)
+    {
+      advise(0, mSize, MADV_RANDOM);
+      mSequential = false;
+    }
+    mReadSinceJump = 0;
+  }
+  mPosition = newPosition;
+  return newPosition;
+}
+#else
+void
+MmapURLProtocolHandler :: advise(int64_t, int64_t, int)
+{
+}
+
+int
+MmapURLProtocolHandler :: url_open(const char *url, int)
+{
+  VS_LOG_DEBUG("memory mapped files are not supported on this platform: %s", url);
+  return -1;
+}
+
+int
+MmapURLProtocolHandler :: url_close()
+{
+  return -1;
+}
+
+int
+MmapURLProtocolHandler :: url_read(unsigned char*, int)
+{
+  return -1;
+}
+
+int64_t
+MmapURLProtocolHandler :: url_seek(int64_t, int)
+{
+  return -1;
+}
+#endif // ! _WIN32
+
+int64_t
+MmapURLProtocolHandler :: url_getsize()
+{
+  if (mFd < 0)
+    return -1;
+  return mSize;
+}
+
+int
+MmapURLProtocolHandler :: url_write(const unsigned char*, int)
+{
+  // read only
+  return -1;
+}
+
+URLProtocolHandler::SeekableFlags
+MmapURLProtocolHandler :: url_seekflags( const char*, int)
+{
+  return URLProtocolHandler::SK_SEEKABLE_NORMAL;
+}
+
+}}}}
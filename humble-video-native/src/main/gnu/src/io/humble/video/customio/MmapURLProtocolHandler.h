@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MMAPURLPROTOCOLHANDLER_H_
+#define MMAPURLPROTOCOLHANDLER_H_
+
+#include <io/humble/video/customio/URLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+  {
+  class MmapURLProtocolManager;
+
+  /**
+   * A read-only local file handler that maps the whole file into memory and
+   * serves reads and seeks from the mapping.
+   * <p>
+   * Reads are a single memcpy from the page cache into FFmpeg's buffer, and
+   * the size is known from the moment the file is opened.  The handler
+   * tells the kernel how the demuxer is reading: while reads are
+   * sequential it asks for read-ahead (MADV_SEQUENTIAL plus MADV_WILLNEED
+   * on the next window); once the demuxer starts jumping around it switches
+   * to MADV_RANDOM so the kernel stops reading pages nobody asked for.
+   * </p><p>
+   * Files open for writing are refused, as are files too large to map
+   * (only a concern in 32-bit processes).  Not available on Windows.
+   * </p><p>
+   * The mapping is made once, when the file is opened, and reads never
+   * ask the file system again: bytes appended later are not seen, and
+   * the file must not shrink while it is open.  Reading a page past the
+   * end of a file someone else has truncated raises SIGBUS, which takes
+   * down the whole process, so only use this for files that are not
+   * written while being read.
+   * </p>
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO MmapURLProtocolHandler : public URLProtocolHandler
+  {
+  public:
+    /** How far ahead of sequential reads we ask the kernel to read. */
+    static const int64_t READ_AHEAD_WINDOW=4*1024*1024;
+
+    MmapURLProtocolHandler(MmapURLProtocolManager* mgr);
+    virtual ~MmapURLProtocolHandler();
+
+    // Now, let's have our forwarding functions
+    virtual int url_open(const char *url, int flags);
+    virtual int url_close();
+    virtual int url_read(unsigned char* buf, int size);
+    virtual int url_write(const unsigned char* buf, int size);
+    virtual int64_t url_seek(int64_t position, int whence);
+    virtual SeekableFlags url_seekflags(const char* url, int flags);
+    virtual int64_t url_getsize();
+
+  private:
+    void advise(int64_t position, int64_t length, int advice);
+    void reset();
+
+    int mFd;
+    unsigned char* mData;
+    int64_t mSize;
+    int64_t mPosition;
+    /** True while the demuxer reads sequentially. */
+    bool mSequential;
+    /** Bytes read since the last jump. */
+    int64_t mReadSinceJump;
+    /** Everything below this offset has been advised WILLNEED. */
+    int64_t mAdvisedTo;
+  };
+  }}}}
+#endif /*MMAPURLPROTOCOLHANDLER_H_*/
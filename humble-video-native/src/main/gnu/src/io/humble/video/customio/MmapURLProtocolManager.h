@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MMAPURLPROTOCOLMANAGER_H_
+#define MMAPURLPROTOCOLMANAGER_H_
+
+#include <io/humble/video/customio/URLProtocolManager.h>
+#include <io/humble/video/customio/MmapURLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+  /**
+   * Hands out MmapURLProtocolHandler objects for local files.
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO MmapURLProtocolManager : public URLProtocolManager
+  {
+  public:
+    /**
+     * Returns a URLProtocol handler for the given url and flags
+     *
+     * @return a {@link URLProtocolHandler} or NULL if none can be created.
+     */
+    MmapURLProtocolHandler* getHandler(const char* url, int flags);
+
+    /**
+     * Convenience method that creates a MmapURLProtocolManager and registers
+     * with the URLProtocolManager global methods, so that for example
+     * "mmap:/path/to/file.mp4" opens through a mapping.
+     */
+    static MmapURLProtocolManager* registerProtocol(const char *aProtocolName);
+
+  protected:
+    MmapURLProtocolManager(const char *aProtocolName);
+    virtual ~MmapURLProtocolManager();
+  };
+}}}}
+#endif /*MMAPURLPROTOCOLMANAGER_H_*/
@@ -0,0 +1,442 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#include <io/humble/ferry/Logger.h>
+
+#include <io/humble/video/customio/PrefetchURLProtocolHandler.h>
+#include <io/humble/video/customio/PrefetchURLProtocolManager.h>
+
+using namespace io::humble::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+
+// The alignment O_DIRECT wants for buffers, offsets and lengths.
+static const size_t DIRECT_IO_ALIGNMENT=4096;
+// More threads than this just queue up in the disk.
+static const int32_t MAX_THREADS=8;
+
+PrefetchURLProtocolHandler :: PrefetchURLProtocolHandler(
+    PrefetchURLProtocolManager* mgr, int32_t blockSize, int32_t blocksAhead,
+    bool directIO) : URLProtocolHandler(mgr)
+{
+  mBlockSize = blockSize;
+  mNumBlocks = blocksAhead;
+  mWantDirect = directIO;
+  mDirect = false;
+  mFd = -1;
+  mPosition = 0;
+  mBlocks = 0;
+  mStop = false;
+  mThreads = 0;
+  mNumThreads = 0;
+  pthread_mutex_init(&mLock, 0);
+  pthread_cond_init(&mQueued, 0);
+  pthread_cond_init(&mDone, 0);
+}
+
+PrefetchURLProtocolHandler :: ~PrefetchURLProtocolHandler()
+{
+  reset();
+  pthread_cond_destroy(&mDone);
+  pthread_cond_destroy(&mQueued);
+  pthread_mutex_destroy(&mLock);
+}
+
+void
+PrefetchURLProtocolHandler :: reset()
+{
+  (void) url_close();
+}
+
+#ifndef _WIN32
+void*
+PrefetchURLProtocolHandler :: run(void* arg)
+{
+  ((PrefetchURLProtocolHandler*)arg)->readBlocks();
+  return 0;
+}
+
+void
+PrefetchURLProtocolHandler :: readBlocks()
+{
+  pthread_mutex_lock(&mLock);
+  while(!mStop)
+  {
+    // take the queued block nearest the front of the file, which is the
+    // one the reader will want first.
+    Block* block = 0;
+    for(int32_t i = 0; i < mNumBlocks; i++)
+      if (mBlocks[i].state == BLOCK_QUEUED &&
+          (!block || mBlocks[i].offset < block->offset))
+        block = &mBlocks[i];
+    if (!block)
+    {
+      pthread_cond_wait(&mQueued, &mLock);
+      continue;
+    }
+    block->state = BLOCK_READING;
+    int64_t offset = block->offset;
+    pthread_mutex_unlock(&mLock);
+
+    // nobody else touches a block while it is being read, so read
+    // without the lock.  Fill the whole block unless we hit the end.
+    int32_t length = 0;
+    bool failed = false;
+    while(length < mBlockSize)
+    {
+      ssize_t bytesRead = pread(mFd, block->data + length,
+          (size_t)(mBlockSize - length), (off_t)(offset + length));
+      if (bytesRead < 0 && errno == EINTR)
+        continue;
+      if (bytesRead < 0)
+        failed = true;
+      if (bytesRead <= 0)
+        break;
+      length += (int32_t)bytesRead;
+      if (mDirect && length % DIRECT_IO_ALIGNMENT)
+        // a short direct read can only mean the end of the file
+        break;
+    }
+
+    pthread_mutex_lock(&mLock);
+    block->length = length;
+    block->state = failed ? BLOCK_FAILED : BLOCK_READY;
+    pthread_cond_broadcast(&mDone);
+  }
+  pthread_mutex_unlock(&mLock);
+}
+
+void
+PrefetchURLProtocolHandler :: queueFrom(int64_t offset)
+{
+  // Block n of the file always lives in slot n % mNumBlocks, so as the
+  // reader finishes a block it can queue the one mNumBlocks further on in
+  // the same slot.  Must hold mLock.
+  int64_t first = offset / mBlockSize;
+  for(int32_t i = 0; i < mNumBlocks; i++)
+  {
+    int64_t blockNo = first + i;
+    Block* block = &mBlocks[blockNo % mNumBlocks];
+    // Queued reads are just dropped, but a read already in progress owns
+    // its buffer until it finishes.
+    while(block->state == BLOCK_READING)
+      pthread_cond_wait(&mDone, &mLock);
+    block->offset = blockNo * mBlockSize;
+    block->length = 0;
+    block->state = BLOCK_QUEUED;
+  }
+  pthread_cond_broadcast(&mQueued);
+}
+
+int
+PrefetchURLProtocolHandler :: url_open(const char *url, int flags)
+{
+  if (!url || !*url)
+    return -1;
+  reset();
+  if (flags != URLProtocolHandler::URL_RDONLY_MODE)
+  {
+    VS_LOG_DEBUG("can only open files for reading: %s", url);
+    return -1;
+  }
+
+  // The URL MAY contain a protocol string.  Find it now.
+  char proto[256];
+  const char* protocol = URLProtocolManager::parseProtocol(proto, sizeof(proto), url);
+  if (protocol)
+  {
+    size_t protoLen = strlen(protocol);
+    // skip past it
+    url = url + protoLen;
+    if (*url == ':' || *url == ',')
+      ++url;
+  }
+
+#ifdef O_DIRECT
+  if (mWantDirect)
+  {
+    mFd = open(url, O_RDONLY | O_DIRECT);
+    if (mFd >= 0)
+      mDirect = true;
+    else if (errno == EINVAL)
+      VS_LOG_DEBUG("file system does not support direct IO; using the page cache: %s", url);
+  }
+#endif
+  if (mFd < 0)
+    mFd = open(url, O_RDONLY);
+  if (mFd < 0)
+    return -1;
+#ifdef POSIX_FADV_SEQUENTIAL
+  if (!mDirect)
+    // we do our own read-ahead, but a bigger kernel window does no harm
+    (void) posix_fadvise(mFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  // value-initialized, so url_close frees only the buffers we got if an
+  // allocation below fails.
+  mBlocks = new Block[mNumBlocks]();
+  for(int32_t i = 0; i < mNumBlocks; i++)
+  {
+    Block* block = &mBlocks[i];
+    block->offset = -1;
+    block->length = 0;
+    block->state = BLOCK_EMPTY;
+    void* data = 0;
+    if (posix_memalign(&data, DIRECT_IO_ALIGNMENT, (size_t)mBlockSize))
+      data = 0;
+    block->data = (unsigned char*)data;
+    if (!block->data)
+    {
+      VS_LOG_ERROR("could not allocate read buffers: %s", url);
+      url_close();
+      return -1;
+    }
+  }
+
+  mStop = false;
+  mNumThreads = mNumBlocks < MAX_THREADS ? mNumBlocks : MAX_THREADS;
+  mThreads = new pthread_t[mNumThreads];
+  for(int32_t i = 0; i < mNumThreads; i++)
+    if (pthread_create(&mThreads[i], 0, run, this))
+    {
+      VS_LOG_ERROR("could not start read threads: %s", url);
+      mNumThreads = i;
+      url_close();
+      return -1;
+    }
+
+  // start reading before FFmpeg asks
+  pthread_mutex_lock(&mLock);
+  queueFrom(0);
+  pthread_mutex_unlock(&mLock);
+  return 0;
+}
+
+int
+PrefetchURLProtocolHandler :: url_close()
+{
+  if (mFd < 0)
+    return -1;
+
+  pthread_mutex_lock(&mLock);
+  mStop = true;
+  pthread_cond_broadcast(&mQueued);
+  pthread_mutex_unlock(&mLock);
+  for(int32_t i = 0; i < mNumThreads; i++)
+    pthread_join(mThreads[i], 0);
+  delete [] mThreads;
+  mThreads = 0;
+  mNumThreads = 0;
+
+  if (mBlocks)
+    for(int32_t i = 0; i < mNumBlocks; i++)
+      free(mBlocks[i].data);
+  delete [] mBlocks;
+  mBlocks = 0;
+
+  int retval = close(mFd);
+  mFd = -1;
+  mDirect = false;
+  mPosition = 0;
+  return retval;
+}
+
+int
+PrefetchURLProtocolHandler :: url_read(unsigned char* buf, int size)
+{
+  if (mFd < 0 || size < 0)
+    return -1;
+  if (!size)
+    return 0;
+
+  pthread_mutex_lock(&mLock);
+  int64_t offset = mPosition - mPosition % mBlockSize;
+  Block* block = &mBlocks[(mPosition / mBlockSize) % mNumBlocks];
+  if (block->offset != offset || block->state == BLOCK_EMPTY)
+    // we seeked away from the blocks we had queued
+    queueFrom(mPosition);
+  while(block->state == BLOCK_QUEUED || block->state == BLOCK_READING)
+    pthread_cond_wait(&mDone, &mLock);
+  BlockState state = block->state;
+  pthread_mutex_unlock(&mLock);
+
+  if (state == BLOCK_FAILED)
+  {
+    // try again on the next read
+    pthread_mutex_lock(&mLock);
+    block->state = BLOCK_EMPTY;
+    pthread_mutex_unlock(&mLock);
+    return -1;
+  }
+
+  // Only this thread moves a ready block on, so copy without the lock.
+  int64_t available = block->offset + block->length - mPosition;
+  if (available <= 0)
+  {
+    // the end of the file, for now; read it again next time in case the
+    // file has grown.
+    pthread_mutex_lock(&mLock);
+    block->state = BLOCK_EMPTY;
+    pthread_mutex_unlock(&mLock);
+    return 0;
+  }
+  if (size > available)
+    size = (int)available;
+  memcpy(buf, block->data + (mPosition - block->offset), size);
+  mPosition += size;
+
+  if (mPosition == block->offset + mBlockSize)
+  {
+    // done with this block; queue the one mNumBlocks further on in its place.
+    pthread_mutex_lock(&mLock);
+    block->offset += (int64_t)mNumBlocks * mBlockSize;
+    block->length = 0;
+    block->state = BLOCK_QUEUED;
+    pthread_cond_signal(&mQueued);
+    pthread_mutex_unlock(&mLock);
+  }
+  return size;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: url_seek(int64_t position,
+    int whence)
+{
+  if (mFd < 0)
+    return -1;
+
+  int64_t newPosition;
+  switch(whence) {
+    case SK_SEEK_SET:
+      newPosition = position;
+      break;
+    case SK_SEEK_CUR:
+      newPosition = mPosition + position;
+      break;
+    case SK_SEEK_END:
+      newPosition = url_getsize() + position;
+      break;
+    case SK_SEEK_SIZE:
+      return url_getsize();
+    default:
+      return -1;
+  }
+  if (newPosition < 0)
+    return -1;
+
+  int64_t first = mPosition / mBlockSize;
+  int64_t blockNo = newPosition / mBlockSize;
+  if (blockNo < first || blockNo >= first + mNumBlocks)
+  {
+    // Outside the blocks in flight, so cancel them now rather than on the
+    // next read; the disk can start on the new position right away.
+    pthread_mutex_lock(&mLock);
+    queueFrom(newPosition);
+    pthread_mutex_unlock(&mLock);
+  }
+  mPosition = newPosition;
+  return newPosition;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: url_getsize()
+{
+  if (mFd < 0)
+    return -1;
+  // the file may still be growing, so ask every time.
+  struct stat info;
+  if (fstat(mFd, &info) < 0)
+    return -1;
+  return info.st_size;
+}
+#else
+void*
+PrefetchURLProtocolHandler :: run(void*)
+{
+  return 0;
+}
+
+void
+PrefetchURLProtocolHandler :: readBlocks()
+{
+}
+
+void
+PrefetchURLProtocolHandler :: queueFrom(int64_t)
+{
+}
+
+int
+PrefetchURLProtocolHandler :: url_open(const char *url, int)
+{
+  VS_LOG_DEBUG("positional reads are not supported on this platform: %s", url);
+  return -1;
+}
+
+int
+PrefetchURLProtocolHandler :: url_close()
+{
+  return -1;
+}
+
+int
+PrefetchURLProtocolHandler :: url_read(unsigned char*, int)
+{
+  return -1;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: url_seek(int64_t, int)
+{
+  return -1;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: url_getsize()
+{
+  return -1;
+}
+#endif // ! _WIN32
+
+int
+PrefetchURLProtocolHandler :: url_write(const unsigned char*, int)
+{
+  // read only
+  return -1;
+}
+
+URLProtocolHandler::SeekableFlags
+PrefetchURLProtocolHandler :: url_seekflags( const char*, int)
+{
+  return URLProtocolHandler::SK_SEEKABLE_NORMAL;
+}
+
+}}}}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PREFETCHURLPROTOCOLHANDLER_H_
+#define PREFETCHURLPROTOCOLHANDLER_H_
+
+#include <pthread.h>
+#include <io/humble/video/customio/URLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+  {
+  class PrefetchURLProtocolManager;
+
+  /**
+   * A read-only local file handler that keeps the disk busy while FFmpeg
+   * parses.
+   * <p>
+   * The file is read in fixed size blocks with pread() by a small pool of
+   * threads owned by the handler, which keep the next few blocks after the
+   * current position in flight.  #url_read(unsigned char*, int) copies out
+   * of a block once it arrives.  A seek outside the blocks already queued
+   * drops the queued reads (waiting only for reads the disk has already
+   * started) and starts again from the new position.
+   * </p><p>
+   * With direct IO the blocks bypass the page cache (O_DIRECT), which suits
+   * one pass over files much larger than memory.  If the file system
+   * refuses O_DIRECT the file is read through the cache instead.
+   * </p>
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO PrefetchURLProtocolHandler : public URLProtocolHandler
+  {
+  public:
+    PrefetchURLProtocolHandler(PrefetchURLProtocolManager* mgr,
+        int32_t blockSize, int32_t blocksAhead, bool directIO);
+    virtual ~PrefetchURLProtocolHandler();
+
+    // Now, let's have our forwarding functions
+    virtual int url_open(const char *url, int flags);
+    virtual int url_close();
+    virtual int url_read(unsigned char* buf, int size);
+    virtual int url_write(const unsigned char* buf, int size);
+    virtual int64_t url_seek(int64_t position, int whence);
+    virtual SeekableFlags url_seekflags(const char* url, int flags);
+    virtual int64_t url_getsize();
+
+    /** Is the open file being read with O_DIRECT? */
+    bool isDirectIO() { return mDirect; }
+
+  private:
+    typedef enum BlockState {
+      BLOCK_EMPTY,
+      BLOCK_QUEUED,
+      BLOCK_READING,
+      BLOCK_READY,
+      BLOCK_FAILED
+    } BlockState;
+
+    typedef struct Block {
+      int64_t offset;
+      int32_t length;
+      BlockState state;
+      unsigned char* data;
+    } Block;
+
+    static void* run(void* arg);
+    void readBlocks();
+    void queueFrom(int64_t offset);
+    void reset();
+
+    int32_t mBlockSize;
+    int32_t mNumBlocks;
+    bool mWantDirect;
+    bool mDirect;
+    int mFd;
+    int64_t mPosition;
+
+    // Guarded by mLock.
+    Block* mBlocks;
+    bool mStop;
+    pthread_t* mThreads;
+    int32_t mNumThreads;
+    pthread_mutex_t mLock;
+    /** Signalled when a block is queued. */
+    pthread_cond_t mQueued;
+    /** Signalled when a block finishes reading. */
+    pthread_cond_t mDone;
+  };
+  }}}}
+#endif /*PREFETCHURLPROTOCOLHANDLER_H_*/
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <io/humble/video/customio/PrefetchURLProtocolManager.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+PrefetchURLProtocolManager*
+PrefetchURLProtocolManager :: registerProtocol(const char *aProtocolName,
+    int32_t blockSize, int32_t blocksAhead, bool directIO)
+{
+  PrefetchURLProtocolManager* mgr = new PrefetchURLProtocolManager(aProtocolName,
+      blockSize, blocksAhead, directIO);
+  return dynamic_cast<PrefetchURLProtocolManager*>(URLProtocolManager::registerProtocol(mgr));
+}
+
+PrefetchURLProtocolManager :: PrefetchURLProtocolManager(
+    const char * aProtocolName, int32_t blockSize, int32_t blocksAhead,
+    bool directIO) : URLProtocolManager(aProtocolName)
+{
+  if (blockSize <= 0)
+    blockSize = DEFAULT_BLOCK_SIZE;
+  // direct IO wants block aligned offsets and lengths
+  mBlockSize = (blockSize + 4095) & ~4095;
+  mBlocksAhead = blocksAhead > 0 ? blocksAhead : DEFAULT_BLOCKS_AHEAD;
+  mDirectIO = directIO;
+}
+
+PrefetchURLProtocolManager :: ~PrefetchURLProtocolManager()
+{
+}
+
+PrefetchURLProtocolHandler *
+PrefetchURLProtocolManager :: getHandler(const char *, int)
+{
+  return new PrefetchURLProtocolHandler(this, mBlockSize, mBlocksAhead,
+      mDirectIO);
+}
+}}}}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PREFETCHURLPROTOCOLMANAGER_H_
+#define PREFETCHURLPROTOCOLMANAGER_H_
+
+#include <io/humble/video/customio/URLProtocolManager.h>
+#include <io/humble/video/customio/PrefetchURLProtocolHandler.h>
+
+namespace io { namespace humble { namespace video { namespace customio
+{
+  /**
+   * Hands out PrefetchURLProtocolHandler objects for local files, all with
+   * the same block size, read-ahead depth and direct IO setting.
+   */
+  class VS_API_HUMBLE_VIDEO_CUSTOMIO PrefetchURLProtocolManager : public URLProtocolManager
+  {
+  public:
+    /** The block size used if none is given. */
+    static const int32_t DEFAULT_BLOCK_SIZE=1024*1024;
+    /** The number of blocks kept in flight if none is given. */
+    static const int32_t DEFAULT_BLOCKS_AHEAD=4;
+
+    /**
+     * Returns a URLProtocol handler for the given url and flags
+     *
+     * @return a {@link URLProtocolHandler} or NULL if none can be created.
+     */
+    PrefetchURLProtocolHandler* getHandler(const char* url, int flags);
+
+    /**
+     * Convenience method that creates a PrefetchURLProtocolManager and
+     * registers with the URLProtocolManager global methods.
+     *
+     * @param aProtocolName The protocol, for example "prefetch".
+     * @param blockSize The size of each read; rounded up to a multiple of
+     *   4096 so direct IO works.  <= 0 means #DEFAULT_BLOCK_SIZE.
+     * @param blocksAhead How many blocks to keep in flight ahead of the
+     *   current position.  <= 0 means #DEFAULT_BLOCKS_AHEAD.
+     * @param directIO Read with O_DIRECT, bypassing the page cache.
+     */
+    static PrefetchURLProtocolManager* registerProtocol(const char *aProtocolName,
+        int32_t blockSize, int32_t blocksAhead, bool directIO);
+
+  protected:
+    PrefetchURLProtocolManager(const char *aProtocolName,
+        int32_t blockSize, int32_t blocksAhead, bool directIO);
+    virtual ~PrefetchURLProtocolManager();
+
+  private:
+    int32_t mBlockSize;
+    int32_t mBlocksAhead;
+    bool mDirectIO;
+  };
+}}}}
+#endif /*PREFETCHURLPROTOCOLMANAGER_H_*/
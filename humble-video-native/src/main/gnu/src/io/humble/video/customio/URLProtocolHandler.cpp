@@ -34,6 +34,13 @@ URLProtocolHandler :: ~URLProtocolHandler()
 
 }
 
+void
+URLProtocolHandler :: setCancellationToken(
+    io::humble::ferry::CancellationToken* token)
+{
+  mCancellationToken.reset(token, true);
+}
+
 const char*
 URLProtocolHandler :: getProtocolName()
 {
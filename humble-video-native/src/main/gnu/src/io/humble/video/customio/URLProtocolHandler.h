@@ -22,6 +22,8 @@
 
 #include <stdint.h>
 
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/ferry/CancellationToken.h>
 #include <io/humble/video/customio/CustomIO.h>
 
 namespace io { namespace humble { namespace video { namespace customio
@@ -50,6 +52,20 @@ namespace io { namespace humble { namespace video { namespace customio
     virtual const char* getProtocolName();
     virtual URLProtocolManager *getProtocolManager() { return mManager; }
 
+    /**
+     * Attach a token that cancels this handler's blocking calls.  With no
+     * token the handler checks the token bound to the calling thread, if
+     * any, and otherwise whether the Java thread was interrupted.
+     */
+    void setCancellationToken(io::humble::ferry::CancellationToken* token);
+    /**
+     * @return The attached token, or null.  The caller does not get a
+     *   reference.
+     */
+    io::humble::ferry::CancellationToken* getCancellationToken() {
+      return mCancellationToken.value();
+    }
+
     // Now, let's have our forwarding functions
     virtual int url_open(const char *url, int flags)=0;
     virtual int url_close()=0;
@@ -64,6 +80,7 @@ namespace io { namespace humble { namespace video { namespace customio
 
   private:
     URLProtocolManager* mManager;
+    io::humble::ferry::RefPointer<io::humble::ferry::CancellationToken> mCancellationToken;
   };
 }}}}
 #endif /*URLPROTOCOLHANDLER_H_*/
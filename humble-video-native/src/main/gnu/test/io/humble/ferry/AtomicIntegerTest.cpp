@@ -0,0 +1,223 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <cstring>
+#include <io/humble/ferry/AtomicInteger.h>
+#include "AtomicIntegerTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+static const int32_t cNumThreads = 8;
+static const int32_t cIterations = 100000;
+
+typedef struct StressArgs {
+  AtomicInteger* value;
+  int32_t* tickets;
+  int32_t thread;
+} StressArgs;
+
+// each thread takes cIterations tickets, and remembers which ones it got.
+static void*
+ticketThread(void* arg)
+{
+  StressArgs* args = (StressArgs*)arg;
+  int32_t* tickets = args->tickets + args->thread*cIterations;
+  for(int32_t i = 0; i < cIterations; i++)
+    tickets[i] = args->value->getAndIncrement();
+  return 0;
+}
+
+// same as above, but hand-rolling the increment out of compareAndSet.
+static void*
+casTicketThread(void* arg)
+{
+  StressArgs* args = (StressArgs*)arg;
+  int32_t* tickets = args->tickets + args->thread*cIterations;
+  for(int32_t i = 0; i < cIterations; i++) {
+    int32_t current;
+    do {
+      current = args->value->get(AtomicInteger::MEMORY_ORDER_RELAXED);
+    } while(!args->value->compareAndSet(current, current+1));
+    tickets[i] = current;
+  }
+  return 0;
+}
+
+// half the threads add, the other half take away.
+static void*
+mixedThread(void* arg)
+{
+  StressArgs* args = (StressArgs*)arg;
+  for(int32_t i = 0; i < cIterations; i++) {
+    if (args->thread % 2) {
+      args->value->incrementAndGet();
+      args->value->getAndAdd(2, AtomicInteger::MEMORY_ORDER_RELAXED);
+    } else {
+      args->value->decrementAndGet(AtomicInteger::MEMORY_ORDER_ACQ_REL);
+      args->value->addAndGet(-2);
+    }
+  }
+  return 0;
+}
+
+/**
+ * Runs cNumThreads copies of the given function against one shared
+ * value.  If tickets is non null, afterwards checks that every value
+ * in [0, cNumThreads*cIterations) was handed out exactly once; that's
+ * only possible if every read-modify-write took effect at a single
+ * instant between its start and end.
+ */
+static void
+runThreads(void* (*func)(void*), AtomicInteger* value, int32_t* tickets)
+{
+  pthread_t threads[cNumThreads];
+  StressArgs args[cNumThreads];
+  for(int32_t i = 0; i < cNumThreads; i++) {
+    args[i].value = value;
+    args[i].tickets = tickets;
+    args[i].thread = i;
+    TSM_ASSERT_EQUALS("could not start thread", pthread_create(&threads[i], 0,
+        func, &args[i]), 0);
+  }
+  for(int32_t i = 0; i < cNumThreads; i++)
+    pthread_join(threads[i], 0);
+
+  if (tickets) {
+    const int32_t numTickets = cNumThreads*cIterations;
+    char* seen = new char[numTickets];
+    memset(seen, 0, numTickets);
+    int32_t duplicates = 0;
+    int32_t outOfRange = 0;
+    for(int32_t i = 0; i < numTickets; i++) {
+      int32_t ticket = tickets[i];
+      if (ticket < 0 || ticket >= numTickets)
+        ++outOfRange;
+      else if (seen[ticket]++)
+        ++duplicates;
+    }
+    delete [] seen;
+    TSM_ASSERT_EQUALS("ticket handed out twice", duplicates, 0);
+    TSM_ASSERT_EQUALS("ticket never handed out", outOfRange, 0);
+    TSM_ASSERT_EQUALS("wrong final value", value->get(), numTickets);
+    // and within a thread, tickets must be strictly increasing
+    for(int32_t t = 0; t < cNumThreads; t++)
+      for(int32_t i = 1; i < cIterations; i++)
+        TSM_ASSERT("tickets went backwards in a thread",
+            tickets[t*cIterations+i-1] < tickets[t*cIterations+i]);
+  }
+}
+
+void
+AtomicIntegerTestSuite :: testCreation()
+{
+  AtomicInteger zero;
+  TSM_ASSERT_EQUALS("not initialized correctly", zero.get(), 0);
+  AtomicInteger five(5);
+  TSM_ASSERT_EQUALS("not initialized correctly", five.get(), 5);
+  TSM_ASSERT("should always be atomic", five.isAtomic());
+  five.set(15);
+  TSM_ASSERT_EQUALS("set did not stick", five.get(), 15);
+}
+
+void
+AtomicIntegerTestSuite :: testGetAndDoSomethingMethods()
+{
+  AtomicInteger ai;
+  TSM_ASSERT_EQUALS("", ai.getAndAdd(5), 0);
+  TSM_ASSERT_EQUALS("", ai.get(), 5);
+  TSM_ASSERT_EQUALS("", ai.getAndIncrement(), 5);
+  TSM_ASSERT_EQUALS("", ai.get(), 6);
+  TSM_ASSERT_EQUALS("", ai.getAndDecrement(), 6);
+  TSM_ASSERT_EQUALS("", ai.get(), 5);
+  TSM_ASSERT_EQUALS("", ai.getAndSet(11), 5);
+  TSM_ASSERT_EQUALS("", ai.get(), 11);
+}
+
+void
+AtomicIntegerTestSuite :: testDoSomethingAndGetMethods()
+{
+  AtomicInteger ai;
+  TSM_ASSERT_EQUALS("", ai.addAndGet(5), 5);
+  TSM_ASSERT_EQUALS("", ai.incrementAndGet(), 6);
+  TSM_ASSERT_EQUALS("", ai.decrementAndGet(), 5);
+  TSM_ASSERT_EQUALS("", ai.addAndGet(-7), -2);
+}
+
+void
+AtomicIntegerTestSuite :: testCompareAndSet()
+{
+  AtomicInteger ai(3);
+  TSM_ASSERT("should not set on mismatch", !ai.compareAndSet(4, 10));
+  TSM_ASSERT_EQUALS("value changed on failed set", ai.get(), 3);
+  TSM_ASSERT("should set on match", ai.compareAndSet(3, 10));
+  TSM_ASSERT_EQUALS("value not changed on set", ai.get(), 10);
+}
+
+void
+AtomicIntegerTestSuite :: testMemoryOrders()
+{
+  // every order must be accepted by every operation, even the
+  // ones that make no sense for it.
+  const AtomicInteger::MemoryOrder orders[] = {
+      AtomicInteger::MEMORY_ORDER_RELAXED,
+      AtomicInteger::MEMORY_ORDER_ACQUIRE,
+      AtomicInteger::MEMORY_ORDER_RELEASE,
+      AtomicInteger::MEMORY_ORDER_ACQ_REL,
+      AtomicInteger::MEMORY_ORDER_SEQ_CST,
+  };
+  for(uint32_t i = 0; i < sizeof(orders)/sizeof(*orders); i++) {
+    AtomicInteger::MemoryOrder order = orders[i];
+    AtomicInteger ai;
+    ai.set(1, order);
+    TSM_ASSERT_EQUALS("", ai.get(order), 1);
+    TSM_ASSERT_EQUALS("", ai.incrementAndGet(order), 2);
+    TSM_ASSERT_EQUALS("", ai.getAndDecrement(order), 2);
+    TSM_ASSERT_EQUALS("", ai.getAndSet(7, order), 1);
+    TSM_ASSERT("", ai.compareAndSet(7, 8, order));
+    TSM_ASSERT("", !ai.compareAndSet(7, 9, order));
+    TSM_ASSERT_EQUALS("", ai.get(order), 8);
+  }
+}
+
+void
+AtomicIntegerTestSuite :: testGetAndIncrementIsLinearizable()
+{
+  AtomicInteger value;
+  int32_t* tickets = new int32_t[cNumThreads*cIterations];
+  runThreads(ticketThread, &value, tickets);
+  delete [] tickets;
+}
+
+void
+AtomicIntegerTestSuite :: testCompareAndSetIsLinearizable()
+{
+  AtomicInteger value;
+  int32_t* tickets = new int32_t[cNumThreads*cIterations];
+  runThreads(casTicketThread, &value, tickets);
+  delete [] tickets;
+}
+
+void
+AtomicIntegerTestSuite :: testMixedOperationsUnderContention()
+{
+  AtomicInteger value;
+  runThreads(mixedThread, &value, 0);
+  TSM_ASSERT_EQUALS("adds and subtracts did not cancel out", value.get(), 0);
+}
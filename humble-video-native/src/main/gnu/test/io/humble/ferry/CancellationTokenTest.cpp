@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <unistd.h>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/ferry/CancellationToken.h>
+#include "CancellationTokenTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace {
+  void*
+  cancelLater(void* closure)
+  {
+    usleep(20000);
+    ((CancellationToken*)closure)->cancel();
+    return 0;
+  }
+}
+
+void
+CancellationTokenTestSuite :: testCancel()
+{
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  TS_ASSERT(token);
+  TS_ASSERT(!token->isCancelled());
+  TS_ASSERT(!CancellationToken::sIsCancelled(token.value()));
+  token->cancel();
+  TS_ASSERT(token->isCancelled());
+  TS_ASSERT(!token->isTimedOut());
+  TS_ASSERT(CancellationToken::sIsCancelled(token.value()));
+  TS_ASSERT_THROWS(VS_CHECK_CANCELLED(token.value(), true),
+      HumbleInterruptedException&);
+  // a false condition means no check at all
+  VS_CHECK_CANCELLED(token.value(), false);
+  token->reset();
+  TS_ASSERT(!token->isCancelled());
+}
+
+void
+CancellationTokenTestSuite :: testTimeout()
+{
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  token->setTimeout(20000);
+  TS_ASSERT(!token->isCancelled());
+  usleep(50000);
+  TS_ASSERT(token->isCancelled());
+  TS_ASSERT(token->isTimedOut());
+  // cancelled tokens stay cancelled
+  token->setTimeout(1000000);
+  TS_ASSERT(token->isCancelled());
+
+  token->reset();
+  token->setTimeout(0);
+  TS_ASSERT(token->isCancelled());
+}
+
+void
+CancellationTokenTestSuite :: testClearTimeout()
+{
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  token->setTimeout(20000);
+  token->clearTimeout();
+  usleep(50000);
+  TS_ASSERT(!token->isCancelled());
+  TS_ASSERT(!token->isTimedOut());
+  token->cancel();
+  token->clearTimeout();
+  TS_ASSERT(token->isCancelled());
+}
+
+void
+CancellationTokenTestSuite :: testCancelFromAnotherThread()
+{
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  pthread_t thread;
+  TS_ASSERT(!pthread_create(&thread, 0, cancelLater, token.value()));
+  int64_t start = VS_TestGetTimeMicros();
+  // stands in for FFmpeg spinning in its I/O loop
+  while(!token->isCancelled() && VS_TestGetTimeMicros() - start < 5000000)
+    ;
+  pthread_join(thread, 0);
+  TS_ASSERT(token->isCancelled());
+}
+
+void
+CancellationTokenTestSuite :: testScope()
+{
+  RefPointer<CancellationToken> outer = CancellationToken::make();
+  RefPointer<CancellationToken> inner = CancellationToken::make();
+  TS_ASSERT(!CancellationToken::getCurrent());
+  // outside a JVM there is no Java thread to be interrupted
+  TS_ASSERT(!CancellationToken::sIsCancelled(0));
+  {
+    CancellationToken::Scope outerScope(outer.value());
+    TS_ASSERT_EQUALS(CancellationToken::getCurrent(), outer.value());
+    {
+      CancellationToken::Scope innerScope(inner.value());
+      TS_ASSERT_EQUALS(CancellationToken::getCurrent(), inner.value());
+      inner->cancel();
+      TS_ASSERT_THROWS(VS_CHECK_CANCELLED(0, true),
+          HumbleInterruptedException&);
+      {
+        // null tokens leave the binding alone
+        CancellationToken::Scope nullScope(0);
+        TS_ASSERT_EQUALS(CancellationToken::getCurrent(), inner.value());
+      }
+    }
+    TS_ASSERT_EQUALS(CancellationToken::getCurrent(), outer.value());
+    TS_ASSERT(!CancellationToken::sIsCancelled(0));
+    // an explicit token wins over the bound one
+    TS_ASSERT(CancellationToken::sIsCancelled(inner.value()));
+  }
+  TS_ASSERT(!CancellationToken::getCurrent());
+}
+
+void
+CancellationTokenTestSuite :: testCheckCost()
+{
+  // this is what FFmpeg's interrupt callback does in its I/O loops.
+  const int32_t iterations = 10000000;
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  int32_t cancelled = 0;
+  int64_t start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < iterations; i++)
+    cancelled += CancellationToken::sIsCancelled(token.value());
+  int64_t plainTime = VS_TestGetTimeMicros() - start;
+  token->setTimeout(3600000000LL);
+  start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < iterations; i++)
+    cancelled += CancellationToken::sIsCancelled(token.value());
+  int64_t deadlineTime = VS_TestGetTimeMicros() - start;
+  TS_ASSERT_EQUALS(cancelled, 0);
+  VS_LOG_INFO("%d cancellation checks: %lld us; with a deadline %lld us",
+      iterations, (long long)plainTime, (long long)deadlineTime);
+}
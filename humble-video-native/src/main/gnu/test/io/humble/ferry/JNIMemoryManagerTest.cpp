@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <cstring>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/MemoryPool.h>
+#include <io/humble/ferry/JNIMemoryManager.h>
+#include "JNIMemoryManagerTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+// a 4K (3840x2160) YUV420P picture
+static const int32_t cFrameWidth = 3840;
+static const int32_t cFrameHeight = 2160;
+static const size_t cFrameSize = cFrameWidth*cFrameHeight*3/2;
+static const int32_t cFramesPerThread = 16;
+static const int32_t cMaxThreads = 4;
+
+void
+JNIMemoryManagerTestSuite :: tearDown()
+{
+  JNIMemoryManager::setAlignment((size_t)JNIMemoryManager::DEFAULT_ALIGNMENT);
+  MemoryPool::setHugePageMode(MemoryPool::HUGE_PAGES_NONE);
+  MemoryPool::setHugePageThreshold(
+      (size_t)MemoryPool::DEFAULT_HUGE_PAGE_THRESHOLD);
+  MemoryPool::setEnabled(false);
+}
+
+void
+JNIMemoryManagerTestSuite :: testDefaultAlignment()
+{
+  TSM_ASSERT_EQUALS("should default to a cache line",
+      JNIMemoryManager::getAlignment(), (size_t)64);
+  // try enough sizes that malloc() hands back every offset it uses
+  void* blocks[100];
+  for(int32_t i = 0; i < 100; i++) {
+    blocks[i] = JNIMemoryManager::malloc(1+i*37);
+    TSM_ASSERT("no memory", blocks[i]);
+    TSM_ASSERT_EQUALS("not aligned", (size_t)blocks[i] % 64, (size_t)0);
+    memset(blocks[i], 0xFF, 1+i*37);
+  }
+  for(int32_t i = 0; i < 100; i++)
+    JNIMemoryManager::free(blocks[i]);
+}
+
+void
+JNIMemoryManagerTestSuite :: testSetAlignment()
+{
+  TSM_ASSERT("should reject 0", !JNIMemoryManager::setAlignment(0));
+  TSM_ASSERT("should reject non powers of two",
+      !JNIMemoryManager::setAlignment(48));
+  TSM_ASSERT("should reject too large",
+      !JNIMemoryManager::setAlignment(2*JNIMemoryManager::MAX_ALIGNMENT));
+  TSM_ASSERT_EQUALS("rejected value changed the alignment",
+      JNIMemoryManager::getAlignment(), (size_t)64);
+
+  void* old = JNIMemoryManager::malloc(1000);
+  const size_t alignments[] = { 1, 16, 128, 256 };
+  for(uint32_t i = 0; i < sizeof(alignments)/sizeof(*alignments); i++) {
+    const size_t alignment = alignments[i];
+    TSM_ASSERT("should accept", JNIMemoryManager::setAlignment(alignment));
+    TSM_ASSERT_EQUALS("did not set", JNIMemoryManager::getAlignment(),
+        alignment);
+    for(int32_t j = 0; j < 20; j++) {
+      void* mem = JNIMemoryManager::malloc(1+j*101);
+      TSM_ASSERT("no memory", mem);
+      TSM_ASSERT_EQUALS("not aligned", (size_t)mem % alignment, (size_t)0);
+      memset(mem, 0, 1+j*101);
+      JNIMemoryManager::free(mem);
+    }
+  }
+  // blocks from before the change must still free correctly
+  JNIMemoryManager::free(old);
+}
+
+void
+JNIMemoryManagerTestSuite :: testHugePageBuffers()
+{
+  if (!MemoryPool::setHugePageMode(MemoryPool::HUGE_PAGES_TRANSPARENT)) {
+    VS_LOG_INFO("huge pages not supported here; skipping");
+    return;
+  }
+  TSM_ASSERT_EQUALS("did not set", MemoryPool::getHugePageMode(),
+      MemoryPool::HUGE_PAGES_TRANSPARENT);
+
+  // below the threshold, no mapping
+  void* small = JNIMemoryManager::malloc(1024*1024);
+  TSM_ASSERT_EQUALS("should not map small buffers",
+      MemoryPool::getHugePageBytes(), 0);
+  JNIMemoryManager::free(small);
+
+  void* frame = JNIMemoryManager::malloc(cFrameSize);
+  TSM_ASSERT("no memory", frame);
+  TSM_ASSERT_EQUALS("not aligned",
+      (size_t)frame % JNIMemoryManager::getAlignment(), (size_t)0);
+  TSM_ASSERT("should have mapped the frame",
+      MemoryPool::getHugePageBytes() >= (int64_t)cFrameSize);
+  TSM_ASSERT_EQUALS("should map whole huge pages",
+      MemoryPool::getHugePageBytes() % MemoryPool::HUGE_PAGE_SIZE, 0);
+  memset(frame, 0x80, cFrameSize);
+  JNIMemoryManager::free(frame);
+  TSM_ASSERT_EQUALS("should unmap with the pool off",
+      MemoryPool::getHugePageBytes(), 0);
+
+  // with the pool on, the mapping is reused.
+  MemoryPool::setEnabled(true);
+  frame = JNIMemoryManager::malloc(cFrameSize);
+  JNIMemoryManager::free(frame);
+  int64_t hits = MemoryPool::getHits();
+  void* again = JNIMemoryManager::malloc(cFrameSize);
+  TSM_ASSERT_EQUALS("should reuse the mapping", again, frame);
+  TSM_ASSERT_EQUALS("hit not counted", MemoryPool::getHits(), hits+1);
+  JNIMemoryManager::free(again);
+  MemoryPool::setEnabled(false);
+  TSM_ASSERT_EQUALS("should unmap when the pool is turned off",
+      MemoryPool::getHugePageBytes(), 0);
+
+  // hugetlb falls back to transparent huge pages when nothing is
+  // reserved, so it always works.
+  TSM_ASSERT("should accept",
+      MemoryPool::setHugePageMode(MemoryPool::HUGE_PAGES_HUGETLB));
+  frame = JNIMemoryManager::malloc(cFrameSize);
+  TSM_ASSERT("no memory", frame);
+  memset(frame, 0x80, cFrameSize);
+  JNIMemoryManager::free(frame);
+  TSM_ASSERT_EQUALS("did not unmap", MemoryPool::getHugePageBytes(), 0);
+}
+
+// Allocates, fills and then walks each frame column by column, the way
+// a vertical filter in a scaler does; every step lands in a different
+// row, which is what makes 4K pictures expensive on small pages.
+static void*
+frameThread(void*)
+{
+  uint32_t sum = 0;
+  for(int32_t i = 0; i < cFramesPerThread; i++) {
+    unsigned char* frame = (unsigned char*)JNIMemoryManager::malloc(cFrameSize);
+    if (!frame)
+      return (void*)1;
+    memset(frame, i, cFrameSize);
+    for(int32_t x = 0; x < cFrameWidth; x += 64)
+      for(int32_t y = 0; y < cFrameHeight; y++)
+        sum += frame[y*cFrameWidth+x];
+    JNIMemoryManager::free(frame);
+  }
+  // keep the compiler from optimizing the walk away
+  return sum == 0xFFFFFFFF ? (void*)1 : 0;
+}
+
+static int64_t
+runFrameThreads(int32_t numThreads)
+{
+  pthread_t threads[cMaxThreads];
+  int64_t start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < numThreads; i++)
+    TSM_ASSERT_EQUALS("could not start thread",
+        pthread_create(&threads[i], 0, frameThread, 0), 0);
+  for(int32_t i = 0; i < numThreads; i++) {
+    void* result = 0;
+    pthread_join(threads[i], &result);
+    TSM_ASSERT("out of memory", !result);
+  }
+  int64_t elapsed = VS_TestGetTimeMicros() - start;
+  return elapsed > 0 ? elapsed : 1;
+}
+
+void
+JNIMemoryManagerTestSuite :: testFrameThroughput()
+{
+  const char* names[] = { "malloc", "pooled", "pooled+hugepages" };
+  for(int32_t config = 0; config < 3; config++) {
+    MemoryPool::setEnabled(config > 0);
+    if (config == 2 &&
+        !MemoryPool::setHugePageMode(MemoryPool::HUGE_PAGES_TRANSPARENT))
+      break;
+    for(int32_t threads = 1; threads <= cMaxThreads; threads *= 2) {
+      int64_t elapsed = runFrameThreads(threads);
+      int64_t frames = (int64_t)threads*cFramesPerThread;
+      VS_LOG_INFO("4K frames, %s, %d threads: %lld frames/s (%lld MB/s)",
+          names[config], threads,
+          (long long)(frames*1000000/elapsed),
+          (long long)(frames*(int64_t)cFrameSize/elapsed));
+    }
+  }
+}
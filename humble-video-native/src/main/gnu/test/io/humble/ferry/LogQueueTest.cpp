@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/LogQueue.h>
+#include "LogQueueTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+static const int32_t cNumThreads = 4;
+static const int32_t cMessagesPerThread = 2000;
+
+static int32_t
+countLines(const std::string& str, const char* match)
+{
+  int32_t retval = 0;
+  std::istringstream in(str);
+  std::string line;
+  while(std::getline(in, line))
+    if (line.find(match) != std::string::npos)
+      ++retval;
+  return retval;
+}
+
+// A stream buffer that is slow to write to, and lets one writer in at a
+// time, like a busy Java appender.
+class SlowBuf : public std::stringbuf
+{
+  public:
+  SlowBuf() {
+    // recursive, because stringbuf::xsputn can call overflow
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mLock, &attr);
+    pthread_mutexattr_destroy(&attr);
+  }
+  virtual ~SlowBuf() { pthread_mutex_destroy(&mLock); }
+  protected:
+  virtual std::streamsize xsputn(const char* s, std::streamsize n)
+  {
+    pthread_mutex_lock(&mLock);
+    if (n > 0 && s[n-1] == '\n')
+      usleep(100);
+    std::streamsize retval = std::stringbuf::xsputn(s, n);
+    pthread_mutex_unlock(&mLock);
+    return retval;
+  }
+  virtual int overflow(int c)
+  {
+    pthread_mutex_lock(&mLock);
+    int retval = std::stringbuf::overflow(c);
+    pthread_mutex_unlock(&mLock);
+    return retval;
+  }
+  private:
+  pthread_mutex_t mLock;
+};
+
+void
+LogQueueTestSuite :: tearDown()
+{
+  Logger::setAsynchronous(false);
+}
+
+void
+LogQueueTestSuite :: testFullQueueDrops()
+{
+  LogQueue* queue = LogQueue::getQueue();
+  TSM_ASSERT("no queue", queue);
+  TSM_ASSERT("should not be running", !queue->isRunning());
+  queue->flush();
+
+  // with nothing draining, the ring fills and then drops.
+  int64_t dropped = queue->getDropped();
+  for(int32_t i = 0; i < LogQueue::CAPACITY; i++) {
+    LogQueue::Record* record = queue->reserve();
+    TSM_ASSERT("should have room", record);
+    if (!record)
+      break;
+    record->mLogger = 0;
+    record->mLevel = Logger::LEVEL_ERROR;
+    *record->mMessage = 0;
+    queue->commit(record);
+  }
+  TSM_ASSERT("should be full", !queue->reserve());
+  TSM_ASSERT_EQUALS("drop not counted", queue->getDropped(), dropped+1);
+
+  // and draining makes room again.
+  queue->flush();
+  LogQueue::Record* record = queue->reserve();
+  TSM_ASSERT("should have room after flush", record);
+  record->mLogger = 0;
+  queue->commit(record);
+  queue->flush();
+}
+
+static void*
+logThread(void* arg)
+{
+  Logger* logger = (Logger*)arg;
+  for(int32_t i = 0; i < cMessagesPerThread; i++)
+    (void) logger->info(__FILE__, __LINE__, "async message %d", i);
+  return 0;
+}
+
+static void
+runLogThreads(Logger* logger)
+{
+  pthread_t threads[cNumThreads];
+  for(int32_t i = 0; i < cNumThreads; i++)
+    TSM_ASSERT_EQUALS("could not start thread",
+        pthread_create(&threads[i], 0, logThread, logger), 0);
+  for(int32_t i = 0; i < cNumThreads; i++)
+    pthread_join(threads[i], 0);
+}
+
+void
+LogQueueTestSuite :: testAsynchronousLogging()
+{
+  Logger* logger = Logger::getLogger("io.humble.ferry.LogQueueTest");
+  TSM_ASSERT("no logger", logger);
+  std::ostringstream captured;
+  std::streambuf* old = std::cerr.rdbuf(captured.rdbuf());
+
+  TSM_ASSERT("could not start", Logger::setAsynchronous(true));
+  TSM_ASSERT("should be asynchronous", Logger::isAsynchronous());
+  int64_t dropped = Logger::getDroppedMessages();
+  runLogThreads(logger);
+  Logger::flush();
+  TSM_ASSERT("could not stop", Logger::setAsynchronous(false));
+  TSM_ASSERT("should be synchronous", !Logger::isAsynchronous());
+  delete logger;
+  std::cerr.rdbuf(old);
+
+  // every message is either logged or counted as dropped.
+  int32_t logged = countLines(captured.str(), "async message");
+  TSM_ASSERT_EQUALS("messages lost",
+      logged + Logger::getDroppedMessages() - dropped,
+      (int64_t)cNumThreads*cMessagesPerThread);
+  TSM_ASSERT("nothing logged", logged > 0);
+}
+
+void
+LogQueueTestSuite :: testLoggingThreadsDoNotWaitForOutput()
+{
+  Logger* logger = Logger::getLogger("io.humble.ferry.LogQueueTest");
+  SlowBuf slow;
+  std::streambuf* old = std::cerr.rdbuf(&slow);
+
+  int64_t start = VS_TestGetTimeMicros();
+  runLogThreads(logger);
+  int64_t syncTime = VS_TestGetTimeMicros() - start;
+
+  Logger::setAsynchronous(true);
+  int64_t dropped = Logger::getDroppedMessages();
+  start = VS_TestGetTimeMicros();
+  runLogThreads(logger);
+  int64_t asyncTime = VS_TestGetTimeMicros() - start;
+  Logger::setAsynchronous(false);
+  dropped = Logger::getDroppedMessages() - dropped;
+
+  delete logger;
+  std::cerr.rdbuf(old);
+  TSM_ASSERT("logging threads waited on output", asyncTime < syncTime);
+  VS_LOG_INFO("%d messages to a slow sink: synchronous %lld us; "
+      "asynchronous %lld us (%lld dropped)",
+      cNumThreads*cMessagesPerThread, (long long)syncTime,
+      (long long)asyncTime, (long long)dropped);
+}
@@ -17,6 +17,10 @@
  * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
  *******************************************************************************/
 
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <string>
 #include <io/humble/ferry/Logger.h>
 #include <io/humble/ferry/LoggerStack.h>
 #include "LoggerTest.h"
@@ -41,3 +45,59 @@ LoggerTestSuite :: testOutputToStandardError()
   TSM_ASSERT("this test really just shouldn't crash.  check log files to ensure it outputted", true);
 }
 
+
+static int32_t
+countLines(const std::string& str, const char* match)
+{
+  int32_t retval = 0;
+  std::istringstream in(str);
+  std::string line;
+  while(std::getline(in, line))
+    if (line.find(match) != std::string::npos)
+      ++retval;
+  return retval;
+}
+
+void
+LoggerTestSuite :: testRateLimit()
+{
+  Logger* logger = Logger::getLogger("io.humble.ferry.RateLimitTest");
+  TSM_ASSERT("no logger", logger);
+  std::ostringstream captured;
+  std::streambuf* old = std::cerr.rdbuf(captured.rdbuf());
+
+  Logger::setRateLimit(5);
+  TSM_ASSERT_EQUALS("did not set", Logger::getRateLimit(), 5);
+  int64_t limited = Logger::getRateLimitedMessages();
+  int32_t logged = 0;
+  for(int32_t i = 0; i < 20; i++)
+    if (logger->error(__FILE__, __LINE__, "rate limited message %d", i))
+      ++logged;
+  // a different site has its own budget.
+  TSM_ASSERT("other site limited",
+      logger->error(__FILE__, __LINE__, "other site"));
+
+  // a site gets a fresh budget each second, and its first message in
+  // the new window says how many were dropped in the last one.
+  TSM_ASSERT("new site limited",
+      logger->error(__FILE__, 42, "rate limited message again"));
+  for(int32_t i = 0; i < 6; i++)
+    (void) logger->error(__FILE__, 42, "burst");
+  usleep(1100*1000);
+  TSM_ASSERT("limited in a new window",
+      logger->error(__FILE__, 42, "after burst"));
+
+  Logger::setRateLimit(0);
+  std::cerr.rdbuf(old);
+  delete logger;
+
+  TSM_ASSERT_EQUALS("wrong number through the limit", logged, 5);
+  TSM_ASSERT_EQUALS("wrong number limited",
+      Logger::getRateLimitedMessages(), limited+15+2);
+  TSM_ASSERT_EQUALS("wrong number logged",
+      countLines(captured.str(), "rate limited message"), 5+1);
+  TSM_ASSERT_EQUALS("wrong number of bursts logged",
+      countLines(captured.str(), "- burst (LoggerTest.cpp:42)"), 4);
+  TSM_ASSERT_EQUALS("dropped messages not reported",
+      countLines(captured.str(), "[2 similar messages suppressed]"), 1);
+}
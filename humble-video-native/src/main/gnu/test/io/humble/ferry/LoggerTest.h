@@ -26,6 +26,7 @@ class LoggerTestSuite : public CxxTest::TestSuite
 {
   public:
   void testOutputToStandardError();
+  void testRateLimit();
 };
 
 
@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <cstring>
+#include <io/humble/ferry/MemoryPool.h>
+#include <io/humble/ferry/JNIMemoryManager.h>
+#include "MemoryPoolTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+static const int32_t cNumThreads = 8;
+static const int32_t cIterations = 10000;
+
+void
+MemoryPoolTestSuite :: setUp()
+{
+  MemoryPool::setHighWaterMark(MemoryPool::DEFAULT_HIGH_WATER_MARK);
+  MemoryPool::setEnabled(true);
+}
+
+void
+MemoryPoolTestSuite :: tearDown()
+{
+  MemoryPool::setEnabled(false);
+  TSM_ASSERT_EQUALS("pool did not let go of everything",
+      MemoryPool::getBytesRetained(), 0);
+}
+
+void
+MemoryPoolTestSuite :: testDisabledPoolDoesNotRetain()
+{
+  MemoryPool::setEnabled(false);
+  TSM_ASSERT("should be off", !MemoryPool::isEnabled());
+  size_t capacity = 0;
+  void* block = MemoryPool::allocate(1000, &capacity);
+  TSM_ASSERT("no block", block);
+  TSM_ASSERT("capacity too small", capacity >= 1000);
+  MemoryPool::release(block, capacity);
+  TSM_ASSERT_EQUALS("should not keep blocks when off",
+      MemoryPool::getBytesRetained(), 0);
+}
+
+void
+MemoryPoolTestSuite :: testSizeClassesAreReused()
+{
+  size_t capacity = 0;
+  void* block = MemoryPool::allocate(1000, &capacity);
+  TSM_ASSERT("no block", block);
+  TSM_ASSERT_EQUALS("should round up to a power of two", capacity, 1024);
+  memset(block, 0xFF, capacity);
+  MemoryPool::release(block, capacity);
+  TSM_ASSERT_EQUALS("block not retained",
+      MemoryPool::getBytesRetained(), (int64_t)capacity);
+
+  // anything that rounds to the same class gets the same block back.
+  int64_t hits = MemoryPool::getHits();
+  size_t capacity2 = 0;
+  void* block2 = MemoryPool::allocate(600, &capacity2);
+  TSM_ASSERT_EQUALS("should have reused the block", block2, block);
+  TSM_ASSERT_EQUALS("wrong capacity", capacity2, capacity);
+  TSM_ASSERT_EQUALS("hit not counted", MemoryPool::getHits(), hits+1);
+  TSM_ASSERT_EQUALS("block still counted as retained",
+      MemoryPool::getBytesRetained(), 0);
+
+  // but a different class misses
+  int64_t misses = MemoryPool::getMisses();
+  size_t capacity3 = 0;
+  void* block3 = MemoryPool::allocate(100, &capacity3);
+  TSM_ASSERT("no block", block3);
+  TSM_ASSERT_EQUALS("smallest class is 256 bytes", capacity3, 256);
+  TSM_ASSERT_EQUALS("miss not counted", MemoryPool::getMisses(), misses+1);
+  MemoryPool::release(block3, capacity3);
+  MemoryPool::release(block2, capacity2);
+}
+
+void
+MemoryPoolTestSuite :: testHugeBlocksAreReusedOnlyForTheSameSize()
+{
+  // a 1080p YUV420P frame
+  const size_t frameSize = 1920*1080*3/2;
+  size_t capacity = 0;
+  void* block = MemoryPool::allocate(frameSize, &capacity);
+  TSM_ASSERT("no block", block);
+  TSM_ASSERT("capacity too small", capacity >= frameSize);
+  TSM_ASSERT_EQUALS("huge blocks should be page rounded", capacity % 4096, 0);
+  MemoryPool::release(block, capacity);
+
+  size_t otherCapacity = 0;
+  void* other = MemoryPool::allocate(frameSize*2, &otherCapacity);
+  TSM_ASSERT("should not hand out a block of the wrong size", other != block);
+
+  size_t sameCapacity = 0;
+  void* same = MemoryPool::allocate(frameSize, &sameCapacity);
+  TSM_ASSERT_EQUALS("should have reused the frame", same, block);
+  TSM_ASSERT_EQUALS("wrong capacity", sameCapacity, capacity);
+
+  MemoryPool::release(other, otherCapacity);
+  MemoryPool::release(same, sameCapacity);
+}
+
+void
+MemoryPoolTestSuite :: testHighWaterMark()
+{
+  const size_t frameSize = 2*MemoryPool::MAX_SIZE_CLASS_CAPACITY;
+  MemoryPool::setHighWaterMark(frameSize + frameSize/2);
+  TSM_ASSERT_EQUALS("did not set", MemoryPool::getHighWaterMark(),
+      (int64_t)(frameSize + frameSize/2));
+
+  size_t capacity1 = 0, capacity2 = 0;
+  void* block1 = MemoryPool::allocate(frameSize, &capacity1);
+  void* block2 = MemoryPool::allocate(frameSize, &capacity2);
+  MemoryPool::release(block1, capacity1);
+  MemoryPool::release(block2, capacity2);
+  TSM_ASSERT_EQUALS("should only keep what fits under the mark",
+      MemoryPool::getBytesRetained(), (int64_t)capacity1);
+
+  // lowering the mark below what's kept lets it go.
+  MemoryPool::setHighWaterMark(0);
+  TSM_ASSERT_EQUALS("should have trimmed",
+      MemoryPool::getBytesRetained(), 0);
+}
+
+void
+MemoryPoolTestSuite :: testTrim()
+{
+  size_t capacity = 0;
+  void* small = MemoryPool::allocate(4000, &capacity);
+  MemoryPool::release(small, capacity);
+  size_t hugeCapacity = 0;
+  void* huge = MemoryPool::allocate(4*1024*1024, &hugeCapacity);
+  MemoryPool::release(huge, hugeCapacity);
+  TSM_ASSERT_EQUALS("should retain both",
+      MemoryPool::getBytesRetained(), (int64_t)(capacity+hugeCapacity));
+  MemoryPool::trim();
+  TSM_ASSERT_EQUALS("should have freed everything",
+      MemoryPool::getBytesRetained(), 0);
+  TSM_ASSERT("should still be on after a trim", MemoryPool::isEnabled());
+}
+
+void
+MemoryPoolTestSuite :: testNativeBuffersUsePool()
+{
+  // outside a JVM, JNIMemoryManager uses the native model.
+  const size_t frameSize = 1920*1080*3/2;
+  void* first = JNIMemoryManager::malloc(frameSize);
+  TSM_ASSERT("no memory", first);
+  memset(first, 0, frameSize);
+  JNIMemoryManager::free(first);
+  TSM_ASSERT("freed buffer not retained", MemoryPool::getBytesRetained() > 0);
+
+  int64_t hits = MemoryPool::getHits();
+  for(int32_t i = 0; i < 10; i++) {
+    void* frame = JNIMemoryManager::malloc(frameSize);
+    TSM_ASSERT("no memory", frame);
+    memset(frame, i, frameSize);
+    JNIMemoryManager::free(frame);
+  }
+  TSM_ASSERT_EQUALS("same sized frames should all come from the pool",
+      MemoryPool::getHits(), hits+10);
+
+  // and buffers allocated before the pool was turned off are still
+  // freed correctly after.
+  void* buffer = JNIMemoryManager::malloc(100);
+  MemoryPool::setEnabled(false);
+  JNIMemoryManager::free(buffer);
+  buffer = JNIMemoryManager::malloc(100);
+  JNIMemoryManager::free(buffer);
+  TSM_ASSERT_EQUALS("should not keep blocks when off",
+      MemoryPool::getBytesRetained(), 0);
+}
+
+// each thread allocates a mix of sizes, holds a few, and scribbles on
+// them to catch blocks being handed to two threads at once.
+static void*
+poolThread(void* arg)
+{
+  const int32_t thread = *(int32_t*)arg;
+  const int32_t cHeld = 16;
+  unsigned char* held[cHeld];
+  size_t capacities[cHeld];
+  memset(held, 0, sizeof(held));
+  int32_t errors = 0;
+  for(int32_t i = 0; i < cIterations; i++) {
+    int32_t slot = i % cHeld;
+    if (held[slot]) {
+      for(size_t j = 0; j < capacities[slot]; j += 64)
+        if (held[slot][j] != (unsigned char)thread)
+          ++errors;
+      MemoryPool::release(held[slot], capacities[slot]);
+    }
+    size_t size = 64 << (i % 12);
+    held[slot] = (unsigned char*)MemoryPool::allocate(size, &capacities[slot]);
+    if (!held[slot])
+      return (void*)1;
+    memset(held[slot], thread, capacities[slot]);
+  }
+  for(int32_t slot = 0; slot < cHeld; slot++)
+    MemoryPool::release(held[slot], capacities[slot]);
+  return errors ? (void*)1 : 0;
+}
+
+void
+MemoryPoolTestSuite :: testAllocateAndReleaseAcrossThreads()
+{
+  pthread_t threads[cNumThreads];
+  int32_t ids[cNumThreads];
+  int64_t hits = MemoryPool::getHits();
+  for(int32_t i = 0; i < cNumThreads; i++) {
+    ids[i] = i;
+    TSM_ASSERT_EQUALS("could not start thread", pthread_create(&threads[i], 0,
+        poolThread, &ids[i]), 0);
+  }
+  for(int32_t i = 0; i < cNumThreads; i++) {
+    void* result = 0;
+    pthread_join(threads[i], &result);
+    TSM_ASSERT("block shared between threads", !result);
+  }
+  TSM_ASSERT("pool never hit", MemoryPool::getHits() > hits);
+  TSM_ASSERT("pool over its high water mark",
+      MemoryPool::getBytesRetained() <= MemoryPool::getHighWaterMark());
+}
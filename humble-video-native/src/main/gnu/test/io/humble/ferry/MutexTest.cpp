@@ -17,7 +17,10 @@
  * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
  *******************************************************************************/
 
+#include <pthread.h>
+#include <stdexcept>
 #include <io/humble/ferry/Mutex.h>
+#include <io/humble/ferry/RefPointer.h>
 #include "MutexTest.h"
 
 using namespace VS_CPP_NAMESPACE;
@@ -30,3 +33,76 @@ MutexTestSuite :: testCreateAndDestroy()
   mutex = Mutex::make();
   TSM_ASSERT("should not get a mutex when running outside Java", !mutex);
 }
+
+void
+MutexTestSuite :: testNativeLockAndUnlock()
+{
+  RefPointer<Mutex> mutex = Mutex::makeNative();
+  TSM_ASSERT("should always get a native mutex", mutex);
+  TSM_ASSERT("should be native", mutex->isNative());
+
+  mutex->lock();
+  // and we're re-entrant, like Java locks
+  mutex->lock();
+  mutex->unlock();
+  mutex->unlock();
+  TSM_ASSERT_EQUALS("wrong acquisition count", mutex->getAcquisitions(), 2);
+  TSM_ASSERT_EQUALS("should not have been contended",
+      mutex->getContendedAcquisitions(), 0);
+  TSM_ASSERT_EQUALS("should not have waited", mutex->getWaitTime(), 0);
+}
+
+void
+MutexTestSuite :: testNativeUnlockWithoutLockFails()
+{
+  RefPointer<Mutex> mutex = Mutex::makeNative(0);
+  TS_ASSERT_THROWS(mutex->unlock(), std::runtime_error &);
+}
+
+static const int32_t cNumThreads = 4;
+static const int32_t cIterations = 100000;
+
+typedef struct ContentionArgs {
+  Mutex* mutex;
+  int64_t* counter;
+} ContentionArgs;
+
+static void*
+contentionThread(void* arg)
+{
+  ContentionArgs* args = (ContentionArgs*)arg;
+  for(int32_t i = 0; i < cIterations; i++) {
+    args->mutex->lock();
+    // deliberately not atomic; the lock is what protects it.
+    int64_t value = *args->counter;
+    *args->counter = value + 1;
+    args->mutex->unlock();
+  }
+  return 0;
+}
+
+void
+MutexTestSuite :: testNativeContention()
+{
+  RefPointer<Mutex> mutex = Mutex::makeNative();
+  int64_t counter = 0;
+  ContentionArgs args;
+  args.mutex = mutex.value();
+  args.counter = &counter;
+
+  pthread_t threads[cNumThreads];
+  for(int32_t i = 0; i < cNumThreads; i++)
+    TSM_ASSERT_EQUALS("could not start thread", pthread_create(&threads[i], 0,
+        contentionThread, &args), 0);
+  for(int32_t i = 0; i < cNumThreads; i++)
+    pthread_join(threads[i], 0);
+
+  TSM_ASSERT_EQUALS("lock did not protect counter", counter,
+      cNumThreads*cIterations);
+  TSM_ASSERT_EQUALS("wrong acquisition count", mutex->getAcquisitions(),
+      cNumThreads*cIterations);
+  TSM_ASSERT("more contended acquisitions than acquisitions",
+      mutex->getContendedAcquisitions() <= mutex->getAcquisitions());
+  TSM_ASSERT("contention without waiting",
+      !mutex->getContendedAcquisitions() || mutex->getWaitTime() > 0);
+}
@@ -26,6 +26,9 @@ class MutexTestSuite : public CxxTest::TestSuite
 {
   public:
   void testCreateAndDestroy();
+  void testNativeLockAndUnlock();
+  void testNativeUnlockWithoutLockFails();
+  void testNativeContention();
 };
 
 
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/ferry/RefCountedTester.h>
+#include <io/humble/ferry/RefCountedRegistry.h>
+#include <io/humble/ferry/Buffer.h>
+#include "RefCountedRegistryTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+namespace {
+  const char* cTesterName = "io::humble::ferry::RefCountedTester";
+  const char* cBufferName = "io::humble::ferry::BufferImpl";
+
+  int64_t
+  live(const char* name)
+  {
+    return RefCountedRegistry::getLiveObjects(
+        RefCountedRegistry::findType(name));
+  }
+  int64_t
+  created(const char* name)
+  {
+    return RefCountedRegistry::getCreatedObjects(
+        RefCountedRegistry::findType(name));
+  }
+  int64_t
+  bytes(const char* name)
+  {
+    return RefCountedRegistry::getBytes(
+        RefCountedRegistry::findType(name));
+  }
+}
+
+void
+RefCountedRegistryTestSuite :: tearDown()
+{
+  RefCountedRegistry::setEnabled(false);
+}
+
+void
+RefCountedRegistryTestSuite :: testNothingCountedWhenDisabled()
+{
+  TS_ASSERT(!RefCountedRegistry::isEnabled());
+  RefPointer<RefCountedTester> tester = RefCountedTester::make();
+  RefPointer<Buffer> buffer = Buffer::make(tester.value(), 1024);
+  TS_ASSERT_EQUALS(RefCountedRegistry::findType(cTesterName), -1);
+  TS_ASSERT_EQUALS(RefCountedRegistry::getNumTypes(), 0);
+  TS_ASSERT(!RefCountedRegistry::getTypeName(0));
+  TS_ASSERT_EQUALS(RefCountedRegistry::getLiveObjects(-1), 0);
+}
+
+void
+RefCountedRegistryTestSuite :: testCountsLiveAndCreated()
+{
+  RefCountedRegistry::setEnabled(true);
+  int64_t startLive = live(cTesterName);
+  int64_t startCreated = created(cTesterName);
+  {
+    RefPointer<RefCountedTester> a = RefCountedTester::make();
+    RefPointer<RefCountedTester> b = RefCountedTester::make();
+    {
+      RefPointer<RefCountedTester> c = RefCountedTester::make();
+      // more references are not more objects
+      RefPointer<RefCountedTester> d = RefCountedTester::make(c.value());
+      TS_ASSERT_EQUALS(live(cTesterName), startLive + 3);
+    }
+    TS_ASSERT_EQUALS(live(cTesterName), startLive + 2);
+    TS_ASSERT_EQUALS(created(cTesterName), startCreated + 3);
+  }
+  TS_ASSERT_EQUALS(live(cTesterName), startLive);
+  TS_ASSERT_EQUALS(created(cTesterName), startCreated + 3);
+
+  int32_t index = RefCountedRegistry::findType(cTesterName);
+  TS_ASSERT(index >= 0);
+  TS_ASSERT_EQUALS(std::string(RefCountedRegistry::getTypeName(index)),
+      std::string(cTesterName));
+}
+
+void
+RefCountedRegistryTestSuite :: testBufferBytesCountedAgainstRequestor()
+{
+  RefCountedRegistry::setEnabled(true);
+  RefPointer<RefCountedTester> tester = RefCountedTester::make();
+  int64_t startTester = bytes(cTesterName);
+  int64_t startBuffer = bytes(cBufferName);
+  int64_t startBuffers = live(cBufferName);
+  {
+    RefPointer<Buffer> owned = Buffer::make(tester.value(), 1000);
+    RefPointer<Buffer> unowned = Buffer::make(0, 500);
+    TS_ASSERT_EQUALS(bytes(cTesterName), startTester + 1000);
+    TS_ASSERT_EQUALS(bytes(cBufferName), startBuffer + 500);
+    TS_ASSERT_EQUALS(live(cBufferName), startBuffers + 2);
+  }
+  TS_ASSERT_EQUALS(bytes(cTesterName), startTester);
+  TS_ASSERT_EQUALS(bytes(cBufferName), startBuffer);
+  TS_ASSERT_EQUALS(live(cBufferName), startBuffers);
+}
+
+void
+RefCountedRegistryTestSuite :: testObjectsMadeWhileDisabledAreNotCounted()
+{
+  RefPointer<RefCountedTester> early = RefCountedTester::make();
+  RefPointer<Buffer> earlyBuffer = Buffer::make(early.value(), 100);
+  RefCountedRegistry::setEnabled(true);
+  int64_t startLive = live(cTesterName);
+  int64_t startBytes = bytes(cTesterName);
+  RefPointer<RefCountedTester> late = RefCountedTester::make();
+  TS_ASSERT_EQUALS(live(cTesterName), startLive + 1);
+  early = 0;
+  earlyBuffer = 0;
+  TS_ASSERT_EQUALS(live(cTesterName), startLive + 1);
+  TS_ASSERT_EQUALS(bytes(cTesterName), startBytes);
+
+  // and objects counted while on are counted out after turning it off
+  RefCountedRegistry::setEnabled(false);
+  late = 0;
+  TS_ASSERT_EQUALS(live(cTesterName), startLive);
+}
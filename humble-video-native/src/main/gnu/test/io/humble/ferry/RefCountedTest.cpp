@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/RefPointer.h>
+#include "RefCountedTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+// This is the object we'll hammer on.
+class RefCountedCounter : public RefCounted
+{
+  VS_JNIUTILS_REFCOUNTED_OBJECT(RefCountedCounter);
+  protected:
+  RefCountedCounter() {}
+  virtual ~RefCountedCounter() {}
+};
+
+// How refcounting used to be done: every object carried a separately
+// allocated counter that every acquire/release went through, and inside
+// a JVM each of those was a JNI call into a java AtomicInteger.  This
+// stand-in keeps the separate allocation and guards the count with a
+// mutex rather than calling into Java, so it is cheaper than the old
+// code but, unlike AtomicInteger today, it is not the new code again.
+class LegacyCounter
+{
+  public:
+  LegacyCounter() : mCount(new Count()) {
+    pthread_mutex_init(&mCount->lock, 0);
+    mCount->value = 0;
+  }
+  ~LegacyCounter() {
+    pthread_mutex_destroy(&mCount->lock);
+    delete mCount;
+  }
+  int32_t acquire() { return add(1); }
+  int32_t release() { return add(-1); }
+  private:
+  int32_t add(int32_t delta) {
+    pthread_mutex_lock(&mCount->lock);
+    int32_t retval = (mCount->value += delta);
+    pthread_mutex_unlock(&mCount->lock);
+    return retval;
+  }
+  struct Count {
+    pthread_mutex_t lock;
+    int32_t value;
+  };
+  Count* mCount;
+};
+
+static const int32_t cIterations = 1000000;
+static const int32_t cNumThreads = 4;
+
+static void*
+acquireAndReleaseThread(void* arg)
+{
+  RefCountedCounter* obj = (RefCountedCounter*)arg;
+  for(int32_t i = 0; i < cIterations; i++) {
+    obj->acquire();
+    obj->release();
+  }
+  return 0;
+}
+
+void
+RefCountedTestSuite :: testAcquireAndRelease()
+{
+  RefCountedCounter* obj = RefCountedCounter::make();
+  TSM_ASSERT("could not create our object", obj);
+  TSM_ASSERT_EQUALS("wrong ref count", obj->getCurrentRefCount(), 1);
+  TSM_ASSERT_EQUALS("wrong ref count on acquire", obj->acquire(), 2);
+  TSM_ASSERT_EQUALS("wrong ref count on acquire", obj->acquire(), 3);
+  TSM_ASSERT_EQUALS("wrong ref count on release", obj->release(), 2);
+  RefCounted* copy = obj->copyReference();
+  TSM_ASSERT("copy should be the same object", copy == obj);
+  TSM_ASSERT_EQUALS("wrong ref count after copy", obj->getCurrentRefCount(), 3);
+  TSM_ASSERT_EQUALS("wrong ref count on release", copy->release(), 2);
+  TSM_ASSERT_EQUALS("wrong ref count on release", obj->release(), 1);
+  TSM_ASSERT_EQUALS("wrong ref count on final release", obj->release(), 0);
+}
+
+void
+RefCountedTestSuite :: testAcquireAndReleaseAcrossThreads()
+{
+  RefPointer<RefCountedCounter> obj = RefCountedCounter::make();
+  pthread_t threads[cNumThreads];
+
+  for(int32_t i = 0; i < cNumThreads; i++)
+    TSM_ASSERT_EQUALS("could not start thread", pthread_create(&threads[i], 0,
+        acquireAndReleaseThread, obj.value()), 0);
+  for(int32_t i = 0; i < cNumThreads; i++)
+    pthread_join(threads[i], 0);
+
+  TSM_ASSERT_EQUALS("lost or gained references under contention",
+      obj->getCurrentRefCount(), 1);
+}
+
+void
+RefCountedTestSuite :: testAcquireReleaseThroughput()
+{
+  int64_t start;
+  int64_t inlineTime;
+  int64_t legacyTime;
+  int64_t contendedTime;
+  int64_t lifecycleTime;
+  int64_t legacyLifecycleTime;
+
+  {
+    RefPointer<RefCountedCounter> obj = RefCountedCounter::make();
+    start = VS_TestGetTimeMicros();
+    acquireAndReleaseThread(obj.value());
+    inlineTime = VS_TestGetTimeMicros() - start;
+    TSM_ASSERT_EQUALS("wrong ref count", obj->getCurrentRefCount(), 1);
+  }
+  {
+    LegacyCounter* obj = new LegacyCounter();
+    obj->acquire();
+    start = VS_TestGetTimeMicros();
+    for(int32_t i = 0; i < cIterations; i++) {
+      obj->acquire();
+      obj->release();
+    }
+    legacyTime = VS_TestGetTimeMicros() - start;
+    TSM_ASSERT_EQUALS("wrong ref count", obj->release(), 0);
+    delete obj;
+  }
+  {
+    RefPointer<RefCountedCounter> obj = RefCountedCounter::make();
+    pthread_t threads[cNumThreads];
+    start = VS_TestGetTimeMicros();
+    for(int32_t i = 0; i < cNumThreads; i++)
+      pthread_create(&threads[i], 0, acquireAndReleaseThread, obj.value());
+    for(int32_t i = 0; i < cNumThreads; i++)
+      pthread_join(threads[i], 0);
+    contendedTime = VS_TestGetTimeMicros() - start;
+  }
+  // and now the make-and-drop pattern the demuxer and decoders use
+  start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < cIterations; i++) {
+    RefCountedCounter* obj = RefCountedCounter::make();
+    obj->release();
+  }
+  lifecycleTime = VS_TestGetTimeMicros() - start;
+  start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < cIterations; i++) {
+    RefCountedCounter* obj = RefCountedCounter::make();
+    LegacyCounter* counter = new LegacyCounter();
+    counter->acquire();
+    counter->release();
+    delete counter;
+    obj->release();
+  }
+  legacyLifecycleTime = VS_TestGetTimeMicros() - start;
+
+  // Note the legacy counter here never calls into Java, so its number is
+  // a lower bound on the old cost inside a JVM.
+  VS_LOG_INFO("%d acquire/release pairs: inline %lld us; legacy %lld us; "
+      "%d threads contended %lld us",
+      cIterations, (long long)inlineTime, (long long)legacyTime,
+      cNumThreads, (long long)contendedTime);
+  VS_LOG_INFO("%d make/release cycles: inline %lld us; legacy %lld us",
+      cIterations, (long long)lifecycleTime, (long long)legacyLifecycleTime);
+}
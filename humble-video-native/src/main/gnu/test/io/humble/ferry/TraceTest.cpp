@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <string>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/LoggerStack.h>
+#include <io/humble/ferry/Trace.h>
+#include "TraceTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace {
+  class CapturingSink : public Trace::Sink
+  {
+  public:
+    CapturingSink() : mCount(0), mLine(0) {}
+    virtual ~CapturingSink() {}
+    virtual void onTrace(const char* filename, int lineNo, const char* message)
+    {
+      ++mCount;
+      mFilename = filename ? filename : "";
+      mLine = lineNo;
+      mMessage = message;
+    }
+    int32_t mCount;
+    std::string mFilename;
+    int mLine;
+    std::string mMessage;
+  };
+
+  int32_t sDescribeCalls = 0;
+
+  // stands in for the logMetadata() calls at the real trace sites.
+  const char*
+  describe()
+  {
+    ++sDescribeCalls;
+    return "described";
+  }
+}
+
+void
+TraceTestSuite :: tearDown()
+{
+  Trace::setSink(0);
+}
+
+void
+TraceTestSuite :: testDisabledByDefault()
+{
+  TSM_ASSERT("should start with no sink", !Trace::getSink());
+  TSM_ASSERT("should start disabled", !Trace::isEnabled());
+  TSM_ASSERT("macro should agree", !VS_TRACE_IS_ENABLED());
+}
+
+void
+TraceTestSuite :: testNothingFormattedWithoutSink()
+{
+  sDescribeCalls = 0;
+  VS_TRACE("read Demuxer@%p[p:%s]", this, describe());
+  if (VS_TRACE_IS_ENABLED()) {
+    VS_TRACE_EMIT("read Demuxer@%p[p:%s]", this, describe());
+  }
+  TSM_ASSERT_EQUALS("arguments evaluated with no sink", sDescribeCalls, 0);
+
+  // and a sink that is detached again turns tracing back off.
+  CapturingSink sink;
+  Trace::setSink(&sink);
+  Trace::setSink(0);
+  VS_TRACE("read Demuxer@%p[p:%s]", this, describe());
+  TSM_ASSERT_EQUALS("arguments evaluated after detach", sDescribeCalls, 0);
+  TSM_ASSERT_EQUALS("detached sink was called", sink.mCount, 0);
+}
+
+void
+TraceTestSuite :: testSinkReceivesMessages()
+{
+  CapturingSink sink;
+  Trace::setSink(&sink);
+  TSM_ASSERT_EQUALS("sink not attached", Trace::getSink(), &sink);
+  TSM_ASSERT("should be enabled", Trace::isEnabled());
+
+  sDescribeCalls = 0;
+  const int line = __LINE__ + 1;
+  VS_TRACE("read Demuxer@%p[p:%s;e:%d]", (void*)0, describe(), 5);
+  TSM_ASSERT_EQUALS("should have formatted", sDescribeCalls, 1);
+  TSM_ASSERT_EQUALS("sink not called", sink.mCount, 1);
+  TSM_ASSERT("wrong message",
+      sink.mMessage.find("p:described;e:5]") != std::string::npos);
+  TSM_ASSERT_EQUALS("wrong line", sink.mLine, line);
+  TSM_ASSERT("wrong file",
+      sink.mFilename.find("TraceTest.cpp") != std::string::npos);
+
+  if (VS_TRACE_IS_ENABLED()) {
+    char descr[64];
+    snprintf(descr, sizeof(descr), "%s", describe());
+    VS_TRACE_EMIT("decodeVideo Decoder@%p[in:%s]", (void*)0, descr);
+  }
+  TSM_ASSERT_EQUALS("sink not called", sink.mCount, 2);
+  TSM_ASSERT("wrong message",
+      sink.mMessage.find("[in:described]") != std::string::npos);
+}
+
+void
+TraceTestSuite :: testLongMessagesAreTruncated()
+{
+  CapturingSink sink;
+  Trace::setSink(&sink);
+  std::string big(4*Trace::MAX_MESSAGE_LENGTH, 'x');
+  VS_TRACE("%s", big.c_str());
+  TSM_ASSERT_EQUALS("sink not called", sink.mCount, 1);
+  TSM_ASSERT_EQUALS("not truncated", sink.mMessage.length(),
+      (size_t)Trace::MAX_MESSAGE_LENGTH-1);
+}
+
+void
+TraceTestSuite :: testLoggerSink()
+{
+  // quiet; this just shouldn't crash.
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_ERROR, false);
+  Trace::Sink* sink = Trace::getLoggerSink();
+  TSM_ASSERT("no logger sink", sink);
+  TSM_ASSERT_EQUALS("should always be the same sink", sink,
+      Trace::getLoggerSink());
+  Trace::setSink(sink);
+  VS_TRACE("open Muxer@%p[u:%s;]", (void*)0, "test");
+}
+
+void
+TraceTestSuite :: testDisabledSiteCost()
+{
+  // a disabled site should cost about what an empty loop iteration
+  // does; compare against always formatting a message.
+  const int32_t iterations = 1000000;
+  char buf[256];
+  volatile int32_t sink = 0;
+  sDescribeCalls = 0;
+  int64_t start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < iterations; i++) {
+    VS_TRACE("read Demuxer@%p[p:%s;e:%d]", this, describe(), i);
+    sink = sink + 1;
+  }
+  int64_t gatedTime = VS_TestGetTimeMicros() - start;
+  start = VS_TestGetTimeMicros();
+  for(int32_t i = 0; i < iterations; i++) {
+    snprintf(buf, sizeof(buf), "read Demuxer@%p[p:%s;e:%d]", this, "", i);
+    sink = sink + buf[0];
+  }
+  int64_t formattedTime = VS_TestGetTimeMicros() - start;
+  TSM_ASSERT_EQUALS("disabled site did work", sDescribeCalls, 0);
+  VS_LOG_INFO("%d trace sites: disabled %lld us; always formatting %lld us",
+      iterations, (long long)gatedTime, (long long)formattedTime);
+}
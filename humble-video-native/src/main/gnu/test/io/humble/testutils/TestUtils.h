@@ -25,9 +25,21 @@
 #define CXXTEST_ABORT_TEST_ON_FAIL
 
 #include <cxxtest/TestSuite.h>
+#include <sys/time.h>
+#include <io/humble/Humble.h>
 
 // This is the main method that will be build by cxxtest. We need
 // to call it from our main.
 int VS_TestMain(int argc, char**argv);
 
+/**
+ * Wall clock time in microseconds; used by the throughput
+ * tests to time a run.
+ */
+inline int64_t VS_TestGetTimeMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return ((int64_t)tv.tv_sec)*1000000 + tv.tv_usec;
+}
+
 #endif // ! __TEST_UTILS_H__
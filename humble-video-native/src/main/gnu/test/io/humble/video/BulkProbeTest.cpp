@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/BulkProbe.h>
+#include <io/humble/video/Global.h>
+#include "BulkProbeTest.h"
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+using namespace io::humble::ferry;
+using namespace io::humble::video;
+
+BulkProbeTest::BulkProbeTest() {
+  mSampleFile[0] = 0;
+  mFixture = mFixtures.getFixture("ucl_h264_aac.mp4");
+  TSM_ASSERT("Missing fixture", mFixture);
+  mFixtures.fillPath(mFixture, mSampleFile, sizeof(mSampleFile));
+}
+
+BulkProbeTest::~BulkProbeTest() {
+}
+
+void
+BulkProbeTest::testMake() {
+  TS_ASSERT_THROWS(BulkProbe::make(0), HumbleInvalidArgument);
+  RefPointer<BulkProbe> probe = BulkProbe::make(4);
+  TS_ASSERT_EQUALS(4, probe->getConcurrency());
+  TS_ASSERT_EQUALS(0, probe->getTimeout());
+  TS_ASSERT_EQUALS(0, probe->getNumFiles());
+  TS_ASSERT_THROWS(probe->add(0), HumbleInvalidArgument);
+  TS_ASSERT_THROWS(probe->getURL(0), HumbleInvalidArgument);
+  // nothing to do is fine
+  TS_ASSERT_EQUALS(0, probe->run());
+}
+
+void
+BulkProbeTest::testRun() {
+  RefPointer<BulkProbe> probe = BulkProbe::make(3);
+  const int32_t numCopies = 8;
+  for(int32_t i = 0; i < numCopies; i++)
+    TS_ASSERT_EQUALS(i, probe->add(mSampleFile));
+  int32_t missing = probe->add("BulkProbeTest_no_such_file.mp4");
+
+  TS_ASSERT_EQUALS(numCopies, probe->run());
+  TS_ASSERT_EQUALS(numCopies+1, probe->getNumFiles());
+  for(int32_t i = 0; i < numCopies; i++) {
+    TS_ASSERT(probe->isProbed(i));
+    TS_ASSERT(!probe->isTimedOut(i));
+    TS_ASSERT(!probe->getErrorMessage(i));
+    TS_ASSERT_EQUALS(0, strcmp(mSampleFile, probe->getURL(i)));
+    TS_ASSERT(strstr(probe->getFormatName(i), "mp4"));
+    TS_ASSERT(probe->getDuration(i) > 0);
+    TS_ASSERT(probe->getBitRate(i) > 0);
+    TS_ASSERT_EQUALS(mFixture->num_streams, probe->getNumStreams(i));
+    for(int32_t j = 0; j < probe->getNumStreams(i); j++) {
+      TS_ASSERT(probe->getStreamTimeBaseNumerator(i, j) > 0);
+      TS_ASSERT(probe->getStreamTimeBaseDenominator(i, j) > 0);
+      switch(probe->getStreamType(i, j)) {
+        case MediaDescriptor::MEDIA_VIDEO:
+          TS_ASSERT_EQUALS(Codec::CODEC_ID_H264, probe->getStreamCodecID(i, j));
+          TS_ASSERT_EQUALS(mFixture->width, probe->getStreamWidth(i, j));
+          TS_ASSERT_EQUALS(mFixture->height, probe->getStreamHeight(i, j));
+          break;
+        case MediaDescriptor::MEDIA_AUDIO:
+          TS_ASSERT_EQUALS(Codec::CODEC_ID_AAC, probe->getStreamCodecID(i, j));
+          TS_ASSERT_EQUALS(mFixture->sample_rate, probe->getStreamSampleRate(i, j));
+          TS_ASSERT_EQUALS(mFixture->channels, probe->getStreamChannels(i, j));
+          break;
+        default:
+          TS_FAIL("unexpected stream type");
+      }
+    }
+    TS_ASSERT_THROWS(probe->getStreamWidth(i, probe->getNumStreams(i)),
+        HumbleInvalidArgument);
+  }
+  TS_ASSERT(!probe->isProbed(missing));
+  TS_ASSERT(!probe->isTimedOut(missing));
+  TS_ASSERT(probe->getErrorMessage(missing));
+  TS_ASSERT(!probe->getFormatName(missing));
+  TS_ASSERT_EQUALS(0, probe->getNumStreams(missing));
+  TS_ASSERT_EQUALS(Global::NO_PTS, probe->getDuration(missing));
+
+  // running again gives the same answers
+  TS_ASSERT_EQUALS(numCopies, probe->run());
+  TS_ASSERT_EQUALS(mFixture->num_streams, probe->getNumStreams(numCopies-1));
+}
+
+void
+BulkProbeTest::testTimeout() {
+  // a server that accepts connections (the kernel does that for us) but
+  // never sends anything, so the probe stalls waiting on I/O.
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  TS_ASSERT(server >= 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  TS_ASSERT_EQUALS(0, bind(server, (struct sockaddr*)&addr, sizeof(addr)));
+  TS_ASSERT_EQUALS(0, listen(server, 4));
+  socklen_t len = sizeof(addr);
+  TS_ASSERT_EQUALS(0, getsockname(server, (struct sockaddr*)&addr, &len));
+  char url[128];
+  snprintf(url, sizeof(url), "tcp://127.0.0.1:%d", ntohs(addr.sin_port));
+
+  RefPointer<BulkProbe> probe = BulkProbe::make(2);
+  probe->setTimeout(250000);
+  TS_ASSERT_EQUALS(250000, probe->getTimeout());
+  int32_t stalled = probe->add(url);
+  int32_t good = probe->add(mSampleFile);
+  TS_ASSERT_EQUALS(1, probe->run());
+  TS_ASSERT(!probe->isProbed(stalled));
+  TS_ASSERT(probe->isTimedOut(stalled));
+  TS_ASSERT(probe->getErrorMessage(stalled));
+  TS_ASSERT(probe->getProbeTime(stalled) >= 250000);
+  // FFmpeg polls the interrupt callback every 100ms or so while it waits
+  TS_ASSERT(probe->getProbeTime(stalled) < 5000000);
+  TS_ASSERT(probe->isProbed(good));
+  TS_ASSERT(!probe->isTimedOut(good));
+  close(server);
+}
+
+static void*
+runProbe(void* arg) {
+  static_cast<BulkProbe*>(arg)->run();
+  return 0;
+}
+
+void
+BulkProbeTest::testBusyWhileRunning() {
+  // as above, a server that never answers keeps run() busy until timeout
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  TS_ASSERT(server >= 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  TS_ASSERT_EQUALS(0, bind(server, (struct sockaddr*)&addr, sizeof(addr)));
+  TS_ASSERT_EQUALS(0, listen(server, 4));
+  socklen_t len = sizeof(addr);
+  TS_ASSERT_EQUALS(0, getsockname(server, (struct sockaddr*)&addr, &len));
+  char url[128];
+  snprintf(url, sizeof(url), "tcp://127.0.0.1:%d", ntohs(addr.sin_port));
+
+  RefPointer<BulkProbe> probe = BulkProbe::make(1);
+  probe->setTimeout(1000000);
+  int32_t stalled = probe->add(url);
+  pthread_t thread;
+  TS_ASSERT_EQUALS(0, pthread_create(&thread, 0, runProbe, probe.value()));
+  usleep(200000);
+  TS_ASSERT_THROWS(probe->add(mSampleFile), HumbleRuntimeError);
+  TS_ASSERT_THROWS(probe->isProbed(stalled), HumbleRuntimeError);
+  TS_ASSERT_THROWS(probe->run(), HumbleRuntimeError);
+  TS_ASSERT_EQUALS(0, pthread_join(thread, 0));
+  TS_ASSERT_EQUALS(1, probe->getNumFiles());
+  TS_ASSERT(probe->isTimedOut(stalled));
+  TS_ASSERT_EQUALS(1, probe->add(mSampleFile));
+  close(server);
+}
@@ -22,12 +22,19 @@
  *  Created on: Jul 28, 2013
  *      Author: aclarke
  */
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
 #include <io/humble/ferry/Logger.h>
 #include <io/humble/ferry/LoggerStack.h>
 
 #include "DecoderTest.h"
 #include <io/humble/ferry/RefPointer.h>
 #include <io/humble/ferry/HumbleException.h>
+#include <io/humble/ferry/JNIMemoryManager.h>
+#include <io/humble/ferry/MemoryPool.h>
+#include <io/humble/ferry/RefCountedRegistry.h>
 #include <io/humble/video/KeyValueBag.h>
 #include <io/humble/video/Demuxer.h>
 #include <io/humble/video/DemuxerStream.h>
@@ -35,6 +42,47 @@
 
 VS_LOG_SETUP(VS_CPP_PACKAGE.DecoderTest);
 
+// Every C++ allocation in this test binary comes through here, and is
+// counted while sCountAllocations is set; that is how
+// testSteadyStateAllocations sees what a decode call costs.
+static volatile bool sCountAllocations = false;
+static int64_t sAllocations = 0;
+
+void*
+operator new(std::size_t size) _GLIBCXX_THROW (std::bad_alloc)
+{
+  if (sCountAllocations)
+    __atomic_add_fetch(&sAllocations, 1, __ATOMIC_RELAXED);
+  void* retval = malloc(size ? size : 1);
+  if (!retval)
+    throw std::bad_alloc();
+  return retval;
+}
+
+void
+operator delete(void* mem) _GLIBCXX_USE_NOEXCEPT
+{
+  free(mem);
+}
+
+#if __cplusplus >= 201402L
+void
+operator delete(void* mem, std::size_t) _GLIBCXX_USE_NOEXCEPT
+{
+  free(mem);
+}
+#endif
+
+/** The RefCounted objects of every type made while the registry was on. */
+static int64_t
+countCreatedObjects()
+{
+  int64_t retval = 0;
+  for(int32_t i = 0; i < RefCountedRegistry::getNumTypes(); i++)
+    retval += RefCountedRegistry::getCreatedObjects(i);
+  return retval;
+}
+
 DecoderTest::DecoderTest() {
 }
 
@@ -403,3 +451,405 @@ DecoderTest::testIssue27()
 
   demuxer->close();
 }
+
+void
+DecoderTest::testThreadSettings()
+{
+  RefPointer<Codec> codec = Codec::findDecodingCodec(Codec::CODEC_ID_H264);
+  RefPointer<Decoder> decoder = Decoder::make(codec.value());
+  TS_ASSERT_EQUALS(Coder::THREAD_NONE, decoder->getActiveThreadType());
+  TS_ASSERT_EQUALS(0, decoder->getThreadDelay());
+  TS_ASSERT_THROWS(decoder->setThreadCount(-1), HumbleInvalidArgument);
+
+  decoder->setThreadCount(4);
+  decoder->setThreadType(Coder::THREAD_FRAME);
+  TS_ASSERT_EQUALS(4, decoder->getThreadCount());
+  TS_ASSERT_EQUALS(Coder::THREAD_FRAME, decoder->getThreadType());
+
+  decoder->open(0, 0);
+  TS_ASSERT_EQUALS(4, decoder->getThreadCount());
+  TS_ASSERT_EQUALS(Coder::THREAD_FRAME, decoder->getActiveThreadType());
+  TS_ASSERT_EQUALS(3, decoder->getThreadDelay());
+  TS_ASSERT_THROWS(decoder->setThreadCount(1), HumbleRuntimeError);
+  TS_ASSERT_THROWS(decoder->setThreadType(Coder::THREAD_SLICE), HumbleRuntimeError);
+
+  // auto becomes a real count once opened
+  decoder = Decoder::make(codec.value());
+  decoder->setThreadCount(0);
+  decoder->setThreadType(Coder::THREAD_SLICE);
+  TS_ASSERT_EQUALS(0, decoder->getThreadCount());
+  decoder->open(0, 0);
+  TS_ASSERT(decoder->getThreadCount() >= 1);
+  TS_ASSERT_EQUALS(0, decoder->getThreadDelay());
+}
+
+static int32_t
+selectVideoStream(Demuxer* source)
+{
+  TS_ASSERT(source->selectStreams(MediaDescriptor::MEDIA_VIDEO) > 0);
+  int32_t n = source->getNumStreams();
+  for(int32_t i = 0; i < n; i++)
+    if (source->isStreamSelected(i))
+      return i;
+  return -1;
+}
+
+int32_t
+DecoderTest::decodeAllVideo(const char* file, int32_t threads,
+    Coder::ThreadType type, int64_t* micros, Decoder** opened)
+{
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(file, 0, false, true, 0, 0);
+  int32_t streamIndex = selectVideoStream(source.value());
+  TS_ASSERT(streamIndex >= 0);
+  RefPointer<DemuxerStream> stream = source->getStream(streamIndex);
+  RefPointer<Decoder> decoder = stream->getDecoder();
+  decoder->setThreadCount(threads);
+  decoder->setThreadType(type);
+  decoder->open(0, 0);
+
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+  RefPointer<MediaPicture> picture = MediaPicture::make(
+      decoder->getWidth(),
+      decoder->getHeight(),
+      decoder->getPixelFormat());
+
+  int32_t retval = 0;
+  int64_t start = VS_TestGetTimeMicros();
+  while(source->read(packet.value()) >= 0) {
+    if (packet->getStreamIndex() != streamIndex || !packet->isComplete())
+      continue;
+    int32_t byteOffset = 0;
+    do {
+      byteOffset += decoder->decodeVideo(picture.value(), packet.value(), byteOffset);
+      if (picture->isComplete())
+        ++retval;
+    } while(byteOffset < packet->getSize());
+  }
+  // frame threads hold back their last getThreadDelay() frames until now
+  do {
+    decoder->decodeVideo(picture.value(), 0, 0);
+    if (picture->isComplete())
+      ++retval;
+  } while (picture->isComplete());
+  if (micros)
+    *micros = VS_TestGetTimeMicros() - start;
+  source->close();
+  if (opened)
+    *opened = decoder.get();
+  return retval;
+}
+
+void
+DecoderTest::testDecodeVideoThreaded()
+{
+  TestData::Fixture* fixture=mFixtures.getFixture("ucl_h264_aac.mp4");
+  TS_ASSERT(fixture);
+  char filepath[2048];
+  mFixtures.fillPath(fixture, filepath, sizeof(filepath));
+
+  int32_t expected = decodeAllVideo(filepath, 1, Coder::THREAD_FRAME_AND_SLICE, 0, 0);
+  TS_ASSERT(expected > 0);
+
+  // no frame may be lost to the delay, whatever the threading
+  RefPointer<Decoder> decoder;
+  Decoder* opened = 0;
+  TS_ASSERT_EQUALS(expected,
+      decodeAllVideo(filepath, 4, Coder::THREAD_FRAME, 0, &opened));
+  decoder = opened;
+  TS_ASSERT_EQUALS(3, decoder->getThreadDelay());
+  TS_ASSERT_EQUALS(expected,
+      decodeAllVideo(filepath, 4, Coder::THREAD_SLICE, 0, 0));
+  TS_ASSERT_EQUALS(expected,
+      decodeAllVideo(filepath, 0, Coder::THREAD_FRAME_AND_SLICE, 0, 0));
+
+  // a drained frame-threaded decoder takes a new stream from the start
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(filepath, 0, false, true, 0, 0);
+  int32_t streamIndex = selectVideoStream(source.value());
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+  RefPointer<MediaPicture> picture = MediaPicture::make(
+      decoder->getWidth(),
+      decoder->getHeight(),
+      decoder->getPixelFormat());
+  int32_t frames = 0;
+  while(source->read(packet.value()) >= 0)
+    if (packet->getStreamIndex() == streamIndex && packet->isComplete()) {
+      decoder->decodeVideo(picture.value(), packet.value(), 0);
+      if (picture->isComplete())
+        ++frames;
+    }
+  source->close();
+  do {
+    decoder->decodeVideo(picture.value(), 0, 0);
+    if (picture->isComplete())
+      ++frames;
+  } while (picture->isComplete());
+  TS_ASSERT_EQUALS(expected, frames);
+}
+
+void
+DecoderTest::benchmarkThreads(const char* file)
+{
+  const int32_t counts[] = { 1, 2, 4, 0 };
+  int32_t frames[4];
+  for(int32_t i = 0; i < 4; i++) {
+    int64_t micros = 0;
+    Decoder* opened = 0;
+    frames[i] = decodeAllVideo(file, counts[i],
+        Coder::THREAD_FRAME_AND_SLICE, &micros, &opened);
+    RefPointer<Decoder> decoder;
+    decoder = opened;
+    VS_LOG_INFO("%s: %d threads (%s), delay %d: %d frames in %" PRIi64 " us; %.1f fps",
+        file, decoder->getThreadCount(),
+        counts[i] ? "asked" : "auto",
+        decoder->getThreadDelay(),
+        frames[i], micros,
+        micros > 0 ? frames[i] * 1000000.0 / micros : 0.0);
+    TS_ASSERT_EQUALS(frames[0], frames[i]);
+  }
+}
+
+void
+DecoderTest::testBenchmarkThreads()
+{
+  TestData::Fixture* fixture=mFixtures.getFixture("ucl_h264_aac.mp4");
+  TS_ASSERT(fixture);
+  char filepath[2048];
+  mFixtures.fillPath(fixture, filepath, sizeof(filepath));
+  benchmarkThreads(filepath);
+  // The fixture is short and small; point this at a long HD movie to see
+  // how far the threads scale.
+  const char* large = getenv("VS_TEST_LARGE_FILE");
+  if (large && *large)
+    benchmarkThreads(large);
+}
+
+void
+DecoderTest::testPictureBufferPool()
+{
+  TestData::Fixture* fixture=mFixtures.getFixture("ucl_h264_aac.mp4");
+  TS_ASSERT(fixture);
+  char filepath[2048];
+  mFixtures.fillPath(fixture, filepath, sizeof(filepath));
+
+  // once the decoder has all the frames it keeps for reference, every
+  // plane comes back around.
+  Decoder* opened = 0;
+  int32_t frames = decodeAllVideo(filepath, 1, Coder::THREAD_FRAME_AND_SLICE, 0, &opened);
+  RefPointer<Decoder> decoder;
+  decoder = opened;
+  TS_ASSERT(decoder->isPictureBufferPooling());
+  TS_ASSERT(decoder->getPictureBufferPoolMisses() > 0);
+  TS_ASSERT(decoder->getPictureBufferPoolHits() > decoder->getPictureBufferPoolMisses());
+  TS_ASSERT(decoder->getPictureBufferPoolHits() + decoder->getPictureBufferPoolMisses() >= frames);
+  // and now nothing is using any of them
+  TS_ASSERT(decoder->getPictureBufferPoolBytesRetained() > 0);
+  TS_ASSERT_THROWS(decoder->setPictureBufferPooling(false), HumbleRuntimeError);
+
+  // a Buffer someone holds is never decoded into again
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(filepath, 0, false, true, 0, 0);
+  int32_t streamIndex = selectVideoStream(source.value());
+  RefPointer<DemuxerStream> stream = source->getStream(streamIndex);
+  decoder = stream->getDecoder();
+  decoder->open(0, 0);
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+  RefPointer<MediaPicture> picture = MediaPicture::make(
+      decoder->getWidth(),
+      decoder->getHeight(),
+      decoder->getPixelFormat());
+  RefPointer<Buffer> held;
+  unsigned char first[64];
+  while(source->read(packet.value()) >= 0) {
+    if (packet->getStreamIndex() != streamIndex || !packet->isComplete())
+      continue;
+    decoder->decodeVideo(picture.value(), packet.value(), 0);
+    if (!picture->isComplete())
+      continue;
+    if (!held) {
+      held = picture->getData(0);
+      TS_ASSERT(held);
+      // the same Buffer each time, not a new wrapper
+      RefPointer<Buffer> again = picture->getData(0);
+      TS_ASSERT_EQUALS(held.value(), again.value());
+      memcpy(first, held->getBytes(0, sizeof(first)), sizeof(first));
+    } else {
+      RefPointer<Buffer> later = picture->getData(0);
+      TS_ASSERT_DIFFERS(held.value(), later.value());
+    }
+  }
+  source->close();
+  TS_ASSERT(held);
+  if (held)
+    TS_ASSERT_EQUALS(0, memcmp(first, held->getBytes(0, sizeof(first)), sizeof(first)));
+
+  // planes stay aligned however JNIMemoryManager aligns its blocks
+  size_t alignment = JNIMemoryManager::getAlignment();
+  TS_ASSERT(JNIMemoryManager::setAlignment(8));
+  decoder = Decoder::make(decoder.value());
+  decoder->open(0, 0);
+  source = Demuxer::make();
+  source->open(filepath, 0, false, true, 0, 0);
+  int32_t checked = 0;
+  while(checked < 8 && source->read(packet.value()) >= 0) {
+    if (packet->getStreamIndex() != streamIndex || !packet->isComplete())
+      continue;
+    decoder->decodeVideo(picture.value(), packet.value(), 0);
+    if (!picture->isComplete())
+      continue;
+    for(int32_t i = 0; i < picture->getNumDataPlanes(); i++) {
+      RefPointer<Buffer> plane = picture->getData(i);
+      TS_ASSERT_EQUALS(0u, (uintptr_t)plane->getBytes(0, 1) % 64);
+    }
+    ++checked;
+  }
+  source->close();
+  TS_ASSERT(checked > 0);
+  JNIMemoryManager::setAlignment(alignment);
+
+  // and with pooling off FFmpeg allocates as it always has
+  decoder = Decoder::make(decoder.value());
+  decoder->setPictureBufferPooling(false);
+  TS_ASSERT(!decoder->isPictureBufferPooling());
+  decoder->open(0, 0);
+  TS_ASSERT_EQUALS(0, decoder->getPictureBufferPoolHits());
+  TS_ASSERT_EQUALS(0, decoder->getPictureBufferPoolBytesRetained());
+}
+
+void
+DecoderTest::testSteadyStateAllocations()
+{
+  TestData::Fixture* fixture=mFixtures.getFixture("ucl_h264_aac.mp4");
+  TS_ASSERT(fixture);
+  char filepath[2048];
+  mFixtures.fillPath(fixture, filepath, sizeof(filepath));
+
+  // count objects and Buffer memory as well as operator new
+  bool registryEnabled = RefCountedRegistry::isEnabled();
+  bool poolEnabled = MemoryPool::isEnabled();
+  RefCountedRegistry::setEnabled(true);
+  MemoryPool::setEnabled(true);
+
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(filepath, 0, false, true, 0, 0);
+  const int32_t n = 2;
+  TS_ASSERT_EQUALS(n, source->getNumStreams());
+  RefPointer<Decoder> decoders[n];
+  RefPointer<MediaSampled> outputs[n];
+  for(int32_t i = 0; i < n; i++) {
+    RefPointer<DemuxerStream> stream = source->getStream(i);
+    decoders[i] = stream->getDecoder();
+    decoders[i]->open(0, 0);
+    if (decoders[i]->getCodecType() == MediaDescriptor::MEDIA_VIDEO)
+      outputs[i] = MediaPicture::make(
+          decoders[i]->getWidth(),
+          decoders[i]->getHeight(),
+          decoders[i]->getPixelFormat());
+    else
+      outputs[i] = MediaAudio::make(
+          decoders[i]->getFrameSize(),
+          decoders[i]->getSampleRate(),
+          decoders[i]->getChannels(),
+          decoders[i]->getChannelLayout(),
+          decoders[i]->getSampleFormat());
+  }
+
+  // give the picture pool time to hold every frame the video decoder
+  // keeps for reference, and the time bases time to be interned.
+  const int32_t warmup = 60;
+  int32_t frames = 0;
+  int32_t counted = 0;
+  int64_t allocations = 0;
+  int64_t objects = 0;
+  int64_t blocks = 0;
+  int64_t planes = 0;
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+  while(source->read(packet.value()) >= 0) {
+    int32_t i = packet->getStreamIndex();
+    if (!packet->isComplete() || i < 0 || i >= n)
+      continue;
+    bool steady = frames >= warmup;
+    int64_t before = sAllocations;
+    int64_t objectsBefore = steady ? countCreatedObjects() : 0;
+    int64_t blocksBefore = MemoryPool::getMisses();
+    int64_t planesBefore = decoders[i]->getPictureBufferPoolMisses();
+    sCountAllocations = steady;
+    decoders[i]->decode(outputs[i].value(), packet.value(), 0);
+    sCountAllocations = false;
+    if (steady) {
+      allocations += sAllocations - before;
+      objects += countCreatedObjects() - objectsBefore;
+      blocks += MemoryPool::getMisses() - blocksBefore;
+      planes += decoders[i]->getPictureBufferPoolMisses() - planesBefore;
+    }
+    if (outputs[i]->isComplete()) {
+      ++frames;
+      if (steady)
+        ++counted;
+    }
+  }
+  source->close();
+  RefCountedRegistry::setEnabled(registryEnabled);
+  MemoryPool::setEnabled(poolEnabled);
+  VS_LOG_INFO("%d allocations, %d objects, %d blocks and %d planes over %d steady state frames",
+      (int32_t)allocations, (int32_t)objects, (int32_t)blocks, (int32_t)planes,
+      counted);
+  TS_ASSERT(counted > 0);
+  TS_ASSERT_EQUALS(0, allocations);
+  // no RefCounted objects made, no Buffer memory from the system, and no
+  // new picture planes
+  TS_ASSERT_EQUALS(0, objects);
+  TS_ASSERT_EQUALS(0, blocks);
+  TS_ASSERT_EQUALS(0, planes);
+}
+
+void
+DecoderTest::testSkipFrame()
+{
+  TestData::Fixture* fixture=mFixtures.getFixture("ucl_h264_aac.mp4");
+  TS_ASSERT(fixture);
+  char filepath[2048];
+  mFixtures.fillPath(fixture, filepath, sizeof(filepath));
+  int32_t expected = decodeAllVideo(filepath, 1, Coder::THREAD_FRAME_AND_SLICE, 0, 0);
+  TS_ASSERT(expected > 0);
+
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(filepath, 0, false, true, 0, 0);
+  int32_t streamIndex = selectVideoStream(source.value());
+  RefPointer<DemuxerStream> stream = source->getStream(streamIndex);
+  RefPointer<Decoder> decoder = stream->getDecoder();
+  TS_ASSERT_EQUALS(Decoder::DISCARD_DEFAULT, decoder->getSkipFrame());
+  TS_ASSERT_EQUALS(Decoder::DISCARD_DEFAULT, decoder->getSkipLoopFilter());
+  TS_ASSERT_EQUALS(Decoder::DISCARD_DEFAULT, decoder->getSkipIDCT());
+  decoder->setSkipLoopFilter(Decoder::DISCARD_ALL);
+  TS_ASSERT_EQUALS(Decoder::DISCARD_ALL, decoder->getSkipLoopFilter());
+  decoder->setSkipIDCT(Decoder::DISCARD_NONREF);
+  TS_ASSERT_EQUALS(Decoder::DISCARD_NONREF, decoder->getSkipIDCT());
+  decoder->setSkipFrame(Decoder::DISCARD_NONKEY);
+  TS_ASSERT_EQUALS(Decoder::DISCARD_NONKEY, decoder->getSkipFrame());
+  decoder->open(0, 0);
+
+  // every packet is consumed, but only key frames come out
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+  RefPointer<MediaPicture> picture = MediaPicture::make(
+      decoder->getWidth(),
+      decoder->getHeight(),
+      decoder->getPixelFormat());
+  int32_t frames = 0;
+  while(source->read(packet.value()) >= 0)
+    if (packet->getStreamIndex() == streamIndex && packet->isComplete()) {
+      TS_ASSERT(decoder->decodeVideo(picture.value(), packet.value(), 0) >= 0);
+      if (picture->isComplete())
+        ++frames;
+    }
+  do {
+    decoder->decodeVideo(picture.value(), 0, 0);
+    if (picture->isComplete())
+      ++frames;
+  } while (picture->isComplete());
+  source->close();
+  VS_LOG_INFO("%d of %d frames decoded with only key frames", frames, expected);
+  TS_ASSERT(frames > 0);
+  TS_ASSERT(frames < expected);
+}
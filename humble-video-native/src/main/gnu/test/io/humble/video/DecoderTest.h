@@ -47,7 +47,16 @@ public:
   void testDecodeVideo();
   void testOpenCloseMP4();
   void testIssue27();
+  void testThreadSettings();
+  void testDecodeVideoThreaded();
+  void testBenchmarkThreads();
+  void testPictureBufferPool();
+  void testSteadyStateAllocations();
+  void testSkipFrame();
 private:
+  int32_t decodeAllVideo(const char* file, int32_t threads,
+      Coder::ThreadType type, int64_t* micros, Decoder** opened);
+  void benchmarkThreads(const char* file);
   void writeAudio(FILE* output, MediaAudio* audio);
   void writePicture(const char* prefix, int32_t* frameNo, MediaPicture* picture);
   TestData mFixtures;
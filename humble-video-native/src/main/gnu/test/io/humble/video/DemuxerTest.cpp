@@ -25,12 +25,16 @@
 
 // for getenv
 #include <cstdlib>
+#include <cstdio>
 #include <vector>
+#include <utime.h>
 
 #include <io/humble/ferry/Logger.h>
 #include <io/humble/ferry/LoggerStack.h>
 #include "DemuxerTest.h"
 #include <io/humble/video/DemuxerImpl.h>
+#include <io/humble/video/FfmpegURLProtocolHandler.h>
+#include <io/humble/video/Global.h>
 #include <io/humble/video/customio/StdioURLProtocolManager.h>
 
 VS_LOG_SETUP(VS_CPP_PACKAGE);
@@ -261,3 +265,469 @@ DemuxerTest::testRead()
   TS_ASSERT_EQUALS(pktsRead, mFixture->packets);
   source->close();
 }
+
+void
+DemuxerTest::testReadAhead()
+{
+  // read everything on this thread first, to have something to compare to.
+  std::vector<int64_t> expected;
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  while (source->read(pkt.value()) >= 0)
+    if (pkt->isComplete())
+      expected.push_back(pkt->getDts() * 31 + pkt->getSize() * 7 + pkt->getStreamIndex());
+  TS_ASSERT_EQUALS((int64_t)expected.size(), (int64_t)mFixture->packets);
+  // seeking lands on a keyframe of the default stream, which need not be
+  // where the file starts, so note what comes first after the seek too.
+  TS_ASSERT(source->seek(-1, Global::NO_PTS, 0, 0, 0) >= 0);
+  TS_ASSERT(source->read(pkt.value()) >= 0);
+  int64_t expectedAfterSeek = pkt->getDts() * 31 + pkt->getSize() * 7 + pkt->getStreamIndex();
+  source->close();
+
+  source = Demuxer::make();
+  source->setReadAhead(8, 64*1024, 1000000);
+  TS_ASSERT_EQUALS(source->getReadAheadMaxPackets(), 8);
+  TS_ASSERT_EQUALS(source->getReadAheadMaxBytes(), 64*1024);
+  TS_ASSERT_EQUALS(source->getReadAheadMaxDuration(), 1000000);
+  source->open(mSampleFile, 0, false, true, 0, 0);
+
+  size_t i = 0;
+  int32_t retval;
+  while ((retval = source->read(pkt.value())) >= 0) {
+    TS_ASSERT(pkt->isComplete());
+    TS_ASSERT(i < expected.size());
+    if (i < expected.size())
+      TS_ASSERT_EQUALS(pkt->getDts() * 31 + pkt->getSize() * 7 + pkt->getStreamIndex(),
+          expected[i]);
+    // the packet must own its data now that the reader has moved on
+    RefPointer<Buffer> data = pkt->getData();
+    TS_ASSERT(data);
+    TS_ASSERT(source->getReadAheadQueuedPackets() <= 8);
+    // this stops the thread, which must finish the packet it is reading
+    // rather than lose it; the next read starts it again.
+    if (i % 100 == 50)
+      source->queryStreamMetaData();
+    TS_ASSERT(source->getFileSize() > 0);
+    ++i;
+  }
+  TS_ASSERT_EQUALS(i, expected.size());
+  // end of file stays end of file
+  TS_ASSERT_EQUALS(source->read(pkt.value()), retval);
+  VS_LOG_DEBUG("read-ahead stalls: empty %" PRIi64 "; full %" PRIi64,
+      source->getReadAheadEmptyStalls(), source->getReadAheadFullStalls());
+
+  // seek back and make sure we do not see anything queued from before.
+  TS_ASSERT(source->seek(-1, Global::NO_PTS, 0, 0, 0) >= 0);
+  TS_ASSERT(source->read(pkt.value()) >= 0);
+  TS_ASSERT_EQUALS(pkt->getDts() * 31 + pkt->getSize() * 7 + pkt->getStreamIndex(),
+      expectedAfterSeek);
+
+  // and close with the queue full and the thread waiting.
+  TS_ASSERT(source->read(pkt.value()) >= 0);
+  source->close();
+  TS_ASSERT_EQUALS(source->getReadAheadQueuedPackets(), 0);
+  TS_ASSERT_EQUALS(source->getReadAheadQueuedBytes(), 0);
+}
+
+void
+DemuxerTest::testReadBatch()
+{
+  TS_ASSERT_THROWS(MediaPacketBatch::make(0), HumbleInvalidArgument);
+
+  std::vector<int64_t> expected;
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  int64_t start = VS_TestGetTimeMicros();
+  while (source->read(pkt.value()) >= 0)
+    if (pkt->isComplete())
+      expected.push_back(pkt->getDts() * 31 + pkt->getSize() * 7 + pkt->getStreamIndex());
+  int64_t single = VS_TestGetTimeMicros() - start;
+  source->close();
+
+  RefPointer<MediaPacketBatch> batch = MediaPacketBatch::make(32);
+  TS_ASSERT_EQUALS(batch->getCapacity(), 32);
+  TS_ASSERT_EQUALS(batch->getSize(), 0);
+  RefPointer<MediaPacket> first = batch->getPacket(0);
+  TS_ASSERT_THROWS(batch->getPacket(32), HumbleInvalidArgument);
+
+  source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  size_t i = 0;
+  int32_t retval;
+  start = VS_TestGetTimeMicros();
+  while ((retval = source->readBatch(batch.value())) > 0) {
+    TS_ASSERT_EQUALS(retval, batch->getSize());
+    for(int32_t j = 0; j < batch->getSize(); j++, i++) {
+      RefPointer<MediaPacket> p = batch->getPacket(j);
+      TS_ASSERT(p->isComplete());
+      RefPointer<Rational> timeBase = p->getTimeBase();
+      TS_ASSERT(timeBase);
+      if (i < expected.size())
+        TS_ASSERT_EQUALS(p->getDts() * 31 + p->getSize() * 7 + p->getStreamIndex(),
+            expected[i]);
+    }
+  }
+  int64_t batched = VS_TestGetTimeMicros() - start;
+  TS_ASSERT(retval < 0);
+  TS_ASSERT_EQUALS(batch->getSize(), 0);
+  TS_ASSERT_EQUALS(i, expected.size());
+  // the batch hands out the same packets every time
+  RefPointer<MediaPacket> again = batch->getPacket(0);
+  TS_ASSERT_EQUALS(first.value(), again.value());
+  source->close();
+  VS_LOG_DEBUG("%d packets: read() %" PRIi64 " us; readBatch() %" PRIi64 " us",
+      (int32_t)expected.size(), single, batched);
+}
+
+void
+DemuxerTest::testSeekIndex()
+{
+  // work on a copy, so we can change its modification time
+  const char* media = "DemuxerTest_testSeekIndex.media";
+  const char* index = "DemuxerTest_testSeekIndex.hvidx";
+  FILE* in = fopen(mSampleFile, "rb");
+  FILE* out = fopen(media, "wb");
+  TS_ASSERT(in && out);
+  char buf[32768];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), in)) > 0)
+    TS_ASSERT_EQUALS(len, fwrite(buf, 1, len, out));
+  fclose(in);
+  fclose(out);
+  (void) remove(index);
+
+  RefPointer<Demuxer> source = Demuxer::make();
+  TS_ASSERT_THROWS(source->buildSeekIndex(), HumbleRuntimeError);
+  source->open(media, 0, false, true, 0, 0);
+  TS_ASSERT(source->loadSeekIndex(index) < 0);
+  int32_t built = source->buildSeekIndex();
+  TS_ASSERT(built > 0);
+  int32_t saved = source->saveSeekIndex(index);
+  TS_ASSERT(saved > 0);
+  // and we are back at the start
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  TS_ASSERT(source->read(pkt.value()) >= 0);
+  TS_ASSERT(pkt->isComplete());
+  TS_ASSERT(pkt->getPosition() < 4096);
+  source->close();
+
+  source = Demuxer::make();
+  source->open(media, 0, false, true, 0, 0);
+  TS_ASSERT_EQUALS(saved, source->loadSeekIndex(index));
+  RefPointer<DemuxerStream> stream = source->getStream(0);
+  TS_ASSERT(stream->getNumIndexEntries() > 0);
+  TS_ASSERT(source->seek(-1, INT64_MIN, source->getDuration()/2, INT64_MAX, 0) >= 0);
+  TS_ASSERT(source->read(pkt.value()) >= 0);
+
+  // an index with a different number of streams is out of date; drop
+  // the last stream from a good one and it must not load.
+  FILE* good = fopen(index, "rb");
+  TS_ASSERT(good);
+  std::vector<unsigned char> data;
+  int c;
+  while ((c = fgetc(good)) != EOF)
+    data.push_back((unsigned char)c);
+  fclose(good);
+  const size_t header = 8 + 4 + 4 + 8 + 8 + 8;
+  int32_t numStreams = data[12] | (data[13] << 8) | (data[14] << 16) | (data[15] << 24);
+  TS_ASSERT(numStreams > 1);
+  size_t offset = header;
+  for(int32_t i = 0; i < numStreams-1 && offset + 12 <= data.size(); i++) {
+    int32_t numEntries = data[offset+8] | (data[offset+9] << 8) |
+        (data[offset+10] << 16) | (data[offset+11] << 24);
+    offset += 12 + numEntries * (8 + 8 + 4 + 4 + 4);
+  }
+  TS_ASSERT(offset < data.size());
+  data.resize(offset);
+  data[12] = (unsigned char)(numStreams-1);
+  const char* fewer = "DemuxerTest_testSeekIndex_fewer.hvidx";
+  FILE* out2 = fopen(fewer, "wb");
+  TS_ASSERT(out2);
+  TS_ASSERT_EQUALS(data.size(), fwrite(&data[0], 1, data.size(), out2));
+  fclose(out2);
+  TS_ASSERT(source->loadSeekIndex(fewer) < 0);
+  (void) remove(fewer);
+
+  // a corrupt stream count is rejected, not allocated
+  FILE* corrupt = fopen(index, "r+b");
+  TS_ASSERT(corrupt);
+  const unsigned char huge[4] = { 0xff, 0xff, 0xff, 0x7f };
+  TS_ASSERT_EQUALS(0, fseek(corrupt, 8 + 4, SEEK_SET));
+  TS_ASSERT_EQUALS(sizeof(huge), fwrite(huge, 1, sizeof(huge), corrupt));
+  fclose(corrupt);
+  TS_ASSERT(source->loadSeekIndex(index) < 0);
+
+  // an index for an older version of the file is ignored
+  struct utimbuf times;
+  times.actime = times.modtime = 1000000000;
+  TS_ASSERT_EQUALS(0, utime(media, &times));
+  TS_ASSERT(source->loadSeekIndex(index) < 0);
+  source->close();
+
+  // nothing to save before open
+  source = Demuxer::make();
+  TS_ASSERT_THROWS(source->saveSeekIndex(0), HumbleRuntimeError);
+  (void) remove(index);
+  (void) remove(media);
+}
+
+void
+DemuxerTest::testProbeCache()
+{
+  Global::setProbeCacheCapacity(4);
+  TS_ASSERT_EQUALS(4, Global::getProbeCacheCapacity());
+  int64_t hits = Global::getProbeCacheHits();
+  int64_t misses = Global::getProbeCacheMisses();
+
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  TS_ASSERT_EQUALS(0, source->getProbeTimeSaved());
+  TS_ASSERT_EQUALS(misses+1, Global::getProbeCacheMisses());
+  int32_t numStreams = source->getNumStreams();
+  int64_t duration = source->getDuration();
+  std::vector<Codec::ID> ids;
+  for(int32_t i = 0; i < numStreams; i++) {
+    RefPointer<DemuxerStream> stream = source->getStream(i);
+    RefPointer<Decoder> decoder = stream->getDecoder();
+    ids.push_back(decoder ? decoder->getCodecID() : Codec::CODEC_ID_NONE);
+  }
+  source->close();
+
+  // the second open is answered from the cache, with the same answers
+  source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  TS_ASSERT_EQUALS(hits+1, Global::getProbeCacheHits());
+  TS_ASSERT(source->getProbeTimeSaved() > 0);
+  TS_ASSERT_EQUALS(numStreams, source->getNumStreams());
+  TS_ASSERT_EQUALS(duration, source->getDuration());
+  for(int32_t i = 0; i < numStreams; i++) {
+    RefPointer<DemuxerStream> stream = source->getStream(i);
+    RefPointer<Decoder> decoder = stream->getDecoder();
+    TS_ASSERT_EQUALS(ids[i], decoder ? decoder->getCodecID() : Codec::CODEC_ID_NONE);
+  }
+  // and the packets still decode
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  TS_ASSERT(source->read(pkt.value()) >= 0);
+  source->close();
+
+  Global::setProbeCacheCapacity(0);
+  TS_ASSERT_EQUALS(0, Global::getProbeCacheCapacity());
+  source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  TS_ASSERT_EQUALS(0, source->getProbeTimeSaved());
+  source->close();
+}
+
+void
+DemuxerTest::testStreamSelection()
+{
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  int32_t numStreams = source->getNumStreams();
+  int32_t audioStream = -1;
+  for(int32_t i = 0; i < numStreams; i++) {
+    TS_ASSERT(source->isStreamSelected(i));
+    RefPointer<DemuxerStream> stream = source->getStream(i);
+    RefPointer<Decoder> decoder = stream->getDecoder();
+    if (decoder && decoder->getCodecType() == MediaDescriptor::MEDIA_AUDIO)
+      audioStream = i;
+  }
+  TS_ASSERT(audioStream >= 0);
+  TS_ASSERT_THROWS(source->isStreamSelected(numStreams), HumbleInvalidArgument);
+  // count from the start of the file; seeking back with every stream
+  // selected lands on a video keyframe and can skip audio before it.
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  int32_t allPackets = 0;
+  int32_t audioPackets = 0;
+  while (source->read(pkt.value()) >= 0)
+    if (pkt->isComplete()) {
+      ++allPackets;
+      if (pkt->getStreamIndex() == audioStream)
+        ++audioPackets;
+    }
+  TS_ASSERT(audioPackets > 0);
+  TS_ASSERT(allPackets > audioPackets);
+
+  TS_ASSERT_EQUALS(1, source->selectStreams(MediaDescriptor::MEDIA_AUDIO));
+  for(int32_t i = 0; i < numStreams; i++)
+    TS_ASSERT_EQUALS(i == audioStream, source->isStreamSelected(i));
+  // only audio comes back now
+  TS_ASSERT_EQUALS(audioPackets, countPackets(source.value(), -1));
+
+  // and selecting the rest again brings their packets back
+  for(int32_t i = 0; i < numStreams; i++)
+    source->setStreamSelected(i, true);
+  TS_ASSERT(countPackets(source.value(), -1) > audioPackets);
+  source->close();
+  TS_ASSERT_THROWS(source->setStreamSelected(0, true), HumbleRuntimeError);
+}
+
+void
+DemuxerTest::testKeyFramesOnly()
+{
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  int32_t numStreams = source->getNumStreams();
+  int32_t videoStream = -1;
+  for(int32_t i = 0; i < numStreams; i++) {
+    TS_ASSERT(!source->isKeyFramesOnly(i));
+    RefPointer<DemuxerStream> stream = source->getStream(i);
+    RefPointer<Decoder> decoder = stream->getDecoder();
+    if (decoder && decoder->getCodecType() == MediaDescriptor::MEDIA_VIDEO)
+      videoStream = i;
+  }
+  TS_ASSERT(videoStream >= 0);
+  int32_t allPackets = countPackets(source.value(), -1);
+  int32_t videoPackets = countPackets(source.value(), videoStream);
+
+  source->setKeyFramesOnly(videoStream, true);
+  TS_ASSERT(source->isKeyFramesOnly(videoStream));
+  TS_ASSERT(source->isStreamSelected(videoStream));
+  TS_ASSERT(source->seek(-1, INT64_MIN, 0, INT64_MAX, 0) >= 0);
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  int32_t keyPackets = 0;
+  int32_t otherPackets = 0;
+  while (source->read(pkt.value()) >= 0) {
+    if (!pkt->isComplete())
+      continue;
+    if (pkt->getStreamIndex() == videoStream) {
+      TS_ASSERT(pkt->isKeyPacket());
+      ++keyPackets;
+    } else
+      ++otherPackets;
+  }
+  TS_ASSERT(keyPackets > 0);
+  TS_ASSERT(keyPackets < videoPackets);
+  // the other streams are left alone
+  TS_ASSERT_EQUALS(allPackets - videoPackets, otherPackets);
+
+  // selecting the stream again returns every packet
+  source->setStreamSelected(videoStream, true);
+  TS_ASSERT(!source->isKeyFramesOnly(videoStream));
+  TS_ASSERT_EQUALS(videoPackets, countPackets(source.value(), videoStream));
+  source->close();
+  TS_ASSERT_THROWS(source->setKeyFramesOnly(videoStream, true), HumbleRuntimeError);
+}
+
+int32_t
+DemuxerTest::countPackets(Demuxer* source, int32_t streamIndex)
+{
+  TS_ASSERT(source->seek(-1, INT64_MIN, 0, INT64_MAX, 0) >= 0);
+  RefPointer<MediaPacket> pkt = MediaPacket::make();
+  int32_t retval = 0;
+  while (source->read(pkt.value()) >= 0)
+    if (pkt->isComplete() &&
+        (streamIndex < 0 || pkt->getStreamIndex() == streamIndex))
+      ++retval;
+  return retval;
+}
+
+void
+DemuxerTest::benchmarkAudioOnly(const char* file)
+{
+  int64_t times[2];
+  int32_t packets[2];
+  for(int32_t audioOnly = 0; audioOnly < 2; audioOnly++) {
+    RefPointer<Demuxer> source = Demuxer::make();
+    source->open(file, 0, false, true, 0, 0);
+    if (audioOnly)
+      TS_ASSERT(source->selectStreams(MediaDescriptor::MEDIA_AUDIO) > 0);
+    RefPointer<MediaPacket> pkt = MediaPacket::make();
+    packets[audioOnly] = 0;
+    int64_t start = VS_TestGetTimeMicros();
+    while (source->read(pkt.value()) >= 0)
+      if (pkt->isComplete())
+        ++packets[audioOnly];
+    times[audioOnly] = VS_TestGetTimeMicros() - start;
+    source->close();
+  }
+  TS_ASSERT(packets[1] < packets[0]);
+  VS_LOG_INFO("%s: all streams %d packets in %" PRIi64 " us; audio only %d packets in %" PRIi64 " us",
+      file, packets[0], times[0], packets[1], times[1]);
+}
+
+void
+DemuxerTest::testBenchmarkAudioOnly()
+{
+  benchmarkAudioOnly(mSampleFile);
+  // Point this at a long movie to see the difference; the fixture is
+  // small enough that it sits in the page cache.
+  const char* large = getenv("VS_TEST_LARGE_FILE");
+  if (large && *large)
+    benchmarkAudioOnly(large);
+}
+
+void
+DemuxerTest::testIOStatistics()
+{
+  IOStatistics::resetTunedBufferLengths();
+  RefPointer<Demuxer> source = Demuxer::make();
+  TS_ASSERT(!source->getIOStatistics());
+  source->setIOInstrumented(true);
+  TS_ASSERT(source->isIOInstrumented());
+  // a plain file, so this counts FFmpeg's own file protocol
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  TS_ASSERT_THROWS(source->setIOInstrumented(false), HumbleRuntimeError);
+  int32_t numPackets = countPackets(source.value(), -1);
+  TS_ASSERT(numPackets > 0);
+
+  RefPointer<IOStatistics> stats = source->getIOStatistics();
+  TS_ASSERT(stats);
+  TS_ASSERT_EQUALS(2048, stats->getBufferLength());
+  TS_ASSERT(stats->getBytesRead() > 0);
+  TS_ASSERT_EQUALS(0, stats->getBytesWritten());
+  TS_ASSERT(stats->getCalls(IOStatistics::READ) > 0);
+  TS_ASSERT_EQUALS(0, stats->getErrors(IOStatistics::READ));
+  int64_t bucketed = 0;
+  for(int32_t i = 0; i < IOStatistics::getNumLatencyBuckets(); i++)
+    bucketed += stats->getLatencyCount(IOStatistics::READ, i);
+  TS_ASSERT_EQUALS(stats->getCalls(IOStatistics::READ), bucketed);
+  TS_ASSERT_EQUALS(0, IOStatistics::getLatencyBucketStart(0));
+  TS_ASSERT_EQUALS(2, IOStatistics::getLatencyBucketStart(1));
+  TS_ASSERT_EQUALS(-1, IOStatistics::getLatencyBucketStart(
+      IOStatistics::getNumLatencyBuckets()));
+  source->close();
+
+  // the totals outlive the close
+  RefPointer<IOStatistics> closed = source->getIOStatistics();
+  TS_ASSERT(closed);
+  TS_ASSERT(closed->getBytesRead() >= stats->getBytesRead());
+
+  // and the next instrumented Demuxer in the same directory reads in
+  // bigger pieces, unless told otherwise
+  source = Demuxer::make();
+  source->setIOInstrumented(true);
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  TS_ASSERT(source->getInputBufferLength() > 2048);
+  TS_ASSERT_EQUALS(numPackets, countPackets(source.value(), -1));
+  source->close();
+  source = Demuxer::make();
+  source->setIOInstrumented(true);
+  source->setInputBufferLength(4096);
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  TS_ASSERT_EQUALS(4096, source->getInputBufferLength());
+  source->close();
+
+  // the protocol's own options still reach it, and are not reported unset
+  source = Demuxer::make();
+  source->setIOInstrumented(true);
+  RefPointer<KeyValueBag> options = KeyValueBag::make();
+  RefPointer<KeyValueBag> optionsNotSet = KeyValueBag::make();
+  options->setValue("blocksize", "512");
+  options->setValue("not-a-valid-option", "1");
+  source->open(mSampleFile, 0, false, true, options.value(),
+      optionsNotSet.value());
+  TS_ASSERT_EQUALS(1, optionsNotSet->getNumKeys());
+  TS_ASSERT(optionsNotSet->getValue("not-a-valid-option", KeyValueBag::KVB_NONE));
+  TS_ASSERT_EQUALS(numPackets, countPackets(source.value(), -1));
+  source->close();
+  IOStatistics::resetTunedBufferLengths();
+
+  // and only URLs FFmpeg would open through a protocol get wrapped
+  TS_ASSERT(FfmpegURLProtocolHandler::isAvioURL(mSampleFile, 0));
+  TS_ASSERT(!FfmpegURLProtocolHandler::isAvioURL("rtsp://127.0.0.1/stream", 0));
+  TS_ASSERT(!FfmpegURLProtocolHandler::isAvioURL("frame%03d.png", 0));
+  TS_ASSERT(!FfmpegURLProtocolHandler::isAvioURL("nosuchprotocol://media", 0));
+}
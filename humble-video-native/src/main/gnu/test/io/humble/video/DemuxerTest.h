@@ -45,8 +45,18 @@ public:
   void testOpenWithoutCloseAutoCloses();
   void testOpenInvalidArguments();
   void testRead();
+  void testReadAhead();
+  void testReadBatch();
+  void testSeekIndex();
+  void testProbeCache();
+  void testStreamSelection();
+  void testKeyFramesOnly();
+  void testBenchmarkAudioOnly();
+  void testIOStatistics();
 private:
   void openTestHelper(const char* url);
+  int32_t countPackets(io::humble::video::Demuxer* source, int32_t streamIndex);
+  void benchmarkAudioOnly(const char* file);
   char mSampleFile[2048];
   TestData mFixtures;
   TestData::Fixture* mFixture;
@@ -23,11 +23,16 @@
  *      Author: aclarke
  */
 
+#include <vector>
+
 #include "MuxerTest.h"
 #include <io/humble/ferry/Logger.h>
 
 #include <io/humble/video/Demuxer.h>
 #include <io/humble/video/Decoder.h>
+#include <io/humble/video/MediaAudio.h>
+#include <io/humble/video/MediaPicture.h>
+#include <io/humble/video/RationalImpl.h>
 #include <io/humble/video/MediaPacket.h>
 #include <io/humble/video/BitStreamFilter.h>
 
@@ -163,3 +168,80 @@ MuxerTest::testHLSRemuxing() {
   muxer->close();
   demuxer->close();
 }
+
+void
+MuxerTest::testSteadyStateAllocatesNoRationals() {
+  // demux, decode and remux a file, and check that once every stream has
+  // been seen no packet or frame makes a new Rational.
+  RefPointer<Muxer> muxer = Muxer::make("MuxerTest_testSteadyStateAllocatesNoRationals.mp4", 0, 0);
+
+  TestData::Fixture* fixture=mFixtures.getFixture("ucl_h264_aac.mp4");
+  TS_ASSERT(fixture);
+  char filepath[2048];
+  mFixtures.fillPath(fixture, filepath, sizeof(filepath));
+
+  RefPointer<Demuxer> demuxer = Demuxer::make();
+  demuxer->open(filepath, 0, false, true, 0, 0);
+
+  int32_t n = demuxer->getNumStreams();
+  std::vector<RefPointer<Decoder> > decoders(n);
+  RefPointer<MediaAudio> audio;
+  RefPointer<MediaPicture> picture;
+  for(int i = 0; i < n; i++) {
+    RefPointer<DemuxerStream> demuxerStream = demuxer->getStream(i);
+    RefPointer<Decoder> d = demuxerStream->getDecoder();
+    RefPointer<MuxerStream> muxerStream = muxer->addNewStream(d.value());
+    // decode with a copy so the muxer's stream is untouched
+    decoders[i] = Decoder::make(d.value());
+    decoders[i]->open(0, 0);
+    if (d->getCodecType() == MediaDescriptor::MEDIA_AUDIO)
+      audio = MediaAudio::make(decoders[i]->getFrameSize(),
+          decoders[i]->getSampleRate(),
+          decoders[i]->getChannels(),
+          decoders[i]->getChannelLayout(),
+          decoders[i]->getSampleFormat());
+    else if (d->getCodecType() == MediaDescriptor::MEDIA_VIDEO)
+      picture = MediaPicture::make(decoders[i]->getWidth(),
+          decoders[i]->getHeight(),
+          decoders[i]->getPixelFormat());
+  }
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+
+  muxer->open(0, 0);
+  const int32_t warmUpPackets = 50;
+  int32_t packetNo = 0;
+  int64_t allocated = 0;
+  bool isMemcheck = getenv("VS_TEST_MEMCHECK");
+  while(demuxer->read(packet.value()) >= 0) {
+    if (packetNo == warmUpPackets)
+      allocated = RationalImpl::getNumAllocated();
+    int32_t i = packet->getStreamIndex();
+    if (packet->isComplete() && i >= 0 && i < n) {
+      MediaDescriptor::Type type = decoders[i]->getCodecType();
+      int32_t offset = 0;
+      while(offset < packet->getSize()) {
+        int32_t bytesRead = 0;
+        if (type == MediaDescriptor::MEDIA_AUDIO && audio)
+          bytesRead = decoders[i]->decodeAudio(audio.value(), packet.value(), offset);
+        else if (type == MediaDescriptor::MEDIA_VIDEO && picture)
+          bytesRead = decoders[i]->decodeVideo(picture.value(), packet.value(), offset);
+        else
+          break;
+        if (bytesRead <= 0)
+          break;
+        offset += bytesRead;
+      }
+    }
+    muxer->write(packet.value(), false);
+    ++packetNo;
+    if (isMemcheck && packetNo > warmUpPackets + 10) {
+      VS_LOG_DEBUG("Cutting short when running under valgrind");
+      break;
+    }
+  }
+  TS_ASSERT(packetNo > warmUpPackets);
+  TSM_ASSERT_EQUALS("Rationals allocated after warm-up",
+      RationalImpl::getNumAllocated(), allocated);
+  muxer->close();
+  demuxer->close();
+}
@@ -43,6 +43,7 @@ public:
   void testCreation();
   void testRemuxing();
   void testHLSRemuxing();
+  void testSteadyStateAllocatesNoRationals();
 private:
   TestData mFixtures;
 };
@@ -20,6 +20,7 @@
 #include <cmath>
 
 #include <io/humble/video/Global.h>
+#include <io/humble/video/RationalImpl.h>
 #include "RationalTest.h"
 
 using namespace io::humble::ferry;
@@ -178,3 +179,40 @@ RationalTest :: testRescaling()
   TSM_ASSERT_EQUALS("", a->rescale(1, b.value()), 20);
   TSM_ASSERT_EQUALS("", b->rescale(1, a.value()), 0);
 }
+
+void
+RationalTest :: testInterning()
+{
+  RefPointer<Rational> a = RationalImpl::intern(1, 90000);
+  TS_ASSERT(a);
+  TS_ASSERT_EQUALS(a->getNumerator(), 1);
+  TS_ASSERT_EQUALS(a->getDenominator(), 90000);
+
+  // reduced the same way make() reduces, and shared
+  RefPointer<Rational> b = RationalImpl::intern(2, 180000);
+  TS_ASSERT_EQUALS(a.value(), b.value());
+
+  RefPointer<Rational> c = RationalImpl::intern(1, 44100);
+  TS_ASSERT_DIFFERS(a.value(), c.value());
+  TS_ASSERT_EQUALS(c->getDenominator(), 44100);
+
+  // once interned, asking again makes nothing
+  int64_t allocated = RationalImpl::getNumAllocated();
+  for(int32_t i = 0; i < 1000; i++) {
+    RefPointer<Rational> d = RationalImpl::intern(1, 90000);
+    RefPointer<Rational> e = RationalImpl::intern(1, 44100);
+  }
+  TS_ASSERT_EQUALS(allocated, RationalImpl::getNumAllocated());
+
+  // but make() still hands out new objects
+  num = Rational::make(1, 90000);
+  TS_ASSERT_DIFFERS(num.value(), a.value());
+  TS_ASSERT_EQUALS(allocated + 1, RationalImpl::getNumAllocated());
+
+  // and nobody can change a shared one
+  a->reduce(1, 25, 25);
+  TS_ASSERT_EQUALS(b->getNumerator(), 1);
+  TS_ASSERT_EQUALS(b->getDenominator(), 90000);
+  a->setNumerator(5);
+  TS_ASSERT_EQUALS(b->getNumerator(), 1);
+}
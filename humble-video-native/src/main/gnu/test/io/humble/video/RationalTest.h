@@ -38,6 +38,7 @@ class RationalTest : public CxxTest::TestSuite
     void testDivision();
     void testConstructionFromNumeratorAndDenominatorPair();
     void testRescaling();
+    void testInterning();
   private:
     io::humble::ferry::RefPointer<Rational> num;
 };
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstdlib>
+
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/ferry/RefPointer.h>
+#include <io/humble/video/Thumbnailer.h>
+#include <io/humble/video/DemuxerStream.h>
+#include <io/humble/video/Global.h>
+#include "ThumbnailerTest.h"
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+using namespace io::humble::ferry;
+using namespace io::humble::video;
+
+ThumbnailerTest::ThumbnailerTest() {
+  mSampleFile[0] = 0;
+  mFixture = mFixtures.getFixture("ucl_h264_aac.mp4");
+  TSM_ASSERT("Missing fixture", mFixture);
+  mFixtures.fillPath(mFixture, mSampleFile, sizeof(mSampleFile));
+}
+
+ThumbnailerTest::~ThumbnailerTest() {
+}
+
+void
+ThumbnailerTest::testMake() {
+  TS_ASSERT_THROWS(Thumbnailer::make(0, -1), HumbleInvalidArgument);
+  RefPointer<Demuxer> source = Demuxer::make();
+  // not open yet
+  TS_ASSERT_THROWS(Thumbnailer::make(source.value(), -1), HumbleRuntimeError);
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  int32_t numStreams = source->getNumStreams();
+  TS_ASSERT_THROWS(Thumbnailer::make(source.value(), numStreams),
+      HumbleInvalidArgument);
+
+  RefPointer<Thumbnailer> thumbnailer = Thumbnailer::make(source.value(), -1);
+  int32_t streamIndex = thumbnailer->getStreamIndex();
+  TS_ASSERT(streamIndex >= 0 && streamIndex < numStreams);
+  RefPointer<Decoder> decoder = thumbnailer->getDecoder();
+  TS_ASSERT_EQUALS(MediaDescriptor::MEDIA_VIDEO, decoder->getCodecType());
+  TS_ASSERT_EQUALS(Decoder::DISCARD_NONKEY, decoder->getSkipFrame());
+  RefPointer<Demuxer> demuxer = thumbnailer->getDemuxer();
+  TS_ASSERT_EQUALS(source.value(), demuxer.value());
+  for(int32_t i = 0; i < numStreams; i++) {
+    TS_ASSERT_EQUALS(i == streamIndex, source->isStreamSelected(i));
+    TS_ASSERT_EQUALS(i == streamIndex, source->isKeyFramesOnly(i));
+    // only the video stream can be thumbnailed
+    if (i != streamIndex)
+      TS_ASSERT_THROWS(Thumbnailer::make(source.value(), i),
+          HumbleInvalidArgument);
+  }
+  TS_ASSERT_EQUALS(0, thumbnailer->getNumThumbnails());
+  TS_ASSERT_THROWS(thumbnailer->getThumbnail(0), HumbleInvalidArgument);
+  source->close();
+}
+
+void
+ThumbnailerTest::testGetKeyFrame() {
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  RefPointer<Thumbnailer> thumbnailer = Thumbnailer::make(source.value(), -1);
+  RefPointer<Decoder> decoder = thumbnailer->getDecoder();
+  TS_ASSERT_EQUALS(Coder::STATE_INITED, decoder->getState());
+
+  RefPointer<MediaPicture> picture = thumbnailer->getKeyFrame(0);
+  TS_ASSERT(picture);
+  TS_ASSERT_EQUALS(Coder::STATE_OPENED, decoder->getState());
+  TS_ASSERT(picture->isComplete());
+  TS_ASSERT_EQUALS(decoder->getWidth(), picture->getWidth());
+  TS_ASSERT_EQUALS(decoder->getHeight(), picture->getHeight());
+
+  // the same key frame comes back from just after it
+  RefPointer<MediaPicture> again = thumbnailer->getKeyFrame(1);
+  TS_ASSERT(again);
+  TS_ASSERT_EQUALS(picture->getTimeStamp(), again->getTimeStamp());
+  source->close();
+}
+
+void
+ThumbnailerTest::testRun() {
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(mSampleFile, 0, false, true, 0, 0);
+  RefPointer<Thumbnailer> thumbnailer = Thumbnailer::make(source.value(), -1);
+  TS_ASSERT_THROWS(thumbnailer->run(0), HumbleInvalidArgument);
+
+  const int32_t count = 5;
+  int32_t made = thumbnailer->run(count);
+  TS_ASSERT(made > 1);
+  TS_ASSERT(made <= count);
+  TS_ASSERT_EQUALS(made, thumbnailer->getNumThumbnails());
+  int64_t last = Global::NO_PTS;
+  for(int32_t i = 0; i < made; i++) {
+    RefPointer<MediaPicture> picture = thumbnailer->getThumbnail(i);
+    TS_ASSERT(picture->isComplete());
+    // each thumbnail is from a later key frame than the one before
+    if (i > 0)
+      TS_ASSERT(picture->getTimeStamp() > last);
+    last = picture->getTimeStamp();
+  }
+  TS_ASSERT_THROWS(thumbnailer->getThumbnail(made), HumbleInvalidArgument);
+
+  // a second run replaces the first
+  TS_ASSERT_EQUALS(1, thumbnailer->run(1));
+  TS_ASSERT_EQUALS(1, thumbnailer->getNumThumbnails());
+  source->close();
+}
+
+int32_t
+ThumbnailerTest::decodeEverything(const char* file, int32_t count,
+    int64_t* micros)
+{
+  int64_t start = VS_TestGetTimeMicros();
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(file, 0, false, true, 0, 0);
+  TS_ASSERT(source->selectStreams(MediaDescriptor::MEDIA_VIDEO) > 0);
+  int32_t streamIndex = 0;
+  while (!source->isStreamSelected(streamIndex))
+    ++streamIndex;
+  RefPointer<DemuxerStream> stream = source->getStream(streamIndex);
+  RefPointer<Rational> streamBase = stream->getTimeBase();
+  int64_t first = stream->getStartTime();
+  if (first == Global::NO_PTS)
+    first = 0;
+  int64_t duration = stream->getDuration();
+  TS_ASSERT(duration > 0);
+  RefPointer<Decoder> decoder = stream->getDecoder();
+  decoder->open(0, 0);
+
+  // keep a copy of the first picture at or after the middle of each part
+  RefPointer<MediaPacket> packet = MediaPacket::make();
+  RefPointer<MediaPicture> picture = MediaPicture::make(
+      decoder->getWidth(),
+      decoder->getHeight(),
+      decoder->getPixelFormat());
+  int32_t kept = 0;
+  bool reading = true;
+  do {
+    if (reading) {
+      reading = source->read(packet.value()) >= 0;
+      if (reading &&
+          (packet->getStreamIndex() != streamIndex || !packet->isComplete()))
+        continue;
+    }
+    decoder->decodeVideo(picture.value(), reading ? packet.value() : 0, 0);
+    if (!picture->isComplete() || kept >= count)
+      continue;
+    RefPointer<Rational> base = picture->getTimeBase();
+    int64_t ts = base ? streamBase->rescale(picture->getTimeStamp(),
+        base.value()) : picture->getTimeStamp();
+    if (ts >= first + duration * (2*kept+1) / (2*count)) {
+      RefPointer<MediaPicture> copy = MediaPicture::make(picture.value(), true);
+      ++kept;
+    }
+  } while (reading || picture->isComplete());
+  source->close();
+  *micros = VS_TestGetTimeMicros() - start;
+  return kept;
+}
+
+void
+ThumbnailerTest::benchmarkThumbnails(const char* file, int32_t count)
+{
+  int64_t naiveMicros = 0;
+  int32_t naive = decodeEverything(file, count, &naiveMicros);
+
+  int64_t start = VS_TestGetTimeMicros();
+  RefPointer<Demuxer> source = Demuxer::make();
+  source->open(file, 0, false, true, 0, 0);
+  RefPointer<Thumbnailer> thumbnailer = Thumbnailer::make(source.value(), -1);
+  int32_t made = thumbnailer->run(count);
+  source->close();
+  int64_t micros = VS_TestGetTimeMicros() - start;
+
+  VS_LOG_INFO("%s: %d thumbnails; decoding everything %d in %" PRIi64 " us; key frames only %d in %" PRIi64 " us",
+      file, count, naive, naiveMicros, made, micros);
+  TS_ASSERT(naive > 0);
+  TS_ASSERT(made > 0);
+}
+
+void
+ThumbnailerTest::testBenchmarkThumbnails()
+{
+  benchmarkThumbnails(mSampleFile, 10);
+  // The fixture is short and small; point this at a long HD movie to see
+  // what skipping all but a few key frames saves.
+  const char* large = getenv("VS_TEST_LARGE_FILE");
+  if (large && *large)
+    benchmarkThumbnails(large, 10);
+}
@@ -0,0 +1,201 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#include "InstrumentedURLProtocolHandlerTest.h"
+
+#include <io/humble/video/customio/StdioURLProtocolManager.h>
+
+using namespace io::humble::video::customio;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+// the size of ucl_h264_aac.mp4
+static const int64_t SAMPLE_FILE_SIZE=762612;
+
+InstrumentedURLProtocolHandlerTest :: InstrumentedURLProtocolHandlerTest()
+{
+     char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+     if (fixtureDirectory)
+       snprintf(mFixtureDir, sizeof(mFixtureDir), "%s", fixtureDirectory);
+     else {
+       TSM_ASSERT("no fixture dir", false);
+       throw new std::runtime_error("Must define environment variable VS_TEST_FIXTUREDIR");
+     }
+     // the whole URL, as a Demuxer would open it
+     snprintf(mSampleFile, sizeof(mSampleFile), "stdio:%s/%s", mFixtureDir, "ucl_h264_aac.mp4");
+}
+
+InstrumentedURLProtocolHandlerTest :: ~InstrumentedURLProtocolHandlerTest()
+{
+}
+
+void
+InstrumentedURLProtocolHandlerTest :: setUp()
+{
+  StdioURLProtocolManager::registerProtocol("stdio");
+  InstrumentedURLProtocolHandler::resetTunedBufferLengths();
+}
+
+void
+InstrumentedURLProtocolHandlerTest :: tearDown()
+{
+  URLProtocolManager::unregisterAllProtocols();
+  InstrumentedURLProtocolHandler::resetTunedBufferLengths();
+}
+
+InstrumentedURLProtocolHandler*
+InstrumentedURLProtocolHandlerTest :: makeHandler()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  TSM_ASSERT("", handler);
+  return new InstrumentedURLProtocolHandler(handler);
+}
+
+int64_t
+InstrumentedURLProtocolHandlerTest :: readAll(URLProtocolHandler* handler,
+    int size, int64_t seekEvery)
+{
+  std::vector<unsigned char> buf(size);
+  int64_t total = 0;
+  int64_t sinceSeek = 0;
+  int retval;
+  while ((retval = handler->url_read(&buf[0], size)) > 0)
+  {
+    total += retval;
+    sinceSeek += retval;
+    if (seekEvery > 0 && sinceSeek >= seekEvery)
+    {
+      // a jump that lands where we already were still counts
+      handler->url_seek(total, URLProtocolHandler::SK_SEEK_SET);
+      sinceSeek = 0;
+    }
+  }
+  return total;
+}
+
+void
+InstrumentedURLProtocolHandlerTest :: testReadCounts()
+{
+  InstrumentedURLProtocolHandler* handler = makeHandler();
+  TS_ASSERT_EQUALS(0, handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(SAMPLE_FILE_SIZE, readAll(handler, 32768, 0));
+  TS_ASSERT_EQUALS(0, handler->url_close());
+
+  TS_ASSERT_EQUALS(SAMPLE_FILE_SIZE, handler->getBytesRead());
+  TS_ASSERT_EQUALS(0, handler->getBytesWritten());
+  // every full buffer, the short one at the end, and end of file
+  TS_ASSERT_EQUALS((SAMPLE_FILE_SIZE+32767)/32768+1,
+      handler->getCalls(InstrumentedURLProtocolHandler::OP_READ));
+  TS_ASSERT_EQUALS(0, handler->getCalls(InstrumentedURLProtocolHandler::OP_WRITE));
+  TS_ASSERT_EQUALS(0, handler->getCalls(InstrumentedURLProtocolHandler::OP_SEEK));
+  TS_ASSERT_EQUALS(0, handler->getErrors(InstrumentedURLProtocolHandler::OP_READ));
+
+  // every call lands in exactly one bucket
+  int64_t bucketed = 0;
+  for(int32_t i = 0; i < InstrumentedURLProtocolHandler::NUM_LATENCY_BUCKETS; i++)
+    bucketed += handler->getLatencyCount(InstrumentedURLProtocolHandler::OP_READ, i);
+  TS_ASSERT_EQUALS(handler->getCalls(InstrumentedURLProtocolHandler::OP_READ), bucketed);
+  TS_ASSERT(handler->getTotalLatency(InstrumentedURLProtocolHandler::OP_READ) >= 0);
+  TS_ASSERT_EQUALS(0, handler->getLatencyCount(InstrumentedURLProtocolHandler::OP_READ, -1));
+  TS_ASSERT_EQUALS(0, handler->getLatencyCount(InstrumentedURLProtocolHandler::OP_READ,
+      InstrumentedURLProtocolHandler::NUM_LATENCY_BUCKETS));
+  delete handler;
+}
+
+void
+InstrumentedURLProtocolHandlerTest :: testSeekCounts()
+{
+  InstrumentedURLProtocolHandler* handler = makeHandler();
+  TS_ASSERT_EQUALS(0, handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(1000, handler->url_seek(1000, URLProtocolHandler::SK_SEEK_SET));
+  unsigned char buf[100];
+  TS_ASSERT_EQUALS(100, handler->url_read(buf, sizeof(buf)));
+  TS_ASSERT_EQUALS(500, handler->url_seek(500, URLProtocolHandler::SK_SEEK_SET));
+  // asking for the size is not a seek
+  TS_ASSERT_EQUALS(SAMPLE_FILE_SIZE, handler->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE));
+  TS_ASSERT_EQUALS(2, handler->getCalls(InstrumentedURLProtocolHandler::OP_SEEK));
+  TS_ASSERT_EQUALS(1000+600, handler->getSeekDistance());
+  TS_ASSERT_EQUALS(0, handler->url_close());
+  delete handler;
+}
+
+void
+InstrumentedURLProtocolHandlerTest :: testErrorCounts()
+{
+  InstrumentedURLProtocolHandler* handler = makeHandler();
+  unsigned char buf[100];
+  // nothing is open yet
+  TS_ASSERT(handler->url_read(buf, sizeof(buf)) < 0);
+  TS_ASSERT_EQUALS(1, handler->getErrors(InstrumentedURLProtocolHandler::OP_READ));
+  TS_ASSERT_EQUALS(0, handler->getCalls(InstrumentedURLProtocolHandler::OP_READ));
+  TS_ASSERT(handler->url_open("stdio:/this/file/does/not/exist",
+      URLProtocolHandler::URL_RDONLY_MODE) < 0);
+  TS_ASSERT(handler->url_close() < 0);
+  delete handler;
+}
+
+void
+InstrumentedURLProtocolHandlerTest :: testTuning()
+{
+  // another file next to the sample
+  char neighbour[2048];
+  snprintf(neighbour, sizeof(neighbour), "stdio:%s/other", mFixtureDir);
+  TS_ASSERT_EQUALS(2048, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      neighbour, URLProtocolHandler::URL_RDONLY_MODE, 2048));
+
+  // one long sequential read: an eighth of the file, rounded down
+  InstrumentedURLProtocolHandler* handler = makeHandler();
+  TS_ASSERT_EQUALS(0, handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(SAMPLE_FILE_SIZE, readAll(handler, 4096, 0));
+  TS_ASSERT_EQUALS(0, handler->url_close());
+  delete handler;
+  TS_ASSERT_EQUALS(65536, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      neighbour, URLProtocolHandler::URL_RDONLY_MODE, 2048));
+  // but only for reading that protocol in that directory
+  TS_ASSERT_EQUALS(2048, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      neighbour, URLProtocolHandler::URL_WRONLY_MODE, 2048));
+  TS_ASSERT_EQUALS(2048, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      "stdio:/somewhere/else/other", URLProtocolHandler::URL_RDONLY_MODE, 2048));
+  TS_ASSERT_EQUALS(2048, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      "/a/local/file", URLProtocolHandler::URL_RDONLY_MODE, 2048));
+  TS_ASSERT_EQUALS(2048, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      "C:\\a\\local\\file", URLProtocolHandler::URL_RDONLY_MODE, 2048));
+
+  // a seek every 8 KiB asks for the smallest buffer, but one file only
+  // moves it by half
+  handler = makeHandler();
+  TS_ASSERT_EQUALS(0, handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(SAMPLE_FILE_SIZE, readAll(handler, 4096, 8192));
+  TS_ASSERT_EQUALS(0, handler->url_close());
+  delete handler;
+  TS_ASSERT_EQUALS(32768, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      neighbour, URLProtocolHandler::URL_RDONLY_MODE, 2048));
+
+  // a handler that hardly did anything teaches nothing
+  handler = makeHandler();
+  TS_ASSERT_EQUALS(0, handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(0, handler->url_close());
+  delete handler;
+  TS_ASSERT_EQUALS(32768, InstrumentedURLProtocolHandler::getTunedBufferLength(
+      neighbour, URLProtocolHandler::URL_RDONLY_MODE, 2048));
+}
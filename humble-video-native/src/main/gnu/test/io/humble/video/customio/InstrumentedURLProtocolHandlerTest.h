@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef INSTRUMENTEDURLPROTOCOLHANDLERTEST_H_
+#define INSTRUMENTEDURLPROTOCOLHANDLERTEST_H_
+
+#include <io/humble/testutils/TestUtils.h>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/video/customio/InstrumentedURLProtocolHandler.h>
+
+using namespace io::humble::video::customio;
+
+class InstrumentedURLProtocolHandlerTest: public CxxTest::TestSuite
+{
+public:
+  InstrumentedURLProtocolHandlerTest();
+  virtual
+  ~InstrumentedURLProtocolHandlerTest();
+  void setUp();
+  void tearDown();
+  void testReadCounts();
+  void testSeekCounts();
+  void testErrorCounts();
+  void testTuning();
+private:
+  InstrumentedURLProtocolHandler* makeHandler();
+  int64_t readAll(URLProtocolHandler* handler, int size, int64_t seekEvery);
+  char mFixtureDir[1024];
+  char mSampleFile[1024];
+};
+
+#endif /* INSTRUMENTEDURLPROTOCOLHANDLERTEST_H_ */
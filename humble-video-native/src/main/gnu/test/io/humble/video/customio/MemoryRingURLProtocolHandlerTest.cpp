@@ -0,0 +1,270 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+
+#include "MemoryRingURLProtocolHandlerTest.h"
+
+#include <io/humble/ferry/RefPointer.h>
+
+using namespace io::humble::ferry;
+using namespace io::humble::video::customio;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+// What the producer thread in testProducerThread writes.
+static const int32_t PRODUCED_BYTES=1024*1024+17;
+
+static unsigned char
+pattern(int64_t i)
+{
+  return (unsigned char)((i * 31) ^ (i >> 9));
+}
+
+static void*
+produce(void* arg)
+{
+  URLProtocolHandler* writer = (URLProtocolHandler*)arg;
+  unsigned char buf[1000];
+  int64_t written = 0;
+  while (written < PRODUCED_BYTES)
+  {
+    int32_t len = PRODUCED_BYTES - written < (int64_t)sizeof(buf) ?
+        (int32_t)(PRODUCED_BYTES - written) : (int32_t)sizeof(buf);
+    for(int32_t i = 0; i < len; i++)
+      buf[i] = pattern(written + i);
+    int32_t retval = writer->url_write(buf, len);
+    if (retval != len)
+      break;
+    written += len;
+  }
+  writer->url_close();
+  return 0;
+}
+
+MemoryRingURLProtocolHandlerTest :: MemoryRingURLProtocolHandlerTest()
+{
+}
+
+MemoryRingURLProtocolHandlerTest :: ~MemoryRingURLProtocolHandlerTest()
+{
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: setUp()
+{
+  // the smallest ring, so the tests wrap around and fill it often
+  MemoryRingURLProtocolManager::registerProtocol("memring", 4096, true);
+  MemoryRingURLProtocolManager::registerProtocol("memringnb", 4096, false);
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: tearDown()
+{
+  URLProtocolManager::unregisterAllProtocols();
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testCreation()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("memring:foo", 0,0);
+  TSM_ASSERT("", handler);
+  TS_ASSERT(dynamic_cast<MemoryRingURLProtocolHandler*>(handler));
+  TSM_ASSERT_EQUALS("", URLProtocolHandler::SK_NOT_SEEKABLE,
+      handler->url_seekflags("memring:foo", 0));
+  delete handler;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testOpenClose()
+{
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memring:foo", 0,0);
+  URLProtocolHandler* writer = URLProtocolManager::findHandler("memring:foo", 0,0);
+  URLProtocolHandler* other = URLProtocolManager::findHandler("memring:foo", 0,0);
+
+  TS_ASSERT_EQUALS(0, reader->url_open("memring:foo", URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(0, writer->url_open("memring:foo", URLProtocolHandler::URL_WRONLY_MODE));
+  // one of each per ring
+  TS_ASSERT_EQUALS(-EBUSY, other->url_open("memring:foo", URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(-EBUSY, other->url_open("memring:foo", URLProtocolHandler::URL_WRONLY_MODE));
+  // but another name is another ring
+  TS_ASSERT_EQUALS(0, other->url_open("memring:bar", URLProtocolHandler::URL_WRONLY_MODE));
+  TS_ASSERT(reader->url_seek(0, URLProtocolHandler::SK_SEEK_SET) < 0);
+  // each end only goes one way
+  unsigned char buf[16];
+  TS_ASSERT(reader->url_write(buf, sizeof(buf)) < 0);
+  TS_ASSERT(writer->url_read(buf, sizeof(buf)) < 0);
+
+  TS_ASSERT_EQUALS(0, writer->url_close());
+  TS_ASSERT(writer->url_close() < 0);
+  TS_ASSERT_EQUALS(0, reader->url_close());
+  // both ends closed, so the name is free again
+  TS_ASSERT_EQUALS(0, reader->url_open("memring:foo", URLProtocolHandler::URL_RDONLY_MODE));
+  delete reader;
+  delete writer;
+  // deleting an open handler closes it
+  delete other;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testEndOfStream()
+{
+  URLProtocolHandler* writer = URLProtocolManager::findHandler("memring:eos", 0,0);
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memring:eos", 0,0);
+  // the producer may start first
+  TS_ASSERT_EQUALS(0, writer->url_open("memring:eos", URLProtocolHandler::URL_WRONLY_MODE));
+  TS_ASSERT_EQUALS(5, writer->url_write((const unsigned char*)"hello", 5));
+  TS_ASSERT_EQUALS(0, writer->url_close());
+
+  TS_ASSERT_EQUALS(0, reader->url_open("memring:eos", URLProtocolHandler::URL_RDONLY_MODE));
+  unsigned char buf[16];
+  TS_ASSERT_EQUALS(3, reader->url_read(buf, 3));
+  TS_ASSERT_EQUALS(0, memcmp(buf, "hel", 3));
+  TS_ASSERT_EQUALS(2, reader->url_read(buf, sizeof(buf)));
+  TS_ASSERT_EQUALS(0, memcmp(buf, "lo", 2));
+  // and then end of file, every time
+  TS_ASSERT_EQUALS(0, reader->url_read(buf, sizeof(buf)));
+  TS_ASSERT_EQUALS(0, reader->url_read(buf, sizeof(buf)));
+  delete reader;
+  delete writer;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testNonBlocking()
+{
+  URLProtocolHandler* writer = URLProtocolManager::findHandler("memringnb:x", 0,0);
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memringnb:x", 0,0);
+  TS_ASSERT_EQUALS(0, writer->url_open("memringnb:x", URLProtocolHandler::URL_WRONLY_MODE));
+  TS_ASSERT_EQUALS(0, reader->url_open("memringnb:x", URLProtocolHandler::URL_RDONLY_MODE));
+
+  unsigned char buf[5000];
+  memset(buf, 7, sizeof(buf));
+  TS_ASSERT_EQUALS(-EAGAIN, reader->url_read(buf, sizeof(buf)));
+  // a write that does not fit is cut short, then refused
+  TS_ASSERT_EQUALS(4096, writer->url_write(buf, sizeof(buf)));
+  TS_ASSERT_EQUALS(-EAGAIN, writer->url_write(buf, 1));
+  TS_ASSERT_EQUALS(1000, reader->url_read(buf, 1000));
+  TS_ASSERT_EQUALS(1000, writer->url_write(buf, 1000));
+  TS_ASSERT_EQUALS(4096, reader->url_read(buf, sizeof(buf)));
+  TS_ASSERT_EQUALS(-EAGAIN, reader->url_read(buf, sizeof(buf)));
+  writer->url_close();
+  TS_ASSERT_EQUALS(0, reader->url_read(buf, sizeof(buf)));
+  delete reader;
+  delete writer;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testReaderGone()
+{
+  URLProtocolHandler* writer = URLProtocolManager::findHandler("memring:gone", 0,0);
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memring:gone", 0,0);
+  TS_ASSERT_EQUALS(0, writer->url_open("memring:gone", URLProtocolHandler::URL_WRONLY_MODE));
+  TS_ASSERT_EQUALS(0, reader->url_open("memring:gone", URLProtocolHandler::URL_RDONLY_MODE));
+  unsigned char buf[16];
+  TS_ASSERT_EQUALS(16, writer->url_write(buf, sizeof(buf)));
+  reader->url_close();
+  // a blocking writer would otherwise wait forever
+  TS_ASSERT_EQUALS(-EPIPE, writer->url_write(buf, sizeof(buf)));
+  delete reader;
+  delete writer;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testCancelBlockedRead()
+{
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memring:cancel", 0,0);
+  TS_ASSERT_EQUALS(0, reader->url_open("memring:cancel", URLProtocolHandler::URL_RDONLY_MODE));
+  RefPointer<CancellationToken> token = CancellationToken::make();
+  token->setTimeout(50000);
+  reader->setCancellationToken(token.value());
+  unsigned char buf[16];
+  // nobody is writing, so this waits until the token times out
+  TS_ASSERT_EQUALS(-EINTR, reader->url_read(buf, sizeof(buf)));
+  TS_ASSERT(token->isTimedOut());
+  delete reader;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testProducerThread()
+{
+  URLProtocolHandler* writer = URLProtocolManager::findHandler("memring:live", 0,0);
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memring:live", 0,0);
+  TS_ASSERT_EQUALS(0, reader->url_open("memring:live", URLProtocolHandler::URL_RDONLY_MODE));
+  TS_ASSERT_EQUALS(0, writer->url_open("memring:live", URLProtocolHandler::URL_WRONLY_MODE));
+
+  pthread_t thread;
+  TS_ASSERT_EQUALS(0, pthread_create(&thread, 0, produce, writer));
+  int64_t total = 0;
+  int64_t mismatches = 0;
+  unsigned char buf[1537];
+  int32_t retval;
+  // odd read sizes, so reads and writes straddle the wrap differently
+  while ((retval = reader->url_read(buf, sizeof(buf))) > 0)
+  {
+    for(int32_t i = 0; i < retval; i++)
+      if (buf[i] != pattern(total + i))
+        ++mismatches;
+    total += retval;
+  }
+  pthread_join(thread, 0);
+  TS_ASSERT_EQUALS(0, retval);
+  TS_ASSERT_EQUALS(PRODUCED_BYTES, total);
+  TS_ASSERT_EQUALS(0, mismatches);
+  delete reader;
+  delete writer;
+}
+
+void
+MemoryRingURLProtocolHandlerTest :: testStatistics()
+{
+  int64_t stats[MemoryRing::NUM_STATS];
+  TS_ASSERT_EQUALS(-1, MemoryRingURLProtocolManager::getStatistics("memringnb:stats",
+      stats, MemoryRing::NUM_STATS));
+  URLProtocolHandler* writer = URLProtocolManager::findHandler("memringnb:stats", 0,0);
+  URLProtocolHandler* reader = URLProtocolManager::findHandler("memringnb:stats", 0,0);
+  TS_ASSERT_EQUALS(0, writer->url_open("memringnb:stats", URLProtocolHandler::URL_WRONLY_MODE));
+  TS_ASSERT_EQUALS(0, reader->url_open("memringnb:stats", URLProtocolHandler::URL_RDONLY_MODE));
+  unsigned char buf[5000];
+  memset(buf, 0, sizeof(buf));
+  TS_ASSERT_EQUALS(-EAGAIN, reader->url_read(buf, 10));
+  TS_ASSERT_EQUALS(3000, writer->url_write(buf, 3000));
+  TS_ASSERT_EQUALS(1000, reader->url_read(buf, 1000));
+  TS_ASSERT_EQUALS(2096, writer->url_write(buf, 3000));
+
+  TS_ASSERT_EQUALS(MemoryRing::NUM_STATS, MemoryRingURLProtocolManager::getStatistics(
+      "memringnb:stats", stats, MemoryRing::NUM_STATS));
+  TS_ASSERT_EQUALS(4096, stats[MemoryRing::STAT_CAPACITY]);
+  TS_ASSERT_EQUALS(4096, stats[MemoryRing::STAT_BUFFERED]);
+  TS_ASSERT_EQUALS(4096, stats[MemoryRing::STAT_HIGH_WATER]);
+  TS_ASSERT_EQUALS(5096, stats[MemoryRing::STAT_BYTES_WRITTEN]);
+  TS_ASSERT_EQUALS(1000, stats[MemoryRing::STAT_BYTES_READ]);
+  TS_ASSERT_EQUALS(1, stats[MemoryRing::STAT_WRITER_STALLS]);
+  TS_ASSERT_EQUALS(1, stats[MemoryRing::STAT_READER_STALLS]);
+  // a short array gets the first few
+  TS_ASSERT_EQUALS(2, MemoryRingURLProtocolManager::getStatistics(
+      "memringnb:stats", stats, 2));
+
+  delete reader;
+  delete writer;
+  // and the ring is gone with both its ends
+  TS_ASSERT_EQUALS(-1, MemoryRingURLProtocolManager::getStatistics("memringnb:stats",
+      stats, MemoryRing::NUM_STATS));
+}
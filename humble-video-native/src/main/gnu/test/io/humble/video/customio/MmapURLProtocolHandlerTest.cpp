@@ -0,0 +1,273 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#include "MmapURLProtocolHandlerTest.h"
+
+#include <io/humble/video/customio/StdioURLProtocolManager.h>
+
+using namespace io::humble::video::customio;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+MmapURLProtocolHandlerTest :: MmapURLProtocolHandlerTest()
+{
+     char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+     if (fixtureDirectory)
+       snprintf(mFixtureDir, sizeof(mFixtureDir), "%s", fixtureDirectory);
+     else {
+       TSM_ASSERT("no fixture dir", false);
+       throw new std::runtime_error("Must define environment variable VS_TEST_FIXTUREDIR");
+     }
+     snprintf(mSampleFile, sizeof(mSampleFile), "%s/%s", mFixtureDir, "ucl_h264_aac.mp4");
+}
+
+MmapURLProtocolHandlerTest :: ~MmapURLProtocolHandlerTest()
+{
+}
+
+void
+MmapURLProtocolHandlerTest :: setUp()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  StdioURLProtocolManager::registerProtocol("stdio");
+}
+
+void
+MmapURLProtocolHandlerTest :: tearDown()
+{
+  URLProtocolManager::unregisterAllProtocols();
+}
+
+void
+MmapURLProtocolHandlerTest :: testCreation()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("mmap:foo", 0,0);
+  TSM_ASSERT("", handler);
+  TS_ASSERT(dynamic_cast<MmapURLProtocolHandler*>(handler));
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testOpenClose()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("mmap:foo", 0,0);
+  TSM_ASSERT("", handler);
+
+  int retval = 0;
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+
+  retval = handler->url_close();
+  TSM_ASSERT("", retval >= 0);
+  // closing twice is an error, not a crash
+  retval = handler->url_close();
+  TSM_ASSERT("", retval < 0);
+
+  retval = handler->url_open("mmap:/this/file/does/not/exist",
+      URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval < 0);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testOpenForWriteFails()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("mmap:foo", 0,0);
+  TSM_ASSERT("", handler);
+  TS_ASSERT(handler->url_open(mSampleFile, URLProtocolHandler::URL_WRONLY_MODE) < 0);
+  TS_ASSERT(handler->url_open(mSampleFile, URLProtocolHandler::URL_RDWR_MODE) < 0);
+  delete handler;
+}
+
+int64_t
+MmapURLProtocolHandlerTest :: readAll(URLProtocolHandler* handler,
+    const char* file, unsigned char* copy, int64_t copyLen)
+{
+  int retval = handler->url_open(file, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+  if (retval < 0)
+    return -1;
+
+  int64_t totalBytes = 0;
+  do {
+    // the size FFmpeg asks for by default
+    unsigned char buf[32768];
+    retval = handler->url_read(buf, (int)sizeof(buf));
+    if (retval > 0) {
+      if (copy && totalBytes + retval <= copyLen)
+        memcpy(copy + totalBytes, buf, retval);
+      totalBytes+= retval;
+    }
+  } while (retval > 0);
+  TSM_ASSERT_EQUALS("", 0, retval);
+
+  retval = handler->url_close();
+  TSM_ASSERT("", retval >= 0);
+  return totalBytes;
+}
+
+int64_t
+MmapURLProtocolHandlerTest :: readScattered(URLProtocolHandler* handler,
+    const char* file)
+{
+  int retval = handler->url_open(file, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+  if (retval < 0)
+    return -1;
+  int64_t size = handler->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE);
+  int64_t totalBytes = 0;
+  // the same pseudo-random offsets for every handler
+  uint32_t seed = 1;
+  for(int i = 0; i < 1000; i++) {
+    seed = seed * 1103515245 + 12345;
+    int64_t offset = (int64_t)(((uint64_t)seed << 20) % (uint64_t)size);
+    TS_ASSERT_EQUALS(offset,
+        handler->url_seek(offset, URLProtocolHandler::SK_SEEK_SET));
+    unsigned char buf[32768];
+    retval = handler->url_read(buf, (int)sizeof(buf));
+    if (retval > 0)
+      totalBytes += retval;
+  }
+  handler->url_close();
+  return totalBytes;
+}
+
+void
+MmapURLProtocolHandlerTest :: testReadMatchesStdio()
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  URLProtocolHandler* mmap = URLProtocolManager::findHandler("mmap:foo", 0,0);
+  TS_ASSERT(stdio && mmap);
+
+  const int64_t maxLen = 8*1024*1024;
+  std::vector<unsigned char> expected(maxLen);
+  std::vector<unsigned char> actual(maxLen);
+  int64_t expectedLen = readAll(stdio, mSampleFile, &expected[0], maxLen);
+  int64_t actualLen = readAll(mmap, mSampleFile, &actual[0], maxLen);
+  TS_ASSERT(expectedLen > 0);
+  TS_ASSERT(expectedLen <= maxLen);
+  TS_ASSERT_EQUALS(expectedLen, actualLen);
+  TS_ASSERT(!memcmp(&expected[0], &actual[0], (size_t)expectedLen));
+
+  delete stdio;
+  delete mmap;
+}
+
+void
+MmapURLProtocolHandlerTest :: testSeek()
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  MmapURLProtocolHandler* handler = dynamic_cast<MmapURLProtocolHandler*>(
+      URLProtocolManager::findHandler("mmap:foo", 0,0));
+  TSM_ASSERT("", handler);
+
+  int64_t size = readAll(stdio, mSampleFile, 0, 0);
+  int retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+
+  TS_ASSERT_EQUALS(size, handler->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE));
+  TS_ASSERT_EQUALS(size, handler->url_getsize());
+
+  unsigned char first[16];
+  unsigned char again[16];
+  TS_ASSERT_EQUALS(16, handler->url_read(first, sizeof(first)));
+  TS_ASSERT_EQUALS(32, handler->url_seek(16, URLProtocolHandler::SK_SEEK_CUR));
+  TS_ASSERT_EQUALS(0, handler->url_seek(0, URLProtocolHandler::SK_SEEK_SET));
+  TS_ASSERT_EQUALS(16, handler->url_read(again, sizeof(again)));
+  TS_ASSERT(!memcmp(first, again, sizeof(first)));
+
+  // the last ten bytes, then end of file
+  TS_ASSERT_EQUALS(size-10, handler->url_seek(-10, URLProtocolHandler::SK_SEEK_END));
+  TS_ASSERT_EQUALS(10, handler->url_read(again, sizeof(again)));
+  TS_ASSERT_EQUALS(0, handler->url_read(again, sizeof(again)));
+  // past the end is fine; before the start is not
+  TS_ASSERT_EQUALS(size+10, handler->url_seek(size+10, URLProtocolHandler::SK_SEEK_SET));
+  TS_ASSERT_EQUALS(0, handler->url_read(again, sizeof(again)));
+  TS_ASSERT(handler->url_seek(-1, URLProtocolHandler::SK_SEEK_SET) < 0);
+
+  retval = handler->url_close();
+  TSM_ASSERT("", retval >= 0);
+  delete handler;
+  delete stdio;
+}
+
+void
+MmapURLProtocolHandlerTest :: testSeekableFlags()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("mmap:foo", 0,0);
+  TSM_ASSERT("", handler);
+  URLProtocolHandler::SeekableFlags flags = handler->url_seekflags("mmap:foo", 0);
+  TSM_ASSERT_EQUALS("", URLProtocolHandler::SK_SEEKABLE_NORMAL, flags);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: benchmark(const char* file)
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  URLProtocolHandler* mmap = URLProtocolManager::findHandler("mmap:foo", 0,0);
+
+  // once to warm the page cache, so both handlers start the same.
+  int64_t size = readAll(stdio, file, 0, 0);
+
+  int64_t start = VS_TestGetTimeMicros();
+  TS_ASSERT_EQUALS(size, readAll(stdio, file, 0, 0));
+  int64_t stdioTime = VS_TestGetTimeMicros() - start;
+  start = VS_TestGetTimeMicros();
+  TS_ASSERT_EQUALS(size, readAll(mmap, file, 0, 0));
+  int64_t mmapTime = VS_TestGetTimeMicros() - start;
+
+  start = VS_TestGetTimeMicros();
+  int64_t stdioScattered = readScattered(stdio, file);
+  int64_t stdioSeekTime = VS_TestGetTimeMicros() - start;
+  start = VS_TestGetTimeMicros();
+  int64_t mmapScattered = readScattered(mmap, file);
+  int64_t mmapSeekTime = VS_TestGetTimeMicros() - start;
+  TS_ASSERT_EQUALS(stdioScattered, mmapScattered);
+
+  VS_LOG_INFO("%s (%" PRIi64 " bytes): sequential stdio %" PRIi64 " us, mmap %" PRIi64
+      " us; 1000 seeks stdio %" PRIi64 " us, mmap %" PRIi64 " us",
+      file, size, stdioTime, mmapTime, stdioSeekTime, mmapSeekTime);
+  delete stdio;
+  delete mmap;
+}
+
+void
+MmapURLProtocolHandlerTest :: testBenchmarkAgainstStdio()
+{
+  const char* fixtures[] = { "ucl_h264_aac.mp4", "testfile.mp3", "testfile.flv" };
+  for(size_t i = 0; i < sizeof(fixtures)/sizeof(*fixtures); i++) {
+    char file[4098];
+    snprintf(file, sizeof(file), "%s/%s", mFixtureDir, fixtures[i]);
+    FILE* exists = fopen(file, "rb");
+    if (!exists)
+      continue;
+    fclose(exists);
+    benchmark(file);
+  }
+  // Point this at a multi-GB file to see how the handlers scale; the
+  // fixtures all fit in the page cache many times over.
+  const char* large = getenv("VS_TEST_LARGE_FILE");
+  if (large && *large)
+    benchmark(large);
+}
@@ -0,0 +1,301 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#include "PrefetchURLProtocolHandlerTest.h"
+
+#include <io/humble/video/customio/StdioURLProtocolManager.h>
+
+using namespace io::humble::video::customio;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+PrefetchURLProtocolHandlerTest :: PrefetchURLProtocolHandlerTest()
+{
+     char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+     if (fixtureDirectory)
+       snprintf(mFixtureDir, sizeof(mFixtureDir), "%s", fixtureDirectory);
+     else {
+       TSM_ASSERT("no fixture dir", false);
+       throw new std::runtime_error("Must define environment variable VS_TEST_FIXTUREDIR");
+     }
+     snprintf(mSampleFile, sizeof(mSampleFile), "%s/%s", mFixtureDir, "ucl_h264_aac.mp4");
+}
+
+PrefetchURLProtocolHandlerTest :: ~PrefetchURLProtocolHandlerTest()
+{
+}
+
+void
+PrefetchURLProtocolHandlerTest :: setUp()
+{
+  // small blocks, so the fixtures cross lots of block boundaries
+  PrefetchURLProtocolManager::registerProtocol("prefetch", 4096, 3, false);
+  PrefetchURLProtocolManager::registerProtocol("prefetchdirect", 4096, 3, true);
+  PrefetchURLProtocolManager::registerProtocol("prefetchdefault", 0, 0, false);
+  StdioURLProtocolManager::registerProtocol("stdio");
+}
+
+void
+PrefetchURLProtocolHandlerTest :: tearDown()
+{
+  URLProtocolManager::unregisterAllProtocols();
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testCreation()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("prefetch:foo", 0,0);
+  TSM_ASSERT("", handler);
+  TS_ASSERT(dynamic_cast<PrefetchURLProtocolHandler*>(handler));
+  TSM_ASSERT_EQUALS("", URLProtocolHandler::SK_SEEKABLE_NORMAL,
+      handler->url_seekflags("prefetch:foo", 0));
+  delete handler;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testOpenClose()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("prefetch:foo", 0,0);
+  TSM_ASSERT("", handler);
+
+  int retval = 0;
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+
+  retval = handler->url_close();
+  TSM_ASSERT("", retval >= 0);
+  // closing twice is an error, not a crash
+  retval = handler->url_close();
+  TSM_ASSERT("", retval < 0);
+
+  retval = handler->url_open("prefetch:/this/file/does/not/exist",
+      URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval < 0);
+
+  // and deleting an open handler stops its threads
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+  delete handler;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testOpenForWriteFails()
+{
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("prefetch:foo", 0,0);
+  TSM_ASSERT("", handler);
+  TS_ASSERT(handler->url_open(mSampleFile, URLProtocolHandler::URL_WRONLY_MODE) < 0);
+  TS_ASSERT(handler->url_open(mSampleFile, URLProtocolHandler::URL_RDWR_MODE) < 0);
+  delete handler;
+}
+
+int64_t
+PrefetchURLProtocolHandlerTest :: readAll(URLProtocolHandler* handler,
+    const char* file, int readSize, unsigned char* copy, int64_t copyLen)
+{
+  int retval = handler->url_open(file, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+  if (retval < 0)
+    return -1;
+
+  std::vector<unsigned char> buf(readSize);
+  int64_t totalBytes = 0;
+  do {
+    retval = handler->url_read(&buf[0], readSize);
+    if (retval > 0) {
+      if (copy && totalBytes + retval <= copyLen)
+        memcpy(copy + totalBytes, &buf[0], retval);
+      totalBytes+= retval;
+    }
+  } while (retval > 0);
+  TSM_ASSERT_EQUALS("", 0, retval);
+
+  retval = handler->url_close();
+  TSM_ASSERT("", retval >= 0);
+  return totalBytes;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: readMatchesStdio(const char* protocol)
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  URLProtocolHandler* handler = URLProtocolManager::findHandler(protocol, 0,0);
+  TS_ASSERT(stdio && handler);
+
+  const int64_t maxLen = 8*1024*1024;
+  std::vector<unsigned char> expected(maxLen);
+  std::vector<unsigned char> actual(maxLen);
+  int64_t expectedLen = readAll(stdio, mSampleFile, 32768, &expected[0], maxLen);
+  TS_ASSERT(expectedLen > 0);
+  TS_ASSERT(expectedLen <= maxLen);
+  // reads that are bigger than, smaller than, and not a multiple of a block
+  const int readSizes[] = { 32768, 4096, 1000, 1 };
+  for(size_t i = 0; i < sizeof(readSizes)/sizeof(*readSizes); i++) {
+    memset(&actual[0], 0, (size_t)expectedLen);
+    int64_t actualLen = readAll(handler, mSampleFile, readSizes[i], &actual[0], maxLen);
+    TS_ASSERT_EQUALS(expectedLen, actualLen);
+    TS_ASSERT(!memcmp(&expected[0], &actual[0], (size_t)expectedLen));
+  }
+
+  delete stdio;
+  delete handler;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testReadMatchesStdio()
+{
+  readMatchesStdio("prefetch:foo");
+  readMatchesStdio("prefetchdefault:foo");
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testDirectReadMatchesStdio()
+{
+  // if the fixture directory cannot do direct IO this just tests the
+  // fallback, which is fine too.
+  readMatchesStdio("prefetchdirect:foo");
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testSeek()
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  PrefetchURLProtocolHandler* handler = dynamic_cast<PrefetchURLProtocolHandler*>(
+      URLProtocolManager::findHandler("prefetch:foo", 0,0));
+  TSM_ASSERT("", handler);
+
+  int64_t size = readAll(stdio, mSampleFile, 32768, 0, 0);
+  int retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  TSM_ASSERT("", retval >= 0);
+
+  TS_ASSERT_EQUALS(size, handler->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE));
+  TS_ASSERT_EQUALS(size, handler->url_getsize());
+
+  unsigned char first[16];
+  unsigned char again[16];
+  TS_ASSERT_EQUALS(16, handler->url_read(first, sizeof(first)));
+  TS_ASSERT_EQUALS(32, handler->url_seek(16, URLProtocolHandler::SK_SEEK_CUR));
+  TS_ASSERT_EQUALS(0, handler->url_seek(0, URLProtocolHandler::SK_SEEK_SET));
+  TS_ASSERT_EQUALS(16, handler->url_read(again, sizeof(again)));
+  TS_ASSERT(!memcmp(first, again, sizeof(first)));
+
+  // a read never crosses a block, so it can come back short
+  TS_ASSERT_EQUALS(4090, handler->url_seek(4090, URLProtocolHandler::SK_SEEK_SET));
+  TS_ASSERT_EQUALS(6, handler->url_read(again, sizeof(again)));
+  TS_ASSERT_EQUALS(16, handler->url_read(again, sizeof(again)));
+
+  // the last ten bytes, then end of file
+  TS_ASSERT_EQUALS(size-10, handler->url_seek(-10, URLProtocolHandler::SK_SEEK_END));
+  TS_ASSERT_EQUALS(10, handler->url_read(again, sizeof(again)));
+  TS_ASSERT_EQUALS(0, handler->url_read(again, sizeof(again)));
+  // past the end is fine; before the start is not
+  TS_ASSERT_EQUALS(size+10, handler->url_seek(size+10, URLProtocolHandler::SK_SEEK_SET));
+  TS_ASSERT_EQUALS(0, handler->url_read(again, sizeof(again)));
+  TS_ASSERT(handler->url_seek(-1, URLProtocolHandler::SK_SEEK_SET) < 0);
+  // and back to the start, cancelling whatever was queued out there
+  TS_ASSERT_EQUALS(0, handler->url_seek(0, URLProtocolHandler::SK_SEEK_SET));
+  TS_ASSERT_EQUALS(16, handler->url_read(again, sizeof(again)));
+  TS_ASSERT(!memcmp(first, again, sizeof(first)));
+
+  retval = handler->url_close();
+  TSM_ASSERT("", retval >= 0);
+  delete handler;
+  delete stdio;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testScatteredReadsMatchStdio()
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("prefetch:foo", 0,0);
+  TS_ASSERT(stdio && handler);
+
+  TS_ASSERT(stdio->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE) >= 0);
+  TS_ASSERT(handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE) >= 0);
+  int64_t size = stdio->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE);
+  TS_ASSERT(size > 0);
+
+  // seeks near and far, each followed by a short run of reads
+  uint32_t seed = 1;
+  for(int i = 0; i < 500; i++) {
+    seed = seed * 1103515245 + 12345;
+    int64_t offset = (int64_t)(((uint64_t)seed << 20) % (uint64_t)size);
+    if (i % 3 == 0)
+      // sometimes just skip a little way forward
+      offset = (stdio->url_seek(0, URLProtocolHandler::SK_SEEK_CUR) +
+          (seed >> 20)) % size;
+    TS_ASSERT_EQUALS(offset,
+        stdio->url_seek(offset, URLProtocolHandler::SK_SEEK_SET));
+    TS_ASSERT_EQUALS(offset,
+        handler->url_seek(offset, URLProtocolHandler::SK_SEEK_SET));
+    for(int j = 0; j < 3; j++) {
+      unsigned char expected[5000];
+      unsigned char actual[5000];
+      int got = handler->url_read(actual, (int)sizeof(actual));
+      TS_ASSERT(got >= 0);
+      if (got <= 0)
+        break;
+      TS_ASSERT_EQUALS(got, stdio->url_read(expected, got));
+      TS_ASSERT(!memcmp(expected, actual, got));
+    }
+  }
+
+  stdio->url_close();
+  handler->url_close();
+  delete stdio;
+  delete handler;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: benchmark(const char* file)
+{
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("stdio:foo", 0,0);
+  URLProtocolHandler* prefetch = URLProtocolManager::findHandler("prefetchdefault:foo", 0,0);
+
+  // once to warm the page cache, so both handlers start the same.
+  int64_t size = readAll(stdio, file, 32768, 0, 0);
+
+  int64_t start = VS_TestGetTimeMicros();
+  TS_ASSERT_EQUALS(size, readAll(stdio, file, 32768, 0, 0));
+  int64_t stdioTime = VS_TestGetTimeMicros() - start;
+  start = VS_TestGetTimeMicros();
+  TS_ASSERT_EQUALS(size, readAll(prefetch, file, 32768, 0, 0));
+  int64_t prefetchTime = VS_TestGetTimeMicros() - start;
+
+  VS_LOG_INFO("%s (%" PRIi64 " bytes): sequential stdio %" PRIi64
+      " us, prefetch %" PRIi64 " us",
+      file, size, stdioTime, prefetchTime);
+  delete stdio;
+  delete prefetch;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testBenchmarkAgainstStdio()
+{
+  benchmark(mSampleFile);
+  // The prefetcher pays off when the disk is slow and the page cache is
+  // cold (a NAS, say), which the fixtures are not; point this at such a
+  // file to see it.
+  const char* large = getenv("VS_TEST_LARGE_FILE");
+  if (large && *large)
+    benchmark(large);
+}
@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Andrew "Art" Clarke.  All rights reserved.
+ *   
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+#ifndef PREFETCHURLPROTOCOLHANDLERTEST_H_
+#define PREFETCHURLPROTOCOLHANDLERTEST_H_
+
+#include <io/humble/testutils/TestUtils.h>
+#include <io/humble/ferry/Logger.h>
+#include <io/humble/video/customio/PrefetchURLProtocolManager.h>
+
+using namespace io::humble::video::customio;
+
+class PrefetchURLProtocolHandlerTest: public CxxTest::TestSuite
+{
+public:
+  PrefetchURLProtocolHandlerTest();
+  virtual
+  ~PrefetchURLProtocolHandlerTest();
+  void setUp();
+  void tearDown();
+  void testCreation();
+  void testOpenClose();
+  void testOpenForWriteFails();
+  void testReadMatchesStdio();
+  void testDirectReadMatchesStdio();
+  void testSeek();
+  void testScatteredReadsMatchStdio();
+  void testBenchmarkAgainstStdio();
+private:
+  void benchmark(const char* file);
+  int64_t readAll(URLProtocolHandler* handler, const char* file,
+      int readSize, unsigned char* copy, int64_t copyLen);
+  void readMatchesStdio(const char* protocol);
+  char mFixtureDir[4098];
+  char mSampleFile[4098];
+};
+
+#endif /* PREFETCHURLPROTOCOLHANDLERTEST_H_ */
@@ -16,15 +16,13 @@ package io.humble.ferry;
  * since you'd just be calling from native code back into Java).  It's<br>
  * here so that native code inside a JVM can have access to portable<br>
  * thread-safe objects.<br>
- * </p>  <br>
+ * </p><br>
  * <p><br>
- * And that said, this method is really only Atomic if running inside a<br>
- * Java JVM (or other virtual machine that can provide the functionality).<br>
- * If running in a standalone C++ program there<br>
- * is no current guarantee of Atomicity.<br>
- * </p><p><br>
- * The object just forwards to the Java object:<br>
- * java.util.concurrent.atomic.AtomicInteger<br>
+ * All operations use the hardware atomic instructions of the platform<br>
+ * we're compiled on, whether or not we're running inside a Java JVM,<br>
+ * and never call into Java.  By default every operation is sequentially<br>
+ * consistent (the same guarantee java.util.concurrent.atomic.AtomicInteger<br>
+ * gives), but callers on hot paths can ask for a weaker {@link MemoryOrder}.<br>
  * </p>
  */
 public class AtomicInteger {
@@ -154,40 +152,90 @@ public class AtomicInteger {
     this(FerryJNI.new_AtomicInteger__SWIG_1(arg0), true);
   }
 
+  public int get(AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_get__SWIG_0(swigCPtr, this, order.swigValue());
+  }
+
   public int get() {
-    return FerryJNI.AtomicInteger_get(swigCPtr, this);
+    return FerryJNI.AtomicInteger_get__SWIG_1(swigCPtr, this);
+  }
+
+  public void set(int newval, AtomicInteger.MemoryOrder order) {
+    FerryJNI.AtomicInteger_set__SWIG_0(swigCPtr, this, newval, order.swigValue());
+  }
+
+  public void set(int newval) {
+    FerryJNI.AtomicInteger_set__SWIG_1(swigCPtr, this, newval);
+  }
+
+  public int getAndSet(int newval, AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_getAndSet__SWIG_0(swigCPtr, this, newval, order.swigValue());
   }
 
-  public void set(int arg0) {
-    FerryJNI.AtomicInteger_set(swigCPtr, this, arg0);
+  public int getAndSet(int newval) {
+    return FerryJNI.AtomicInteger_getAndSet__SWIG_1(swigCPtr, this, newval);
   }
 
-  public int getAndSet(int arg0) {
-    return FerryJNI.AtomicInteger_getAndSet(swigCPtr, this, arg0);
+  public int getAndIncrement(AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_getAndIncrement__SWIG_0(swigCPtr, this, order.swigValue());
   }
 
   public int getAndIncrement() {
-    return FerryJNI.AtomicInteger_getAndIncrement(swigCPtr, this);
+    return FerryJNI.AtomicInteger_getAndIncrement__SWIG_1(swigCPtr, this);
+  }
+
+  public int getAndDecrement(AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_getAndDecrement__SWIG_0(swigCPtr, this, order.swigValue());
   }
 
   public int getAndDecrement() {
-    return FerryJNI.AtomicInteger_getAndDecrement(swigCPtr, this);
+    return FerryJNI.AtomicInteger_getAndDecrement__SWIG_1(swigCPtr, this);
+  }
+
+  public int getAndAdd(int delta, AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_getAndAdd__SWIG_0(swigCPtr, this, delta, order.swigValue());
+  }
+
+  public int getAndAdd(int delta) {
+    return FerryJNI.AtomicInteger_getAndAdd__SWIG_1(swigCPtr, this, delta);
   }
 
-  public int getAndAdd(int arg0) {
-    return FerryJNI.AtomicInteger_getAndAdd(swigCPtr, this, arg0);
+  public int incrementAndGet(AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_incrementAndGet__SWIG_0(swigCPtr, this, order.swigValue());
   }
 
   public int incrementAndGet() {
-    return FerryJNI.AtomicInteger_incrementAndGet(swigCPtr, this);
+    return FerryJNI.AtomicInteger_incrementAndGet__SWIG_1(swigCPtr, this);
+  }
+
+  public int decrementAndGet(AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_decrementAndGet__SWIG_0(swigCPtr, this, order.swigValue());
   }
 
   public int decrementAndGet() {
-    return FerryJNI.AtomicInteger_decrementAndGet(swigCPtr, this);
+    return FerryJNI.AtomicInteger_decrementAndGet__SWIG_1(swigCPtr, this);
+  }
+
+  public int addAndGet(int delta, AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_addAndGet__SWIG_0(swigCPtr, this, delta, order.swigValue());
   }
 
-  public int addAndGet(int arg0) {
-    return FerryJNI.AtomicInteger_addAndGet(swigCPtr, this, arg0);
+  public int addAndGet(int delta) {
+    return FerryJNI.AtomicInteger_addAndGet__SWIG_1(swigCPtr, this, delta);
+  }
+
+/**
+ * Compare the current value to expected, and if<br>
+ * they are equal, set the current value to update.<br>
+ * @param expected the value expected<br>
+ * @param update the value to update to<br>
+ * @param order the memory order to use if the update happens; if<br>
+ *   it does not, the read of the current value is done with the<br>
+ *   load equivalent of this order.<br>
+ * @return true if equal
+ */
+  public boolean compareAndSet(int expected, int update, AtomicInteger.MemoryOrder order) {
+    return FerryJNI.AtomicInteger_compareAndSet__SWIG_0(swigCPtr, this, expected, update, order.swigValue());
   }
 
 /**
@@ -195,18 +243,91 @@ public class AtomicInteger {
  * they are equal, set the current value to update.<br>
  * @param expected the value expected<br>
  * @param update the value to update to<br>
+ * @param order the memory order to use if the update happens; if<br>
+ *   it does not, the read of the current value is done with the<br>
+ *   load equivalent of this order.<br>
  * @return true if equal
  */
   public boolean compareAndSet(int expected, int update) {
-    return FerryJNI.AtomicInteger_compareAndSet(swigCPtr, this, expected, update);
+    return FerryJNI.AtomicInteger_compareAndSet__SWIG_1(swigCPtr, this, expected, update);
   }
 
 /**
  * @return true if we're actually able to guarantee<br>
- * atomicity; false if we can't.
+ * atomicity; false if we can't.  Now that we use native atomics<br>
+ * this is always true.
  */
   public boolean isAtomic() {
     return FerryJNI.AtomicInteger_isAtomic(swigCPtr, this);
   }
 
+  /**
+   * The memory ordering to apply to an operation.  These map<br>
+   * one-for-one onto the C++11 memory model orders.<br>
+   * <p><br>
+   * Orders that make no sense for an operation (e.g. MEMORY_ORDER_RELEASE<br>
+   * on a #get()) are weakened to the nearest order that does.<br>
+   * </p>
+   */
+  public enum MemoryOrder {
+  /**
+   * Atomic, but no ordering of other memory operations. 
+   */
+    MEMORY_ORDER_RELAXED(FerryJNI.AtomicInteger_MEMORY_ORDER_RELAXED_get()),
+  /**
+   * Later reads and writes may not move before this operation. 
+   */
+    MEMORY_ORDER_ACQUIRE(FerryJNI.AtomicInteger_MEMORY_ORDER_ACQUIRE_get()),
+  /**
+   * Earlier reads and writes may not move after this operation. 
+   */
+    MEMORY_ORDER_RELEASE(FerryJNI.AtomicInteger_MEMORY_ORDER_RELEASE_get()),
+  /**
+   * Both MEMORY_ORDER_ACQUIRE and MEMORY_ORDER_RELEASE. 
+   */
+    MEMORY_ORDER_ACQ_REL(FerryJNI.AtomicInteger_MEMORY_ORDER_ACQ_REL_get()),
+  /**
+   * A single total order across all sequentially consistent operations. 
+   */
+    MEMORY_ORDER_SEQ_CST(FerryJNI.AtomicInteger_MEMORY_ORDER_SEQ_CST_get()),
+  ;
+
+    public final int swigValue() {
+      return swigValue;
+    }
+
+    public static MemoryOrder swigToEnum(int swigValue) {
+      MemoryOrder[] swigValues = MemoryOrder.class.getEnumConstants();
+      if (swigValue < swigValues.length && swigValue >= 0 && swigValues[swigValue].swigValue == swigValue)
+        return swigValues[swigValue];
+      for (MemoryOrder swigEnum : swigValues)
+        if (swigEnum.swigValue == swigValue)
+          return swigEnum;
+      throw new IllegalArgumentException("No enum " + MemoryOrder.class + " with value " + swigValue);
+    }
+
+    @SuppressWarnings("unused")
+    private MemoryOrder() {
+      this.swigValue = SwigNext.next++;
+    }
+
+    @SuppressWarnings("unused")
+    private MemoryOrder(int swigValue) {
+      this.swigValue = swigValue;
+      SwigNext.next = swigValue+1;
+    }
+
+    @SuppressWarnings("unused")
+    private MemoryOrder(MemoryOrder swigEnum) {
+      this.swigValue = swigEnum.swigValue;
+      SwigNext.next = this.swigValue+1;
+    }
+
+    private final int swigValue;
+
+    private static class SwigNext {
+      private static int next = 0;
+    }
+  }
+
 }
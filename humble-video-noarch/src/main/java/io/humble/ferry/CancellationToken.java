@@ -0,0 +1,233 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.6
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package io.humble.ferry;
+
+/**
+ * A flag that tells a blocking operation to give up, optionally once a<br>
+ * deadline has passed.<br>
+ * <p><br>
+ * Attach a token to a Demuxer, Muxer or custom IO handler and any thread<br>
+ * can then #cancel() the work it is doing.  Checking a token that<br>
+ * has no deadline is a single atomic load, so the I/O loops inside FFmpeg<br>
+ * can check it as often as they like.<br>
+ * </p><p><br>
+ * Once cancelled a token stays cancelled until #reset() is called.<br>
+ * </p>
+ */
+public class CancellationToken extends RefCounted {
+  // CancellationToken.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.  Not part of public API.
+   * <p>
+   * Unfortunately this constructor is public because
+   * io.humble.video.Container#getCancellationToken() needs it,
+   * but do not pass in values to this method as you may end up
+   * crashing the virtual machine.
+   * </p>
+   */
+  public CancellationToken(long cPtr, boolean cMemoryOwn) {
+    super(FerryJNI.CancellationToken_SWIGUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected CancellationToken(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(FerryJNI.CancellationToken_SWIGUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  protected static long getCPtr(CancellationToken obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  protected long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new CancellationToken object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public CancellationToken copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new CancellationToken(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof CancellationToken)
+      equal = (((CancellationToken)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // CancellationToken.swg: End generated code
+  
+  /**
+   * Cancel this token if the calling thread is interrupted.
+   * <p>
+   * Native code never asks Java whether a thread holding a token was
+   * interrupted; instead call this once on the thread that will block, and
+   * {@link Thread#interrupt()} will cancel the token directly.  If the
+   * thread is already interrupted the token is cancelled immediately.
+   * </p>
+   * <pre>
+   * final CancellationToken.InterruptBridge bridge = token.bridgeInterrupts();
+   * try {
+   *   while(demuxer.read(packet) &gt;= 0) { ... }
+   * } finally {
+   *   bridge.detach();
+   * }
+   * </pre>
+   *
+   * @return a bridge; call {@link InterruptBridge#detach()} on the same
+   *   thread when the blocking work is done.
+   */
+  public InterruptBridge bridgeInterrupts() {
+    return new InterruptBridge(this);
+  }
+
+  /**
+   * Forwards {@link Thread#interrupt()} for one thread to a
+   * {@link CancellationToken}.  Uses the same hook the JDK uses to wake
+   * threads blocked on an interruptible channel.
+   */
+  public static final class InterruptBridge
+    extends java.nio.channels.spi.AbstractInterruptibleChannel
+  {
+    private final CancellationToken mToken;
+    private InterruptBridge(CancellationToken token) {
+      mToken = token;
+      begin();
+    }
+    /**
+     * Stop forwarding interrupts.  Must be called on the thread that
+     * created this bridge.
+     */
+    public void detach() {
+      try {
+        end(true);
+      } catch (java.nio.channels.AsynchronousCloseException e) {
+        // the token was cancelled, which is all we wanted
+      }
+    }
+    @Override
+    protected void implCloseChannel() {
+      mToken.cancel();
+    }
+  }
+
+/**
+ * Make a new token that is not cancelled and has no deadline.
+ */
+  public static CancellationToken make() {
+    long cPtr = FerryJNI.CancellationToken_make();
+    return (cPtr == 0) ? null : new CancellationToken(cPtr, false);
+  }
+
+/**
+ * Cancel any operation checking this token.  Safe to call from any<br>
+ * thread, including while the operation is blocked.
+ */
+  public void cancel() {
+    FerryJNI.CancellationToken_cancel(swigCPtr, this);
+  }
+
+/**
+ * Has this token been cancelled, or has its deadline passed?
+ */
+  public boolean isCancelled() {
+    return FerryJNI.CancellationToken_isCancelled(swigCPtr, this);
+  }
+
+/**
+ * Did this token cancel because its deadline passed (rather than because<br>
+ * someone called #cancel())?
+ */
+  public boolean isTimedOut() {
+    return FerryJNI.CancellationToken_isTimedOut(swigCPtr, this);
+  }
+
+/**
+ * Cancel this token automatically once the given amount of time has<br>
+ * passed.  Replaces any earlier deadline.  Has no effect if the token is<br>
+ * already cancelled.<br>
+ * <br>
+ * @param microseconds How long from now the deadline is.  0 or less<br>
+ *   means the deadline has already passed.
+ */
+  public void setTimeout(long microseconds) {
+    FerryJNI.CancellationToken_setTimeout(swigCPtr, this, microseconds);
+  }
+
+/**
+ * Remove any deadline set with #setTimeout(long).  Has no effect if the<br>
+ * token is already cancelled.
+ */
+  public void clearTimeout() {
+    FerryJNI.CancellationToken_clearTimeout(swigCPtr, this);
+  }
+
+/**
+ * Clear both the cancelled flag and any deadline so the token can be<br>
+ * used again.  Only call this when no operation is checking the token.
+ */
+  public void reset() {
+    FerryJNI.CancellationToken_reset(swigCPtr, this);
+  }
+
+}
@@ -39,21 +39,92 @@ public class FerryJNI {
    * Internal Only.  Do not call.
    */
   public native static void setMemoryModel(int value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static boolean isNativeBufferPooling();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static void setNativeBufferPooling(boolean value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getNativeBufferPoolHighWaterMark();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static void setNativeBufferPoolHighWaterMark(long value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getNativeBufferPoolHits();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getNativeBufferPoolMisses();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getNativeBufferPoolBytesRetained();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static void trimNativeBufferPool();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static int getNativeBufferAlignment();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static boolean setNativeBufferAlignment(int value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static int getNativeBufferHugePageMode();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static boolean setNativeBufferHugePageMode(int value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getNativeBufferHugePageThreshold();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static void setNativeBufferHugePageThreshold(long value);
   
 
+  public final static native int AtomicInteger_MEMORY_ORDER_RELAXED_get();
+  public final static native int AtomicInteger_MEMORY_ORDER_ACQUIRE_get();
+  public final static native int AtomicInteger_MEMORY_ORDER_RELEASE_get();
+  public final static native int AtomicInteger_MEMORY_ORDER_ACQ_REL_get();
+  public final static native int AtomicInteger_MEMORY_ORDER_SEQ_CST_get();
   public final static native long new_AtomicInteger__SWIG_0();
   public final static native long new_AtomicInteger__SWIG_1(int jarg1);
   public final static native void delete_AtomicInteger(long jarg1);
-  public final static native int AtomicInteger_get(long jarg1, AtomicInteger jarg1_);
-  public final static native void AtomicInteger_set(long jarg1, AtomicInteger jarg1_, int jarg2);
-  public final static native int AtomicInteger_getAndSet(long jarg1, AtomicInteger jarg1_, int jarg2);
-  public final static native int AtomicInteger_getAndIncrement(long jarg1, AtomicInteger jarg1_);
-  public final static native int AtomicInteger_getAndDecrement(long jarg1, AtomicInteger jarg1_);
-  public final static native int AtomicInteger_getAndAdd(long jarg1, AtomicInteger jarg1_, int jarg2);
-  public final static native int AtomicInteger_incrementAndGet(long jarg1, AtomicInteger jarg1_);
-  public final static native int AtomicInteger_decrementAndGet(long jarg1, AtomicInteger jarg1_);
-  public final static native int AtomicInteger_addAndGet(long jarg1, AtomicInteger jarg1_, int jarg2);
-  public final static native boolean AtomicInteger_compareAndSet(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3);
+  public final static native int AtomicInteger_get__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_get__SWIG_1(long jarg1, AtomicInteger jarg1_);
+  public final static native void AtomicInteger_set__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3);
+  public final static native void AtomicInteger_set__SWIG_1(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_getAndSet__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3);
+  public final static native int AtomicInteger_getAndSet__SWIG_1(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_getAndIncrement__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_getAndIncrement__SWIG_1(long jarg1, AtomicInteger jarg1_);
+  public final static native int AtomicInteger_getAndDecrement__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_getAndDecrement__SWIG_1(long jarg1, AtomicInteger jarg1_);
+  public final static native int AtomicInteger_getAndAdd__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3);
+  public final static native int AtomicInteger_getAndAdd__SWIG_1(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_incrementAndGet__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_incrementAndGet__SWIG_1(long jarg1, AtomicInteger jarg1_);
+  public final static native int AtomicInteger_decrementAndGet__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native int AtomicInteger_decrementAndGet__SWIG_1(long jarg1, AtomicInteger jarg1_);
+  public final static native int AtomicInteger_addAndGet__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3);
+  public final static native int AtomicInteger_addAndGet__SWIG_1(long jarg1, AtomicInteger jarg1_, int jarg2);
+  public final static native boolean AtomicInteger_compareAndSet__SWIG_0(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3, int jarg4);
+  public final static native boolean AtomicInteger_compareAndSet__SWIG_1(long jarg1, AtomicInteger jarg1_, int jarg2, int jarg3);
   public final static native boolean AtomicInteger_isAtomic(long jarg1, AtomicInteger jarg1_);
   public final static native int RefCounted_acquire(long jarg1, RefCounted jarg1_);
   public final static native int RefCounted_release(long jarg1, RefCounted jarg1_);
@@ -78,10 +149,28 @@ public class FerryJNI {
   public final static native boolean Logger_isGlobalLogging(int jarg1);
   public final static native void Logger_setGlobalIsLogging(int jarg1, boolean jarg2);
   public final static native String Logger_getName(long jarg1, Logger jarg1_);
+  public final static native boolean Logger_setAsynchronous(boolean jarg1);
+  public final static native boolean Logger_isAsynchronous();
+  public final static native void Logger_flush();
+  public final static native long Logger_getDroppedMessages();
+  public final static native void Logger_setRateLimit(int jarg1);
+  public final static native int Logger_getRateLimit();
+  public final static native long Logger_getRateLimitedMessages();
   public final static native void delete_Logger(long jarg1);
   public final static native long Mutex_make();
   public final static native void Mutex_lock(long jarg1, Mutex jarg1_);
   public final static native void Mutex_unlock(long jarg1, Mutex jarg1_);
+  public final static native boolean Mutex_isNative(long jarg1, Mutex jarg1_);
+  public final static native long Mutex_getAcquisitions(long jarg1, Mutex jarg1_);
+  public final static native long Mutex_getContendedAcquisitions(long jarg1, Mutex jarg1_);
+  public final static native long Mutex_getWaitTime(long jarg1, Mutex jarg1_);
+  public final static native long CancellationToken_make();
+  public final static native void CancellationToken_cancel(long jarg1, CancellationToken jarg1_);
+  public final static native boolean CancellationToken_isCancelled(long jarg1, CancellationToken jarg1_);
+  public final static native boolean CancellationToken_isTimedOut(long jarg1, CancellationToken jarg1_);
+  public final static native void CancellationToken_setTimeout(long jarg1, CancellationToken jarg1_, long jarg2);
+  public final static native void CancellationToken_clearTimeout(long jarg1, CancellationToken jarg1_);
+  public final static native void CancellationToken_reset(long jarg1, CancellationToken jarg1_);
   public final static native int Buffer_getBufferSize(long jarg1, Buffer jarg1_);
   public final static native long Buffer_make__SWIG_0(long jarg1, RefCounted jarg1_, int jarg2);
   public final static native int Buffer_getType(long jarg1, Buffer jarg1_);
@@ -96,6 +185,7 @@ public class FerryJNI {
   public final static native long RefCountedTester_make__SWIG_0();
   public final static native long RefCountedTester_make__SWIG_1(long jarg1, RefCountedTester jarg1_);
   public final static native long Mutex_SWIGUpcast(long jarg1);
+  public final static native long CancellationToken_SWIGUpcast(long jarg1);
   public final static native long Buffer_SWIGUpcast(long jarg1);
   public final static native long RefCountedTester_SWIGUpcast(long jarg1);
 }
@@ -1443,6 +1443,244 @@ public final class JNIMemoryManager
     mMemoryModel = model;
   }
 
+  /**
+   * Turns pooling of native buffers on or off.
+   * <p>
+   * Only has an effect under the {@link MemoryModel#NATIVE_BUFFERS} and
+   * {@link MemoryModel#NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION}
+   * models.  When on, native memory that is released is kept and handed
+   * out again to later allocations of the same size, instead of being
+   * returned to the operating system.  This avoids repeated large
+   * allocations when decoding or encoding many same-sized frames.
+   * </p>
+   * <p>
+   * Small blocks are pooled by size class with a cache per thread; blocks
+   * larger than one megabyte are only reused for exactly the same size.
+   * The pool holds on to at most {@link #getNativeBufferPoolHighWaterMark()}
+   * bytes.  Turning pooling off frees everything the pool holds.
+   * </p>
+   * 
+   * @param enabled true to pool native buffers.
+   */
+  public static void setNativeBufferPooling(boolean enabled)
+  {
+    FerryJNI.setNativeBufferPooling(enabled);
+  }
+
+  /**
+   * Is native buffer pooling on?
+   * 
+   * @return true if native buffers are pooled.
+   * @see #setNativeBufferPooling(boolean)
+   */
+  public static boolean isNativeBufferPooling()
+  {
+    return FerryJNI.isNativeBufferPooling();
+  }
+
+  /**
+   * Sets the most bytes of released native buffers the pool will hold on
+   * to. Memory released past that is returned to the operating system.
+   * 
+   * @param bytes the high water mark, in bytes.
+   * @see #setNativeBufferPooling(boolean)
+   */
+  public static void setNativeBufferPoolHighWaterMark(long bytes)
+  {
+    FerryJNI.setNativeBufferPoolHighWaterMark(bytes);
+  }
+
+  /**
+   * Gets the most bytes of released native buffers the pool will hold on
+   * to.
+   * 
+   * @return the high water mark, in bytes.
+   * @see #setNativeBufferPoolHighWaterMark(long)
+   */
+  public static long getNativeBufferPoolHighWaterMark()
+  {
+    return FerryJNI.getNativeBufferPoolHighWaterMark();
+  }
+
+  /**
+   * Gets the number of native buffer allocations that were served from the
+   * pool.
+   * 
+   * @return the number of pool hits.
+   */
+  public static long getNativeBufferPoolHits()
+  {
+    return FerryJNI.getNativeBufferPoolHits();
+  }
+
+  /**
+   * Gets the number of native buffer allocations made while pooling was on
+   * that the pool could not serve.
+   * 
+   * @return the number of pool misses.
+   */
+  public static long getNativeBufferPoolMisses()
+  {
+    return FerryJNI.getNativeBufferPoolMisses();
+  }
+
+  /**
+   * Gets the number of bytes of released native buffers the pool is
+   * currently holding on to.
+   * 
+   * @return the bytes retained.
+   */
+  public static long getNativeBufferPoolBytesRetained()
+  {
+    return FerryJNI.getNativeBufferPoolBytesRetained();
+  }
+
+  /**
+   * Returns the native buffers the pool is holding on to to the operating
+   * system.
+   */
+  public static void trimNativeBufferPool()
+  {
+    FerryJNI.trimNativeBufferPool();
+  }
+
+  /**
+   * Sets the boundary, in bytes, that native buffers are aligned on.
+   * <p>
+   * The default is 64 bytes, which lets AVX2 and AVX-512 code in the
+   * scaler and codecs use aligned loads and stores.  Buffers already
+   * allocated keep their alignment.
+   * </p>
+   * 
+   * @param alignment a power of two, no larger than 256.
+   * @return true if set; false if alignment is not valid.
+   */
+  public static boolean setNativeBufferAlignment(int alignment)
+  {
+    return FerryJNI.setNativeBufferAlignment(alignment);
+  }
+
+  /**
+   * Gets the boundary, in bytes, that native buffers are aligned on.
+   * 
+   * @return the alignment.
+   * @see #setNativeBufferAlignment(int)
+   */
+  public static int getNativeBufferAlignment()
+  {
+    return FerryJNI.getNativeBufferAlignment();
+  }
+
+  /**
+   * How large native buffers are backed by huge pages.
+   * 
+   * @see JNIMemoryManager#setNativeBufferHugePages(HugePageMode)
+   */
+  public enum HugePageMode
+  {
+    /**
+     * Never; large buffers come from the normal heap. The default.
+     */
+    NONE(0),
+    /**
+     * Map large buffers and advise the kernel to back them with
+     * transparent huge pages.  Needs transparent huge pages set to
+     * <code>always</code> or <code>madvise</code> on Linux.
+     */
+    TRANSPARENT(1),
+    /**
+     * Map large buffers from the huge page pool the administrator
+     * reserved (<code>/proc/sys/vm/nr_hugepages</code> on Linux), falling
+     * back to {@link #TRANSPARENT} when the pool is empty.
+     */
+    HUGETLB(2);
+
+    /**
+     * The integer native mode that the MemoryPool.cpp file expects
+     */
+    private final int mNativeValue;
+
+    /**
+     * Create a {@link HugePageMode}.
+     * 
+     * @param nativeValue What we actually use in native code.
+     */
+    private HugePageMode(int nativeValue)
+    {
+      mNativeValue = nativeValue;
+    }
+
+    /**
+     * Get the native value to pass to native code
+     * 
+     * @return a value.
+     */
+    public int getNativeValue()
+    {
+      return mNativeValue;
+    }
+  }
+
+  /**
+   * Sets how native buffers at or above
+   * {@link #getNativeBufferHugePageThreshold()} bytes are backed by huge
+   * pages.
+   * <p>
+   * Only has an effect under the {@link MemoryModel#NATIVE_BUFFERS} and
+   * {@link MemoryModel#NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION}
+   * models.  Huge pages cut the TLB misses when scaling or encoding
+   * large (e.g. 4K) pictures.  Combine with
+   * {@link #setNativeBufferPooling(boolean)} so the mapped buffers are
+   * reused rather than mapped again every frame.
+   * </p>
+   * 
+   * @param mode the mode.
+   * @return false if this platform does not support mode.
+   */
+  public static boolean setNativeBufferHugePages(HugePageMode mode)
+  {
+    return FerryJNI.setNativeBufferHugePageMode(mode.getNativeValue());
+  }
+
+  /**
+   * Gets how large native buffers are backed by huge pages.
+   * 
+   * @return the mode.
+   * @see #setNativeBufferHugePages(HugePageMode)
+   */
+  public static HugePageMode getNativeBufferHugePages()
+  {
+    int mode = FerryJNI.getNativeBufferHugePageMode();
+    for (HugePageMode candidate : HugePageMode.values())
+      if (candidate.getNativeValue() == mode)
+        return candidate;
+    return HugePageMode.NONE;
+  }
+
+  /**
+   * Sets the size, in bytes, at and above which native buffers are
+   * backed by huge pages. Defaults to 2 megabytes.
+   * 
+   * @param bytes the threshold.
+   * @see #setNativeBufferHugePages(HugePageMode)
+   */
+  public static void setNativeBufferHugePageThreshold(long bytes)
+  {
+    FerryJNI.setNativeBufferHugePageThreshold(bytes);
+  }
+
+  /**
+   * Gets the size, in bytes, at and above which native buffers are
+   * backed by huge pages.
+   * 
+   * @return the threshold.
+   * @see #setNativeBufferHugePages(HugePageMode)
+   */
+  public static long getNativeBufferHugePageThreshold()
+  {
+    return FerryJNI.getNativeBufferHugePageThreshold();
+  }
+
   /**
    * Internal Only.
    * 
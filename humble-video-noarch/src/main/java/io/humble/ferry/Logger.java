@@ -231,6 +231,75 @@ public class Logger {
     return FerryJNI.Logger_getName(swigCPtr, this);
   }
 
+/**
+ * Turn asynchronous logging on or off for all loggers.<br>
+ * <p><br>
+ * When on, logging threads format their message into a bounded<br>
+ * ring buffer and return immediately; a separate thread passes<br>
+ * messages on to Java or stderr.  If the ring is full the message<br>
+ * is dropped and counted in #getDroppedMessages().  Messages longer<br>
+ * than 1023 bytes are truncated.<br>
+ * </p><br>
+ * <p><br>
+ * Turning it off logs anything still queued before returning.<br>
+ * </p><br>
+ * <br>
+ * @param value true for asynchronous logging.<br>
+ * @return true if logging is now in the mode asked for.
+ */
+  public static boolean setAsynchronous(boolean value) {
+    return FerryJNI.Logger_setAsynchronous(value);
+  }
+
+/**
+ * @return true if logging is asynchronous. 
+ */
+  public static boolean isAsynchronous() {
+    return FerryJNI.Logger_isAsynchronous();
+  }
+
+/**
+ * If logging is asynchronous, log everything queued so far before<br>
+ * returning.
+ */
+  public static void flush() {
+    FerryJNI.Logger_flush();
+  }
+
+/**
+ * @return the number of messages dropped because the asynchronous<br>
+ *   queue was full.
+ */
+  public static long getDroppedMessages() {
+    return FerryJNI.Logger_getDroppedMessages();
+  }
+
+/**
+ * Limit how many messages each place in the code can log per<br>
+ * second.  Messages over the limit are dropped; the next message<br>
+ * from that place to get through says how many were dropped.<br>
+ * <br>
+ * @param messagesPerSecond The limit, or 0 for no limit (the<br>
+ *   default).
+ */
+  public static void setRateLimit(int messagesPerSecond) {
+    FerryJNI.Logger_setRateLimit(messagesPerSecond);
+  }
+
+/**
+ * @return the messages per second each place in the code may log. 
+ */
+  public static int getRateLimit() {
+    return FerryJNI.Logger_getRateLimit();
+  }
+
+/**
+ * @return the number of messages dropped by the rate limit.
+ */
+  public static long getRateLimitedMessages() {
+    return FerryJNI.Logger_getRateLimitedMessages();
+  }
+
   /**
    * Different logging levels (noiseness) supported by us.
    */
@@ -14,12 +14,18 @@ package io.humble.ferry;
  * This object exists so that Native code can get access to <br>
  * thread safe locking objects if they need it.<br>
  * </p><p><br>
- * Implements a blocking Mutually-Exclusive lock<br>
- * by wrapping a Java lock.<br>
- * </p><p><br>
- * If not running inside Java, lock() and unlock()<br>
- * are NO-OPs.<br>
- * </p>
+ * Implements a blocking, re-entrant, Mutually-Exclusive lock.  There are<br>
+ * two flavors:<br>
+ * </p><br>
+ * <ul><br>
+ * <li>#make() wraps a Java lock.  If not running inside Java, #make()<br>
+ * returns null.</li><br>
+ * <li>#makeNative() uses a native pthread mutex (a futex on Linux) and<br>
+ * works with or without a JVM.  Before blocking in the kernel, a<br>
+ * contended lock() spins for a while, adapting how long it spins to how<br>
+ * long the lock has recently been held.  It also keeps contention<br>
+ * counters.</li><br>
+ * </ul>
  */
 public class Mutex extends RefCounted {
   // JNIHelper.swg: Start generated code
@@ -134,4 +140,36 @@ public class Mutex extends RefCounted {
     FerryJNI.Mutex_unlock(swigCPtr, this);
   }
 
+/**
+ * @return true if this is a native mutex; false if it wraps a Java lock.
+ */
+  public boolean isNative() {
+    return FerryJNI.Mutex_isNative(swigCPtr, this);
+  }
+
+/**
+ * @return The number of times this mutex has been locked.  Always<br>
+ *   0 for mutexes that wrap a Java lock.
+ */
+  public long getAcquisitions() {
+    return FerryJNI.Mutex_getAcquisitions(swigCPtr, this);
+  }
+
+/**
+ * @return The number of times #lock() found this mutex held by another<br>
+ *   thread.  Always 0 for mutexes that wrap a Java lock.
+ */
+  public long getContendedAcquisitions() {
+    return FerryJNI.Mutex_getContendedAcquisitions(swigCPtr, this);
+  }
+
+/**
+ * @return The total time, in nanoseconds, threads have spent spinning<br>
+ *   or blocked waiting for this mutex.  Always 0 for mutexes that<br>
+ *   wrap a Java lock.
+ */
+  public long getWaitTime() {
+    return FerryJNI.Mutex_getWaitTime(swigCPtr, this);
+  }
+
 }
@@ -0,0 +1,326 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.6
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package io.humble.video;
+import io.humble.ferry.*;
+/**
+ * Probes many media files at once and keeps a compact summary of each.<br>
+ * <p><br>
+ * Opening a file and querying its streams with a Demuxer mostly waits on<br>
+ * I/O, so probing a catalog one file at a time leaves the machine idle.<br>
+ * Add the URLs with #add(String), then #run() opens each one and reads<br>
+ * its stream meta data on a pool of native threads, #getConcurrency() at<br>
+ * a time.<br>
+ * </p><p><br>
+ * The results are read back by file and stream number, for example<br>
+ * #getDuration(int) or #getStreamCodecID(int, int), so no Java objects<br>
+ * are made per file or per stream.  Each file gets at most<br>
+ * #getTimeout() microseconds; a file that takes longer is abandoned<br>
+ * through FFmpeg's I/O interrupt callback and reported by<br>
+ * #isTimedOut(int).<br>
+ * </p><p><br>
+ * Each file is opened with a Demuxer, so custom protocols and the probe<br>
+ * cache (see Global#setProbeCacheCapacity(int)) work as they do for a<br>
+ * single file.<br>
+ * </p>
+ */
+public class BulkProbe extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    Buffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected BulkProbe(long cPtr, boolean cMemoryOwn) {
+    super(VideoJNI.BulkProbe_SWIGUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected BulkProbe(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(VideoJNI.BulkProbe_SWIGUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  protected static long getCPtr(BulkProbe obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  protected long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new BulkProbe object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public BulkProbe copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new BulkProbe(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof BulkProbe)
+      equal = (((BulkProbe)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+/**
+ * Make an empty BulkProbe.<br>
+ * <br>
+ * @param concurrency How many files to probe at once; must be &gt; 0.
+ */
+  public static BulkProbe make(int concurrency) {
+    long cPtr = VideoJNI.BulkProbe_make(concurrency);
+    return (cPtr == 0) ? null : new BulkProbe(cPtr, false);
+  }
+
+/**
+ * @return How many files are probed at once.
+ */
+  public int getConcurrency() {
+    return VideoJNI.BulkProbe_getConcurrency(swigCPtr, this);
+  }
+
+/**
+ * Set the most time each file may take to open and probe.<br>
+ * <br>
+ * @param microseconds The time limit; 0 or less means no limit, the<br>
+ *   default.
+ */
+  public void setTimeout(long microseconds) {
+    VideoJNI.BulkProbe_setTimeout(swigCPtr, this, microseconds);
+  }
+
+/**
+ * @return The time limit for each file in microseconds, or 0 for none.
+ */
+  public long getTimeout() {
+    return VideoJNI.BulkProbe_getTimeout(swigCPtr, this);
+  }
+
+/**
+ * Add a file to probe.<br>
+ * <br>
+ * @param url The URL to open, as for Demuxer#open.<br>
+ * @return The number of the file, used to read its results.<br>
+ * @throws HumbleRuntimeError if #run() is in progress.
+ */
+  public int add(String url) {
+    return VideoJNI.BulkProbe_add(swigCPtr, this, url);
+  }
+
+/**
+ * @return The number of files added.
+ */
+  public int getNumFiles() {
+    return VideoJNI.BulkProbe_getNumFiles(swigCPtr, this);
+  }
+
+/**
+ * Probe every file added, replacing any results from an earlier run.<br>
+ * Blocks until all files are done.  Files cannot be added, and results<br>
+ * cannot be read, from other threads until it returns.<br>
+ * <br>
+ * @return The number of files that were probed without error.<br>
+ * @throws HumbleRuntimeError if #run() is already in progress.
+ */
+  public int run() {
+    return VideoJNI.BulkProbe_run(swigCPtr, this);
+  }
+
+/**
+ * @return The URL of the given file.
+ */
+  public String getURL(int file) {
+    return VideoJNI.BulkProbe_getURL(swigCPtr, this, file);
+  }
+
+/**
+ * @return true if the file was opened and probed.
+ */
+  public boolean isProbed(int file) {
+    return VideoJNI.BulkProbe_isProbed(swigCPtr, this, file);
+  }
+
+/**
+ * @return Why the file could not be probed, or null if it was.
+ */
+  public String getErrorMessage(int file) {
+    return VideoJNI.BulkProbe_getErrorMessage(swigCPtr, this, file);
+  }
+
+/**
+ * @return true if the file ran out of time.
+ */
+  public boolean isTimedOut(int file) {
+    return VideoJNI.BulkProbe_isTimedOut(swigCPtr, this, file);
+  }
+
+/**
+ * @return How long opening and probing the file took, in microseconds.
+ */
+  public long getProbeTime(int file) {
+    return VideoJNI.BulkProbe_getProbeTime(swigCPtr, this, file);
+  }
+
+/**
+ * @return The short name of the file's format, or null if it could not<br>
+ *   be opened.
+ */
+  public String getFormatName(int file) {
+    return VideoJNI.BulkProbe_getFormatName(swigCPtr, this, file);
+  }
+
+/**
+ * @return The file's duration in microseconds, or Global#NO_PTS if<br>
+ *   unknown.
+ */
+  public long getDuration(int file) {
+    return VideoJNI.BulkProbe_getDuration(swigCPtr, this, file);
+  }
+
+/**
+ * @return The file's start time in microseconds, or Global#NO_PTS if<br>
+ *   unknown.
+ */
+  public long getStartTime(int file) {
+    return VideoJNI.BulkProbe_getStartTime(swigCPtr, this, file);
+  }
+
+/**
+ * @return The file's bit rate in bits per second, or 0 if unknown.
+ */
+  public int getBitRate(int file) {
+    return VideoJNI.BulkProbe_getBitRate(swigCPtr, this, file);
+  }
+
+/**
+ * @return The number of streams in the file; 0 if it could not be<br>
+ *   probed.
+ */
+  public int getNumStreams(int file) {
+    return VideoJNI.BulkProbe_getNumStreams(swigCPtr, this, file);
+  }
+
+/**
+ * @return The type of media in the given stream.
+ */
+  public MediaDescriptor.Type getStreamType(int file, int stream) {
+    return MediaDescriptor.Type.swigToEnum(VideoJNI.BulkProbe_getStreamType(swigCPtr, this, file, stream));
+  }
+
+/**
+ * @return The codec of the given stream.
+ */
+  public Codec.ID getStreamCodecID(int file, int stream) {
+    return Codec.ID.swigToEnum(VideoJNI.BulkProbe_getStreamCodecID(swigCPtr, this, file, stream));
+  }
+
+/**
+ * @return The width in pixels of a video stream, or 0.
+ */
+  public int getStreamWidth(int file, int stream) {
+    return VideoJNI.BulkProbe_getStreamWidth(swigCPtr, this, file, stream);
+  }
+
+/**
+ * @return The height in pixels of a video stream, or 0.
+ */
+  public int getStreamHeight(int file, int stream) {
+    return VideoJNI.BulkProbe_getStreamHeight(swigCPtr, this, file, stream);
+  }
+
+/**
+ * @return The sample rate of an audio stream, or 0.
+ */
+  public int getStreamSampleRate(int file, int stream) {
+    return VideoJNI.BulkProbe_getStreamSampleRate(swigCPtr, this, file, stream);
+  }
+
+/**
+ * @return The number of channels in an audio stream, or 0.
+ */
+  public int getStreamChannels(int file, int stream) {
+    return VideoJNI.BulkProbe_getStreamChannels(swigCPtr, this, file, stream);
+  }
+
+/**
+ * @return The numerator of the given stream's time base.
+ */
+  public int getStreamTimeBaseNumerator(int file, int stream) {
+    return VideoJNI.BulkProbe_getStreamTimeBaseNumerator(swigCPtr, this, file, stream);
+  }
+
+/**
+ * @return The denominator of the given stream's time base.
+ */
+  public int getStreamTimeBaseDenominator(int file, int stream) {
+    return VideoJNI.BulkProbe_getStreamTimeBaseDenominator(swigCPtr, this, file, stream);
+  }
+
+}
@@ -429,6 +429,67 @@ public class Coder extends Configurable {
     VideoJNI.Coder_setFlag2(swigCPtr, this, flag.swigValue(), value);
   }
 
+/**
+ * Set how many threads this Coder may use. Coders use one thread<br>
+ * unless told otherwise.<br>
+ * <br>
+ * @param count The number of threads, or 0 to use one per CPU<br>
+ *   (plus one, so a thread waiting on memory does not idle a core).<br>
+ * @throws InvalidArgument if count is negative.<br>
+ * @throws RuntimeException if this Coder is already open.
+ */
+  public void setThreadCount(int count) {
+    VideoJNI.Coder_setThreadCount(swigCPtr, this, count);
+  }
+
+/**
+ * Before open, the thread count asked for (0 meaning one per CPU); after<br>
+ * open, the number of threads actually in use.
+ */
+  public int getThreadCount() {
+    return VideoJNI.Coder_getThreadCount(swigCPtr, this);
+  }
+
+/**
+ * Set which kinds of threading this Coder may use. The default is<br>
+ * #THREAD_FRAME_AND_SLICE. Low latency callers, such as a live player,<br>
+ * may prefer #THREAD_SLICE.<br>
+ * <br>
+ * @throws RuntimeException if this Coder is already open.
+ */
+  public void setThreadType(Coder.ThreadType type) {
+    VideoJNI.Coder_setThreadType(swigCPtr, this, type.swigValue());
+  }
+
+/**
+ * The kinds of threading this Coder may use.
+ */
+  public Coder.ThreadType getThreadType() {
+    return Coder.ThreadType.swigToEnum(VideoJNI.Coder_getThreadType(swigCPtr, this));
+  }
+
+/**
+ * The kind of threading this Coder actually uses, which depends on<br>
+ * the Codec and the thread count. #THREAD_NONE until opened.
+ */
+  public Coder.ThreadType getActiveThreadType() {
+    return Coder.ThreadType.swigToEnum(VideoJNI.Coder_getActiveThreadType(swigCPtr, this));
+  }
+
+/**
+ * The number of packets a frame-threaded Decoder takes in before it<br>
+ * returns its first frame, and so the number of frames it still holds<br>
+ * when the input runs out. Always 0 before open and when frame<br>
+ * threading is not active.<br>
+ * <p><br>
+ * Those frames only come out if the Decoder is drained by passing null<br>
+ * packets until no complete frame comes back.<br>
+ * </p>
+ */
+  public int getThreadDelay() {
+    return VideoJNI.Coder_getThreadDelay(swigCPtr, this);
+  }
+
   /**
    * The state that a Coder can be in.
    */
@@ -676,4 +737,66 @@ public class Coder extends Configurable {
     }
   }
 
+  /**
+   * The ways a Coder may split its work across threads. Values may be<br>
+   * or-ed together; the Codec picks the best of those it supports.
+   */
+  public enum ThreadType {
+  /**
+   * Do all the work on the calling thread. 
+   */
+    THREAD_NONE(VideoJNI.Coder_THREAD_NONE_get()),
+  /**
+   * Work on several frames at once. Scales well, but a decoder holds<br>
+   * back output by one frame per extra thread; see #getThreadDelay().
+   */
+    THREAD_FRAME(VideoJNI.Coder_THREAD_FRAME_get()),
+  /**
+   * Work on several slices of one frame at once. Adds no delay. 
+   */
+    THREAD_SLICE(VideoJNI.Coder_THREAD_SLICE_get()),
+  /**
+   * Use whichever of the above the Codec supports. 
+   */
+    THREAD_FRAME_AND_SLICE(VideoJNI.Coder_THREAD_FRAME_AND_SLICE_get()),
+  ;
+
+    public final int swigValue() {
+      return swigValue;
+    }
+
+    public static ThreadType swigToEnum(int swigValue) {
+      ThreadType[] swigValues = ThreadType.class.getEnumConstants();
+      if (swigValue < swigValues.length && swigValue >= 0 && swigValues[swigValue].swigValue == swigValue)
+        return swigValues[swigValue];
+      for (ThreadType swigEnum : swigValues)
+        if (swigEnum.swigValue == swigValue)
+          return swigEnum;
+      throw new IllegalArgumentException("No enum " + ThreadType.class + " with value " + swigValue);
+    }
+
+    @SuppressWarnings("unused")
+    private ThreadType() {
+      this.swigValue = SwigNext.next++;
+    }
+
+    @SuppressWarnings("unused")
+    private ThreadType(int swigValue) {
+      this.swigValue = swigValue;
+      SwigNext.next = swigValue+1;
+    }
+
+    @SuppressWarnings("unused")
+    private ThreadType(ThreadType swigEnum) {
+      this.swigValue = swigEnum.swigValue;
+      SwigNext.next = this.swigValue+1;
+    }
+
+    private final int swigValue;
+
+    private static class SwigNext {
+      private static int next = 0;
+    }
+  }
+
 }
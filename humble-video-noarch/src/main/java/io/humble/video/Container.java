@@ -138,6 +138,33 @@ public class Container extends Configurable {
     return VideoJNI.Container_getNumStreams(swigCPtr, this);
   }
 
+/**
+ * Attach a token that cancels this container's blocking methods.<br>
+ * <p><br>
+ * While a token is attached, FFmpeg's I/O loops and Humble Video check<br>
+ * only the token, and never ask Java whether the thread was<br>
+ * interrupted.  To have Thread#interrupt() still stop a blocked call, see<br>
+ * CancellationToken#bridgeInterrupts().<br>
+ * </p><p><br>
+ * Do not change the token while another thread is using this container.<br>
+ * </p><br>
+ * <br>
+ * @param token The token to check, or null to go back to checking<br>
+ *   whether the calling thread has been interrupted.
+ */
+  public void setCancellationToken(CancellationToken token) {
+    VideoJNI.Container_setCancellationToken(swigCPtr, this, CancellationToken.getCPtr(token), token);
+  }
+
+/**
+ * @return The token set with #setCancellationToken(CancellationToken),<br>
+ *   or null.
+ */
+  public CancellationToken getCancellationToken() {
+    long cPtr = VideoJNI.Container_getCancellationToken(swigCPtr, this);
+    return (cPtr == 0) ? null : new CancellationToken(cPtr, false);
+  }
+
   /**
    * Do not set these flags -- several are used by the internals of Humble Video.
    */
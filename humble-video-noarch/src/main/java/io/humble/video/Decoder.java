@@ -135,7 +135,13 @@ public class Decoder extends Coder {
 
 /**
  * Flush this Decoder, getting rid of any cached packets (call after seek).<br>
- * Next packet given to decode should be a key packet.
+ * Next packet given to decode should be a key packet.<br>
+ * <p><br>
+ * Frames still held back by frame threads are thrown away too; to get<br>
+ * them out instead, drain the Decoder by decoding null packets until no<br>
+ * complete frame comes back. Once drained, the next packet decoded<br>
+ * flushes the Decoder first, so it too should be a key packet.<br>
+ * </p>
  */
   public void flush() {
     VideoJNI.Decoder_flush(swigCPtr, this);
@@ -176,6 +182,12 @@ public class Decoder extends Coder {
  * in memory managed by you, then pass in a MediaPicture allocated without<br>
  * a buffer to DecodeVideo, and then copy that into your own media picture.<br>
  * </p><br>
+ * <p><br>
+ * A frame-threaded Decoder (see Coder#setThreadCount(int32_t)) returns<br>
+ * no picture for the first Coder#getThreadDelay() packets it is given,<br>
+ * and holds back as many at the end; pass null packets until the<br>
+ * picture is no longer complete to get them.<br>
+ * </p><br>
  * <br>
  * @param output The MediaPicture we decode. Caller must check if it is complete on return.<br>
  * @param packet  The packet we're attempting to decode from.<br>
@@ -210,4 +222,177 @@ public class Decoder extends Coder {
     return VideoJNI.Decoder_decode(swigCPtr, this, MediaSampled.getCPtr(output), output, MediaPacket.getCPtr(packet), packet, byteOffset);
   }
 
+/**
+ * Set whether a video Decoder decodes into memory it keeps and reuses<br>
+ * once every MediaPicture using it lets go. It is on by default.<br>
+ * <p><br>
+ * Pooled planes are laid out just as FFmpeg would lay them out, and<br>
+ * MediaPicture#getData(int) returns the very Buffer the Decoder wrote<br>
+ * into rather than a new one each call. A Buffer held on to is never<br>
+ * written into again, so holding one is safe but defeats the pool.<br>
+ * </p><br>
+ * <br>
+ * @throws RuntimeException if this Decoder is already open.
+ */
+  public void setPictureBufferPooling(boolean pooled) {
+    VideoJNI.Decoder_setPictureBufferPooling(swigCPtr, this, pooled);
+  }
+
+/**
+ * @return Whether this Decoder pools picture memory. Always false for<br>
+ *   a Decoder that is not for video.
+ */
+  public boolean isPictureBufferPooling() {
+    return VideoJNI.Decoder_isPictureBufferPooling(swigCPtr, this);
+  }
+
+/**
+ * @return How many picture planes were served from the pool.
+ */
+  public long getPictureBufferPoolHits() {
+    return VideoJNI.Decoder_getPictureBufferPoolHits(swigCPtr, this);
+  }
+
+/**
+ * @return How many picture planes had to be allocated because the pool<br>
+ *   had none free.
+ */
+  public long getPictureBufferPoolMisses() {
+    return VideoJNI.Decoder_getPictureBufferPoolMisses(swigCPtr, this);
+  }
+
+/**
+ * @return The bytes of picture memory the pool holds waiting to be<br>
+ *   reused.
+ */
+  public long getPictureBufferPoolBytesRetained() {
+    return VideoJNI.Decoder_getPictureBufferPoolBytesRetained(swigCPtr, this);
+  }
+
+/**
+ * Set which frames this Decoder skips without decoding. A skipped<br>
+ * packet is consumed but no picture comes back for it.<br>
+ * <p><br>
+ * With DISCARD_NONKEY a video Decoder only decodes key frames, which<br>
+ * is all a thumbnail or scrubbing preview needs. How closely each level<br>
+ * is honoured is up to the codec; H.264, MPEG-1/2/4 and VC-1 honour<br>
+ * them all. May be changed at any time, even while decoding.<br>
+ * </p>
+ */
+  public void setSkipFrame(Decoder.Discard discard) {
+    VideoJNI.Decoder_setSkipFrame(swigCPtr, this, discard.swigValue());
+  }
+
+/**
+ * @return Which frames this Decoder skips.
+ */
+  public Decoder.Discard getSkipFrame() {
+    return Decoder.Discard.swigToEnum(VideoJNI.Decoder_getSkipFrame(swigCPtr, this));
+  }
+
+/**
+ * Set for which frames this Decoder skips the in-loop deblocking<br>
+ * filter. Skipping it is much cheaper but leaves block edges visible,<br>
+ * and the error carries into the frames predicted from them.<br>
+ * May be changed at any time.
+ */
+  public void setSkipLoopFilter(Decoder.Discard discard) {
+    VideoJNI.Decoder_setSkipLoopFilter(swigCPtr, this, discard.swigValue());
+  }
+
+/**
+ * @return For which frames this Decoder skips the loop filter.
+ */
+  public Decoder.Discard getSkipLoopFilter() {
+    return Decoder.Discard.swigToEnum(VideoJNI.Decoder_getSkipLoopFilter(swigCPtr, this));
+  }
+
+/**
+ * Set for which frames this Decoder skips the inverse transform, giving<br>
+ * a rough picture for much less work. May be changed at any time.
+ */
+  public void setSkipIDCT(Decoder.Discard discard) {
+    VideoJNI.Decoder_setSkipIDCT(swigCPtr, this, discard.swigValue());
+  }
+
+/**
+ * @return For which frames this Decoder skips the inverse transform.
+ */
+  public Decoder.Discard getSkipIDCT() {
+    return Decoder.Discard.swigToEnum(VideoJNI.Decoder_getSkipIDCT(swigCPtr, this));
+  }
+
+  /**
+   * Which frames, or which parts of the work on a frame, a Decoder may<br>
+   * skip. Each level skips everything the levels above it skip.
+   */
+  public enum Discard {
+  /**
+   * Skip nothing, not even empty packets. 
+   */
+    DISCARD_NONE(VideoJNI.Decoder_DISCARD_NONE_get()),
+  /**
+   * Skip only useless packets, such as empty ones. The default. 
+   */
+    DISCARD_DEFAULT(VideoJNI.Decoder_DISCARD_DEFAULT_get()),
+  /**
+   * Skip frames no other frame refers to. 
+   */
+    DISCARD_NONREF(VideoJNI.Decoder_DISCARD_NONREF_get()),
+  /**
+   * Skip bidirectionally predicted frames. 
+   */
+    DISCARD_BIDIR(VideoJNI.Decoder_DISCARD_BIDIR_get()),
+  /**
+   * Skip everything but intra frames. 
+   */
+    DISCARD_NONINTRA(VideoJNI.Decoder_DISCARD_NONINTRA_get()),
+  /**
+   * Skip everything but key frames. 
+   */
+    DISCARD_NONKEY(VideoJNI.Decoder_DISCARD_NONKEY_get()),
+  /**
+   * Skip everything. 
+   */
+    DISCARD_ALL(VideoJNI.Decoder_DISCARD_ALL_get()),
+  ;
+
+    public final int swigValue() {
+      return swigValue;
+    }
+
+    public static Discard swigToEnum(int swigValue) {
+      Discard[] swigValues = Discard.class.getEnumConstants();
+      if (swigValue < swigValues.length && swigValue >= 0 && swigValues[swigValue].swigValue == swigValue)
+        return swigValues[swigValue];
+      for (Discard swigEnum : swigValues)
+        if (swigEnum.swigValue == swigValue)
+          return swigEnum;
+      throw new IllegalArgumentException("No enum " + Discard.class + " with value " + swigValue);
+    }
+
+    @SuppressWarnings("unused")
+    private Discard() {
+      this.swigValue = SwigNext.next++;
+    }
+
+    @SuppressWarnings("unused")
+    private Discard(int swigValue) {
+      this.swigValue = swigValue;
+      SwigNext.next = swigValue+1;
+    }
+
+    @SuppressWarnings("unused")
+    private Discard(Discard swigEnum) {
+      this.swigValue = swigEnum.swigValue;
+      SwigNext.next = this.swigValue+1;
+    }
+
+    private final int swigValue;
+
+    private static class SwigNext {
+      private static int next = 0;
+    }
+  }
+
 }
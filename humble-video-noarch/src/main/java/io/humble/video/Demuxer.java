@@ -168,6 +168,43 @@ public class Demuxer extends Container {
     return VideoJNI.Demuxer_getInputBufferLength(swigCPtr, this);
   }
 
+/**
+ * Count and time every read and seek this Demuxer makes; see<br>
+ * #getIOStatistics().  Works for customio protocols and for any<br>
+ * protocol FFmpeg reads as a stream of bytes (file, http, tcp...), but<br>
+ * not for formats that do their own networking, such as RTSP.<br>
+ * <p><br>
+ * An instrumented Demuxer also tunes its buffer: unless<br>
+ * #setInputBufferLength(int) was called, it opens with the length<br>
+ * learned from earlier instrumented Demuxers on the same server (or,<br>
+ * for local files, in the same directory), chosen to match how far<br>
+ * they read between seeks.<br>
+ * </p><br>
+ * <br>
+ * @param instrumented Whether to instrument the next open.<br>
+ * @throws RuntimeException if this Demuxer has already been opened.
+ */
+  public void setIOInstrumented(boolean instrumented) {
+    VideoJNI.Demuxer_setIOInstrumented(swigCPtr, this, instrumented);
+  }
+
+/**
+ * @return Whether I/O is (or will be, once opened) instrumented.
+ */
+  public boolean isIOInstrumented() {
+    return VideoJNI.Demuxer_isIOInstrumented(swigCPtr, this);
+  }
+
+/**
+ * @return A snapshot of this Demuxer's I/O so far, or the totals at<br>
+ *   close if it has been closed; null if I/O was not instrumented.<br>
+ *   Safe to call from any thread.
+ */
+  public IOStatistics getIOStatistics() {
+    long cPtr = VideoJNI.Demuxer_getIOStatistics(swigCPtr, this);
+    return (cPtr == 0) ? null : new IOStatistics(cPtr, false);
+  }
+
 /**
  * Open this container and make it ready for reading, optionally<br>
  * reading as far into the container as necessary to find all streams.<br>
@@ -224,6 +261,76 @@ public class Demuxer extends Container {
     return (cPtr == 0) ? null : new DemuxerStream(cPtr, false);
   }
 
+/**
+ * Select or deselect a stream.<br>
+ * <p><br>
+ * All streams start selected.  A deselected stream is discarded inside<br>
+ * FFmpeg: #read(MediaPacket) never returns its packets, many formats<br>
+ * (MP4 and MOV among them) skip over its data without reading it, and<br>
+ * no Decoder is made for it.  Deselected streams are also ignored when<br>
+ * #seek(int, long, long, long, int) looks for a place every active<br>
+ * stream can start from.<br>
+ * </p><p><br>
+ * Packets from a deselected stream already read ahead are dropped.<br>
+ * </p><br>
+ * <br>
+ * @param streamIndex The stream, from 0 to #getNumStreams()-1.<br>
+ * @param selected true to read the stream; false to discard it.
+ */
+  public void setStreamSelected(int streamIndex, boolean selected) {
+    VideoJNI.Demuxer_setStreamSelected(swigCPtr, this, streamIndex, selected);
+  }
+
+/**
+ * @param streamIndex The stream, from 0 to #getNumStreams()-1.<br>
+ * @return true unless the stream was deselected with<br>
+ *   #setStreamSelected(int, boolean).
+ */
+  public boolean isStreamSelected(int streamIndex) {
+    return VideoJNI.Demuxer_isStreamSelected(swigCPtr, this, streamIndex);
+  }
+
+/**
+ * Select every stream of one media type, and deselect all the others.<br>
+ * For example, pass MediaDescriptor.Type.MEDIA_AUDIO to extract only<br>
+ * the audio from a movie.<br>
+ * <br>
+ * @param type The type of stream to keep.<br>
+ * @return The number of streams selected.
+ */
+  public int selectStreams(MediaDescriptor.Type type) {
+    return VideoJNI.Demuxer_selectStreams(swigCPtr, this, type.swigValue());
+  }
+
+/**
+ * Have #read(MediaPacket) and #readBatch(MediaPacketBatch) return only<br>
+ * the key packets of a stream and drop the rest.<br>
+ * <p><br>
+ * A thumbnailer or scrubbing preview only needs key frames, and this<br>
+ * keeps the rest from ever reaching a Decoder.  Formats that support it<br>
+ * (AVI, FLV, ASF, RealMedia and NUT) skip over the dropped packets'<br>
+ * data without reading it; others read them and throw them away.<br>
+ * </p><p><br>
+ * Turning this on selects the stream if it was deselected, and<br>
+ * #setStreamSelected(int, boolean) turns it off again.<br>
+ * </p><br>
+ * <br>
+ * @param streamIndex The stream, from 0 to #getNumStreams()-1.<br>
+ * @param keyFramesOnly true to drop all but key packets; false to<br>
+ *   return every packet.
+ */
+  public void setKeyFramesOnly(int streamIndex, boolean keyFramesOnly) {
+    VideoJNI.Demuxer_setKeyFramesOnly(swigCPtr, this, streamIndex, keyFramesOnly);
+  }
+
+/**
+ * @param streamIndex The stream, from 0 to #getNumStreams()-1.<br>
+ * @return true if only key packets are read from the stream.
+ */
+  public boolean isKeyFramesOnly(int streamIndex) {
+    return VideoJNI.Demuxer_isKeyFramesOnly(swigCPtr, this, streamIndex);
+  }
+
 /**
  * Reads the next packet in the Demuxer into the Packet.  This method will<br>
  * release any buffers currently held by this packet and allocate<br>
@@ -244,6 +351,31 @@ public class Demuxer extends Container {
     return VideoJNI.Demuxer_read(swigCPtr, this, MediaPacket.getCPtr(packet), packet);
   }
 
+/**
+ * Reads up to MediaPacketBatch#getCapacity() packets in one call.<br>
+ * <p><br>
+ * Does the same work as calling #read(MediaPacket) once per packet,<br>
+ * but crosses from Java to native code once per batch and looks up each<br>
+ * stream's Coder and time base once per batch rather than once per<br>
+ * packet, which matters when remuxing many small packets.<br>
+ * </p><p><br>
+ * Reading stops early at end of file, on an error, or when a<br>
+ * non-blocking source has nothing more yet.  If packets were read before<br>
+ * an error, they are returned and the error is reported by the next<br>
+ * read.<br>
+ * </p><br>
+ * <br>
+ * @param batch [In/Out] The batch to fill; MediaPacketBatch#getSize() is<br>
+ *   set to the number of packets read.<br>
+ * <br>
+ * @return The number of packets read (0 if a non-blocking source had<br>
+ *   none ready), or &lt;0 at end of file.<br>
+ * @throws RuntimeException if an error occurs and no packets were read.
+ */
+  public int readBatch(MediaPacketBatch batch) throws java.lang.InterruptedException, java.io.IOException {
+    return VideoJNI.Demuxer_readBatch(swigCPtr, this, MediaPacketBatch.getCPtr(batch), batch);
+  }
+
 /**
  * Attempts to read all the meta data in this stream, potentially by reading ahead<br>
  * and decoding packets.<br>
@@ -258,6 +390,15 @@ public class Demuxer extends Container {
     VideoJNI.Demuxer_queryStreamMetaData(swigCPtr, this);
   }
 
+/**
+ * @return How long, in microseconds, the probe cache saved<br>
+ *   #queryStreamMetaData() on this Demuxer: the time the original probe<br>
+ *   took, or 0 if this Demuxer probed the file itself.
+ */
+  public long getProbeTimeSaved() {
+    return VideoJNI.Demuxer_getProbeTimeSaved(swigCPtr, this);
+  }
+
 /**
  * Gets the duration, if known, of this container.<br>
  * <br>
@@ -382,6 +523,94 @@ public class Demuxer extends Container {
     VideoJNI.Demuxer_setReadRetryCount(swigCPtr, this, count);
   }
 
+/**
+ * Turns background read-ahead on or off.<br>
+ * <p><br>
+ * With read-ahead on, the first #read(MediaPacket) starts a native<br>
+ * thread that keeps demuxing into a bounded queue, and #read(MediaPacket)<br>
+ * takes packets from that queue, so a slow disk or network only stalls<br>
+ * the caller once the queue runs dry.  The queue is full once any one of<br>
+ * the limits is reached.<br>
+ * </p><p><br>
+ * #seek(int, long, long, long, int) and #close() interrupt the read in<br>
+ * progress rather than wait on a stalled source, and throw away the<br>
+ * queue.  Other calls that need the container to themselves, such as<br>
+ * #pause(), #setStreamSelected(int, boolean) and<br>
+ * #queryStreamMetaData(), wait for the packet in progress so nothing<br>
+ * is lost; pausing keeps the queue.  A custom protocol handler is only<br>
+ * interrupted through its own CancellationToken.  While a read or one<br>
+ * of those calls is waiting on the read-ahead thread, a<br>
+ * CancellationToken set on this Demuxer (or Thread#interrupt()) still<br>
+ * ends it.<br>
+ * </p><p><br>
+ * Read-ahead is ignored for containers where<br>
+ * #canStreamsBeAddedDynamically() is true.  Off by default.<br>
+ * </p><br>
+ * <br>
+ * @param maxPackets The most packets to queue.  &lt;= 0 turns read-ahead<br>
+ *   off; packets already queued are still returned first.<br>
+ * @param maxBytes The most bytes of packet data to queue, or &lt;= 0 for no<br>
+ *   byte limit.<br>
+ * @param maxDuration The most time, in microseconds, between the oldest<br>
+ *   and newest queued packets, or &lt;= 0 for no time limit.
+ */
+  public void setReadAhead(int maxPackets, int maxBytes, long maxDuration) {
+    VideoJNI.Demuxer_setReadAhead(swigCPtr, this, maxPackets, maxBytes, maxDuration);
+  }
+
+/**
+ * @return The packet limit set by #setReadAhead(int, int, long); 0<br>
+ *   if read-ahead is off.
+ */
+  public int getReadAheadMaxPackets() {
+    return VideoJNI.Demuxer_getReadAheadMaxPackets(swigCPtr, this);
+  }
+
+/**
+ * @return The byte limit set by #setReadAhead(int, int, long).
+ */
+  public int getReadAheadMaxBytes() {
+    return VideoJNI.Demuxer_getReadAheadMaxBytes(swigCPtr, this);
+  }
+
+/**
+ * @return The time limit set by #setReadAhead(int, int, long).
+ */
+  public long getReadAheadMaxDuration() {
+    return VideoJNI.Demuxer_getReadAheadMaxDuration(swigCPtr, this);
+  }
+
+/**
+ * @return The number of packets waiting in the read-ahead queue now.
+ */
+  public int getReadAheadQueuedPackets() {
+    return VideoJNI.Demuxer_getReadAheadQueuedPackets(swigCPtr, this);
+  }
+
+/**
+ * @return The bytes of packet data waiting in the read-ahead queue now.
+ */
+  public long getReadAheadQueuedBytes() {
+    return VideoJNI.Demuxer_getReadAheadQueuedBytes(swigCPtr, this);
+  }
+
+/**
+ * @return The number of times #read(MediaPacket) found the read-ahead<br>
+ *   queue empty and had to wait.  If this keeps growing the source is<br>
+ *   slower than the caller, or the queue is too small to hide its stalls.
+ */
+  public long getReadAheadEmptyStalls() {
+    return VideoJNI.Demuxer_getReadAheadEmptyStalls(swigCPtr, this);
+  }
+
+/**
+ * @return The number of times the read-ahead thread found the queue full<br>
+ *   and had to wait for the caller.
+ */
+  public long getReadAheadFullStalls() {
+    return VideoJNI.Demuxer_getReadAheadFullStalls(swigCPtr, this);
+  }
+
 /**
  * Can streams be added dynamically to this container?<br>
  * <br>
@@ -476,6 +705,58 @@ public class Demuxer extends Container {
     return VideoJNI.Demuxer_seek(swigCPtr, this, stream_index, min_ts, ts, max_ts, flags);
   }
 
+/**
+ * Reads the whole file, adding every keyframe to its stream's index<br>
+ * (see ContainerStream#getIndexEntry(int)), and then seeks back to the<br>
+ * start.<br>
+ * <p><br>
+ * Formats with no index of their own (MPEG-TS, raw H.264, FLV without<br>
+ * keyframe metadata) otherwise make #seek(int, long, long, long, int)<br>
+ * scan the file.  Save the result with #saveSeekIndex(String) and<br>
+ * later opens of the same file will seek by binary search instead.<br>
+ * </p><br>
+ * <br>
+ * @return The number of keyframes indexed.<br>
+ * @throws RuntimeException if the Demuxer is not open, or a read fails.
+ */
+  public int buildSeekIndex() throws java.lang.InterruptedException, java.io.IOException {
+    return VideoJNI.Demuxer_buildSeekIndex(swigCPtr, this);
+  }
+
+/**
+ * Writes the keyframe entries of every stream's index to a sidecar<br>
+ * file, along with the size and modification time of the media file, so<br>
+ * #loadSeekIndex(String) can tell if it is out of date.<br>
+ * <br>
+ * @param filename Where to write the index, or null to write it next to<br>
+ *   the media file with ".hvidx" added to its name.<br>
+ * @return The number of entries written.<br>
+ * @throws RuntimeException if the Demuxer is not open, was not opened on<br>
+ *   a local file, or the index cannot be written.
+ */
+  public int saveSeekIndex(String filename) {
+    return VideoJNI.Demuxer_saveSeekIndex(swigCPtr, this, filename);
+  }
+
+/**
+ * Adds the entries of a sidecar file written by #saveSeekIndex(String)<br>
+ * to this Demuxer's stream indexes.<br>
+ * <p><br>
+ * #queryStreamMetaData() already does this for the default sidecar<br>
+ * name, so this is only needed for index files kept elsewhere.  The file is ignored if the<br>
+ * media file's size or modification time has changed, if it has a<br>
+ * different number of streams or a stream's time base differs, or if it<br>
+ * was written by an incompatible version.<br>
+ * </p><br>
+ * <br>
+ * @param filename The index file, or null for the default name.<br>
+ * @return The number of entries added, or &lt;0 if there was no usable<br>
+ *   index.
+ */
+  public int loadSeekIndex(String filename) {
+    return VideoJNI.Demuxer_loadSeekIndex(swigCPtr, this, filename);
+  }
+
 /**
  * Gets the AVFormatContext.max_delay property if possible.<br>
  * @return The max delay, error code otherwise.
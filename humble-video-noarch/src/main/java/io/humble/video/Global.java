@@ -209,6 +209,159 @@ public class Global extends RefCounted {
     VideoJNI.Global_setFFmpegLoggingLevel(level);
   }
 
+/**
+ * Get the number of times the global Humble Video lock and the locks<br>
+ * FFmpeg takes (for example around opening and closing codecs) have<br>
+ * been acquired.<br>
+ * @return the number of acquisitions.
+ */
+  public static long getLockAcquisitions() {
+    return VideoJNI.Global_getLockAcquisitions();
+  }
+
+/**
+ * Get the number of times a thread tried to take the global Humble Video<br>
+ * lock or one of FFmpeg's locks while another thread held it.<br>
+ * @return the number of contended acquisitions.
+ */
+  public static long getLockContendedAcquisitions() {
+    return VideoJNI.Global_getLockContendedAcquisitions();
+  }
+
+/**
+ * Get the total time threads have spent waiting for the global Humble<br>
+ * Video lock and FFmpeg's locks.<br>
+ * @return the wait time, in nanoseconds.
+ */
+  public static long getLockWaitTime() {
+    return VideoJNI.Global_getLockWaitTime();
+  }
+
+/**
+ * Turn counting of native objects by type on or off.<br>
+ * <p><br>
+ * Off by default.  While on, every native object made (packets,<br>
+ * pictures, audio, buffers, rationals, coders and so on) is counted<br>
+ * against its concrete type, and buffers count their bytes against<br>
+ * the type that asked for them.  This costs a few atomic<br>
+ * adds per object made and destroyed, so leave it off unless you are<br>
+ * chasing memory growth.<br>
+ * </p><p><br>
+ * The counters can be sampled from any thread while media is being<br>
+ * processed.  Objects made while counting was off are never counted.<br>
+ * </p><br>
+ * @param enabled true to count.
+ */
+  public static void setObjectCounting(boolean enabled) {
+    VideoJNI.Global_setObjectCounting(enabled);
+  }
+
+/**
+ * @return true if native objects are being counted.<br>
+ * @see #setObjectCounting(boolean)
+ */
+  public static boolean isObjectCounting() {
+    return VideoJNI.Global_isObjectCounting();
+  }
+
+/**
+ * @return The number of native types counted so far.  Types are<br>
+ *   numbered from 0 in the order they were first seen, and a type<br>
+ *   keeps its number.
+ */
+  public static int getNumObjectTypes() {
+    return VideoJNI.Global_getNumObjectTypes();
+  }
+
+/**
+ * @param index A type number from 0 to #getNumObjectTypes()-1.<br>
+ * @return The native name of that type (for example<br>
+ *   "io::humble::video::MediaPacketImpl"), or null.
+ */
+  public static String getObjectTypeName(int index) {
+    return VideoJNI.Global_getObjectTypeName(index);
+  }
+
+/**
+ * @param index A type number from 0 to #getNumObjectTypes()-1.<br>
+ * @return The number of objects of that type alive now.
+ */
+  public static long getLiveObjects(int index) {
+    return VideoJNI.Global_getLiveObjects(index);
+  }
+
+/**
+ * @param index A type number from 0 to #getNumObjectTypes()-1.<br>
+ * @return The number of objects of that type made while counting<br>
+ *   was on.
+ */
+  public static long getCreatedObjects(int index) {
+    return VideoJNI.Global_getCreatedObjects(index);
+  }
+
+/**
+ * @param index A type number from 0 to #getNumObjectTypes()-1.<br>
+ * @return The bytes of Buffer memory objects of that type hold now.
+ */
+  public static long getObjectBytes(int index) {
+    return VideoJNI.Global_getObjectBytes(index);
+  }
+
+/**
+ * Turn on the probe cache, and set how many files it remembers.<br>
+ * <p><br>
+ * Demuxer#queryStreamMetaData() normally decodes the first part of a<br>
+ * file to learn its codec parameters, which is the slow part of<br>
+ * opening most media.  With the cache on, what it learned is kept<br>
+ * (keyed by path, size and modification time for local files, or by<br>
+ * size and a hash of the first 64 KiB for custom IO) and reused the<br>
+ * next time the same file is opened in this process.  Useful for<br>
+ * services that open the same assets over and over.<br>
+ * </p><br>
+ * @param entries How many files to remember; 0 (the default) turns the<br>
+ *   cache off and empties it.
+ */
+  public static void setProbeCacheCapacity(int entries) {
+    VideoJNI.Global_setProbeCacheCapacity(entries);
+  }
+
+/**
+ * @return How many files the probe cache remembers; 0 if it is off.
+ */
+  public static int getProbeCacheCapacity() {
+    return VideoJNI.Global_getProbeCacheCapacity();
+  }
+
+/**
+ * Empty the probe cache, for example after media files are replaced<br>
+ * in ways that keep their size and modification time.
+ */
+  public static void clearProbeCache() {
+    VideoJNI.Global_clearProbeCache();
+  }
+
+/**
+ * @return The number of probes the cache has answered.
+ */
+  public static long getProbeCacheHits() {
+    return VideoJNI.Global_getProbeCacheHits();
+  }
+
+/**
+ * @return The number of cacheable probes the cache could not answer.
+ */
+  public static long getProbeCacheMisses() {
+    return VideoJNI.Global_getProbeCacheMisses();
+  }
+
+/**
+ * @return The total time, in microseconds, the original probes took<br>
+ *   for every probe the cache has answered.
+ */
+  public static long getProbeCacheTimeSaved() {
+    return VideoJNI.Global_getProbeCacheTimeSaved();
+  }
+
 /**
  * A value that means no time stamp is set for a given object.<br>
  * if the Media#getTimeStamp() method of an<br>
@@ -0,0 +1,251 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.6
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package io.humble.video;
+import io.humble.ferry.*;
+/**
+ * What a Demuxer or Muxer's I/O has done so far: bytes, calls, seeks,<br>
+ * errors and how long the calls took.<br>
+ * <p><br>
+ * Turn it on with Demuxer#setIOInstrumented(boolean) or<br>
+ * Muxer#setIOInstrumented(boolean) before opening, then ask for a<br>
+ * snapshot with getIOStatistics() at any time, from any thread; the<br>
+ * snapshot does not change after it is taken.  It counts the calls<br>
+ * FFmpeg makes to fill (or drain) the Demuxer's input buffer (or the<br>
+ * Muxer's output buffer), so together with #getBufferLength() it tells<br>
+ * whether a slow job is waiting on I/O.<br>
+ * </p><p><br>
+ * Latencies are counted in power of 2 buckets; see<br>
+ * #getLatencyBucketStart(int).<br>
+ * </p>
+ */
+public class IOStatistics extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    Buffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected IOStatistics(long cPtr, boolean cMemoryOwn) {
+    super(VideoJNI.IOStatistics_SWIGUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected IOStatistics(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(VideoJNI.IOStatistics_SWIGUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  protected static long getCPtr(IOStatistics obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  protected long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new IOStatistics object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public IOStatistics copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new IOStatistics(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof IOStatistics)
+      equal = (((IOStatistics)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+/**
+ * @return The number of latency buckets.
+ */
+  public static int getNumLatencyBuckets() {
+    return VideoJNI.IOStatistics_getNumLatencyBuckets();
+  }
+
+/**
+ * @return The shortest latency, in microseconds, counted in the given<br>
+ *   bucket; each bucket ends where the next starts, and the last has no<br>
+ *   end.  -1 if bucket is out of range.
+ */
+  public static long getLatencyBucketStart(int bucket) {
+    return VideoJNI.IOStatistics_getLatencyBucketStart(bucket);
+  }
+
+/**
+ * Forget the buffer lengths learned by instrumented Demuxers and Muxers<br>
+ * for the protocols they used, so the next ones start from the<br>
+ * defaults again.
+ */
+  public static void resetTunedBufferLengths() {
+    VideoJNI.IOStatistics_resetTunedBufferLengths();
+  }
+
+/**
+ * @return The buffer length the Demuxer or Muxer gave FFmpeg when it<br>
+ *   opened.
+ */
+  public int getBufferLength() {
+    return VideoJNI.IOStatistics_getBufferLength(swigCPtr, this);
+  }
+
+  public long getBytesRead() {
+    return VideoJNI.IOStatistics_getBytesRead(swigCPtr, this);
+  }
+
+  public long getBytesWritten() {
+    return VideoJNI.IOStatistics_getBytesWritten(swigCPtr, this);
+  }
+
+/**
+ * @return The bytes skipped or rewound by seeks, added up.
+ */
+  public long getSeekDistance() {
+    return VideoJNI.IOStatistics_getSeekDistance(swigCPtr, this);
+  }
+
+/**
+ * @return The successful calls of the given kind.
+ */
+  public long getCalls(IOStatistics.Operation op) {
+    return VideoJNI.IOStatistics_getCalls(swigCPtr, this, op.swigValue());
+  }
+
+/**
+ * @return The calls of the given kind that returned an error.
+ */
+  public long getErrors(IOStatistics.Operation op) {
+    return VideoJNI.IOStatistics_getErrors(swigCPtr, this, op.swigValue());
+  }
+
+/**
+ * @return The microseconds spent in calls of the given kind.
+ */
+  public long getTotalLatency(IOStatistics.Operation op) {
+    return VideoJNI.IOStatistics_getTotalLatency(swigCPtr, this, op.swigValue());
+  }
+
+/**
+ * @return How many calls of the given kind took a time in the given<br>
+ *   bucket, or 0 if bucket is out of range.
+ */
+  public long getLatencyCount(IOStatistics.Operation op, int bucket) {
+    return VideoJNI.IOStatistics_getLatencyCount(swigCPtr, this, op.swigValue(), bucket);
+  }
+
+  /**
+   * The kinds of call counted; the same order as the handler's. 
+   */
+  public enum Operation {
+    READ(VideoJNI.IOStatistics_READ_get()),
+    WRITE(VideoJNI.IOStatistics_WRITE_get()),
+    SEEK(VideoJNI.IOStatistics_SEEK_get()),
+  ;
+
+    public final int swigValue() {
+      return swigValue;
+    }
+
+    public static Operation swigToEnum(int swigValue) {
+      Operation[] swigValues = Operation.class.getEnumConstants();
+      if (swigValue < swigValues.length && swigValue >= 0 && swigValues[swigValue].swigValue == swigValue)
+        return swigValues[swigValue];
+      for (Operation swigEnum : swigValues)
+        if (swigEnum.swigValue == swigValue)
+          return swigEnum;
+      throw new IllegalArgumentException("No enum " + Operation.class + " with value " + swigValue);
+    }
+
+    @SuppressWarnings("unused")
+    private Operation() {
+      this.swigValue = SwigNext.next++;
+    }
+
+    @SuppressWarnings("unused")
+    private Operation(int swigValue) {
+      this.swigValue = swigValue;
+      SwigNext.next = swigValue+1;
+    }
+
+    @SuppressWarnings("unused")
+    private Operation(Operation swigEnum) {
+      this.swigValue = swigEnum.swigValue;
+      SwigNext.next = this.swigValue+1;
+    }
+
+    private final int swigValue;
+
+    private static class SwigNext {
+      private static int next = 0;
+    }
+  }
+
+}
@@ -0,0 +1,157 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.6
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package io.humble.video;
+import io.humble.ferry.*;
+/**
+ * A fixed set of MediaPackets that Demuxer#readBatch(MediaPacketBatch)<br>
+ * fills in one call.<br>
+ * <p><br>
+ * The batch always holds the same packet objects, and each call to<br>
+ * Demuxer#readBatch(MediaPacketBatch) refills them from the start, so<br>
+ * Java callers can fetch every packet once with #getPacket(int) and keep<br>
+ * using them.  Anything that must outlive the next batch should be copied<br>
+ * with MediaPacket#make(MediaPacket, boolean).<br>
+ * </p>
+ */
+public class MediaPacketBatch extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    Buffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected MediaPacketBatch(long cPtr, boolean cMemoryOwn) {
+    super(VideoJNI.MediaPacketBatch_SWIGUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected MediaPacketBatch(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(VideoJNI.MediaPacketBatch_SWIGUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  protected static long getCPtr(MediaPacketBatch obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  protected long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new MediaPacketBatch object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public MediaPacketBatch copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new MediaPacketBatch(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof MediaPacketBatch)
+      equal = (((MediaPacketBatch)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+/**
+ * Make a batch of empty packets.<br>
+ * <br>
+ * @param capacity The number of packets; must be &gt; 0.
+ */
+  public static MediaPacketBatch make(int capacity) {
+    long cPtr = VideoJNI.MediaPacketBatch_make(capacity);
+    return (cPtr == 0) ? null : new MediaPacketBatch(cPtr, false);
+  }
+
+/**
+ * @return The number of packets in this batch.
+ */
+  public int getCapacity() {
+    return VideoJNI.MediaPacketBatch_getCapacity(swigCPtr, this);
+  }
+
+/**
+ * @return The number of packets filled by the last read; packets<br>
+ *   0 to getSize()-1 hold data.
+ */
+  public int getSize() {
+    return VideoJNI.MediaPacketBatch_getSize(swigCPtr, this);
+  }
+
+/**
+ * @param index Which packet, from 0 to #getCapacity()-1.<br>
+ * @return The packet at that position.  The same object is returned<br>
+ *   every time.
+ */
+  public MediaPacket getPacket(int index) {
+    long cPtr = VideoJNI.MediaPacketBatch_getPacket(swigCPtr, this, index);
+    return (cPtr == 0) ? null : new MediaPacket(cPtr, false);
+  }
+
+}
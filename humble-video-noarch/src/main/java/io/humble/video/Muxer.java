@@ -216,6 +216,42 @@ public class Muxer extends Container {
     return VideoJNI.Muxer_getOutputBufferLength(swigCPtr, this);
   }
 
+/**
+ * Count and time every write and seek this Muxer makes; see<br>
+ * #getIOStatistics().  Works for customio protocols and for any<br>
+ * protocol FFmpeg writes as a stream of bytes, but not for formats that<br>
+ * do their own networking, such as RTSP.<br>
+ * <p><br>
+ * An instrumented Muxer also tunes its buffer: unless<br>
+ * #setOutputBufferLength(int) was called, it opens with the length<br>
+ * learned from earlier instrumented Muxers on the same server (or, for<br>
+ * local files, in the same directory).<br>
+ * </p><br>
+ * <br>
+ * @param instrumented Whether to instrument the next open.<br>
+ * @throws RuntimeException if this Muxer has already been opened.
+ */
+  public void setIOInstrumented(boolean instrumented) {
+    VideoJNI.Muxer_setIOInstrumented(swigCPtr, this, instrumented);
+  }
+
+/**
+ * @return Whether I/O is (or will be, once opened) instrumented.
+ */
+  public boolean isIOInstrumented() {
+    return VideoJNI.Muxer_isIOInstrumented(swigCPtr, this);
+  }
+
+/**
+ * @return A snapshot of this Muxer's I/O so far, or the totals at close<br>
+ *   if it has been closed; null if I/O was not instrumented.  Safe to<br>
+ *   call from any thread.
+ */
+  public IOStatistics getIOStatistics() {
+    long cPtr = VideoJNI.Muxer_getIOStatistics(swigCPtr, this);
+    return (cPtr == 0) ? null : new IOStatistics(cPtr, false);
+  }
+
 /**
  * Adds a new stream that will have packets written to it.<br>
  * <br>
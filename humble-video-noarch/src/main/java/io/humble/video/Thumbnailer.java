@@ -0,0 +1,219 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.6
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package io.humble.video;
+import io.humble.ferry.*;
+/**
+ * Makes thumbnails of a video stream by decoding only a few of its key<br>
+ * frames.<br>
+ * <p><br>
+ * Decoding a whole movie to pick out a dozen pictures spends nearly all<br>
+ * its time on frames that are thrown away.  A Thumbnailer instead picks<br>
+ * #run(int) evenly spaced times, finds the key frame at or before each<br>
+ * one in the stream's index (see ContainerStream#getIndexEntry(int)),<br>
+ * seeks straight to it and decodes just that frame.  The Demuxer only<br>
+ * returns key packets (see Demuxer#setKeyFramesOnly(int, boolean)) and<br>
+ * the Decoder skips anything else it is given (see<br>
+ * Decoder#setSkipFrame(Decoder.Discard)).<br>
+ * </p><p><br>
+ * A stream with no index is thumbnailed the same way, leaving it to<br>
+ * Demuxer#seek(int, long, long, long, int) to find each key frame; build<br>
+ * one first with Demuxer#buildSeekIndex() if the format's seeking is slow.<br>
+ * </p><p><br>
+ * The Thumbnailer takes over the Demuxer: it deselects every other stream<br>
+ * and seeks wherever it needs to.<br>
+ * </p>
+ */
+public class Thumbnailer extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    Buffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected Thumbnailer(long cPtr, boolean cMemoryOwn) {
+    super(VideoJNI.Thumbnailer_SWIGUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected Thumbnailer(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(VideoJNI.Thumbnailer_SWIGUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  protected static long getCPtr(Thumbnailer obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  protected long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new Thumbnailer object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public Thumbnailer copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new Thumbnailer(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof Thumbnailer)
+      equal = (((Thumbnailer)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+/**
+ * Make a Thumbnailer for one video stream of an opened Demuxer.<br>
+ * @param demuxer The Demuxer to read from; must be open and not<br>
+ *   playing or paused.<br>
+ * @param streamIndex The video stream, or -1 for the first one.<br>
+ * @throws InvalidArgument if demuxer is null or the stream is not a<br>
+ *   video stream.
+ */
+  public static Thumbnailer make(Demuxer demuxer, int streamIndex) throws java.lang.InterruptedException, java.io.IOException {
+    long cPtr = VideoJNI.Thumbnailer_make(Demuxer.getCPtr(demuxer), demuxer, streamIndex);
+    return (cPtr == 0) ? null : new Thumbnailer(cPtr, false);
+  }
+
+/**
+ * @return The Demuxer read from.
+ */
+  public Demuxer getDemuxer() {
+    long cPtr = VideoJNI.Thumbnailer_getDemuxer(swigCPtr, this);
+    return (cPtr == 0) ? null : new Demuxer(cPtr, false);
+  }
+
+/**
+ * @return The stream thumbnailed.
+ */
+  public int getStreamIndex() {
+    return VideoJNI.Thumbnailer_getStreamIndex(swigCPtr, this);
+  }
+
+/**
+ * The Decoder used.  It is opened by the first thumbnail made, so set<br>
+ * anything else on it, such as Coder#setThreadCount(int), before then.<br>
+ * Decoder#setSkipLoopFilter(Decoder.Discard) makes each thumbnail<br>
+ * cheaper still, at some cost in quality.
+ */
+  public Decoder getDecoder() {
+    long cPtr = VideoJNI.Thumbnailer_getDecoder(swigCPtr, this);
+    return (cPtr == 0) ? null : new Decoder(cPtr, false);
+  }
+
+/**
+ * Seek to the key frame at or before a time stamp and decode it.<br>
+ * @param timeStamp The time stamp, in the stream's time base.<br>
+ * @return A new picture, or null if no key frame could be decoded<br>
+ *   from there to the end of the stream.<br>
+ * @throws RuntimeException if the Decoder cannot be opened.
+ */
+  public MediaPicture getKeyFrame(long timeStamp) throws java.lang.InterruptedException, java.io.IOException {
+    long cPtr = VideoJNI.Thumbnailer_getKeyFrame(swigCPtr, this, timeStamp);
+    return (cPtr == 0) ? null : new MediaPicture(cPtr, false);
+  }
+
+/**
+ * Make thumbnails at count evenly spaced times, replacing any from an<br>
+ * earlier run.<br>
+ * <p><br>
+ * Each of the count equal parts of the stream is represented by the<br>
+ * key frame at or before its middle.  A stream with fewer key frames<br>
+ * than that gets fewer thumbnails, as parts that share a key frame<br>
+ * share a thumbnail.  If the stream's duration is not known, only the<br>
+ * first key frame is used.<br>
+ * </p><br>
+ * @param count How many thumbnails to make; must be &gt; 0.<br>
+ * @return The number of thumbnails made.<br>
+ * @throws InvalidArgument if count &lt;= 0.
+ */
+  public int run(int count) throws java.lang.InterruptedException, java.io.IOException {
+    return VideoJNI.Thumbnailer_run(swigCPtr, this, count);
+  }
+
+/**
+ * @return The number of thumbnails the last #run(int) made.
+ */
+  public int getNumThumbnails() {
+    return VideoJNI.Thumbnailer_getNumThumbnails(swigCPtr, this);
+  }
+
+/**
+ * @param n The thumbnail, from 0 to #getNumThumbnails()-1.<br>
+ * @return The picture; MediaPicture#getTimeStamp() says where in the<br>
+ *   stream it is from.<br>
+ * @throws InvalidArgument if n is out of range.
+ */
+  public MediaPicture getThumbnail(int n) {
+    long cPtr = VideoJNI.Thumbnailer_getThumbnail(swigCPtr, this, n);
+    return (cPtr == 0) ? null : new MediaPicture(cPtr, false);
+  }
+
+}
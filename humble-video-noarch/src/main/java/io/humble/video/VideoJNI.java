@@ -9,6 +9,7 @@
 package io.humble.video;
 
 import io.humble.ferry.Buffer;
+import io.humble.ferry.CancellationToken;
 
 public class VideoJNI {
 
@@ -252,6 +253,22 @@ public class VideoJNI {
   public final static native String Global_getAVCodecVersionStr();
   public final static native void Global_init();
   public final static native void Global_setFFmpegLoggingLevel(int jarg1);
+  public final static native long Global_getLockAcquisitions();
+  public final static native long Global_getLockContendedAcquisitions();
+  public final static native long Global_getLockWaitTime();
+  public final static native void Global_setObjectCounting(boolean jarg1);
+  public final static native boolean Global_isObjectCounting();
+  public final static native int Global_getNumObjectTypes();
+  public final static native String Global_getObjectTypeName(int jarg1);
+  public final static native long Global_getLiveObjects(int jarg1);
+  public final static native long Global_getCreatedObjects(int jarg1);
+  public final static native long Global_getObjectBytes(int jarg1);
+  public final static native void Global_setProbeCacheCapacity(int jarg1);
+  public final static native int Global_getProbeCacheCapacity();
+  public final static native void Global_clearProbeCache();
+  public final static native long Global_getProbeCacheHits();
+  public final static native long Global_getProbeCacheMisses();
+  public final static native long Global_getProbeCacheTimeSaved();
   public final static native int KeyValueBag_KVB_NONE_get();
   public final static native int KeyValueBag_KVB_MATCH_CASE_get();
   public final static native int KeyValueBag_KVB_DONT_OVERWRITE_get();
@@ -517,6 +534,24 @@ public class VideoJNI {
   public final static native long MediaPacket_getConvergenceDuration(long jarg1, MediaPacket jarg1_);
   public final static native void MediaPacket_setConvergenceDuration(long jarg1, MediaPacket jarg1_, long jarg2);
   public final static native void MediaPacket_reset(long jarg1, MediaPacket jarg1_, int jarg2);
+  public final static native long MediaPacketBatch_make(int jarg1);
+  public final static native int MediaPacketBatch_getCapacity(long jarg1, MediaPacketBatch jarg1_);
+  public final static native int MediaPacketBatch_getSize(long jarg1, MediaPacketBatch jarg1_);
+  public final static native long MediaPacketBatch_getPacket(long jarg1, MediaPacketBatch jarg1_, int jarg2);
+  public final static native int IOStatistics_READ_get();
+  public final static native int IOStatistics_WRITE_get();
+  public final static native int IOStatistics_SEEK_get();
+  public final static native int IOStatistics_getNumLatencyBuckets();
+  public final static native long IOStatistics_getLatencyBucketStart(int jarg1);
+  public final static native void IOStatistics_resetTunedBufferLengths();
+  public final static native int IOStatistics_getBufferLength(long jarg1, IOStatistics jarg1_);
+  public final static native long IOStatistics_getBytesRead(long jarg1, IOStatistics jarg1_);
+  public final static native long IOStatistics_getBytesWritten(long jarg1, IOStatistics jarg1_);
+  public final static native long IOStatistics_getSeekDistance(long jarg1, IOStatistics jarg1_);
+  public final static native long IOStatistics_getCalls(long jarg1, IOStatistics jarg1_, int jarg2);
+  public final static native long IOStatistics_getErrors(long jarg1, IOStatistics jarg1_, int jarg2);
+  public final static native long IOStatistics_getTotalLatency(long jarg1, IOStatistics jarg1_, int jarg2);
+  public final static native long IOStatistics_getLatencyCount(long jarg1, IOStatistics jarg1_, int jarg2, int jarg3);
   public final static native int Configurable_getNumProperties(long jarg1, Configurable jarg1_);
   public final static native long Configurable_getPropertyMetaData__SWIG_0(long jarg1, Configurable jarg1_, int jarg2);
   public final static native long Configurable_getPropertyMetaData__SWIG_1(long jarg1, Configurable jarg1_, String jarg2);
@@ -1172,6 +1207,10 @@ public class VideoJNI {
   public final static native int Coder_FLAG2_CHUNKS_get();
   public final static native int Coder_FLAG2_SHOW_ALL_get();
   public final static native int Coder_FLAG2_EXPORT_MVS_get();
+  public final static native int Coder_THREAD_NONE_get();
+  public final static native int Coder_THREAD_FRAME_get();
+  public final static native int Coder_THREAD_SLICE_get();
+  public final static native int Coder_THREAD_FRAME_AND_SLICE_get();
   public final static native void Coder_open(long jarg1, Coder jarg1_, long jarg2, KeyValueBag jarg2_, long jarg3, KeyValueBag jarg3_);
   public final static native long Coder_getCodec(long jarg1, Coder jarg1_);
   public final static native int Coder_getCodecType(long jarg1, Coder jarg1_);
@@ -1203,6 +1242,12 @@ public class VideoJNI {
   public final static native void Coder_setFlag(long jarg1, Coder jarg1_, int jarg2, boolean jarg3);
   public final static native void Coder_setFlags2(long jarg1, Coder jarg1_, int jarg2);
   public final static native void Coder_setFlag2(long jarg1, Coder jarg1_, int jarg2, boolean jarg3);
+  public final static native void Coder_setThreadCount(long jarg1, Coder jarg1_, int jarg2);
+  public final static native int Coder_getThreadCount(long jarg1, Coder jarg1_);
+  public final static native void Coder_setThreadType(long jarg1, Coder jarg1_, int jarg2);
+  public final static native int Coder_getThreadType(long jarg1, Coder jarg1_);
+  public final static native int Coder_getActiveThreadType(long jarg1, Coder jarg1_);
+  public final static native int Coder_getThreadDelay(long jarg1, Coder jarg1_);
   public final static native int ContainerFormat_INVALID_FLAG_get();
   public final static native int ContainerFormat_NO_FILE_get();
   public final static native int ContainerFormat_NEED_NUMBER_get();
@@ -1270,6 +1315,24 @@ public class VideoJNI {
   public final static native int Decoder_decodeAudio(long jarg1, Decoder jarg1_, long jarg2, MediaAudio jarg2_, long jarg3, MediaPacket jarg3_, int jarg4);
   public final static native int Decoder_decodeVideo(long jarg1, Decoder jarg1_, long jarg2, MediaPicture jarg2_, long jarg3, MediaPacket jarg3_, int jarg4);
   public final static native int Decoder_decode(long jarg1, Decoder jarg1_, long jarg2, MediaSampled jarg2_, long jarg3, MediaPacket jarg3_, int jarg4);
+  public final static native void Decoder_setPictureBufferPooling(long jarg1, Decoder jarg1_, boolean jarg2);
+  public final static native boolean Decoder_isPictureBufferPooling(long jarg1, Decoder jarg1_);
+  public final static native long Decoder_getPictureBufferPoolHits(long jarg1, Decoder jarg1_);
+  public final static native long Decoder_getPictureBufferPoolMisses(long jarg1, Decoder jarg1_);
+  public final static native long Decoder_getPictureBufferPoolBytesRetained(long jarg1, Decoder jarg1_);
+  public final static native int Decoder_DISCARD_NONE_get();
+  public final static native int Decoder_DISCARD_DEFAULT_get();
+  public final static native int Decoder_DISCARD_NONREF_get();
+  public final static native int Decoder_DISCARD_BIDIR_get();
+  public final static native int Decoder_DISCARD_NONINTRA_get();
+  public final static native int Decoder_DISCARD_NONKEY_get();
+  public final static native int Decoder_DISCARD_ALL_get();
+  public final static native void Decoder_setSkipFrame(long jarg1, Decoder jarg1_, int jarg2);
+  public final static native int Decoder_getSkipFrame(long jarg1, Decoder jarg1_);
+  public final static native void Decoder_setSkipLoopFilter(long jarg1, Decoder jarg1_, int jarg2);
+  public final static native int Decoder_getSkipLoopFilter(long jarg1, Decoder jarg1_);
+  public final static native void Decoder_setSkipIDCT(long jarg1, Decoder jarg1_, int jarg2);
+  public final static native int Decoder_getSkipIDCT(long jarg1, Decoder jarg1_);
   public final static native long Encoder_getNumDroppedFrames(long jarg1, Encoder jarg1_);
   public final static native long Encoder_make__SWIG_0(long jarg1, Codec jarg1_);
   public final static native long Encoder_make__SWIG_1(long jarg1, Coder jarg1_);
@@ -1329,6 +1392,8 @@ public class VideoJNI {
   public final static native int Container_FLAG_PRIV_OPT_get();
   public final static native int Container_FLAG_KEEP_SIDE_DATA_get();
   public final static native int Container_getNumStreams(long jarg1, Container jarg1_) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native void Container_setCancellationToken(long jarg1, Container jarg1_, long jarg2, CancellationToken jarg2_);
+  public final static native long Container_getCancellationToken(long jarg1, Container jarg1_);
   public final static native long MuxerStream_getCoder(long jarg1, MuxerStream jarg1_);
   public final static native long MuxerStream_getMuxer(long jarg1, MuxerStream jarg1_);
   public final static native long DemuxerStream_getDecoder(long jarg1, DemuxerStream jarg1_);
@@ -1342,6 +1407,9 @@ public class VideoJNI {
   public final static native int Muxer_getNumStreams(long jarg1, Muxer jarg1_) throws java.lang.InterruptedException, java.io.IOException;
   public final static native void Muxer_setOutputBufferLength(long jarg1, Muxer jarg1_, int jarg2);
   public final static native int Muxer_getOutputBufferLength(long jarg1, Muxer jarg1_);
+  public final static native void Muxer_setIOInstrumented(long jarg1, Muxer jarg1_, boolean jarg2);
+  public final static native boolean Muxer_isIOInstrumented(long jarg1, Muxer jarg1_);
+  public final static native long Muxer_getIOStatistics(long jarg1, Muxer jarg1_);
   public final static native long Muxer_addNewStream(long jarg1, Muxer jarg1_, long jarg2, Coder jarg2_);
   public final static native long Muxer_getStream(long jarg1, Muxer jarg1_, int jarg2) throws java.lang.InterruptedException, java.io.IOException;
   public final static native boolean Muxer_write(long jarg1, Muxer jarg1_, long jarg2, MediaPacket jarg2_, boolean jarg3);
@@ -1350,11 +1418,21 @@ public class VideoJNI {
   public final static native long Demuxer_getFormat(long jarg1, Demuxer jarg1_);
   public final static native void Demuxer_setInputBufferLength(long jarg1, Demuxer jarg1_, int jarg2);
   public final static native int Demuxer_getInputBufferLength(long jarg1, Demuxer jarg1_);
+  public final static native void Demuxer_setIOInstrumented(long jarg1, Demuxer jarg1_, boolean jarg2);
+  public final static native boolean Demuxer_isIOInstrumented(long jarg1, Demuxer jarg1_);
+  public final static native long Demuxer_getIOStatistics(long jarg1, Demuxer jarg1_);
   public final static native void Demuxer_open(long jarg1, Demuxer jarg1_, String jarg2, long jarg3, DemuxerFormat jarg3_, boolean jarg4, boolean jarg5, long jarg6, KeyValueBag jarg6_, long jarg7, KeyValueBag jarg7_) throws java.lang.InterruptedException, java.io.IOException;
   public final static native void Demuxer_close(long jarg1, Demuxer jarg1_) throws java.lang.InterruptedException, java.io.IOException;
   public final static native long Demuxer_getStream(long jarg1, Demuxer jarg1_, int jarg2) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native void Demuxer_setStreamSelected(long jarg1, Demuxer jarg1_, int jarg2, boolean jarg3);
+  public final static native boolean Demuxer_isStreamSelected(long jarg1, Demuxer jarg1_, int jarg2);
+  public final static native int Demuxer_selectStreams(long jarg1, Demuxer jarg1_, int jarg2);
+  public final static native void Demuxer_setKeyFramesOnly(long jarg1, Demuxer jarg1_, int jarg2, boolean jarg3);
+  public final static native boolean Demuxer_isKeyFramesOnly(long jarg1, Demuxer jarg1_, int jarg2);
   public final static native int Demuxer_read(long jarg1, Demuxer jarg1_, long jarg2, MediaPacket jarg2_) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native int Demuxer_readBatch(long jarg1, Demuxer jarg1_, long jarg2, MediaPacketBatch jarg2_) throws java.lang.InterruptedException, java.io.IOException;
   public final static native void Demuxer_queryStreamMetaData(long jarg1, Demuxer jarg1_) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native long Demuxer_getProbeTimeSaved(long jarg1, Demuxer jarg1_);
   public final static native long Demuxer_getDuration(long jarg1, Demuxer jarg1_);
   public final static native long Demuxer_getStartTime(long jarg1, Demuxer jarg1_);
   public final static native long Demuxer_getFileSize(long jarg1, Demuxer jarg1_);
@@ -1366,6 +1444,14 @@ public class VideoJNI {
   public final static native String Demuxer_getURL(long jarg1, Demuxer jarg1_);
   public final static native int Demuxer_getReadRetryCount(long jarg1, Demuxer jarg1_);
   public final static native void Demuxer_setReadRetryCount(long jarg1, Demuxer jarg1_, int jarg2);
+  public final static native void Demuxer_setReadAhead(long jarg1, Demuxer jarg1_, int jarg2, int jarg3, long jarg4);
+  public final static native int Demuxer_getReadAheadMaxPackets(long jarg1, Demuxer jarg1_);
+  public final static native int Demuxer_getReadAheadMaxBytes(long jarg1, Demuxer jarg1_);
+  public final static native long Demuxer_getReadAheadMaxDuration(long jarg1, Demuxer jarg1_);
+  public final static native int Demuxer_getReadAheadQueuedPackets(long jarg1, Demuxer jarg1_);
+  public final static native long Demuxer_getReadAheadQueuedBytes(long jarg1, Demuxer jarg1_);
+  public final static native long Demuxer_getReadAheadEmptyStalls(long jarg1, Demuxer jarg1_);
+  public final static native long Demuxer_getReadAheadFullStalls(long jarg1, Demuxer jarg1_);
   public final static native boolean Demuxer_canStreamsBeAddedDynamically(long jarg1, Demuxer jarg1_);
   public final static native long Demuxer_getMetaData(long jarg1, Demuxer jarg1_);
   public final static native int Demuxer_setForcedAudioCodec(long jarg1, Demuxer jarg1_, int jarg2);
@@ -1376,9 +1462,45 @@ public class VideoJNI {
   public final static native int Demuxer_SEEK_ANY_get();
   public final static native int Demuxer_SEEK_FRAME_get();
   public final static native int Demuxer_seek(long jarg1, Demuxer jarg1_, int jarg2, long jarg3, long jarg4, long jarg5, int jarg6) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native int Demuxer_buildSeekIndex(long jarg1, Demuxer jarg1_) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native int Demuxer_saveSeekIndex(long jarg1, Demuxer jarg1_, String jarg2);
+  public final static native int Demuxer_loadSeekIndex(long jarg1, Demuxer jarg1_, String jarg2);
   public final static native int Demuxer_getMaxDelay(long jarg1, Demuxer jarg1_);
   public final static native void Demuxer_play(long jarg1, Demuxer jarg1_) throws java.lang.InterruptedException, java.io.IOException;
   public final static native void Demuxer_pause(long jarg1, Demuxer jarg1_) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native long BulkProbe_make(int jarg1);
+  public final static native int BulkProbe_getConcurrency(long jarg1, BulkProbe jarg1_);
+  public final static native void BulkProbe_setTimeout(long jarg1, BulkProbe jarg1_, long jarg2);
+  public final static native long BulkProbe_getTimeout(long jarg1, BulkProbe jarg1_);
+  public final static native int BulkProbe_add(long jarg1, BulkProbe jarg1_, String jarg2);
+  public final static native int BulkProbe_getNumFiles(long jarg1, BulkProbe jarg1_);
+  public final static native int BulkProbe_run(long jarg1, BulkProbe jarg1_);
+  public final static native String BulkProbe_getURL(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native boolean BulkProbe_isProbed(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native String BulkProbe_getErrorMessage(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native boolean BulkProbe_isTimedOut(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native long BulkProbe_getProbeTime(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native String BulkProbe_getFormatName(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native long BulkProbe_getDuration(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native long BulkProbe_getStartTime(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native int BulkProbe_getBitRate(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native int BulkProbe_getNumStreams(long jarg1, BulkProbe jarg1_, int jarg2);
+  public final static native int BulkProbe_getStreamType(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamCodecID(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamWidth(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamHeight(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamSampleRate(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamChannels(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamTimeBaseNumerator(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native int BulkProbe_getStreamTimeBaseDenominator(long jarg1, BulkProbe jarg1_, int jarg2, int jarg3);
+  public final static native long Thumbnailer_make(long jarg1, Demuxer jarg1_, int jarg2) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native long Thumbnailer_getDemuxer(long jarg1, Thumbnailer jarg1_);
+  public final static native int Thumbnailer_getStreamIndex(long jarg1, Thumbnailer jarg1_);
+  public final static native long Thumbnailer_getDecoder(long jarg1, Thumbnailer jarg1_);
+  public final static native long Thumbnailer_getKeyFrame(long jarg1, Thumbnailer jarg1_, long jarg2) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native int Thumbnailer_run(long jarg1, Thumbnailer jarg1_, int jarg2) throws java.lang.InterruptedException, java.io.IOException;
+  public final static native int Thumbnailer_getNumThumbnails(long jarg1, Thumbnailer jarg1_);
+  public final static native long Thumbnailer_getThumbnail(long jarg1, Thumbnailer jarg1_, int jarg2);
   public final static native int FilterType_FILTER_FLAG_UNKNOWN_get();
   public final static native int FilterType_FILTER_FLAG_DYNAMIC_INPUTS_get();
   public final static native int FilterType_FILTER_FLAG_DYNAMIC_OUTPUTS_get();
@@ -1484,6 +1606,8 @@ public class VideoJNI {
   public final static native long MediaSubtitle_SWIGUpcast(long jarg1);
   public final static native long MediaSubtitleRectangle_SWIGUpcast(long jarg1);
   public final static native long MediaPacket_SWIGUpcast(long jarg1);
+  public final static native long MediaPacketBatch_SWIGUpcast(long jarg1);
+  public final static native long IOStatistics_SWIGUpcast(long jarg1);
   public final static native long Configurable_SWIGUpcast(long jarg1);
   public final static native long MediaResampler_SWIGUpcast(long jarg1);
   public final static native long MediaPictureResampler_SWIGUpcast(long jarg1);
@@ -1505,6 +1629,8 @@ public class VideoJNI {
   public final static native long DemuxerStream_SWIGUpcast(long jarg1);
   public final static native long Muxer_SWIGUpcast(long jarg1);
   public final static native long Demuxer_SWIGUpcast(long jarg1);
+  public final static native long BulkProbe_SWIGUpcast(long jarg1);
+  public final static native long Thumbnailer_SWIGUpcast(long jarg1);
   public final static native long FilterType_SWIGUpcast(long jarg1);
   public final static native long FilterGraph_SWIGUpcast(long jarg1);
   public final static native long Filter_SWIGUpcast(long jarg1);
@@ -19,6 +19,8 @@
 package io.humble.video.customio;
 
 
+import java.nio.ByteBuffer;
+
 import io.humble.video.customio.FfmpegIOHandle;
 import io.humble.video.customio.IURLProtocolHandlerFactory;
 import io.humble.video.customio.URLProtocolManager;
@@ -82,6 +84,102 @@ public class FfmpegIO
     native_registerProtocolHandler(protocol, manager);
   }
 
+  /**
+   * Register a native protocol that reads local files through a memory
+   * mapping, so that for example
+   * <code>Demuxer.open("mmap:/data/movie.mp4", ...)</code> never copies
+   * file data through stdio or Java.  Read only, and not available on
+   * Windows.
+   * 
+   * @param protocol The protocol name to register, for example "mmap".
+   * @return 0 on success; -1 on error.
+   */
+  public static synchronized int registerMmapProtocol(String protocol)
+  {
+    return native_registerMmapProtocol(protocol);
+  }
+
+  /**
+   * Register a native protocol that reads local files a block at a time on
+   * background threads, keeping several blocks in flight ahead of the
+   * current position so the disk (or NAS) stays busy while FFmpeg parses.
+   * A seek cancels the reads that are no longer wanted.  Read only, and
+   * not available on Windows.
+   * 
+   * @param protocol The protocol name to register, for example "prefetch".
+   * @param blockSize The bytes read at a time, rounded up to a multiple of
+   *   4096; 0 for the default of 1 MB.
+   * @param blocksAhead How many blocks to keep in flight; 0 for the
+   *   default of 4.
+   * @param directIO If true, read with O_DIRECT so a single pass over a
+   *   very large file does not push everything else out of the page cache.
+   *   Ignored if the file system does not support it.
+   * @return 0 on success; -1 on error.
+   */
+  public static synchronized int registerPrefetchProtocol(String protocol,
+      int blockSize, int blocksAhead, boolean directIO)
+  {
+    return native_registerPrefetchProtocol(protocol, blockSize, blocksAhead,
+        directIO);
+  }
+
+  /**
+   * Register a native protocol that carries bytes from a producer to a
+   * consumer through a ring buffer in memory, so a live source can feed a
+   * Demuxer without a pipe, socket or Java InputStream in between.  Each
+   * URL names its own ring; open it once for writing (the producer, using
+   * {@link #url_write(FfmpegIOHandle, ByteBuffer, int)}) and once for
+   * reading (usually <code>Demuxer.open("memring:camera1", ...)</code>).
+   * Closing the writer is end of file for the reader; closing the reader
+   * makes further writes fail.  Not seekable.
+   * 
+   * @param protocol The protocol name to register, for example "memring".
+   * @param capacity The bytes each ring holds, rounded up to a power of 2;
+   *   0 for the default of 4 MB.
+   * @param blocking If true, a reader waits for data and a writer waits for
+   *   room; otherwise they return -EAGAIN.  Waits end early if the
+   *   handle's CancellationToken is cancelled or times out.
+   * @return 0 on success; -1 on error.
+   */
+  public static synchronized int registerMemoryRingProtocol(String protocol,
+      int capacity, boolean blocking)
+  {
+    return native_registerMemoryRingProtocol(protocol, capacity, blocking);
+  }
+
+  /** Index of the ring's capacity in bytes, in memory ring statistics. */
+  public static final int MEMRING_STAT_CAPACITY = 0;
+  /** Index of the bytes written but not yet read. */
+  public static final int MEMRING_STAT_BUFFERED = 1;
+  /** Index of the most bytes ever buffered at once. */
+  public static final int MEMRING_STAT_HIGH_WATER = 2;
+  /** Index of the total bytes written. */
+  public static final int MEMRING_STAT_BYTES_WRITTEN = 3;
+  /** Index of the total bytes read. */
+  public static final int MEMRING_STAT_BYTES_READ = 4;
+  /** Index of the writes that found the ring full. */
+  public static final int MEMRING_STAT_WRITER_STALLS = 5;
+  /** Index of the reads that found the ring empty. */
+  public static final int MEMRING_STAT_READER_STALLS = 6;
+  /** The number of memory ring statistics. */
+  public static final int MEMRING_NUM_STATS = 7;
+
+  /**
+   * Sample the counters of a memory ring registered with
+   * {@link #registerMemoryRingProtocol(String, int, boolean)}.  Safe to
+   * call from any thread while the ring is in use.
+   * 
+   * @param url The ring's URL, for example "memring:camera1".
+   * @param stats Filled in, indexed by the MEMRING_STAT_ constants; a
+   *   shorter array gets the first few.
+   * @return The number of statistics filled in, or -1 if no ring is open
+   *   under that URL.
+   */
+  public static int getMemoryRingStatistics(String url, long[] stats)
+  {
+    return native_getMemoryRingStatistics(url, stats);
+  }
+
   public static int url_open(FfmpegIOHandle handle, String filename, int flags)
   {
     return native_url_open(handle, filename, flags);
@@ -102,6 +200,32 @@ public class FfmpegIO
     return native_url_write(handle, buffer, length);
   }
 
+  /**
+   * Write length bytes from the buffer's position, and move the position
+   * past whatever was written.  A direct buffer is handed to the native
+   * handler without being copied.
+   * 
+   * @return The number of bytes written, or a negative number on error.
+   */
+  public static int url_write(FfmpegIOHandle handle, ByteBuffer buffer,
+      int length)
+  {
+    if (length > buffer.remaining())
+      throw new IllegalArgumentException("length is past the buffer's limit");
+    int retval;
+    if (buffer.isDirect())
+      retval = native_url_writeDirect(handle, buffer, buffer.position(), length);
+    else
+    {
+      byte[] bytes = new byte[length];
+      buffer.duplicate().get(bytes);
+      retval = native_url_write(handle, bytes, length);
+    }
+    if (retval > 0)
+      buffer.position(buffer.position() + retval);
+    return retval;
+  }
+
   public static long url_seek(FfmpegIOHandle handle, long position, int whence)
   {
     return native_url_seek(handle, position, whence);
@@ -110,6 +234,17 @@ public class FfmpegIO
   private static native int native_registerProtocolHandler(
       String urlPrefix, URLProtocolManager proto);
 
+  private static native int native_registerMmapProtocol(String protocol);
+
+  private static native int native_registerPrefetchProtocol(String protocol,
+      int blockSize, int blocksAhead, boolean directIO);
+
+  private static native int native_registerMemoryRingProtocol(String protocol,
+      int capacity, boolean blocking);
+
+  private static native int native_getMemoryRingStatistics(String url,
+      long[] stats);
+
   private static native int native_url_open(FfmpegIOHandle handle,
       String filename, int flags);
 
@@ -119,6 +254,9 @@ public class FfmpegIO
   private static native int native_url_write(FfmpegIOHandle handle,
       byte[] buffer, int length);
 
+  private static native int native_url_writeDirect(FfmpegIOHandle handle,
+      ByteBuffer buffer, int offset, int length);
+
   private static native long native_url_seek(FfmpegIOHandle handle,
       long position, int whence);
 
@@ -21,10 +21,11 @@ package io.humble.video.customio;
 import java.io.File;
 import java.io.IOException;
 import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
-import io.humble.video.customio.IURLProtocolHandler;
+import io.humble.video.customio.IDirectURLProtocolHandler;
 
 /**
  * Implementation of URLProtocolHandler that can read and write files.
@@ -36,7 +37,7 @@ import io.humble.video.customio.IURLProtocolHandler;
  * @author aclarke
  *
  */
-public class FileProtocolHandler implements IURLProtocolHandler
+public class FileProtocolHandler implements IDirectURLProtocolHandler
 {
   File file = null;
   RandomAccessFile stream = null;
@@ -157,6 +158,21 @@ public class FileProtocolHandler implements IURLProtocolHandler
     }
   }
 
+  public int read(ByteBuffer buf, int size)
+  {
+    // the channel shares the file pointer with stream
+    try
+    {
+      return stream.getChannel().read(buf);
+    }
+    catch (IOException e)
+    {
+      log.error("Got IO exception reading from file: {}", file);
+      e.printStackTrace();
+      return -1;
+    }
+  }
+
   public long seek(long offset, int whence)
   {
     try
@@ -207,6 +223,22 @@ public class FileProtocolHandler implements IURLProtocolHandler
     }
   }
 
+  public int write(ByteBuffer buf, int size)
+  {
+    try
+    {
+      while (buf.hasRemaining())
+        stream.getChannel().write(buf);
+      return size;
+    }
+    catch (IOException e)
+    {
+      log.error("Got error writing to file: {}", file);
+      e.printStackTrace();
+      return -1;
+    }
+  }
+
   private String getFilename(String url)
   {
     String retval = url;
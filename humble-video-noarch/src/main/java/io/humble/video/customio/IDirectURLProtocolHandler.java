@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Art Clarke.  All rights reserved.
+ *  
+ * This file is part of Humble-Video.
+ *
+ * Humble-Video is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Humble-Video is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Humble-Video.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+package io.humble.video.customio;
+
+import java.nio.ByteBuffer;
+
+/**
+ * An {@link IURLProtocolHandler} that can read and write FFMPEG's own
+ * buffers directly.
+ * <p>
+ * For a plain {@link IURLProtocolHandler}, every read and write makes a new
+ * Java byte array and copies it to or from FFMPEG's native buffer.  If
+ * your handler implements this interface instead, Humble Video passes a
+ * direct {@link ByteBuffer} over FFMPEG's buffer, made once per handler
+ * and reused, so a {@link java.nio.channels.ReadableByteChannel} (say) can
+ * read straight into native memory with no copies or garbage.
+ * </p>
+ * <p>
+ * The buffer is only valid during the call; do not keep a reference to
+ * it.  Its position is 0 and its limit is <code>size</code> on every call,
+ * and what you do to its position and limit does not matter afterwards.
+ * The byte[] versions of {@link #read(byte[], int)} and
+ * {@link #write(byte[], int)} are only called if Humble Video cannot wrap
+ * native memory on this JVM.
+ * </p>
+ */
+public interface IDirectURLProtocolHandler extends IURLProtocolHandler
+{
+  /**
+   * Like {@link IURLProtocolHandler#read(byte[], int)}, but into FFMPEG's
+   * own buffer.
+   * 
+   * @param buf The buffer to write your data to, from index 0.
+   * @param size The number of bytes available in buf.
+   * @return 0 for end of file, else number of bytes you wrote to the buffer, or -1 if error.
+   */
+  public int read(ByteBuffer buf, int size);
+
+  /**
+   * Like {@link IURLProtocolHandler#write(byte[], int)}, but from FFMPEG's
+   * own buffer.  Do not modify the buffer.
+   * 
+   * @param buf The data you should write, from index 0.
+   * @param size The number of bytes in buf.
+   * @return 0 for end of file, else number of bytes you read from buf, or -1 if error.
+   */
+  public int write(ByteBuffer buf, int size);
+}
@@ -44,7 +44,7 @@ import org.slf4j.LoggerFactory;
  * 
  */
 
-public class ReadableWritableChannelHandler implements IURLProtocolHandler
+public class ReadableWritableChannelHandler implements IDirectURLProtocolHandler
 {
   private final Logger log = LoggerFactory.getLogger(this.getClass());
 
@@ -236,6 +236,50 @@ public class ReadableWritableChannelHandler implements IURLProtocolHandler
     }
   }
 
+  /**
+   * {@inheritDoc}
+   * 
+   * Reads straight from the channel into FFMPEG's buffer.
+   */
+  public int read(ByteBuffer buf, int size)
+  {
+    if (mOpenStream == null || !(mOpenStream instanceof ReadableByteChannel))
+      return -1;
+
+    try
+    {
+      return ((ReadableByteChannel) mOpenStream).read(buf);
+    }
+    catch (IOException e)
+    {
+      log.error("Got IO exception reading from channel: {}; {}",
+          mOpenStream, e);
+      return -1;
+    }
+  }
+
+  /**
+   * {@inheritDoc}
+   * 
+   * Writes straight from FFMPEG's buffer to the channel.
+   */
+  public int write(ByteBuffer buf, int size)
+  {
+    if (mOpenStream == null ||
+        !(mOpenStream instanceof WritableByteChannel))
+      return -1;
+
+    try
+    {
+      return ((WritableByteChannel) mOpenStream).write(buf);
+    }
+    catch (IOException e)
+    {
+      log.error("Got error writing to file: {}; {}", mOpenStream, e);
+      return -1;
+    }
+  }
+
   /**
    * {@inheritDoc}
    * Always true for this class. 
@@ -54,11 +54,10 @@ public class AtomicIntegerTest extends TestCase
   }
   
   @Test
-  @Ignore
   public void testIsAtomic()
   {
     ai = new AtomicInteger();
-    assertTrue("is not using JVM for atomic locks", ai.isAtomic());
+    assertTrue("is not using native atomics", ai.isAtomic());
   }
   
   @Test
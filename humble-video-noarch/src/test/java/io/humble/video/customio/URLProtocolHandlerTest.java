@@ -19,6 +19,10 @@
 package io.humble.video.customio;
 
 import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+import java.nio.ByteBuffer;
+import java.util.Arrays;
 
 import org.junit.Before;
 import org.junit.BeforeClass;
@@ -26,6 +30,7 @@ import org.junit.Test;
 
 import io.humble.video.customio.FfmpegIO;
 import io.humble.video.customio.FfmpegIOHandle;
+import io.humble.video.customio.IDirectURLProtocolHandler;
 import io.humble.video.customio.IURLProtocolHandler;
 import io.humble.video.customio.IURLProtocolHandlerFactory;
 import io.humble.video.customio.URLProtocolManager;
@@ -76,6 +81,67 @@ public class URLProtocolHandlerTest
       return mHandler;
     }
   };
+  /** Only the ByteBuffer methods work, so we know which ones were called. */
+  private static final IDirectURLProtocolHandler mDirectHandler = new IDirectURLProtocolHandler()
+  {
+    public int close()
+    {
+      return 0;
+    }
+
+    public boolean isStreamed(String aUrl, int aFlags)
+    {
+      return true;
+    }
+
+    public int open(String aUrl, int aFlags)
+    {
+      return 0;
+    }
+
+    public int read(byte[] aBuf, int aSize)
+    {
+      throw new IllegalStateException("should have read into a ByteBuffer");
+    }
+
+    public int read(ByteBuffer aBuf, int aSize)
+    {
+      assertTrue(aBuf.isDirect());
+      assertEquals(0, aBuf.position());
+      assertEquals(aSize, aBuf.remaining());
+      for (int i = 0; i < aSize; i++)
+        aBuf.put((byte) (i + 1));
+      return aSize;
+    }
+
+    public long seek(long aOffset, int aWhence)
+    {
+      return -1;
+    }
+
+    public int write(byte[] aBuf, int aSize)
+    {
+      throw new IllegalStateException("should have written from a ByteBuffer");
+    }
+
+    public int write(ByteBuffer aBuf, int aSize)
+    {
+      assertTrue(aBuf.isDirect());
+      assertEquals(aSize, aBuf.remaining());
+      for (int i = 0; i < aSize; i++)
+        if (aBuf.get(i) != (byte) (i + 1))
+          return -1;
+      return aSize;
+    }
+  };
+  private static final IURLProtocolHandlerFactory mDirectFactory = new IURLProtocolHandlerFactory()
+  {
+    public IURLProtocolHandler getHandler(String aProtocol, String aUrl,
+        int aFlags)
+    {
+      return mDirectHandler;
+    }
+  };
   private final byte[] mBuffer = new byte[10];
   private FfmpegIOHandle mHandle;
   
@@ -83,6 +149,7 @@ public class URLProtocolHandlerTest
   public static void beforeClass()
   {
     mMgr.registerFactory("test", mFactory);
+    mMgr.registerFactory("testdirect", mDirectFactory);
   }
   
   @Before
@@ -138,6 +205,27 @@ public class URLProtocolHandlerTest
     assertEquals("should fail", -1, retval);
   }
 
+  @Test
+  public void testDirectReadWrite()
+  {
+    int retval = -1;
+    retval = FfmpegIO.url_open(mHandle, "testdirect:succeed", IURLProtocolHandler.URL_RDWR);
+    assertEquals("should succeed", 0, retval);
+    // twice, so the second read reuses the ByteBuffer
+    for (int i = 0; i < 2; i++)
+    {
+      Arrays.fill(mBuffer, (byte) 0);
+      retval = FfmpegIO.url_read(mHandle, mBuffer, mBuffer.length);
+      assertEquals(mBuffer.length, retval);
+      for (int j = 0; j < mBuffer.length; j++)
+        assertEquals((byte) (j + 1), mBuffer[j]);
+    }
+    retval = FfmpegIO.url_write(mHandle, mBuffer, mBuffer.length);
+    assertEquals(mBuffer.length, retval);
+    retval = FfmpegIO.url_close(mHandle);
+    assertEquals(0, retval);
+  }
+
   @Test
   public void testURLProtocolManagerGetResource()
   {